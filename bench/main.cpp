@@ -0,0 +1,320 @@
+/* Microbenchmarks for the vku hot paths.
+ *
+ * Results are written as a JSON array (stdout by default, or the file given by --output), one object per benchmark
+ * with the per-iteration statistics in nanoseconds. Use --filter <substring> to run the subset of benchmarks.
+ *
+ * The suite is headless, therefore it can run on the software Vulkan implementations like lavapipe or SwiftShader,
+ * by forcing the ICD with VK_DRIVER_FILES (or VK_ICD_FILENAMES for the older loaders).
+ */
+
+#include <vulkan/vulkan_hpp_macros.hpp>
+
+import std;
+import vku;
+
+#if VULKAN_HPP_DISPATCH_LOADER_DYNAMIC == 1
+VULKAN_HPP_DEFAULT_DISPATCH_LOADER_DYNAMIC_STORAGE
+#endif
+
+struct QueueFamilies {
+    std::uint32_t graphics;
+
+    explicit QueueFamilies(vk::PhysicalDevice physicalDevice)
+        : graphics { vku::getGraphicsQueueFamily(physicalDevice.getQueueFamilyProperties()).value() } { }
+};
+
+struct Queues {
+    vk::Queue graphics;
+
+    Queues(vk::Device device, const QueueFamilies &queueFamilies)
+        : graphics { device.getQueue(queueFamilies.graphics, 0) } { }
+
+    [[nodiscard]] static auto getCreateInfos(vk::PhysicalDevice, const QueueFamilies &queueFamilies) noexcept -> vku::RefHolder<vk::DeviceQueueCreateInfo> {
+        return vku::RefHolder {
+            [&]() {
+                static constexpr float priority = 1.f;
+                return vk::DeviceQueueCreateInfo {
+                    {},
+                    queueFamilies.graphics,
+                    vk::ArrayProxyNoTemporaries<const float>(priority),
+                };
+            },
+        };
+    }
+};
+
+struct Gpu : vku::Gpu<QueueFamilies, Queues> {
+    explicit Gpu(const vk::raii::Instance &instance [[clang::lifetimebound]])
+        : vku::Gpu<QueueFamilies, Queues> { instance, vku::Gpu<QueueFamilies, Queues>::Config {
+#if __APPLE__
+            .deviceExtensions = {
+                vk::KHRPortabilitySubsetExtensionName,
+            },
+#endif
+            .devicePNexts = std::tuple {
+                vk::PhysicalDeviceTimelineSemaphoreFeatures { true },
+            },
+            .apiVersion = vk::makeApiVersion(0, 1, 2, 0),
+        } } { }
+};
+
+class Harness {
+public:
+    explicit Harness(std::string_view filter) noexcept
+        : filter { filter } { }
+
+    /**
+     * Run \p f for \p iterations times (after a warm-up run) and record the per-iteration statistics.
+     * @param name Benchmark name.
+     * @param iterations Number of the measured iterations.
+     * @param itemsPerIteration Number of the items processed in an iteration, for the per-item throughput.
+     * @param f Benchmark body.
+     */
+    void run(std::string_view name, std::size_t iterations, std::size_t itemsPerIteration, std::invocable auto &&f) {
+        if (!name.contains(filter)) {
+            return;
+        }
+
+        f();
+
+        std::vector<double> durations;
+        durations.reserve(iterations);
+        for (std::size_t i = 0; i < iterations; ++i) {
+            const auto start = std::chrono::steady_clock::now();
+            f();
+            durations.push_back(std::chrono::duration<double, std::nano> { std::chrono::steady_clock::now() - start }.count());
+        }
+        std::ranges::sort(durations);
+
+        const double mean = std::ranges::fold_left(durations, 0.0, std::plus{}) / durations.size();
+        results.push_back({
+            .name = std::string { name },
+            .iterations = iterations,
+            .itemsPerIteration = itemsPerIteration,
+            .minNs = durations.front(),
+            .medianNs = durations[durations.size() / 2],
+            .meanNs = mean,
+            .maxNs = durations.back(),
+        });
+        std::println(std::cerr, "{}: {:.1f} ns/iter (median)", name, results.back().medianNs);
+    }
+
+    void writeJson(std::ostream &os) const {
+        os << "[\n";
+        for (bool first = true; const Result &result : results) {
+            if (!first) {
+                os << ",\n";
+            }
+            first = false;
+
+            os << std::format(
+                R"(  {{ "name": "{}", "iterations": {}, "items_per_iteration": {}, "min_ns": {:.1f}, "median_ns": {:.1f}, "mean_ns": {:.1f}, "max_ns": {:.1f} }})",
+                result.name, result.iterations, result.itemsPerIteration, result.minNs, result.medianNs, result.meanNs, result.maxNs);
+        }
+        os << "\n]\n";
+    }
+
+private:
+    struct Result {
+        std::string name;
+        std::size_t iterations;
+        std::size_t itemsPerIteration;
+        double minNs;
+        double medianNs;
+        double meanNs;
+        double maxNs;
+    };
+
+    std::string_view filter;
+    std::vector<Result> results;
+};
+
+// OpEntryPoint GLCompute %1 "main"; OpExecutionMode %1 LocalSize 1 1 1; void main() { }
+constexpr std::array emptyComputeSpirv {
+    0x07230203U, 0x00010000U, 0U, 5U, 0U,
+    0x00020011U, 1U, // OpCapability Shader
+    0x0003000EU, 0U, 1U, // OpMemoryModel Logical GLSL450
+    0x0005000FU, 5U, 1U, 0x6E69616DU, 0U, // OpEntryPoint GLCompute %1 "main"
+    0x00060010U, 1U, 17U, 1U, 1U, 1U, // OpExecutionMode %1 LocalSize 1 1 1
+    0x00020013U, 2U, // %2 = OpTypeVoid
+    0x00030021U, 3U, 2U, // %3 = OpTypeFunction %2
+    0x00050036U, 2U, 1U, 0U, 3U, // %1 = OpFunction %2 None %3
+    0x000200F8U, 4U, // %4 = OpLabel
+    0x000100FDU, // OpReturn
+    0x00010038U, // OpFunctionEnd
+};
+
+int main(int argc, char **argv) {
+    std::string_view filter;
+    std::optional<std::filesystem::path> outputPath;
+    for (int i = 1; i < argc; ++i) {
+        if (const std::string_view arg { argv[i] }; arg == "--filter" && i + 1 < argc) {
+            filter = argv[++i];
+        }
+        else if (arg == "--output" && i + 1 < argc) {
+            outputPath.emplace(argv[++i]);
+        }
+        else {
+            std::println(std::cerr, "Usage: {} [--filter <substring>] [--output <path>]", argv[0]);
+            return 1;
+        }
+    }
+
+#if VULKAN_HPP_DISPATCH_LOADER_DYNAMIC == 1
+    VULKAN_HPP_DEFAULT_DISPATCHER.init();
+#endif
+
+    const vk::raii::Context context;
+
+    const vk::raii::Instance instance { context, vk::InstanceCreateInfo {
+#if __APPLE__
+        vk::InstanceCreateFlagBits::eEnumeratePortabilityKHR,
+#else
+        {},
+#endif
+        vku::unsafeAddress(vk::ApplicationInfo {
+            "vku_bench", 0,
+            {}, 0,
+            vk::makeApiVersion(0, 1, 2, 0),
+        }),
+        {},
+#if __APPLE__
+        vku::unsafeProxy({
+            vk::KHRGetPhysicalDeviceProperties2ExtensionName,
+            vk::KHRPortabilityEnumerationExtensionName,
+        }),
+#endif
+    } };
+#if VULKAN_HPP_DISPATCH_LOADER_DYNAMIC == 1
+    VULKAN_HPP_DEFAULT_DISPATCHER.init(*instance);
+#endif
+
+    Harness harness { filter };
+
+    harness.run("Gpu construction", 8, 1, [&] {
+        std::ignore = Gpu { instance };
+    });
+
+    const Gpu gpu { instance };
+    const vk::raii::CommandPool commandPool { gpu.device, vk::CommandPoolCreateInfo { vk::CommandPoolCreateFlagBits::eTransient, gpu.queueFamilies.graphics } };
+
+    harness.run("executeSingleCommand", 256, 1, [&] {
+        const vk::raii::Fence fence { gpu.device, vk::FenceCreateInfo{} };
+        vku::executeSingleCommand(*gpu.device, *commandPool, gpu.queues.graphics, [](vk::CommandBuffer) { }, *fence);
+        std::ignore = gpu.device.waitForFences(*fence, true, ~0ULL);
+        commandPool.reset();
+    });
+
+    harness.run("executeHierarchicalCommands", 256, 4, [&] {
+        const auto [timelineSemaphores, waitValues] = vku::executeHierarchicalCommands(
+            gpu.device,
+            std::forward_as_tuple(
+                vku::ExecutionInfo { [](vk::CommandBuffer) { }, *commandPool, gpu.queues.graphics },
+                vku::ExecutionInfo { [](vk::CommandBuffer) { }, *commandPool, gpu.queues.graphics }),
+            std::forward_as_tuple(
+                vku::ExecutionInfo { [](vk::CommandBuffer) { }, *commandPool, gpu.queues.graphics },
+                vku::ExecutionInfo { [](vk::CommandBuffer) { }, *commandPool, gpu.queues.graphics }));
+        std::ignore = gpu.device.waitSemaphores({
+            {},
+            vku::unsafeProxy(timelineSemaphores | std::views::transform([](const auto &x) { return *x; }) | std::ranges::to<std::vector>()),
+            waitValues,
+        }, ~0ULL);
+        commandPool.reset();
+    });
+
+    const std::vector<std::uint32_t> bufferData(1 << 18, 0xC8C8C8C8U);
+    harness.run("MappedBuffer construction and fill (1 MiB)", 64, 1, [&] {
+        std::ignore = vku::MappedBuffer { gpu.allocator, std::from_range, bufferData, vk::BufferUsageFlagBits::eStorageBuffer };
+    });
+
+    struct Layout : vku::DescriptorSetLayout<vk::DescriptorType::eUniformBuffer, vk::DescriptorType::eStorageBuffer, vk::DescriptorType::eStorageBuffer, vk::DescriptorType::eStorageBuffer> {
+        explicit Layout(const vk::raii::Device &device [[clang::lifetimebound]])
+            : DescriptorSetLayout { device, vk::DescriptorSetLayoutCreateInfo {
+                {},
+                vku::unsafeProxy(getBindings(
+                    { 1, vk::ShaderStageFlagBits::eCompute },
+                    { 1, vk::ShaderStageFlagBits::eCompute },
+                    { 1, vk::ShaderStageFlagBits::eCompute },
+                    { 1, vk::ShaderStageFlagBits::eCompute })),
+            } } { }
+    } layout { gpu.device };
+
+    harness.run("PoolSizes arithmetic", 4096, 1, [&] {
+        const vku::PoolSizes poolSizes = layout.getPoolSize() * 64 + layout.getPoolSize() * 3;
+        std::ignore = poolSizes.getDescriptorPoolCreateInfo();
+    });
+
+    // Descriptor set updates: vkUpdateDescriptorSets with vk::WriteDescriptorSet structs vs. single
+    // vkUpdateDescriptorSetWithTemplate call.
+    {
+        const vku::AllocatedBuffer buffer { gpu.allocator, vk::BufferCreateInfo {
+            {},
+            256,
+            vk::BufferUsageFlagBits::eUniformBuffer | vk::BufferUsageFlagBits::eStorageBuffer,
+        } };
+
+        constexpr std::uint32_t setCount = 1024;
+        vku::DescriptorAllocator descriptorAllocator { gpu.device, layout.getPoolSize() * setCount };
+        std::vector<vku::DescriptorSet<Layout>> descriptorSets;
+        descriptorSets.reserve(setCount);
+        for (std::uint32_t i = 0; i < setCount; ++i) {
+            descriptorSets.push_back(get<0>(descriptorAllocator.allocate(std::tie(layout))));
+        }
+
+        harness.run("vkUpdateDescriptorSets", 64, setCount, [&] {
+            for (const auto &descriptorSet : descriptorSets) {
+                gpu.device.updateDescriptorSets({
+                    descriptorSet.getWriteOne<0>({ buffer, 0, 64 }),
+                    descriptorSet.getWriteOne<1>({ buffer, 64, 64 }),
+                    descriptorSet.getWriteOne<2>({ buffer, 128, 64 }),
+                    descriptorSet.getWriteOne<3>({ buffer, 192, 64 }),
+                }, {});
+            }
+        });
+
+        const vku::DescriptorUpdateTemplate updateTemplate { gpu.device, layout };
+        harness.run("vkUpdateDescriptorSetWithTemplate", 64, setCount, [&] {
+            for (const auto &descriptorSet : descriptorSets) {
+                descriptorSet.update(*gpu.device, updateTemplate, {
+                    vk::DescriptorBufferInfo { buffer, 0, 64 },
+                    vk::DescriptorBufferInfo { buffer, 64, 64 },
+                    vk::DescriptorBufferInfo { buffer, 128, 64 },
+                    vk::DescriptorBufferInfo { buffer, 192, 64 },
+                });
+            }
+        });
+    }
+
+    {
+        vku::AttachmentGroup attachmentGroup { vk::Extent2D { 64, 64 } };
+        const vku::AllocatedImage colorImage = attachmentGroup.createColorImage(gpu.allocator, vk::Format::eR8G8B8A8Unorm);
+        attachmentGroup.addColorAttachment(gpu.device, colorImage);
+        const vku::AllocatedImage depthImage = attachmentGroup.createDepthStencilImage(gpu.allocator, vk::Format::eD32Sfloat);
+        attachmentGroup.setDepthStencilAttachment(gpu.device, depthImage);
+
+        harness.run("getRenderingInfo", 4096, 1, [&] {
+            std::ignore = attachmentGroup.getRenderingInfo(
+                vku::AttachmentGroup::ColorAttachmentInfo { vk::AttachmentLoadOp::eClear, vk::AttachmentStoreOp::eStore },
+                { vk::AttachmentLoadOp::eClear, vk::AttachmentStoreOp::eDontCare, { 1.f, 0U } });
+        });
+
+        attachmentGroup.updateRenderingInfoCache(
+            vku::AttachmentGroup::ColorAttachmentInfo { vk::AttachmentLoadOp::eClear, vk::AttachmentStoreOp::eStore },
+            { vk::AttachmentLoadOp::eClear, vk::AttachmentStoreOp::eDontCare, { 1.f, 0U } });
+        harness.run("getCachedRenderingInfo", 4096, 1, [&] {
+            std::ignore = attachmentGroup.getCachedRenderingInfo();
+        });
+    }
+
+    harness.run("createPipelineStages", 1024, 1, [&] {
+        std::ignore = vku::createPipelineStages(gpu.device, vku::Shader { emptyComputeSpirv, vk::ShaderStageFlagBits::eCompute });
+    });
+
+    if (outputPath) {
+        std::ofstream file { *outputPath };
+        harness.writeJson(file);
+    }
+    else {
+        harness.writeJson(std::cout);
+    }
+}
@@ -13,6 +13,7 @@ import std;
 export import vk_mem_alloc_hpp;
 export import vulkan_hpp;
 import :details.concepts;
+export import :pipelines.PipelineCache;
 import :utils;
 
 // #define VMA_HPP_NAMESPACE to vma, if not defined.
@@ -23,6 +24,49 @@ import :utils;
 #define CHECK_FEATURE(feature) if (pPhysicalDeviceFeatures->feature && !availableFeatures.feature) { unavailableFeatures.push_back(#feature); }
 
 namespace vku {
+    /**
+     * Get the names of the features that are requested in \p devicePNexts but not supported by \p physicalDevice.
+     *
+     * Only the structures that can be chained to <tt>vk::PhysicalDeviceFeatures2</tt> (and itself) are checked. Since
+     * feature structures consist of the structure header followed by <tt>vk::Bool32</tt> members only, each member is
+     * compared in order, and reported as <tt>StructureType[memberIndex]</tt>.
+     */
+    template <typename... DevicePNexts>
+    [[nodiscard]] auto getUnavailableDeviceFeatures(
+        VULKAN_HPP_NAMESPACE::PhysicalDevice physicalDevice,
+        const std::tuple<DevicePNexts...> &devicePNexts
+    ) -> std::vector<std::string> {
+        std::vector<std::string> result;
+        const auto check = [&]<typename T>(const T &requested) {
+            if constexpr (std::same_as<T, VULKAN_HPP_NAMESPACE::PhysicalDeviceFeatures2> || VULKAN_HPP_NAMESPACE::StructExtends<T, VULKAN_HPP_NAMESPACE::PhysicalDeviceFeatures2>::value) {
+                T available;
+                if constexpr (std::same_as<T, VULKAN_HPP_NAMESPACE::PhysicalDeviceFeatures2>) {
+                    available = physicalDevice.getFeatures2();
+                }
+                else {
+                    available = physicalDevice.template getFeatures2<VULKAN_HPP_NAMESPACE::PhysicalDeviceFeatures2, T>().template get<T>();
+                }
+
+                constexpr std::size_t headerSize = sizeof(VULKAN_HPP_NAMESPACE::BaseOutStructure);
+                static_assert((sizeof(T) - headerSize) % sizeof(VULKAN_HPP_NAMESPACE::Bool32) == 0);
+                constexpr std::size_t memberCount = (sizeof(T) - headerSize) / sizeof(VULKAN_HPP_NAMESPACE::Bool32);
+
+                std::array<VULKAN_HPP_NAMESPACE::Bool32, memberCount> requestedMembers, availableMembers;
+                std::memcpy(requestedMembers.data(), reinterpret_cast<const std::byte*>(&requested) + headerSize, sizeof(requestedMembers));
+                std::memcpy(availableMembers.data(), reinterpret_cast<const std::byte*>(&available) + headerSize, sizeof(availableMembers));
+
+                for (std::size_t i = 0; i < memberCount; ++i) {
+                    // Compare with VK_TRUE exactly, as the trailing padding of the structure may not be zeroed.
+                    if (requestedMembers[i] == VULKAN_HPP_NAMESPACE::True && availableMembers[i] != VULKAN_HPP_NAMESPACE::True) {
+                        result.push_back(std::format("{}[{}]", to_string(T::structureType), i));
+                    }
+                }
+            }
+        };
+        std::apply([&](const auto &...pNexts) { (check(pNexts), ...); }, devicePNexts);
+        return result;
+    }
+
     /**
      * @brief Bootstrapper for Vulkan RAII physical device, device, allocator creation.
      * @tparam QueueFamilies A struct type that would contain the queue family indices of the selected physical device.
@@ -44,6 +88,13 @@ namespace vku {
             std::span<const char* const> deviceExtensions;
             const VULKAN_HPP_NAMESPACE::PhysicalDeviceFeatures *pPhysicalDeviceFeatures = nullptr;
 
+            /**
+             * @brief Function that returns the names of the requested but unavailable features in the
+             * <tt>vk::PhysicalDeviceFeatures2</tt> structure chain. If empty, <tt>vku::Gpu</tt> checks
+             * <tt>Config::devicePNexts</tt> with <tt>getUnavailableDeviceFeatures</tt> when selecting the physical device.
+             */
+            std::function<std::vector<std::string>(VULKAN_HPP_NAMESPACE::PhysicalDevice)> featureChainChecker = {};
+
             [[nodiscard]] auto operator()(VULKAN_HPP_NAMESPACE::PhysicalDevice physicalDevice) const -> std::uint32_t {
                 const VULKAN_HPP_NAMESPACE::PhysicalDeviceProperties properties = physicalDevice.getProperties();
                 const std::string_view deviceName { properties.deviceName.data() };
@@ -54,7 +105,7 @@ namespace vku {
                 }
                 catch (const std::runtime_error &e) {
                     if (verbose) {
-                        std::cerr << "Physical device \"" << deviceName << "\" rejected because it failed to get the request queue families: " << e.what() << '\n';
+                        std::cerr << std::format("Physical device \"{}\" rejected because it failed to get the request queue families: {}\n", deviceName, e.what());
                     }
                     return 0;
                 }
@@ -80,15 +131,7 @@ namespace vku {
                     if (verbose) {
                         std::vector<std::string_view> unavailableExtensions;
                         std::ranges::set_difference(deviceExtensionNames, availableExtensionNames, std::back_inserter(unavailableExtensions));
-                        std::cerr << "Physical device \"" << deviceName << "\" rejected because it lacks the following device extensions: [";
-                        for (std::size_t i = 0; i < unavailableExtensions.size(); ++i) {
-                            if (i == unavailableExtensions.size() - 1) {
-                                std::cerr << unavailableExtensions[i] << "]\n";
-                            }
-                            else {
-                                std::cerr << unavailableExtensions[i] << ", ";
-                            }
-                        }
+                        std::cerr << std::format("Physical device \"{}\" rejected because it lacks the following device extensions: {::s}\n", deviceName, unavailableExtensions);
                     }
                     return 0;
                 }
@@ -156,15 +199,17 @@ namespace vku {
 
                     if (!unavailableFeatures.empty()) {
                         if (verbose) {
-                            std::cerr << "Physical device \"" << deviceName << "\" rejected because it lacks the following physical device features: [";
-                            for (std::size_t i = 0; i < unavailableFeatures.size(); ++i) {
-                                if (i == unavailableFeatures.size() - 1) {
-                                    std::cerr << unavailableFeatures[i] << "]\n";
-                                }
-                                else {
-                                    std::cerr << unavailableFeatures[i] << ", ";
-                                }
-                            }
+                            std::cerr << std::format("Physical device \"{}\" rejected because it lacks the following physical device features: {::s}\n", deviceName, unavailableFeatures);
+                        }
+                        return 0;
+                    }
+                }
+
+                // Check the feature structure chain availability.
+                if (featureChainChecker) {
+                    if (const std::vector unavailableFeatures = featureChainChecker(physicalDevice); !unavailableFeatures.empty()) {
+                        if (verbose) {
+                            std::cerr << std::format("Physical device \"{}\" rejected because it lacks the following features in the structure chain: {::s}\n", deviceName, unavailableFeatures);
                         }
                         return 0;
                     }
@@ -178,7 +223,7 @@ namespace vku {
                 score += properties.limits.maxImageDimension2D;
 
                 if (verbose) {
-                    std::cerr << "Physical device \"" << deviceName << "\" accepted (score=" << score << ").\n";
+                    std::cerr << std::format("Physical device \"{}\" accepted (score={}).\n", deviceName, score);
                 }
                 return score;
             }
@@ -194,10 +239,29 @@ namespace vku {
             std::conditional_t<hasPhysicalDeviceFeatures, VULKAN_HPP_NAMESPACE::PhysicalDeviceFeatures, std::monostate> physicalDeviceFeatures = {};
             std::function<QueueFamilies(VULKAN_HPP_NAMESPACE::PhysicalDevice)> queueFamilyGetter = &getQueueFamilies;
             std::function<std::uint32_t(VULKAN_HPP_NAMESPACE::PhysicalDevice)> physicalDeviceRater
-                = DefaultPhysicalDeviceRater { verbose, queueFamilyGetter, deviceExtensions, hasPhysicalDeviceFeatures ? &physicalDeviceFeatures : nullptr };
+                = DefaultPhysicalDeviceRater {
+                    verbose,
+                    queueFamilyGetter,
+                    deviceExtensions,
+                    [&]() -> const VULKAN_HPP_NAMESPACE::PhysicalDeviceFeatures* {
+                        if constexpr (hasPhysicalDeviceFeatures) {
+                            return &physicalDeviceFeatures;
+                        }
+                        else {
+                            return nullptr;
+                        }
+                    }(),
+                };
+
+            /**
+             * @brief Rate the physical devices concurrently. Enable it only if \p physicalDeviceRater (and
+             * \p queueFamilyGetter used by the default rater) is thread-safe.
+             */
+            bool parallelPhysicalDeviceRating = false;
             std::tuple<DevicePNexts...> devicePNexts = {};
             VMA_HPP_NAMESPACE::AllocatorCreateFlags allocatorCreateFlags = {};
             std::uint32_t apiVersion = VULKAN_HPP_NAMESPACE::makeApiVersion(0, 1, 0, 0);
+            std::filesystem::path pipelineCachePath = {};
         };
 
         /**
@@ -225,6 +289,15 @@ namespace vku {
          */
         VMA_HPP_NAMESPACE::Allocator allocator;
 
+        /**
+         * @brief Pipeline cache, loaded from <tt>Config::pipelineCachePath</tt> if set. It is saved back to the file
+         * when this object is destroyed.
+         *
+         * Pass it to the pipeline constructors to reuse the pipelines compiled in the previous runs, e.g.
+         * <tt>vk::raii::Pipeline { gpu.device, gpu.pipelineCache, createInfo }</tt>.
+         */
+        PipelineCache pipelineCache;
+
         /**
          * @brief Create Vulkan physical device, device, allocator and retrieve queues from the device at once.
          * @param instance Vulkan RAII instance that the physical device will be created from.
@@ -234,28 +307,120 @@ namespace vku {
         explicit Gpu(
             const VULKAN_HPP_NAMESPACE::VULKAN_HPP_RAII_NAMESPACE::Instance &instance [[clang::lifetimebound]],
             const Config<DevicePNexts...> &config = {}
-        ) : physicalDevice { selectPhysicalDevice(instance, config) },
-            queueFamilies { config.queueFamilyGetter(physicalDevice) },
-            device { createDevice(config) },
-            queues { *device, queueFamilies },
-            allocator { createAllocator(instance, config) } { }
+        ) : Gpu { instance, config, StartupTimer{} } { }
 
         ~Gpu() {
+            try {
+                pipelineCache.save();
+            }
+            catch (const std::exception &e) {
+                // Failing to save the pipeline cache is not fatal.
+                std::cerr << "Failed to save the pipeline cache: " << e.what() << '\n';
+            }
             allocator.destroy();
         }
 
     private:
+        /**
+         * Measures the elapsed time of each startup stage, to be reported in verbose mode.
+         */
+        struct StartupTimer {
+            std::vector<std::pair<const char*, std::chrono::steady_clock::duration>> stages;
+
+            template <std::invocable F>
+            auto measure(const char *stageName, F &&f) -> std::invoke_result_t<F> {
+                const auto start = std::chrono::steady_clock::now();
+                // Record the elapsed time on scope exit, so that the result can be returned as prvalue (which makes
+                // non-movable members be initializable).
+                struct Recorder {
+                    StartupTimer &timer;
+                    const char *stageName;
+                    std::chrono::steady_clock::time_point start;
+
+                    ~Recorder() {
+                        timer.stages.emplace_back(stageName, std::chrono::steady_clock::now() - start);
+                    }
+                } recorder { *this, stageName, start };
+                return std::invoke(std::forward<F>(f));
+            }
+
+            void report() const {
+                std::string message = "Gpu startup timing breakdown:\n";
+                std::chrono::steady_clock::duration total {};
+                for (const auto &[stageName, duration] : stages) {
+                    message += std::format("  {:<24}{:>10.3f} ms\n", stageName, std::chrono::duration<double, std::milli> { duration }.count());
+                    total += duration;
+                }
+                message += std::format("  {:<24}{:>10.3f} ms\n", "total", std::chrono::duration<double, std::milli> { total }.count());
+                std::cerr << message;
+            }
+        };
+
+        template <typename... DevicePNexts>
+        Gpu(
+            const VULKAN_HPP_NAMESPACE::VULKAN_HPP_RAII_NAMESPACE::Instance &instance [[clang::lifetimebound]],
+            const Config<DevicePNexts...> &config,
+            StartupTimer &&timer
+        ) : physicalDevice { timer.measure("physical device selection", [&] { return selectPhysicalDevice(instance, config); }) },
+            queueFamilies { timer.measure("queue family retrieval", [&] { return config.queueFamilyGetter(physicalDevice); }) },
+            device { timer.measure("device creation", [&] { return createDevice(config); }) },
+            queues { timer.measure("queue retrieval", [&] { return Queues { *device, queueFamilies }; }) },
+            allocator { timer.measure("allocator creation", [&] { return createAllocator(instance, config); }) },
+            pipelineCache { timer.measure("pipeline cache loading", [&] { return PipelineCache { device, physicalDevice.getProperties(), config.pipelineCachePath }; }) } {
+            if (config.verbose) {
+                timer.report();
+            }
+        }
+
         template <typename... DevicePNexts>
         [[nodiscard]] static auto selectPhysicalDevice(
             const VULKAN_HPP_NAMESPACE::VULKAN_HPP_RAII_NAMESPACE::Instance &instance,
             const Config<DevicePNexts...> &config
         ) -> VULKAN_HPP_NAMESPACE::VULKAN_HPP_RAII_NAMESPACE::PhysicalDevice {
             std::vector physicalDevices = instance.enumeratePhysicalDevices();
-            VULKAN_HPP_NAMESPACE::VULKAN_HPP_RAII_NAMESPACE::PhysicalDevice bestPhysicalDevice = *std::ranges::max_element(physicalDevices, {}, config.physicalDeviceRater);
-            if (config.physicalDeviceRater(*bestPhysicalDevice) == 0) {
+
+            // Let the default rater check the requested feature structure chain. It is wired here rather than in the
+            // Config's default member initializer, so that it holds its own copy of devicePNexts instead of a pointer
+            // to the Config.
+            std::function physicalDeviceRater = config.physicalDeviceRater;
+            if (const DefaultPhysicalDeviceRater *defaultRater = physicalDeviceRater.template target<DefaultPhysicalDeviceRater>();
+                defaultRater && !defaultRater->featureChainChecker) {
+                DefaultPhysicalDeviceRater rater = *defaultRater;
+                rater.featureChainChecker = [devicePNexts = config.devicePNexts](VULKAN_HPP_NAMESPACE::PhysicalDevice physicalDevice) {
+                    return getUnavailableDeviceFeatures(physicalDevice, devicePNexts);
+                };
+                physicalDeviceRater = std::move(rater);
+            }
+
+            // Rate each physical device exactly once. As rating issues several driver queries per device (extensions,
+            // queue families, features), they are run concurrently if allowed.
+            std::vector<std::uint32_t> scores;
+            if (config.parallelPhysicalDeviceRating && physicalDevices.size() > 1) {
+                std::vector<std::future<std::uint32_t>> futures;
+                futures.reserve(physicalDevices.size());
+                for (const VULKAN_HPP_NAMESPACE::VULKAN_HPP_RAII_NAMESPACE::PhysicalDevice &physicalDevice : physicalDevices) {
+                    futures.push_back(std::async(std::launch::async, [&physicalDeviceRater, physicalDevice = *physicalDevice] {
+                        return physicalDeviceRater(physicalDevice);
+                    }));
+                }
+
+                scores = futures
+                    | std::views::transform([](std::future<std::uint32_t> &future) { return future.get(); })
+                    | std::ranges::to<std::vector>();
+            }
+            else {
+                scores = physicalDevices
+                    | std::views::transform([&](const VULKAN_HPP_NAMESPACE::VULKAN_HPP_RAII_NAMESPACE::PhysicalDevice &physicalDevice) {
+                        return physicalDeviceRater(*physicalDevice);
+                    })
+                    | std::ranges::to<std::vector>();
+            }
+
+            const auto bestScoreIt = std::ranges::max_element(scores);
+            if (bestScoreIt == scores.end() || *bestScoreIt == 0) {
                 throw std::runtime_error { "No suitable GPU for the application." };
             }
-            return bestPhysicalDevice;
+            return std::move(physicalDevices[std::ranges::distance(scores.begin(), bestScoreIt)]);
         }
 
         template <typename... PNexts>
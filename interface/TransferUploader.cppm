@@ -0,0 +1,380 @@
+/** @file TransferUploader.cppm
+ */
+
+module;
+
+#include <vulkan/vulkan_hpp_macros.hpp>
+
+export module vku:TransferUploader;
+
+import std;
+export import vk_mem_alloc_hpp;
+export import vulkan_hpp;
+export import :buffers.Buffer;
+import :buffers.MappedBuffer;
+export import :images.Image;
+import :utils;
+
+// #define VMA_HPP_NAMESPACE to vma, if not defined.
+#ifndef VMA_HPP_NAMESPACE
+#define VMA_HPP_NAMESPACE vma
+#endif
+
+namespace vku {
+    /**
+     * @brief Asynchronous uploader that copies the host data into the device resources in the transfer queue.
+     *
+     * Each upload copies the data into its own staging buffer, and records the copy command into the pending command
+     * buffer, which is submitted by <tt>submit()</tt> with signaling the timeline semaphore. If the destination queue
+     * family differs from the transfer queue family (for <tt>vk::SharingMode::eExclusive</tt> resources), the queue
+     * family ownership release barrier is recorded after the copy, and the matching acquire barrier is returned. The
+     * consumer has to wait the semaphore for the value and record the acquire barrier in its queue before using the
+     * resource. Staging buffers are retained until <tt>collect()</tt> observes the completion of the submission.
+     *
+     * @code{.cpp}
+     * vku::TransferUploader uploader { gpu.device, gpu.allocator, gpu.queues.transfer, gpu.queueFamilies.transfer };
+     * const vku::TransferUploader::Upload upload = uploader.uploadBuffer(
+     *     vertexBuffer, std::as_bytes(std::span { vertices }), 0,
+     *     gpu.queueFamilies.graphics, vk::PipelineStageFlagBits2::eVertexAttributeInput, vk::AccessFlagBits2::eVertexAttributeRead);
+     * uploader.submit();
+     *
+     * // In the graphics queue.
+     * graphicsCommandBuffer.pipelineBarrier2({ {}, {}, *upload.bufferAcquireBarrier, {} });
+     * graphicsQueue.submit2(vk::SubmitInfo2 {
+     *     {},
+     *     vku::unsafeProxy(vk::SemaphoreSubmitInfo { uploader.getTimelineSemaphore(), upload.timelineValue, vk::PipelineStageFlagBits2::eVertexAttributeInput }),
+     *     ...
+     * });
+     *
+     * // Periodically.
+     * uploader.collect();
+     * @endcode
+     *
+     * @note Member functions are thread-safe.
+     */
+    export class TransferUploader {
+    public:
+        struct Upload {
+            /**
+             * @brief Timeline semaphore value that will be signaled when the copy is completed.
+             */
+            std::uint64_t timelineValue;
+
+            /**
+             * @brief Queue family ownership acquire barrier, if the destination queue family differs from the transfer
+             * queue family. Only the one matching the uploaded resource type is set.
+             */
+            std::optional<VULKAN_HPP_NAMESPACE::BufferMemoryBarrier2> bufferAcquireBarrier;
+            std::optional<VULKAN_HPP_NAMESPACE::ImageMemoryBarrier2> imageAcquireBarrier;
+        };
+
+        /**
+         * @brief Create the uploader.
+         * @param device Vulkan device.
+         * @param allocator VMA allocator used to allocate staging buffers.
+         * @param transferQueue Queue to submit the copy commands, preferably from
+         * <tt>getTransferSpecializedQueueFamily</tt>. It must be externally synchronized with the other submissions.
+         * @param transferQueueFamilyIndex Queue family index of \p transferQueue.
+         */
+        TransferUploader(
+            const VULKAN_HPP_NAMESPACE::VULKAN_HPP_RAII_NAMESPACE::Device &device [[clang::lifetimebound]],
+            VMA_HPP_NAMESPACE::Allocator allocator,
+            VULKAN_HPP_NAMESPACE::Queue transferQueue,
+            std::uint32_t transferQueueFamilyIndex
+        );
+
+        TransferUploader(const TransferUploader&) = delete;
+        auto operator=(const TransferUploader&) -> TransferUploader& = delete;
+
+        /**
+         * @brief Wait for the submitted copies to be completed, to safely destroy the staging buffers.
+         */
+        ~TransferUploader();
+
+        /**
+         * @brief Timeline semaphore that is signaled by the submissions.
+         */
+        [[nodiscard]] auto getTimelineSemaphore() const noexcept -> VULKAN_HPP_NAMESPACE::Semaphore;
+
+        /**
+         * @brief Record the copy of \p data into \p dst at \p dstOffset.
+         * @param dst Destination buffer. Must have <tt>vk::BufferUsageFlagBits::eTransferDst</tt> usage.
+         * @param data Data to be copied.
+         * @param dstOffset Destination offset in bytes.
+         * @param dstQueueFamilyIndex Queue family index that will use the buffer. Pass
+         * <tt>vk::QueueFamilyIgnored</tt> for <tt>vk::SharingMode::eConcurrent</tt> buffer.
+         * @param dstStageMask Pipeline stages that will use the buffer, for the acquire barrier.
+         * @param dstAccessMask Access types of the buffer usage, for the acquire barrier.
+         * @return Upload info.
+         */
+        [[nodiscard]] auto uploadBuffer(
+            const Buffer &dst,
+            std::span<const std::byte> data,
+            VULKAN_HPP_NAMESPACE::DeviceSize dstOffset,
+            std::uint32_t dstQueueFamilyIndex,
+            VULKAN_HPP_NAMESPACE::PipelineStageFlags2 dstStageMask,
+            VULKAN_HPP_NAMESPACE::AccessFlags2 dstAccessMask
+        ) -> Upload;
+
+        /**
+         * @brief Record the copy of \p data into the first mip level of every array layers of \p dst.
+         *
+         * \p dst must be in <tt>vk::ImageLayout::eUndefined</tt> layout (its contents are discarded), and will be
+         * transitioned to \p finalLayout.
+         *
+         * @param dst Destination image. Must have <tt>vk::ImageUsageFlagBits::eTransferDst</tt> usage.
+         * @param data Tightly packed texel data of the array layers.
+         * @param finalLayout Image layout after the upload.
+         * @param dstQueueFamilyIndex Queue family index that will use the image. Pass
+         * <tt>vk::QueueFamilyIgnored</tt> for <tt>vk::SharingMode::eConcurrent</tt> image.
+         * @param dstStageMask Pipeline stages that will use the image, for the acquire barrier.
+         * @param dstAccessMask Access types of the image usage, for the acquire barrier.
+         * @return Upload info.
+         */
+        [[nodiscard]] auto uploadImage(
+            const Image &dst,
+            std::span<const std::byte> data,
+            VULKAN_HPP_NAMESPACE::ImageLayout finalLayout,
+            std::uint32_t dstQueueFamilyIndex,
+            VULKAN_HPP_NAMESPACE::PipelineStageFlags2 dstStageMask,
+            VULKAN_HPP_NAMESPACE::AccessFlags2 dstAccessMask
+        ) -> Upload;
+
+        /**
+         * @brief Submit the recorded copies to the transfer queue.
+         * @return Timeline semaphore value that will be signaled when the copies are completed. If nothing is
+         * recorded, the last submitted value is returned.
+         */
+        auto submit() -> std::uint64_t;
+
+        /**
+         * @brief Destroy the staging buffers and command buffers of the completed submissions.
+         * @return Timeline semaphore value that is completed.
+         */
+        auto collect() -> std::uint64_t;
+
+    private:
+        struct InFlightSubmission {
+            std::uint64_t timelineValue;
+            VULKAN_HPP_NAMESPACE::VULKAN_HPP_RAII_NAMESPACE::CommandBuffer commandBuffer;
+            std::vector<MappedBuffer> stagingBuffers;
+        };
+
+        std::reference_wrapper<const VULKAN_HPP_NAMESPACE::VULKAN_HPP_RAII_NAMESPACE::Device> device;
+        VMA_HPP_NAMESPACE::Allocator allocator;
+        VULKAN_HPP_NAMESPACE::Queue transferQueue;
+        std::uint32_t transferQueueFamilyIndex;
+
+        VULKAN_HPP_NAMESPACE::VULKAN_HPP_RAII_NAMESPACE::Semaphore timelineSemaphore;
+        VULKAN_HPP_NAMESPACE::VULKAN_HPP_RAII_NAMESPACE::CommandPool commandPool;
+
+        std::mutex mutex;
+        std::uint64_t lastSubmittedValue = 0;
+        std::optional<VULKAN_HPP_NAMESPACE::VULKAN_HPP_RAII_NAMESPACE::CommandBuffer> recordingCommandBuffer;
+        std::vector<MappedBuffer> recordingStagingBuffers;
+        std::deque<InFlightSubmission> inFlightSubmissions;
+
+        [[nodiscard]] auto requiresOwnershipTransfer(std::uint32_t dstQueueFamilyIndex) const noexcept -> bool;
+
+        /**
+         * @brief Get the recording command buffer (begin it if not), and create the staging buffer of \p data.
+         * @note \p mutex must be locked.
+         */
+        [[nodiscard]] auto prepareCopy(std::span<const std::byte> data) -> std::pair<VULKAN_HPP_NAMESPACE::CommandBuffer, const MappedBuffer&>;
+    };
+}
+
+// --------------------
+// Implementations.
+// --------------------
+
+vku::TransferUploader::TransferUploader(
+    const VULKAN_HPP_NAMESPACE::VULKAN_HPP_RAII_NAMESPACE::Device &device,
+    VMA_HPP_NAMESPACE::Allocator allocator,
+    VULKAN_HPP_NAMESPACE::Queue transferQueue,
+    std::uint32_t transferQueueFamilyIndex
+) : device { device },
+    allocator { allocator },
+    transferQueue { transferQueue },
+    transferQueueFamilyIndex { transferQueueFamilyIndex },
+    timelineSemaphore { device, VULKAN_HPP_NAMESPACE::StructureChain {
+        VULKAN_HPP_NAMESPACE::SemaphoreCreateInfo{},
+        VULKAN_HPP_NAMESPACE::SemaphoreTypeCreateInfo { VULKAN_HPP_NAMESPACE::SemaphoreType::eTimeline, 0 },
+    }.get() },
+    commandPool { device, VULKAN_HPP_NAMESPACE::CommandPoolCreateInfo {
+        VULKAN_HPP_NAMESPACE::CommandPoolCreateFlagBits::eTransient,
+        transferQueueFamilyIndex,
+    } } { }
+
+vku::TransferUploader::~TransferUploader() {
+    if (lastSubmittedValue != 0) {
+        const VULKAN_HPP_NAMESPACE::Semaphore semaphore = *timelineSemaphore;
+        try {
+            std::ignore = device.get().waitSemaphores({ {}, semaphore, lastSubmittedValue }, ~0ULL);
+        }
+        catch (const std::exception &e) {
+            std::cerr << "Failed to wait for the transfer uploads: " << e.what() << '\n';
+        }
+    }
+}
+
+auto vku::TransferUploader::getTimelineSemaphore() const noexcept -> VULKAN_HPP_NAMESPACE::Semaphore {
+    return *timelineSemaphore;
+}
+
+auto vku::TransferUploader::uploadBuffer(
+    const Buffer &dst,
+    std::span<const std::byte> data,
+    VULKAN_HPP_NAMESPACE::DeviceSize dstOffset,
+    std::uint32_t dstQueueFamilyIndex,
+    VULKAN_HPP_NAMESPACE::PipelineStageFlags2 dstStageMask,
+    VULKAN_HPP_NAMESPACE::AccessFlags2 dstAccessMask
+) -> Upload {
+    std::scoped_lock lock { mutex };
+    const auto [commandBuffer, stagingBuffer] = prepareCopy(data);
+    commandBuffer.copyBuffer(stagingBuffer, dst, VULKAN_HPP_NAMESPACE::BufferCopy { 0, dstOffset, data.size() });
+
+    Upload result { lastSubmittedValue + 1 };
+    if (requiresOwnershipTransfer(dstQueueFamilyIndex)) {
+        // Release barrier: destination stage/access are ignored, and the matching acquire barrier ignores the source
+        // stage/access. The semaphore signal operation provides the execution dependency between them.
+        commandBuffer.pipelineBarrier2({
+            {}, {},
+            unsafeProxy(VULKAN_HPP_NAMESPACE::BufferMemoryBarrier2 {
+                VULKAN_HPP_NAMESPACE::PipelineStageFlagBits2::eCopy, VULKAN_HPP_NAMESPACE::AccessFlagBits2::eTransferWrite,
+                {}, {},
+                transferQueueFamilyIndex, dstQueueFamilyIndex,
+                dst, dstOffset, data.size(),
+            }),
+            {},
+        });
+        result.bufferAcquireBarrier.emplace(
+            VULKAN_HPP_NAMESPACE::PipelineStageFlagBits2::eNone, VULKAN_HPP_NAMESPACE::AccessFlagBits2::eNone,
+            dstStageMask, dstAccessMask,
+            transferQueueFamilyIndex, dstQueueFamilyIndex,
+            dst, dstOffset, data.size());
+    }
+    return result;
+}
+
+auto vku::TransferUploader::uploadImage(
+    const Image &dst,
+    std::span<const std::byte> data,
+    VULKAN_HPP_NAMESPACE::ImageLayout finalLayout,
+    std::uint32_t dstQueueFamilyIndex,
+    VULKAN_HPP_NAMESPACE::PipelineStageFlags2 dstStageMask,
+    VULKAN_HPP_NAMESPACE::AccessFlags2 dstAccessMask
+) -> Upload {
+    std::scoped_lock lock { mutex };
+    const auto [commandBuffer, stagingBuffer] = prepareCopy(data);
+
+    const VULKAN_HPP_NAMESPACE::ImageAspectFlags aspectFlags = Image::inferAspectFlags(dst.format);
+    const VULKAN_HPP_NAMESPACE::ImageSubresourceRange subresourceRange { aspectFlags, 0, 1, 0, dst.arrayLayers };
+
+    commandBuffer.pipelineBarrier2({
+        {}, {}, {},
+        unsafeProxy(VULKAN_HPP_NAMESPACE::ImageMemoryBarrier2 {
+            {}, {},
+            VULKAN_HPP_NAMESPACE::PipelineStageFlagBits2::eCopy, VULKAN_HPP_NAMESPACE::AccessFlagBits2::eTransferWrite,
+            {}, VULKAN_HPP_NAMESPACE::ImageLayout::eTransferDstOptimal,
+            VULKAN_HPP_NAMESPACE::QueueFamilyIgnored, VULKAN_HPP_NAMESPACE::QueueFamilyIgnored,
+            dst, subresourceRange,
+        }),
+    });
+    commandBuffer.copyBufferToImage(
+        stagingBuffer, dst, VULKAN_HPP_NAMESPACE::ImageLayout::eTransferDstOptimal,
+        VULKAN_HPP_NAMESPACE::BufferImageCopy {
+            0, 0, 0,
+            { aspectFlags, 0, 0, dst.arrayLayers },
+            { 0, 0, 0 }, dst.extent,
+        });
+
+    Upload result { lastSubmittedValue + 1 };
+    if (requiresOwnershipTransfer(dstQueueFamilyIndex)) {
+        // Layout transition is performed once by both release and acquire barriers, which must have the same layouts.
+        commandBuffer.pipelineBarrier2({
+            {}, {}, {},
+            unsafeProxy(VULKAN_HPP_NAMESPACE::ImageMemoryBarrier2 {
+                VULKAN_HPP_NAMESPACE::PipelineStageFlagBits2::eCopy, VULKAN_HPP_NAMESPACE::AccessFlagBits2::eTransferWrite,
+                {}, {},
+                VULKAN_HPP_NAMESPACE::ImageLayout::eTransferDstOptimal, finalLayout,
+                transferQueueFamilyIndex, dstQueueFamilyIndex,
+                dst, subresourceRange,
+            }),
+        });
+        result.imageAcquireBarrier.emplace(
+            VULKAN_HPP_NAMESPACE::PipelineStageFlagBits2::eNone, VULKAN_HPP_NAMESPACE::AccessFlagBits2::eNone,
+            dstStageMask, dstAccessMask,
+            VULKAN_HPP_NAMESPACE::ImageLayout::eTransferDstOptimal, finalLayout,
+            transferQueueFamilyIndex, dstQueueFamilyIndex,
+            dst, subresourceRange);
+    }
+    else {
+        // The memory dependency to the consumer is provided by the semaphore signal/wait operations.
+        commandBuffer.pipelineBarrier2({
+            {}, {}, {},
+            unsafeProxy(VULKAN_HPP_NAMESPACE::ImageMemoryBarrier2 {
+                VULKAN_HPP_NAMESPACE::PipelineStageFlagBits2::eCopy, VULKAN_HPP_NAMESPACE::AccessFlagBits2::eTransferWrite,
+                VULKAN_HPP_NAMESPACE::PipelineStageFlagBits2::eAllCommands, {},
+                VULKAN_HPP_NAMESPACE::ImageLayout::eTransferDstOptimal, finalLayout,
+                VULKAN_HPP_NAMESPACE::QueueFamilyIgnored, VULKAN_HPP_NAMESPACE::QueueFamilyIgnored,
+                dst, subresourceRange,
+            }),
+        });
+    }
+    return result;
+}
+
+auto vku::TransferUploader::submit() -> std::uint64_t {
+    std::scoped_lock lock { mutex };
+    if (!recordingCommandBuffer) {
+        return lastSubmittedValue;
+    }
+
+    recordingCommandBuffer->end();
+    transferQueue.submit2(VULKAN_HPP_NAMESPACE::SubmitInfo2 {
+        {},
+        {},
+        unsafeProxy(VULKAN_HPP_NAMESPACE::CommandBufferSubmitInfo { *recordingCommandBuffer }),
+        unsafeProxy(VULKAN_HPP_NAMESPACE::SemaphoreSubmitInfo { *timelineSemaphore, lastSubmittedValue + 1, VULKAN_HPP_NAMESPACE::PipelineStageFlagBits2::eAllCommands }),
+    });
+
+    ++lastSubmittedValue;
+    inFlightSubmissions.emplace_back(lastSubmittedValue, std::move(*recordingCommandBuffer), std::move(recordingStagingBuffers));
+    recordingCommandBuffer.reset();
+    recordingStagingBuffers.clear();
+    return lastSubmittedValue;
+}
+
+auto vku::TransferUploader::collect() -> std::uint64_t {
+    const std::uint64_t completedValue = timelineSemaphore.getCounterValue();
+
+    std::scoped_lock lock { mutex };
+    while (!inFlightSubmissions.empty() && inFlightSubmissions.front().timelineValue <= completedValue) {
+        inFlightSubmissions.pop_front();
+    }
+    return completedValue;
+}
+
+auto vku::TransferUploader::requiresOwnershipTransfer(
+    std::uint32_t dstQueueFamilyIndex
+) const noexcept -> bool {
+    return dstQueueFamilyIndex != VULKAN_HPP_NAMESPACE::QueueFamilyIgnored && dstQueueFamilyIndex != transferQueueFamilyIndex;
+}
+
+auto vku::TransferUploader::prepareCopy(
+    std::span<const std::byte> data
+) -> std::pair<VULKAN_HPP_NAMESPACE::CommandBuffer, const MappedBuffer&> {
+    if (!recordingCommandBuffer) {
+        recordingCommandBuffer.emplace(std::move(device.get().allocateCommandBuffers(VULKAN_HPP_NAMESPACE::CommandBufferAllocateInfo {
+            *commandPool,
+            VULKAN_HPP_NAMESPACE::CommandBufferLevel::ePrimary,
+            1,
+        }).front()));
+        recordingCommandBuffer->begin({ VULKAN_HPP_NAMESPACE::CommandBufferUsageFlagBits::eOneTimeSubmit });
+    }
+
+    const MappedBuffer &stagingBuffer = recordingStagingBuffers.emplace_back(
+        allocator, std::from_range, data, VULKAN_HPP_NAMESPACE::BufferUsageFlagBits::eTransferSrc);
+    return { **recordingCommandBuffer, stagingBuffer };
+}
@@ -0,0 +1,240 @@
+/** @file caches/ImageViewCache.cppm
+ */
+
+module;
+
+#include <vulkan/vulkan_hpp_macros.hpp>
+
+export module vku:caches.ImageViewCache;
+
+import std;
+export import vulkan_hpp;
+import :details.hash;
+
+namespace vku {
+    /**
+     * @brief Shared ownership of <tt>vk::raii::ImageView</tt>.
+     *
+     * It can be either obtained from <tt>vku::ImageViewCache</tt> (the view is shared with the other users that requested
+     * the same <tt>vk::ImageViewCreateInfo</tt>) or constructed from a standalone <tt>vk::raii::ImageView</tt>. Dereferencing
+     * it gives the <tt>vk::ImageView</tt> handle, same as <tt>vk::raii::ImageView</tt>.
+     */
+    export class SharedImageView {
+    public:
+        SharedImageView() noexcept = default;
+
+        /**
+         * @brief Take the ownership of the standalone \p view.
+         * @param view Image view to be owned.
+         */
+        SharedImageView(VULKAN_HPP_NAMESPACE::VULKAN_HPP_RAII_NAMESPACE::ImageView &&view);
+
+        explicit SharedImageView(std::shared_ptr<const VULKAN_HPP_NAMESPACE::VULKAN_HPP_RAII_NAMESPACE::ImageView> view) noexcept;
+
+        [[nodiscard]] VULKAN_HPP_NAMESPACE::ImageView operator*() const noexcept {
+            return view ? **view : VULKAN_HPP_NAMESPACE::ImageView{};
+        }
+
+        [[nodiscard]] auto operator->() const noexcept -> const VULKAN_HPP_NAMESPACE::VULKAN_HPP_RAII_NAMESPACE::ImageView* {
+            return view.get();
+        }
+
+        [[nodiscard]] explicit operator bool() const noexcept {
+            return static_cast<bool>(view);
+        }
+
+    private:
+        std::shared_ptr<const VULKAN_HPP_NAMESPACE::VULKAN_HPP_RAII_NAMESPACE::ImageView> view;
+    };
+
+    /**
+     * @brief Device-level cache of image views, keyed by the hash of <tt>vk::ImageViewCreateInfo</tt>.
+     *
+     * Requesting a view with the same create info (including <tt>vk::ImageViewUsageCreateInfo</tt>,
+     * <tt>vk::SamplerYcbcrConversionInfo</tt> and <tt>vk::ImageViewMinLodCreateInfoEXT</tt> in its pNext chain) returns
+     * the same view instead of creating a new one. If the pNext chain contains any other structure, the view is not cached
+     * and created every time.
+     *
+     * The cache holds a reference of each view until it is evicted. As an image view must be destroyed before its image,
+     * you must call <tt>evict(image)</tt> before destroying the image (e.g. before recreating the swapchain or the
+     * attachment images on window resize), and must not use the returned views after that. Attachment groups using the
+     * cache (<tt>vku::AttachmentGroupBase::imageViewCache</tt>) do this automatically on their destruction.
+     *
+     * All member functions are thread-safe.
+     *
+     * @code{.cpp}
+     * vku::ImageViewCache imageViewCache { gpu.device };
+     * for (const vk::ImageViewCreateInfo &createInfo : image.getMipViewCreateInfos()) {
+     *     mipViews.push_back(imageViewCache.get(createInfo)); // Same views are returned on the next call.
+     * }
+     * @endcode
+     */
+    export class ImageViewCache {
+    public:
+        explicit ImageViewCache(const VULKAN_HPP_NAMESPACE::VULKAN_HPP_RAII_NAMESPACE::Device &device);
+
+        /**
+         * @brief Get the image view with \p createInfo, or create it if not exists.
+         * @param createInfo Image view create info.
+         * @return Shared image view.
+         */
+        [[nodiscard]] auto get(const VULKAN_HPP_NAMESPACE::ImageViewCreateInfo &createInfo) -> SharedImageView;
+
+        /**
+         * @brief Remove all views of \p image from the cache.
+         * @param image Image whose views are removed. It must be called before \p image is destroyed.
+         * @return Number of the removed views.
+         */
+        auto evict(VULKAN_HPP_NAMESPACE::Image image) -> std::size_t;
+
+        /**
+         * @brief Remove all views from the cache.
+         */
+        void clear() noexcept;
+
+        /**
+         * @brief Number of the cached views.
+         */
+        [[nodiscard]] auto size() const noexcept -> std::size_t;
+
+    private:
+        struct Key {
+            VULKAN_HPP_NAMESPACE::ImageViewCreateFlags flags;
+            VULKAN_HPP_NAMESPACE::Image image;
+            VULKAN_HPP_NAMESPACE::ImageViewType viewType;
+            VULKAN_HPP_NAMESPACE::Format format;
+            VULKAN_HPP_NAMESPACE::ComponentMapping components;
+            VULKAN_HPP_NAMESPACE::ImageSubresourceRange subresourceRange;
+            VULKAN_HPP_NAMESPACE::ImageUsageFlags usage;
+            VULKAN_HPP_NAMESPACE::SamplerYcbcrConversion ycbcrConversion;
+            float minLod;
+
+            [[nodiscard]] bool operator==(const Key&) const noexcept = default;
+        };
+
+        struct KeyHash {
+            [[nodiscard]] auto operator()(const Key &key) const noexcept -> std::size_t;
+        };
+
+        std::reference_wrapper<const VULKAN_HPP_NAMESPACE::VULKAN_HPP_RAII_NAMESPACE::Device> device;
+        mutable std::mutex mutex;
+        std::unordered_map<Key, std::shared_ptr<const VULKAN_HPP_NAMESPACE::VULKAN_HPP_RAII_NAMESPACE::ImageView>, KeyHash> views;
+
+        /**
+         * @brief Make the cache key from \p createInfo.
+         * @return Cache key, or <tt>std::nullopt</tt> if pNext chain contains the structure that is not recognized.
+         */
+        [[nodiscard]] static auto getKey(const VULKAN_HPP_NAMESPACE::ImageViewCreateInfo &createInfo) noexcept -> std::optional<Key>;
+    };
+}
+
+// --------------------
+// Implementations.
+// --------------------
+
+vku::SharedImageView::SharedImageView(
+    VULKAN_HPP_NAMESPACE::VULKAN_HPP_RAII_NAMESPACE::ImageView &&view
+) : view { std::make_shared<const VULKAN_HPP_NAMESPACE::VULKAN_HPP_RAII_NAMESPACE::ImageView>(std::move(view)) } { }
+
+vku::SharedImageView::SharedImageView(
+    std::shared_ptr<const VULKAN_HPP_NAMESPACE::VULKAN_HPP_RAII_NAMESPACE::ImageView> view
+) noexcept : view { std::move(view) } { }
+
+vku::ImageViewCache::ImageViewCache(
+    const VULKAN_HPP_NAMESPACE::VULKAN_HPP_RAII_NAMESPACE::Device &device
+) : device { device } { }
+
+auto vku::ImageViewCache::get(
+    const VULKAN_HPP_NAMESPACE::ImageViewCreateInfo &createInfo
+) -> SharedImageView {
+    const std::optional<Key> key = getKey(createInfo);
+    if (!key) {
+        return { VULKAN_HPP_NAMESPACE::VULKAN_HPP_RAII_NAMESPACE::ImageView { device.get(), createInfo } };
+    }
+
+    std::scoped_lock lock { mutex };
+    auto it = views.find(*key);
+    if (it == views.end()) {
+        it = views.emplace(
+            *key,
+            std::make_shared<const VULKAN_HPP_NAMESPACE::VULKAN_HPP_RAII_NAMESPACE::ImageView>(device.get(), createInfo)).first;
+    }
+    return SharedImageView { it->second };
+}
+
+auto vku::ImageViewCache::evict(
+    VULKAN_HPP_NAMESPACE::Image image
+) -> std::size_t {
+    std::scoped_lock lock { mutex };
+    return std::erase_if(views, [&](const auto &pair) {
+        return pair.first.image == image;
+    });
+}
+
+void vku::ImageViewCache::clear() noexcept {
+    std::scoped_lock lock { mutex };
+    views.clear();
+}
+
+auto vku::ImageViewCache::size() const noexcept -> std::size_t {
+    std::scoped_lock lock { mutex };
+    return views.size();
+}
+
+auto vku::ImageViewCache::KeyHash::operator()(
+    const Key &key
+) const noexcept -> std::size_t {
+    std::size_t seed = 0;
+    details::hash_combine(seed, static_cast<VULKAN_HPP_NAMESPACE::ImageViewCreateFlags::MaskType>(key.flags));
+    details::hash_combine(seed, key.image);
+    details::hash_combine(seed, key.viewType);
+    details::hash_combine(seed, key.format);
+    details::hash_combine(seed, key.components.r);
+    details::hash_combine(seed, key.components.g);
+    details::hash_combine(seed, key.components.b);
+    details::hash_combine(seed, key.components.a);
+    details::hash_combine(seed, static_cast<VULKAN_HPP_NAMESPACE::ImageAspectFlags::MaskType>(key.subresourceRange.aspectMask));
+    details::hash_combine(seed, key.subresourceRange.baseMipLevel);
+    details::hash_combine(seed, key.subresourceRange.levelCount);
+    details::hash_combine(seed, key.subresourceRange.baseArrayLayer);
+    details::hash_combine(seed, key.subresourceRange.layerCount);
+    details::hash_combine(seed, static_cast<VULKAN_HPP_NAMESPACE::ImageUsageFlags::MaskType>(key.usage));
+    details::hash_combine(seed, key.ycbcrConversion);
+    details::hash_combine(seed, key.minLod);
+    return seed;
+}
+
+auto vku::ImageViewCache::getKey(
+    const VULKAN_HPP_NAMESPACE::ImageViewCreateInfo &createInfo
+) noexcept -> std::optional<Key> {
+    Key key {
+        createInfo.flags,
+        createInfo.image,
+        createInfo.viewType,
+        createInfo.format,
+        createInfo.components,
+        createInfo.subresourceRange,
+        {},
+        {},
+        0.f,
+    };
+
+    for (auto pNext = static_cast<const VULKAN_HPP_NAMESPACE::BaseInStructure*>(createInfo.pNext); pNext; pNext = pNext->pNext) {
+        switch (pNext->sType) {
+            case VULKAN_HPP_NAMESPACE::StructureType::eImageViewUsageCreateInfo:
+                key.usage = reinterpret_cast<const VULKAN_HPP_NAMESPACE::ImageViewUsageCreateInfo*>(pNext)->usage;
+                break;
+            case VULKAN_HPP_NAMESPACE::StructureType::eSamplerYcbcrConversionInfo:
+                key.ycbcrConversion = reinterpret_cast<const VULKAN_HPP_NAMESPACE::SamplerYcbcrConversionInfo*>(pNext)->conversion;
+                break;
+            case VULKAN_HPP_NAMESPACE::StructureType::eImageViewMinLodCreateInfoEXT:
+                key.minLod = reinterpret_cast<const VULKAN_HPP_NAMESPACE::ImageViewMinLodCreateInfoEXT*>(pNext)->minLod;
+                break;
+            default:
+                // Unknown structure: the view cannot be identified by the key.
+                return std::nullopt;
+        }
+    }
+
+    return key;
+}
@@ -0,0 +1,332 @@
+/** @file caches/ObjectCache.cppm
+ */
+
+module;
+
+#include <vulkan/vulkan_hpp_macros.hpp>
+
+export module vku:caches.ObjectCache;
+
+import std;
+export import vulkan_hpp;
+export import :descriptors.DescriptorSetLayout;
+import :details.concepts;
+import :details.hash;
+
+namespace vku {
+    /**
+     * @brief Thread-safe hash-consing cache of the device objects whose identity is fully determined by their create
+     * info: samplers, descriptor set layouts and pipeline layouts.
+     *
+     * Requesting an object with the same create info contents (not the same pointers) returns the same object, therefore
+     * e.g. pipeline layouts created from the cached descriptor set layouts are also deduplicated and compatible with each
+     * other. Create info contents include the pNext chain structures listed below; if the pNext chain contains any other
+     * structure, the object is created uncached.
+     * - Sampler: <tt>vk::SamplerReductionModeCreateInfo</tt>, <tt>vk::SamplerYcbcrConversionInfo</tt>.
+     * - Descriptor set layout: <tt>vk::DescriptorSetLayoutBindingFlagsCreateInfo</tt>. Immutable samplers are compared by their handles.
+     * - Pipeline layout: none.
+     *
+     * Objects are alive until <tt>clear()</tt> is called and all returned references are released. Lookups take a shared
+     * lock, and cache misses create the object outside the lock and only take an exclusive lock for the insertion, so that
+     * concurrent pipeline creation rarely contends. If multiple threads miss the same key at once, the first inserted
+     * object is returned to all of them and the others are destroyed.
+     *
+     * @code{.cpp}
+     * vku::DeviceObjectCache objectCache { gpu.device };
+     * const std::shared_ptr sampler = objectCache.getSampler(vk::SamplerCreateInfo { ... });
+     * const std::shared_ptr layout = objectCache.getDescriptorSetLayout<vku::DescriptorSetLayout<vk::DescriptorType::eCombinedImageSampler>>(vk::DescriptorSetLayoutCreateInfo {
+     *     {},
+     *     vku::unsafeProxy(vk::DescriptorSetLayoutBinding { 0, vk::DescriptorType::eCombinedImageSampler, 1, vk::ShaderStageFlagBits::eFragment, &**sampler }),
+     * });
+     * const std::shared_ptr pipelineLayout = objectCache.getPipelineLayout(vk::PipelineLayoutCreateInfo { {}, **layout });
+     * @endcode
+     */
+    export class DeviceObjectCache {
+    public:
+        explicit DeviceObjectCache(const VULKAN_HPP_NAMESPACE::VULKAN_HPP_RAII_NAMESPACE::Device &device [[clang::lifetimebound]]);
+
+        /**
+         * @brief Get the sampler with \p createInfo, or create it if not exists.
+         */
+        [[nodiscard]] auto getSampler(
+            const VULKAN_HPP_NAMESPACE::SamplerCreateInfo &createInfo
+        ) -> std::shared_ptr<const VULKAN_HPP_NAMESPACE::VULKAN_HPP_RAII_NAMESPACE::Sampler>;
+
+        /**
+         * @brief Get the typed descriptor set layout with \p createInfo, or create it if not exists.
+         *
+         * The returned object wraps the cached untyped descriptor set layout with the same create info, therefore the
+         * typed and untyped layouts (and the layouts of the different types) with the same create info share a single
+         * <tt>vk::DescriptorSetLayout</tt> handle. The wrapper does not destroy the handle, and keeps the cached layout
+         * alive while it is referenced.
+         *
+         * @tparam Layout Descriptor set layout type, which must be constructible from the RAII descriptor set layout and
+         * \p createInfo.
+         */
+        template <details::derived_from_value_specialization_of<DescriptorSetLayout> Layout>
+            requires std::constructible_from<Layout, VULKAN_HPP_NAMESPACE::VULKAN_HPP_RAII_NAMESPACE::DescriptorSetLayout, const VULKAN_HPP_NAMESPACE::DescriptorSetLayoutCreateInfo&>
+        [[nodiscard]] auto getDescriptorSetLayout(const VULKAN_HPP_NAMESPACE::DescriptorSetLayoutCreateInfo &createInfo) -> std::shared_ptr<const Layout> {
+            std::shared_ptr layout = getDescriptorSetLayout(createInfo);
+            const VULKAN_HPP_NAMESPACE::DescriptorSetLayout handle = **layout;
+            return {
+                new Layout { VULKAN_HPP_NAMESPACE::VULKAN_HPP_RAII_NAMESPACE::DescriptorSetLayout { device.get(), handle }, createInfo },
+                // The handle is owned by the cached layout, therefore release it before the wrapper destruction.
+                [layout = std::move(layout)](Layout *wrapper) noexcept {
+                    std::ignore = wrapper->release();
+                    delete wrapper;
+                },
+            };
+        }
+
+        /**
+         * @brief Get the untyped descriptor set layout with \p createInfo, or create it if not exists.
+         *
+         * It is useful when the layout bindings are only known at runtime (e.g. from the shader reflection). Untyped
+         * layouts share their handles with the typed layouts of the same create info.
+         */
+        [[nodiscard]] auto getDescriptorSetLayout(
+            const VULKAN_HPP_NAMESPACE::DescriptorSetLayoutCreateInfo &createInfo
+        ) -> std::shared_ptr<const VULKAN_HPP_NAMESPACE::VULKAN_HPP_RAII_NAMESPACE::DescriptorSetLayout>;
+
+        /**
+         * @brief Get the pipeline layout with \p createInfo, or create it if not exists.
+         */
+        [[nodiscard]] auto getPipelineLayout(
+            const VULKAN_HPP_NAMESPACE::PipelineLayoutCreateInfo &createInfo
+        ) -> std::shared_ptr<const VULKAN_HPP_NAMESPACE::VULKAN_HPP_RAII_NAMESPACE::PipelineLayout>;
+
+        /**
+         * @brief Remove all objects from the cache. Objects that are still referenced outside are kept alive.
+         */
+        void clear() noexcept;
+
+        /**
+         * @brief Number of the cached objects.
+         */
+        [[nodiscard]] auto size() const noexcept -> std::size_t;
+
+    private:
+        struct KeyHash {
+            [[nodiscard]] auto operator()(const std::vector<std::uint64_t> &words) const noexcept -> std::size_t;
+        };
+
+        std::reference_wrapper<const VULKAN_HPP_NAMESPACE::VULKAN_HPP_RAII_NAMESPACE::Device> device;
+        mutable std::shared_mutex mutex;
+        std::unordered_map<std::vector<std::uint64_t>, std::shared_ptr<const void>, KeyHash> objects;
+
+        /**
+         * @brief Find the object with \p words, or create it with \p factory if not exists.
+         * @param words Serialized create info, or <tt>std::nullopt</tt> if the object cannot be cached. It starts with the
+         * create info's <tt>sType</tt>, so the objects of the different kinds never collide.
+         * @param factory Function that creates the object. It is called without holding the lock.
+         */
+        [[nodiscard]] auto getOrCreate(
+            std::optional<std::vector<std::uint64_t>> words,
+            std::function<std::shared_ptr<const void>()> factory
+        ) -> std::shared_ptr<const void>;
+
+        [[nodiscard]] static auto getKeyWords(const VULKAN_HPP_NAMESPACE::SamplerCreateInfo &createInfo) -> std::optional<std::vector<std::uint64_t>>;
+        [[nodiscard]] static auto getKeyWords(const VULKAN_HPP_NAMESPACE::DescriptorSetLayoutCreateInfo &createInfo) -> std::optional<std::vector<std::uint64_t>>;
+        [[nodiscard]] static auto getKeyWords(const VULKAN_HPP_NAMESPACE::PipelineLayoutCreateInfo &createInfo) -> std::optional<std::vector<std::uint64_t>>;
+    };
+}
+
+// --------------------
+// Implementations.
+// --------------------
+
+/**
+ * @brief Serialize create info members into 64-bit words, that are used as a cache key.
+ */
+struct ObjectCacheKeyWriter {
+    std::vector<std::uint64_t> words;
+
+    template <typename... Ts>
+    void operator()(const Ts &...values) {
+        (write(values), ...);
+    }
+
+private:
+    template <typename T>
+    void write(const T &value) {
+        if constexpr (std::is_enum_v<T>) {
+            words.push_back(static_cast<std::uint64_t>(std::to_underlying(value)));
+        }
+        else if constexpr (std::integral<T>) {
+            words.push_back(static_cast<std::uint64_t>(value));
+        }
+        else if constexpr (std::same_as<T, float>) {
+            words.push_back(std::bit_cast<std::uint32_t>(value));
+        }
+        else if constexpr (requires { typename T::MaskType; }) {
+            // vk::Flags
+            words.push_back(static_cast<std::uint64_t>(static_cast<typename T::MaskType>(value)));
+        }
+        else {
+            // Non-dispatchable handles, which are always 64-bit.
+            static_assert(sizeof(T) == sizeof(std::uint64_t));
+            words.push_back(std::bit_cast<std::uint64_t>(value));
+        }
+    }
+};
+
+vku::DeviceObjectCache::DeviceObjectCache(
+    const VULKAN_HPP_NAMESPACE::VULKAN_HPP_RAII_NAMESPACE::Device &device
+) : device { device } { }
+
+auto vku::DeviceObjectCache::getSampler(
+    const VULKAN_HPP_NAMESPACE::SamplerCreateInfo &createInfo
+) -> std::shared_ptr<const VULKAN_HPP_NAMESPACE::VULKAN_HPP_RAII_NAMESPACE::Sampler> {
+    using Sampler = VULKAN_HPP_NAMESPACE::VULKAN_HPP_RAII_NAMESPACE::Sampler;
+    return std::static_pointer_cast<const Sampler>(getOrCreate(getKeyWords(createInfo), [&]() -> std::shared_ptr<const void> {
+        return std::make_shared<const Sampler>(device.get(), createInfo);
+    }));
+}
+
+auto vku::DeviceObjectCache::getDescriptorSetLayout(
+    const VULKAN_HPP_NAMESPACE::DescriptorSetLayoutCreateInfo &createInfo
+) -> std::shared_ptr<const VULKAN_HPP_NAMESPACE::VULKAN_HPP_RAII_NAMESPACE::DescriptorSetLayout> {
+    using DescriptorSetLayout = VULKAN_HPP_NAMESPACE::VULKAN_HPP_RAII_NAMESPACE::DescriptorSetLayout;
+    return std::static_pointer_cast<const DescriptorSetLayout>(getOrCreate(getKeyWords(createInfo), [&]() -> std::shared_ptr<const void> {
+        return std::make_shared<const DescriptorSetLayout>(device.get(), createInfo);
+    }));
+}
+
+auto vku::DeviceObjectCache::getPipelineLayout(
+    const VULKAN_HPP_NAMESPACE::PipelineLayoutCreateInfo &createInfo
+) -> std::shared_ptr<const VULKAN_HPP_NAMESPACE::VULKAN_HPP_RAII_NAMESPACE::PipelineLayout> {
+    using PipelineLayout = VULKAN_HPP_NAMESPACE::VULKAN_HPP_RAII_NAMESPACE::PipelineLayout;
+    return std::static_pointer_cast<const PipelineLayout>(getOrCreate(getKeyWords(createInfo), [&]() -> std::shared_ptr<const void> {
+        return std::make_shared<const PipelineLayout>(device.get(), createInfo);
+    }));
+}
+
+void vku::DeviceObjectCache::clear() noexcept {
+    std::unique_lock lock { mutex };
+    objects.clear();
+}
+
+auto vku::DeviceObjectCache::size() const noexcept -> std::size_t {
+    std::shared_lock lock { mutex };
+    return objects.size();
+}
+
+auto vku::DeviceObjectCache::KeyHash::operator()(
+    const std::vector<std::uint64_t> &words
+) const noexcept -> std::size_t {
+    std::size_t seed = words.size();
+    for (std::uint64_t word : words) {
+        details::hash_combine(seed, word);
+    }
+    return seed;
+}
+
+auto vku::DeviceObjectCache::getOrCreate(
+    std::optional<std::vector<std::uint64_t>> words,
+    std::function<std::shared_ptr<const void>()> factory
+) -> std::shared_ptr<const void> {
+    if (!words) {
+        return factory();
+    }
+
+    {
+        std::shared_lock lock { mutex };
+        if (auto it = objects.find(*words); it != objects.end()) {
+            return it->second;
+        }
+    }
+
+    // Create the object outside the lock, so that the object creation does not block the other lookups.
+    const std::shared_ptr object = factory();
+
+    std::unique_lock lock { mutex };
+    // Other thread may have inserted the object with the same key meanwhile. In that case, the existing one is returned
+    // and the created object is destroyed after the lock is released.
+    return objects.try_emplace(*std::move(words), object).first->second;
+}
+
+auto vku::DeviceObjectCache::getKeyWords(
+    const VULKAN_HPP_NAMESPACE::SamplerCreateInfo &createInfo
+) -> std::optional<std::vector<std::uint64_t>> {
+    ObjectCacheKeyWriter writer;
+    writer(
+        createInfo.sType, createInfo.flags, createInfo.magFilter, createInfo.minFilter, createInfo.mipmapMode,
+        createInfo.addressModeU, createInfo.addressModeV, createInfo.addressModeW,
+        createInfo.mipLodBias, createInfo.anisotropyEnable, createInfo.maxAnisotropy,
+        createInfo.compareEnable, createInfo.compareOp, createInfo.minLod, createInfo.maxLod,
+        createInfo.borderColor, createInfo.unnormalizedCoordinates);
+
+    for (auto pNext = static_cast<const VULKAN_HPP_NAMESPACE::BaseInStructure*>(createInfo.pNext); pNext; pNext = pNext->pNext) {
+        switch (pNext->sType) {
+            case VULKAN_HPP_NAMESPACE::StructureType::eSamplerReductionModeCreateInfo:
+                writer(pNext->sType, reinterpret_cast<const VULKAN_HPP_NAMESPACE::SamplerReductionModeCreateInfo*>(pNext)->reductionMode);
+                break;
+            case VULKAN_HPP_NAMESPACE::StructureType::eSamplerYcbcrConversionInfo:
+                writer(pNext->sType, reinterpret_cast<const VULKAN_HPP_NAMESPACE::SamplerYcbcrConversionInfo*>(pNext)->conversion);
+                break;
+            default:
+                return std::nullopt;
+        }
+    }
+
+    return std::move(writer.words);
+}
+
+auto vku::DeviceObjectCache::getKeyWords(
+    const VULKAN_HPP_NAMESPACE::DescriptorSetLayoutCreateInfo &createInfo
+) -> std::optional<std::vector<std::uint64_t>> {
+    ObjectCacheKeyWriter writer;
+    writer(createInfo.sType, createInfo.flags, createInfo.bindingCount);
+    for (const VULKAN_HPP_NAMESPACE::DescriptorSetLayoutBinding &binding : std::span { createInfo.pBindings, createInfo.bindingCount }) {
+        writer(binding.binding, binding.descriptorType, binding.descriptorCount, binding.stageFlags);
+
+        // Immutable samplers are only used for the sampler descriptor types.
+        if ((binding.descriptorType == VULKAN_HPP_NAMESPACE::DescriptorType::eSampler || binding.descriptorType == VULKAN_HPP_NAMESPACE::DescriptorType::eCombinedImageSampler)
+            && binding.pImmutableSamplers) {
+            writer(true);
+            for (VULKAN_HPP_NAMESPACE::Sampler sampler : std::span { binding.pImmutableSamplers, binding.descriptorCount }) {
+                writer(sampler);
+            }
+        }
+        else {
+            writer(false);
+        }
+    }
+
+    for (auto pNext = static_cast<const VULKAN_HPP_NAMESPACE::BaseInStructure*>(createInfo.pNext); pNext; pNext = pNext->pNext) {
+        switch (pNext->sType) {
+            case VULKAN_HPP_NAMESPACE::StructureType::eDescriptorSetLayoutBindingFlagsCreateInfo: {
+                const auto &bindingFlagsCreateInfo = *reinterpret_cast<const VULKAN_HPP_NAMESPACE::DescriptorSetLayoutBindingFlagsCreateInfo*>(pNext);
+                writer(pNext->sType, bindingFlagsCreateInfo.bindingCount);
+                for (VULKAN_HPP_NAMESPACE::DescriptorBindingFlags flags : std::span { bindingFlagsCreateInfo.pBindingFlags, bindingFlagsCreateInfo.bindingCount }) {
+                    writer(flags);
+                }
+                break;
+            }
+            default:
+                return std::nullopt;
+        }
+    }
+
+    return std::move(writer.words);
+}
+
+auto vku::DeviceObjectCache::getKeyWords(
+    const VULKAN_HPP_NAMESPACE::PipelineLayoutCreateInfo &createInfo
+) -> std::optional<std::vector<std::uint64_t>> {
+    if (createInfo.pNext) {
+        return std::nullopt;
+    }
+
+    ObjectCacheKeyWriter writer;
+    writer(createInfo.sType, createInfo.flags, createInfo.setLayoutCount);
+    for (VULKAN_HPP_NAMESPACE::DescriptorSetLayout setLayout : std::span { createInfo.pSetLayouts, createInfo.setLayoutCount }) {
+        writer(setLayout);
+    }
+    writer(createInfo.pushConstantRangeCount);
+    for (const VULKAN_HPP_NAMESPACE::PushConstantRange &range : std::span { createInfo.pPushConstantRanges, createInfo.pushConstantRangeCount }) {
+        writer(range.stageFlags, range.offset, range.size);
+    }
+
+    return std::move(writer.words);
+}
@@ -0,0 +1,122 @@
+/** @file caches/ShaderModuleCache.cppm
+ */
+
+module;
+
+#include <vulkan/vulkan_hpp_macros.hpp>
+
+export module vku:caches.ShaderModuleCache;
+
+import std;
+export import vulkan_hpp;
+
+namespace vku {
+    /**
+     * @brief Device-level cache of shader modules, keyed by the content of the SPIR-V code.
+     *
+     * Requesting a module with the same SPIR-V code returns the same module instead of creating a new one, regardless of
+     * where the code came from (e.g. the same file loaded multiple times for the pipeline permutations). Lookup is done
+     * by the hash of the code, and hash collisions are resolved by comparing the whole code.
+     *
+     * Modules are alive until the cache is cleared or destroyed, therefore pipelines that are using them must be created
+     * before that.
+     *
+     * All member functions are thread-safe.
+     *
+     * @code{.cpp}
+     * vku::ShaderModuleCache shaderModuleCache { gpu.device };
+     * for (const vk::SpecializationInfo &specializationInfo : permutations) {
+     *     // Shader module is created only once.
+     *     pipelines.emplace_back(gpu.device, gpu.pipelineCache, vk::ComputePipelineCreateInfo {
+     *         {},
+     *         vku::createPipelineStages(
+     *             shaderModuleCache,
+     *             vku::Shader::fromSpirvFile("shader.comp.spv", vk::ShaderStageFlagBits::eCompute, &specializationInfo)).get()[0],
+     *         *pipelineLayout,
+     *     });
+     * }
+     * @endcode
+     */
+    export class ShaderModuleCache {
+    public:
+        explicit ShaderModuleCache(const VULKAN_HPP_NAMESPACE::VULKAN_HPP_RAII_NAMESPACE::Device &device [[clang::lifetimebound]]);
+
+        /**
+         * @brief Get the shader module of \p code, or create it if not exists.
+         * @param code SPIR-V code. It is copied into the cache only if the module is newly created.
+         * @return Shader module handle, which is valid until the cache is cleared or destroyed.
+         */
+        [[nodiscard]] auto get(std::span<const std::uint32_t> code) -> VULKAN_HPP_NAMESPACE::ShaderModule;
+
+        /**
+         * @brief Destroy all cached modules.
+         */
+        void clear() noexcept;
+
+        /**
+         * @brief Number of the cached modules.
+         */
+        [[nodiscard]] auto size() const noexcept -> std::size_t;
+
+    private:
+        struct CodeHash {
+            using is_transparent = void;
+
+            [[nodiscard]] auto operator()(std::span<const std::uint32_t> code) const noexcept -> std::size_t;
+        };
+
+        struct CodeEqual {
+            using is_transparent = void;
+
+            [[nodiscard]] bool operator()(std::span<const std::uint32_t> lhs, std::span<const std::uint32_t> rhs) const noexcept;
+        };
+
+        std::reference_wrapper<const VULKAN_HPP_NAMESPACE::VULKAN_HPP_RAII_NAMESPACE::Device> device;
+        mutable std::mutex mutex;
+        std::unordered_map<std::vector<std::uint32_t>, VULKAN_HPP_NAMESPACE::VULKAN_HPP_RAII_NAMESPACE::ShaderModule, CodeHash, CodeEqual> shaderModules;
+    };
+}
+
+// --------------------
+// Implementations.
+// --------------------
+
+vku::ShaderModuleCache::ShaderModuleCache(
+    const VULKAN_HPP_NAMESPACE::VULKAN_HPP_RAII_NAMESPACE::Device &device
+) : device { device } { }
+
+auto vku::ShaderModuleCache::get(
+    std::span<const std::uint32_t> code
+) -> VULKAN_HPP_NAMESPACE::ShaderModule {
+    std::scoped_lock lock { mutex };
+    auto it = shaderModules.find(code);
+    if (it == shaderModules.end()) {
+        it = shaderModules.emplace(
+            code | std::ranges::to<std::vector>(),
+            VULKAN_HPP_NAMESPACE::VULKAN_HPP_RAII_NAMESPACE::ShaderModule { device.get(), VULKAN_HPP_NAMESPACE::ShaderModuleCreateInfo { {}, code } }).first;
+    }
+    return *it->second;
+}
+
+void vku::ShaderModuleCache::clear() noexcept {
+    std::scoped_lock lock { mutex };
+    shaderModules.clear();
+}
+
+auto vku::ShaderModuleCache::size() const noexcept -> std::size_t {
+    std::scoped_lock lock { mutex };
+    return shaderModules.size();
+}
+
+auto vku::ShaderModuleCache::CodeHash::operator()(
+    std::span<const std::uint32_t> code
+) const noexcept -> std::size_t {
+    return std::hash<std::string_view>{}({ reinterpret_cast<const char*>(code.data()), code.size_bytes() });
+}
+
+bool vku::ShaderModuleCache::CodeEqual::operator()(
+    std::span<const std::uint32_t> lhs,
+    std::span<const std::uint32_t> rhs
+) const noexcept {
+    return std::ranges::equal(lhs, rhs);
+}
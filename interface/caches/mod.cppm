@@ -0,0 +1,7 @@
+/** @file caches/mod.cppm
+ */
+
+export module vku:caches;
+export import :caches.ImageViewCache;
+export import :caches.ObjectCache;
+export import :caches.ShaderModuleCache;
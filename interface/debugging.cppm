@@ -8,6 +8,7 @@ module;
 export module vku:debugging;
 
 import std;
+export import vulkan_hpp;
 import :details.to_string;
 import :utils;
 
@@ -16,32 +17,234 @@ namespace vku {
      * @brief <tt>vk::DebugUtilsObjectNameInfoEXT</tt> with deduced object type.
      * @tparam T Vulkan object type.
      * @param handle Vulkan object handle.
-     * @param name Name of the object to be set. Default is the current source location.
+     * @param name Name of the object to be set.
      * @return <tt>vk::DebugUtilsObjectNameInfoEXT</tt> with deduced object type.
      */
     export template <typename T>
     [[nodiscard]] VULKAN_HPP_NAMESPACE::DebugUtilsObjectNameInfoEXT getDebugUtilsObjectNameInfoEXT(
         T handle,
-        const char *name = details::to_string(std::source_location::current()).c_str()
+        const char *name
     ) noexcept {
         return { T::objectType, toUint64(handle), name };
     }
 
+    /**
+     * @brief <tt>vk::DebugUtilsObjectNameInfoEXT</tt> with deduced object type, named by the caller's source location.
+     * @tparam T Vulkan object type.
+     * @param handle Vulkan object handle.
+     * @param location Source location of the caller, which is formatted at compile time. Its name is interned to the
+     * static storage, therefore the returned struct can outlive the call.
+     * @return <tt>vk::DebugUtilsObjectNameInfoEXT</tt> with deduced object type.
+     */
+    export template <typename T>
+    [[nodiscard]] VULKAN_HPP_NAMESPACE::DebugUtilsObjectNameInfoEXT getDebugUtilsObjectNameInfoEXT(
+        T handle,
+        details::SourceLocationName location = std::source_location::current()
+    ) {
+        return getDebugUtilsObjectNameInfoEXT(handle, details::intern(location));
+    }
+
     /**
      * @brief <tt>vk::DebugUtilsObjectTagInfoEXT</tt> with deduced object type and tag data.
      * @tparam T Vulkan object type.
      * @tparam U Data type of the tag.
      * @param handle Vulkan object handle.
      * @param data Contiguous range of the data to be tagged.
-     * @param name Name of the object to be set. Default is the current source location.
+     * @param tagName Numerical identifier of the tag. Default is the hash of the current source location, computed at
+     * compile time.
      * @return <tt>vk::DebugUtilsObjectTagInfoEXT</tt> with deduced object type and tag data.
      */
     export template <typename T, typename U>
     [[nodiscard]] VULKAN_HPP_NAMESPACE::DebugUtilsObjectTagInfoEXT getDebugUtilsObjectTagInfoEXT(
         T handle,
         VULKAN_HPP_NAMESPACE::ArrayProxyNoTemporaries<const U> data,
-        const char *name = details::to_string(std::source_location::current()).c_str()
+        std::uint64_t tagName = details::SourceLocationName { std::source_location::current() }.hash()
     ) noexcept {
-        return { T::objectType, toUint64(handle), name, data };
+        return { T::objectType, toUint64(handle), tagName, data };
+    }
+
+    /**
+     * @brief Set the debug name of \p handle.
+     *
+     * The call compiles to nothing if the macro <tt>VKU_ENABLE_DEBUG_UTILS</tt> is not defined.
+     *
+     * @tparam T Vulkan object type.
+     * @param device Vulkan-Hpp RAII device that owns \p handle. Its dispatcher is used for the call.
+     * @param handle Vulkan object handle.
+     * @param name Name of the object.
+     */
+    export template <typename T>
+    void setObjectName(
+        const VULKAN_HPP_NAMESPACE::VULKAN_HPP_RAII_NAMESPACE::Device &device,
+        T handle,
+        const char *name
+    ) {
+    #ifdef VKU_ENABLE_DEBUG_UTILS
+        device.setDebugUtilsObjectNameEXT(getDebugUtilsObjectNameInfoEXT(handle, name));
+    #else
+        static_cast<void>(device);
+        static_cast<void>(handle);
+        static_cast<void>(name);
+    #endif
+    }
+
+    /**
+     * @brief Set the debug name of \p handle to the caller's source location.
+     * @tparam T Vulkan object type.
+     * @param device Vulkan-Hpp RAII device that owns \p handle. Its dispatcher is used for the call.
+     * @param handle Vulkan object handle.
+     * @param location Source location of the caller.
+     */
+    export template <typename T>
+    void setObjectName(
+        const VULKAN_HPP_NAMESPACE::VULKAN_HPP_RAII_NAMESPACE::Device &device,
+        T handle,
+        details::SourceLocationName location = std::source_location::current()
+    ) {
+        // The name is copied by the driver, therefore it doesn't have to be interned.
+        setObjectName(device, handle, location.c_str());
     }
-}
\ No newline at end of file
+
+    /**
+     * @brief RAII debug label region of a command buffer.
+     *
+     * <tt>vkCmdBeginDebugUtilsLabelEXT</tt> is recorded at construction, and the matching
+     * <tt>vkCmdEndDebugUtilsLabelEXT</tt> at destruction. If the macro <tt>VKU_ENABLE_DEBUG_UTILS</tt> is not defined,
+     * the class is empty and both are no-op.
+     *
+     * @code{.cpp}
+     * {
+     *     const vku::CommandLabelScope label { device, cb, "Shadow pass", { 0.5f, 0.5f, 0.5f, 1.f } };
+     *     cb.beginRenderingKHR(...);
+     *     ...
+     * } // Label region ends.
+     * @endcode
+     */
+    export class CommandLabelScope {
+    public:
+        /**
+         * @param device Vulkan-Hpp RAII device whose dispatcher is used for recording the labels.
+         * @param commandBuffer Command buffer to record the label region.
+         * @param label Label name.
+         * @param color RGBA color of the label. Default is zero (no color).
+         */
+        CommandLabelScope(
+            const VULKAN_HPP_NAMESPACE::VULKAN_HPP_RAII_NAMESPACE::Device &device [[clang::lifetimebound]],
+            VULKAN_HPP_NAMESPACE::CommandBuffer commandBuffer,
+            const char *label,
+            const std::array<float, 4> &color = {}
+        );
+
+        /**
+         * @param device Vulkan-Hpp RAII device whose dispatcher is used for recording the labels.
+         * @param commandBuffer Command buffer to record the label region.
+         * @param location Source location of the caller, which is used as the label name.
+         */
+        CommandLabelScope(
+            const VULKAN_HPP_NAMESPACE::VULKAN_HPP_RAII_NAMESPACE::Device &device [[clang::lifetimebound]],
+            VULKAN_HPP_NAMESPACE::CommandBuffer commandBuffer,
+            details::SourceLocationName location = std::source_location::current()
+        );
+        CommandLabelScope(const CommandLabelScope&) = delete;
+        auto operator=(const CommandLabelScope&) -> CommandLabelScope& = delete;
+        ~CommandLabelScope();
+
+    private:
+    #ifdef VKU_ENABLE_DEBUG_UTILS
+        const VULKAN_HPP_NAMESPACE::VULKAN_HPP_RAII_NAMESPACE::Device *device;
+        VULKAN_HPP_NAMESPACE::CommandBuffer commandBuffer;
+    #endif
+    };
+
+    /**
+     * @brief Record a single debug label into \p commandBuffer.
+     *
+     * The call compiles to nothing if the macro <tt>VKU_ENABLE_DEBUG_UTILS</tt> is not defined.
+     *
+     * @param device Vulkan-Hpp RAII device whose dispatcher is used for recording the label.
+     * @param commandBuffer Command buffer to record the label.
+     * @param label Label name.
+     * @param color RGBA color of the label. Default is zero (no color).
+     */
+    export inline void insertCommandLabel(
+        const VULKAN_HPP_NAMESPACE::VULKAN_HPP_RAII_NAMESPACE::Device &device,
+        VULKAN_HPP_NAMESPACE::CommandBuffer commandBuffer,
+        const char *label,
+        const std::array<float, 4> &color = {}
+    );
+
+    /**
+     * @brief Record a single debug label named by the caller's source location into \p commandBuffer.
+     * @param device Vulkan-Hpp RAII device whose dispatcher is used for recording the label.
+     * @param commandBuffer Command buffer to record the label.
+     * @param location Source location of the caller.
+     */
+    export inline void insertCommandLabel(
+        const VULKAN_HPP_NAMESPACE::VULKAN_HPP_RAII_NAMESPACE::Device &device,
+        VULKAN_HPP_NAMESPACE::CommandBuffer commandBuffer,
+        details::SourceLocationName location = std::source_location::current()
+    );
+}
+
+// --------------------
+// Implementations.
+// --------------------
+
+// Functions are explicitly inline, as member functions of a named module are not implicitly inline and would otherwise
+// remain as opaque calls in the release builds.
+
+inline vku::CommandLabelScope::CommandLabelScope(
+    const VULKAN_HPP_NAMESPACE::VULKAN_HPP_RAII_NAMESPACE::Device &device,
+    VULKAN_HPP_NAMESPACE::CommandBuffer commandBuffer,
+    const char *label,
+    const std::array<float, 4> &color
+)
+#ifdef VKU_ENABLE_DEBUG_UTILS
+    : device { &device },
+      commandBuffer { commandBuffer } {
+    commandBuffer.beginDebugUtilsLabelEXT({ label, color }, *device.getDispatcher());
+}
+#else
+{
+    static_cast<void>(device);
+    static_cast<void>(commandBuffer);
+    static_cast<void>(label);
+    static_cast<void>(color);
+}
+#endif
+
+inline vku::CommandLabelScope::CommandLabelScope(
+    const VULKAN_HPP_NAMESPACE::VULKAN_HPP_RAII_NAMESPACE::Device &device,
+    VULKAN_HPP_NAMESPACE::CommandBuffer commandBuffer,
+    details::SourceLocationName location
+) : CommandLabelScope { device, commandBuffer, location.c_str() } { }
+
+inline vku::CommandLabelScope::~CommandLabelScope() {
+#ifdef VKU_ENABLE_DEBUG_UTILS
+    commandBuffer.endDebugUtilsLabelEXT(*device->getDispatcher());
+#endif
+}
+
+inline void vku::insertCommandLabel(
+    const VULKAN_HPP_NAMESPACE::VULKAN_HPP_RAII_NAMESPACE::Device &device,
+    VULKAN_HPP_NAMESPACE::CommandBuffer commandBuffer,
+    const char *label,
+    const std::array<float, 4> &color
+) {
+#ifdef VKU_ENABLE_DEBUG_UTILS
+    commandBuffer.insertDebugUtilsLabelEXT({ label, color }, *device.getDispatcher());
+#else
+    static_cast<void>(device);
+    static_cast<void>(commandBuffer);
+    static_cast<void>(label);
+    static_cast<void>(color);
+#endif
+}
+
+inline void vku::insertCommandLabel(
+    const VULKAN_HPP_NAMESPACE::VULKAN_HPP_RAII_NAMESPACE::Device &device,
+    VULKAN_HPP_NAMESPACE::CommandBuffer commandBuffer,
+    details::SourceLocationName location
+) {
+    insertCommandLabel(device, commandBuffer, location.c_str());
+}
@@ -0,0 +1,311 @@
+/** @file descriptors/BindlessDescriptorHeap.cppm
+ */
+
+module;
+
+#include <cassert>
+
+#include <vulkan/vulkan_hpp_macros.hpp>
+
+export module vku:descriptors.BindlessDescriptorHeap;
+
+import std;
+export import vulkan_hpp;
+export import :descriptors.DescriptorSet;
+export import :descriptors.DescriptorSetLayout;
+import :utils;
+
+namespace vku {
+    /**
+     * @brief Thread-safe slot allocator for bindless descriptor arrays.
+     *
+     * Free slots are managed by a lock-free stack (with the ABA tag), and slots that are never used are handed out from a
+     * bump counter. Freed slots are not reused immediately: <tt>retire(slot, value)</tt> defers the release until
+     * <tt>collect(completedValue)</tt> is called with <tt>completedValue >= value</tt>, where the values are usually
+     * the timeline semaphore values (or frame indices) that indicate the GPU is done with the slot.
+     */
+    export class BindlessSlotAllocator {
+    public:
+        /**
+         * @brief Maximum number of slots.
+         */
+        std::uint32_t capacity;
+
+        explicit BindlessSlotAllocator(std::uint32_t capacity);
+
+        /**
+         * @brief Allocate a slot.
+         * @return Allocated slot index, which is less than <tt>capacity</tt>.
+         * @throw std::runtime_error If all slots are in use.
+         */
+        [[nodiscard]] auto allocate() -> std::uint32_t;
+
+        /**
+         * @brief Release the \p slot immediately.
+         * @param slot Slot index to release. It must not be used by the GPU.
+         */
+        void free(std::uint32_t slot) noexcept;
+
+        /**
+         * @brief Release the \p slot when <tt>collect</tt> is called with the value that is greater than or equal to \p retireValue.
+         * @param slot Slot index to release.
+         * @param retireValue Value that indicates the GPU is done with the slot.
+         */
+        void retire(std::uint32_t slot, std::uint64_t retireValue);
+
+        /**
+         * @brief Release all retired slots whose retire value is less than or equal to \p completedValue.
+         * @param completedValue Value that the GPU has been completed.
+         * @return Number of released slots.
+         */
+        auto collect(std::uint64_t completedValue) -> std::size_t;
+
+    private:
+        static constexpr std::uint32_t nullSlot = ~0U;
+
+        std::unique_ptr<std::atomic<std::uint32_t>[]> nextFreeSlots;
+
+        // Lower 32 bits: top slot of the free slot stack (nullSlot if empty), upper 32 bits: ABA tag.
+        std::atomic<std::uint64_t> freeSlotStackTop { nullSlot };
+        std::atomic<std::uint32_t> bumpCount { 0 };
+
+        std::mutex retiredSlotsMutex;
+        std::vector<std::pair<std::uint64_t, std::uint32_t>> retiredSlots;
+    };
+
+    /**
+     * @brief Single large update-after-bind descriptor set of \p Type, whose descriptors are indexed by the slots.
+     *
+     * @code{.cpp}
+     * vku::BindlessDescriptorHeap<vk::DescriptorType::eSampledImage> textureHeap { gpu.device, 65536 };
+     *
+     * // Loading a texture, from any thread.
+     * const std::uint32_t textureIndex = textureHeap.allocate({ {}, *textureView, vk::ImageLayout::eShaderReadOnlyOptimal });
+     *
+     * // Frame loop.
+     * textureHeap.collect(completedFrameIndex);
+     * textureHeap.flush(*gpu.device); // All writes of this frame are done with a single vkUpdateDescriptorSets call.
+     * cb.bindDescriptorSets(vk::PipelineBindPoint::eGraphics, *pipelineLayout, 0, textureHeap.descriptorSet, {});
+     * ... // Pass textureIndex via push constant or per-material buffer.
+     *
+     * // Unloading a texture.
+     * textureHeap.retire(textureIndex, currentFrameIndex);
+     * @endcode
+     *
+     * @tparam Type Descriptor type of the heap.
+     * @note Device must be created with the <tt>descriptorBindingPartiallyBound</tt> and
+     * <tt>descriptorBinding<Type>UpdateAfterBind</tt> features of <tt>vk::PhysicalDeviceDescriptorIndexingFeatures</tt>
+     * (or <tt>vk::PhysicalDeviceVulkan12Features</tt>).
+     */
+    export template <VULKAN_HPP_NAMESPACE::DescriptorType Type>
+    class BindlessDescriptorHeap {
+    public:
+        using Layout = DescriptorSetLayout<Type>;
+        using DescriptorInfo = WriteDescriptorInfo_t<Type>;
+
+        /**
+         * @brief Binding flags of the heap binding.
+         */
+        static constexpr VULKAN_HPP_NAMESPACE::DescriptorBindingFlags bindingFlags
+            = VULKAN_HPP_NAMESPACE::DescriptorBindingFlagBits::eUpdateAfterBind
+            | VULKAN_HPP_NAMESPACE::DescriptorBindingFlagBits::eUpdateUnusedWhilePending
+            | VULKAN_HPP_NAMESPACE::DescriptorBindingFlagBits::ePartiallyBound;
+
+        Layout layout;
+        VULKAN_HPP_NAMESPACE::VULKAN_HPP_RAII_NAMESPACE::DescriptorPool pool;
+        DescriptorSet<Layout> descriptorSet;
+
+        /**
+         * @brief Create a heap with \p capacity descriptors.
+         * @param device Vulkan device.
+         * @param capacity Number of descriptors, must not exceed the <tt>maxDescriptorSetUpdateAfterBind*</tt> limit.
+         * @param stageFlags Shader stages that can access the heap.
+         */
+        BindlessDescriptorHeap(
+            const VULKAN_HPP_NAMESPACE::VULKAN_HPP_RAII_NAMESPACE::Device &device [[clang::lifetimebound]],
+            std::uint32_t capacity,
+            VULKAN_HPP_NAMESPACE::ShaderStageFlags stageFlags = VULKAN_HPP_NAMESPACE::ShaderStageFlagBits::eAll
+        ) : layout { device, VULKAN_HPP_NAMESPACE::StructureChain {
+                VULKAN_HPP_NAMESPACE::DescriptorSetLayoutCreateInfo {
+                    VULKAN_HPP_NAMESPACE::DescriptorSetLayoutCreateFlagBits::eUpdateAfterBindPool,
+                    unsafeProxy(Layout::getBindings({ capacity, stageFlags, nullptr, bindingFlags })),
+                },
+                VULKAN_HPP_NAMESPACE::DescriptorSetLayoutBindingFlagsCreateInfo {
+                    unsafeProxy(Layout::getBindingFlags({ capacity, stageFlags, nullptr, bindingFlags })),
+                },
+            }.get() },
+            pool { device, layout.getPoolSize().getDescriptorPoolCreateInfo(VULKAN_HPP_NAMESPACE::DescriptorPoolCreateFlagBits::eUpdateAfterBind).get() },
+            descriptorSet { get<0>(allocateDescriptorSets(*device, *pool, std::tie(layout))) },
+            slotAllocator { capacity } { }
+
+        /**
+         * @brief Allocate a slot without writing the descriptor.
+         * @return Allocated slot index.
+         * @throw std::runtime_error If the heap is full.
+         */
+        [[nodiscard]] auto allocate() -> std::uint32_t {
+            return slotAllocator.allocate();
+        }
+
+        /**
+         * @brief Allocate a slot and queue the write of \p descriptorInfo into it.
+         * @param descriptorInfo Descriptor info to write.
+         * @return Allocated slot index.
+         * @throw std::runtime_error If the heap is full.
+         */
+        [[nodiscard]] auto allocate(const DescriptorInfo &descriptorInfo) -> std::uint32_t {
+            const std::uint32_t slot = slotAllocator.allocate();
+            write(slot, descriptorInfo);
+            return slot;
+        }
+
+        /**
+         * @brief Queue the write of \p descriptorInfo into \p slot. The write is done at the next <tt>flush</tt>.
+         * @param slot Slot index to write.
+         * @param descriptorInfo Descriptor info to write.
+         */
+        void write(std::uint32_t slot, const DescriptorInfo &descriptorInfo) {
+            assert(slot < slotAllocator.capacity && "Slot index out of range");
+            std::scoped_lock lock { pendingWritesMutex };
+            pendingWrites.emplace_back(slot, descriptorInfo);
+        }
+
+        /**
+         * @brief Release the \p slot after the GPU completes the \p retireValue.
+         * @copydetails BindlessSlotAllocator::retire
+         */
+        void retire(std::uint32_t slot, std::uint64_t retireValue) {
+            slotAllocator.retire(slot, retireValue);
+        }
+
+        /**
+         * @copydoc BindlessSlotAllocator::collect
+         */
+        auto collect(std::uint64_t completedValue) -> std::size_t {
+            return slotAllocator.collect(completedValue);
+        }
+
+        /**
+         * @brief Write all queued descriptors with a single <tt>vkUpdateDescriptorSets</tt> call.
+         *
+         * Writes for the consecutive slots are merged into a single <tt>vk::WriteDescriptorSet</tt>, and if the same slot
+         * is written multiple times, the last write is used.
+         *
+         * @param device Vulkan device.
+         */
+        void flush(VULKAN_HPP_NAMESPACE::Device device) {
+            std::vector<std::pair<std::uint32_t, DescriptorInfo>> writes;
+            {
+                std::scoped_lock lock { pendingWritesMutex };
+                writes.swap(pendingWrites);
+            }
+            if (writes.empty()) {
+                return;
+            }
+
+            std::ranges::stable_sort(writes, {}, &std::pair<std::uint32_t, DescriptorInfo>::first);
+
+            // Descriptor infos (ordered by the slot) and their [slot, infoIndex, count) ranges.
+            std::vector<DescriptorInfo> descriptorInfos;
+            descriptorInfos.reserve(writes.size());
+            std::vector<std::tuple<std::uint32_t, std::uint32_t, std::uint32_t>> ranges;
+            for (auto it = writes.begin(); it != writes.end();) {
+                const auto sameSlotEnd = std::ranges::find_if(it, writes.end(), [slot = it->first](const auto &write) {
+                    return write.first != slot;
+                });
+                const auto &[slot, descriptorInfo] = *std::prev(sameSlotEnd);
+
+                if (!ranges.empty() && get<0>(ranges.back()) + get<2>(ranges.back()) == slot) {
+                    ++get<2>(ranges.back());
+                }
+                else {
+                    ranges.emplace_back(slot, static_cast<std::uint32_t>(descriptorInfos.size()), 1U);
+                }
+                descriptorInfos.push_back(descriptorInfo);
+
+                it = sameSlotEnd;
+            }
+
+            std::vector<VULKAN_HPP_NAMESPACE::WriteDescriptorSet> descriptorWrites;
+            descriptorWrites.reserve(ranges.size());
+            for (const auto &[slot, infoIndex, count] : ranges) {
+                VULKAN_HPP_NAMESPACE::WriteDescriptorSet &descriptorWrite = descriptorWrites.emplace_back(
+                    descriptorSet.template getWrite<0>(VULKAN_HPP_NAMESPACE::ArrayProxyNoTemporaries<const DescriptorInfo> { count, &descriptorInfos[infoIndex] }));
+                descriptorWrite.dstArrayElement = slot;
+            }
+            device.updateDescriptorSets(descriptorWrites, {});
+        }
+
+    private:
+        BindlessSlotAllocator slotAllocator;
+        std::mutex pendingWritesMutex;
+        std::vector<std::pair<std::uint32_t, DescriptorInfo>> pendingWrites;
+    };
+}
+
+// --------------------
+// Implementations.
+// --------------------
+
+vku::BindlessSlotAllocator::BindlessSlotAllocator(
+    std::uint32_t capacity
+) : capacity { capacity },
+    nextFreeSlots { std::make_unique<std::atomic<std::uint32_t>[]>(capacity) } { }
+
+auto vku::BindlessSlotAllocator::allocate() -> std::uint32_t {
+    // Pop from the free slot stack.
+    std::uint64_t top = freeSlotStackTop.load(std::memory_order_acquire);
+    while (static_cast<std::uint32_t>(top) != nullSlot) {
+        const std::uint32_t slot = static_cast<std::uint32_t>(top);
+        const std::uint64_t newTop = ((top >> 32) + 1) << 32 | nextFreeSlots[slot].load(std::memory_order_relaxed);
+        if (freeSlotStackTop.compare_exchange_weak(top, newTop, std::memory_order_acquire, std::memory_order_acquire)) {
+            return slot;
+        }
+    }
+
+    // Free slot stack is empty: take a never used slot.
+    std::uint32_t count = bumpCount.load(std::memory_order_relaxed);
+    do {
+        if (count >= capacity) {
+            throw std::runtime_error { "No more slot available in the bindless descriptor heap" };
+        }
+    } while (!bumpCount.compare_exchange_weak(count, count + 1, std::memory_order_relaxed));
+    return count;
+}
+
+void vku::BindlessSlotAllocator::free(
+    std::uint32_t slot
+) noexcept {
+    assert(slot < capacity && "Slot index out of range");
+
+    std::uint64_t top = freeSlotStackTop.load(std::memory_order_relaxed);
+    std::uint64_t newTop;
+    do {
+        nextFreeSlots[slot].store(static_cast<std::uint32_t>(top), std::memory_order_relaxed);
+        newTop = ((top >> 32) + 1) << 32 | slot;
+    } while (!freeSlotStackTop.compare_exchange_weak(top, newTop, std::memory_order_release, std::memory_order_relaxed));
+}
+
+void vku::BindlessSlotAllocator::retire(
+    std::uint32_t slot,
+    std::uint64_t retireValue
+) {
+    std::scoped_lock lock { retiredSlotsMutex };
+    retiredSlots.emplace_back(retireValue, slot);
+}
+
+auto vku::BindlessSlotAllocator::collect(
+    std::uint64_t completedValue
+) -> std::size_t {
+    std::scoped_lock lock { retiredSlotsMutex };
+    const auto collected = std::ranges::partition(retiredSlots, [&](const auto &pair) {
+        return pair.first > completedValue;
+    });
+    for (std::uint32_t slot : collected | std::views::values) {
+        free(slot);
+    }
+
+    const std::size_t collectedCount = collected.size();
+    retiredSlots.erase(collected.begin(), collected.end());
+    return collectedCount;
+}
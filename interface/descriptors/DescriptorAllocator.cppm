@@ -0,0 +1,188 @@
+/** @file descriptors/DescriptorAllocator.cppm
+ */
+
+module;
+
+#include <vulkan/vulkan_hpp_macros.hpp>
+
+export module vku:descriptors.DescriptorAllocator;
+
+import std;
+export import vulkan_hpp;
+export import :descriptors.DescriptorSet;
+export import :descriptors.PoolSizes;
+import :details.concepts;
+import :utils;
+
+#define INDEX_SEQ(Is, N, ...) [&]<std::size_t ...Is>(std::index_sequence<Is...>) __VA_ARGS__ (std::make_index_sequence<N>{})
+
+namespace vku {
+    /**
+     * @brief Growable descriptor set allocator that manages a chain of descriptor pools.
+     *
+     * Descriptor sets are allocated from the current pool. When the pool is exhausted (<tt>vk::OutOfPoolMemoryError</tt>
+     * or <tt>vk::FragmentedPoolError</tt>), the allocator falls through to the next pool in the chain, and creates a new
+     * pool if there is no more. New pools are sized from the usage observed since the last <tt>reset()</tt>, so that the
+     * pool capacity grows geometrically.
+     *
+     * <tt>reset()</tt> frees all descriptor sets at once. If more than one pool was used, the chain is collapsed into a
+     * single pool that can hold the observed usage, so that a steady-state frame only needs a single
+     * <tt>vkResetDescriptorPool</tt> call. Using one allocator per frame in flight is recommended.
+     *
+     * @code{.cpp}
+     * vku::DescriptorAllocator descriptorAllocator { gpu.device, getPoolSizes(layout) * 16 };
+     *
+     * // In each frame:
+     * descriptorAllocator.reset();
+     * const auto [descriptorSet] = descriptorAllocator.allocate(std::tie(layout)); // vku::DescriptorSet<decltype(layout)>
+     * @endcode
+     *
+     * @note Device must be created with the <tt>VK_KHR_maintenance1</tt> extension or Vulkan 1.1, as the allocator relies on
+     * <tt>vk::OutOfPoolMemoryError</tt> being reported for pool exhaustion.
+     */
+    export class DescriptorAllocator {
+    public:
+        /**
+         * @brief Create an allocator with no pool. The first pool will be created at the first allocation.
+         * @param device Vulkan device.
+         * @param initialPoolSizes Lower bound of the pool sizes for each pool creation.
+         * @param flags Descriptor pool create flags for each pool creation.
+         */
+        explicit DescriptorAllocator(
+            const VULKAN_HPP_NAMESPACE::VULKAN_HPP_RAII_NAMESPACE::Device &device [[clang::lifetimebound]],
+            PoolSizes initialPoolSizes = {},
+            VULKAN_HPP_NAMESPACE::DescriptorPoolCreateFlags flags = {}
+        );
+
+        /**
+         * @brief Allocate typed descriptor sets of the specified \p layouts.
+         * @param layouts Descriptor set layouts.
+         * @return Tuple of <tt>vku::DescriptorSet</tt>s, whose layout types are matched to \p layouts.
+         */
+        template <details::derived_from_value_specialization_of<DescriptorSetLayout>... Layouts>
+        [[nodiscard]] auto allocate(const std::tuple<Layouts...> &layouts) -> std::tuple<DescriptorSet<std::remove_cvref_t<Layouts>>...> {
+            const std::array rawDescriptorSetLayouts = std::apply([&](const auto &...layout) {
+                return std::array { *layout... };
+            }, layouts);
+            const PoolSizes requiredPoolSizes = std::apply([](const auto &...layout) {
+                return getPoolSizes(layout...);
+            }, layouts);
+
+            const std::vector rawDescriptorSets = allocate(rawDescriptorSetLayouts, requiredPoolSizes);
+            return INDEX_SEQ(Is, sizeof...(Layouts), {
+                return std::tuple { DescriptorSet<std::remove_cvref_t<Layouts>> { unsafe, rawDescriptorSets[Is] }... };
+            });
+        }
+
+        /**
+         * @brief Allocate raw descriptor sets of the specified \p layouts.
+         * @param layouts Descriptor set layouts.
+         * @param requiredPoolSizes Pool sizes that allocating \p layouts requires.
+         * @return Allocated descriptor sets.
+         */
+        [[nodiscard]] auto allocate(
+            std::span<const VULKAN_HPP_NAMESPACE::DescriptorSetLayout> layouts,
+            const PoolSizes &requiredPoolSizes
+        ) -> std::vector<VULKAN_HPP_NAMESPACE::DescriptorSet>;
+
+        /**
+         * @brief Free all descriptor sets allocated from this allocator.
+         *
+         * If more than one pool was used since the last reset, the pools are replaced by a single pool that can hold
+         * the observed usage. Otherwise, the pool is reset.
+         *
+         * @warning All descriptor sets allocated from this allocator must not be in use by the device.
+         */
+        void reset();
+
+        /**
+         * @brief Total pool sizes of the descriptor sets allocated since the last reset.
+         */
+        [[nodiscard]] auto getUsage() const noexcept -> const PoolSizes& {
+            return usage;
+        }
+
+        /**
+         * @brief Number of the pools in the chain.
+         */
+        [[nodiscard]] auto getPoolCount() const noexcept -> std::size_t {
+            return pools.size();
+        }
+
+    private:
+        std::reference_wrapper<const VULKAN_HPP_NAMESPACE::VULKAN_HPP_RAII_NAMESPACE::Device> device;
+        PoolSizes initialPoolSizes;
+        VULKAN_HPP_NAMESPACE::DescriptorPoolCreateFlags flags;
+        std::vector<VULKAN_HPP_NAMESPACE::VULKAN_HPP_RAII_NAMESPACE::DescriptorPool> pools;
+        std::size_t currentPoolIndex = 0;
+        PoolSizes usage {};
+
+        [[nodiscard]] auto createPool(const PoolSizes &poolSizes) const -> VULKAN_HPP_NAMESPACE::VULKAN_HPP_RAII_NAMESPACE::DescriptorPool;
+    };
+}
+
+// --------------------
+// Implementations.
+// --------------------
+
+/**
+ * @brief Element-wise maximum of the two pool sizes.
+ */
+[[nodiscard]] vku::PoolSizes getMaxPoolSizes(vku::PoolSizes lhs, const vku::PoolSizes &rhs) {
+    lhs.setCount = std::max(lhs.setCount, rhs.setCount);
+    for (const auto &[type, count] : rhs.typeCounts) {
+        std::uint32_t &lhsCount = lhs.typeCounts[type];
+        lhsCount = std::max(lhsCount, count);
+    }
+    return lhs;
+}
+
+vku::DescriptorAllocator::DescriptorAllocator(
+    const VULKAN_HPP_NAMESPACE::VULKAN_HPP_RAII_NAMESPACE::Device &device,
+    PoolSizes initialPoolSizes,
+    VULKAN_HPP_NAMESPACE::DescriptorPoolCreateFlags flags
+) : device { device },
+    initialPoolSizes { std::move(initialPoolSizes) },
+    flags { flags } { }
+
+auto vku::DescriptorAllocator::allocate(
+    std::span<const VULKAN_HPP_NAMESPACE::DescriptorSetLayout> layouts,
+    const PoolSizes &requiredPoolSizes
+) -> std::vector<VULKAN_HPP_NAMESPACE::DescriptorSet> {
+    for (; currentPoolIndex < pools.size(); ++currentPoolIndex) {
+        try {
+            std::vector result = (*device.get()).allocateDescriptorSets({ *pools[currentPoolIndex], layouts });
+            usage += requiredPoolSizes;
+            return result;
+        }
+        catch (const VULKAN_HPP_NAMESPACE::OutOfPoolMemoryError&) { }
+        catch (const VULKAN_HPP_NAMESPACE::FragmentedPoolError&) { }
+    }
+
+    // All pools are exhausted: create a new pool that can hold at least the usage so far and the current request.
+    // If this allocation still fails, the error is propagated to the caller.
+    const VULKAN_HPP_NAMESPACE::DescriptorPool pool = *pools.emplace_back(createPool(usage + requiredPoolSizes));
+    std::vector result = (*device.get()).allocateDescriptorSets({ pool, layouts });
+    usage += requiredPoolSizes;
+    return result;
+}
+
+void vku::DescriptorAllocator::reset() {
+    if (pools.size() > 1) {
+        // Collapse the chain into a single pool, therefore the next usage of the same amount only needs a single pool.
+        pools.clear();
+        pools.push_back(createPool(usage));
+    }
+    else if (!pools.empty()) {
+        pools.front().reset();
+    }
+
+    currentPoolIndex = 0;
+    usage = {};
+}
+
+auto vku::DescriptorAllocator::createPool(
+    const PoolSizes &poolSizes
+) const -> VULKAN_HPP_NAMESPACE::VULKAN_HPP_RAII_NAMESPACE::DescriptorPool {
+    return { device.get(), getMaxPoolSizes(initialPoolSizes, poolSizes).getDescriptorPoolCreateInfo(flags).get() };
+}
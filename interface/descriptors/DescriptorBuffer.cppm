@@ -0,0 +1,299 @@
+/** @file descriptors/DescriptorBuffer.cppm
+ */
+
+module;
+
+#include <cassert>
+
+#include <vulkan/vulkan_hpp_macros.hpp>
+
+export module vku:descriptors.DescriptorBuffer;
+
+import std;
+export import vulkan_hpp;
+export import :buffers.MappedBuffer;
+export import :descriptors.DescriptorSetLayout;
+import :details.concepts;
+
+// #define VMA_HPP_NAMESPACE to vma, if not defined.
+#ifndef VMA_HPP_NAMESPACE
+#define VMA_HPP_NAMESPACE vma
+#endif
+
+namespace vku {
+    /**
+     * @brief Host-visible descriptor buffer (<tt>VK_EXT_descriptor_buffer</tt>) that holds descriptor sets of a single
+     * layout. You should use <tt>vku::DescriptorBuffer<Layout></tt> for typed layouts.
+     */
+    export class DescriptorBufferBase : public MappedBuffer {
+    public:
+        /**
+         * @brief Number of descriptor sets that can be stored in this buffer.
+         */
+        std::uint32_t setCount;
+
+        /**
+         * @brief Byte stride between consecutive descriptor sets, aligned to <tt>descriptorBufferOffsetAlignment</tt>.
+         */
+        VULKAN_HPP_NAMESPACE::DeviceSize setStride;
+
+        DescriptorBufferBase(
+            const VULKAN_HPP_NAMESPACE::VULKAN_HPP_RAII_NAMESPACE::Device &device [[clang::lifetimebound]],
+            VMA_HPP_NAMESPACE::Allocator allocator,
+            const VULKAN_HPP_NAMESPACE::VULKAN_HPP_RAII_NAMESPACE::DescriptorSetLayout &layout,
+            std::uint32_t bindingCount,
+            const VULKAN_HPP_NAMESPACE::PhysicalDeviceDescriptorBufferPropertiesEXT &properties,
+            std::uint32_t setCount,
+            VULKAN_HPP_NAMESPACE::BufferUsageFlags usage
+        );
+
+        /**
+         * @brief Write descriptors into the descriptor set at \p setIndex with <tt>vkGetDescriptorEXT</tt>.
+         *
+         * It accepts the same <tt>vk::WriteDescriptorSet</tt>s for <tt>vkUpdateDescriptorSets</tt> (<tt>dstSet</tt> is
+         * ignored), therefore the descriptor writes from <tt>DescriptorSetLayout::getWrite<Binding></tt> can be used as is.
+         *
+         * @param setIndex Index of the descriptor set in this buffer.
+         * @param writes Descriptor writes.
+         * @throw std::runtime_error If a write has an unsupported descriptor type. The preceding writes are already applied.
+         * @note Buffer descriptor range must not be <tt>vk::WholeSize</tt>, as the buffer size cannot be queried from its handle.
+         * Texel buffer and dynamic buffer descriptors are not supported.
+         * @warning Buffer must be created with <tt>vk::BufferUsageFlagBits::eShaderDeviceAddress</tt> for buffer descriptors.
+         */
+        void update(std::uint32_t setIndex, VULKAN_HPP_NAMESPACE::ArrayProxy<const VULKAN_HPP_NAMESPACE::WriteDescriptorSet> writes);
+
+        /**
+         * @brief Get the binding info for <tt>vkCmdBindDescriptorBuffersEXT</tt>.
+         */
+        [[nodiscard]] auto getBindingInfo() const noexcept -> VULKAN_HPP_NAMESPACE::DescriptorBufferBindingInfoEXT {
+            return { deviceAddress, usage };
+        }
+
+        /**
+         * @brief Get the byte offset of the descriptor set at \p setIndex, for <tt>vkCmdSetDescriptorBufferOffsetsEXT</tt>.
+         */
+        [[nodiscard]] auto getOffset(std::uint32_t setIndex) const noexcept -> VULKAN_HPP_NAMESPACE::DeviceSize {
+            return setIndex * setStride;
+        }
+
+        /**
+         * @brief Bind the descriptor set at \p setIndex with <tt>vkCmdSetDescriptorBufferOffsetsEXT</tt>.
+         *
+         * @code{.cpp}
+         * cb.bindDescriptorBuffersEXT(descriptorBuffer.getBindingInfo(), *device.getDispatcher()); // descriptor buffer index 0.
+         * descriptorBuffer.bindSet(cb, vk::PipelineBindPoint::eCompute, *pipelineLayout, 0, 0, frameIndex);
+         * @endcode
+         * @param commandBuffer Command buffer to record.
+         * @param pipelineBindPoint Pipeline bind point.
+         * @param pipelineLayout Pipeline layout. Its descriptor set layouts must be created with <tt>vk::DescriptorSetLayoutCreateFlagBits::eDescriptorBufferEXT</tt>.
+         * @param set Set number to bind.
+         * @param bufferIndex Index of this buffer in the <tt>vkCmdBindDescriptorBuffersEXT</tt> call.
+         * @param setIndex Index of the descriptor set in this buffer.
+         * @note The command is dispatched through the dispatcher of the device passed at construction.
+         */
+        void bindSet(
+            VULKAN_HPP_NAMESPACE::CommandBuffer commandBuffer,
+            VULKAN_HPP_NAMESPACE::PipelineBindPoint pipelineBindPoint,
+            VULKAN_HPP_NAMESPACE::PipelineLayout pipelineLayout,
+            std::uint32_t set,
+            std::uint32_t bufferIndex,
+            std::uint32_t setIndex
+        ) const;
+
+    private:
+        std::reference_wrapper<const VULKAN_HPP_NAMESPACE::VULKAN_HPP_RAII_NAMESPACE::Device> device;
+        VULKAN_HPP_NAMESPACE::PhysicalDeviceDescriptorBufferPropertiesEXT properties;
+        VULKAN_HPP_NAMESPACE::BufferUsageFlags usage;
+        VULKAN_HPP_NAMESPACE::DeviceAddress deviceAddress;
+        std::vector<VULKAN_HPP_NAMESPACE::DeviceSize> bindingOffsets;
+
+        [[nodiscard]] auto getDescriptorSize(VULKAN_HPP_NAMESPACE::DescriptorType type) const noexcept -> std::size_t;
+    };
+
+    /**
+     * @brief Descriptor buffer that holds \p setCount descriptor sets of \p Layout, as a replacement of descriptor
+     * pool and descriptor sets.
+     *
+     * @code{.cpp}
+     * struct Layout : vku::DescriptorSetLayout<vk::DescriptorType::eStorageBuffer> { ... } layout; // created with vk::DescriptorSetLayoutCreateFlagBits::eDescriptorBufferEXT.
+     * vku::DescriptorBuffer descriptorBuffer { device, allocator, layout, descriptorBufferProperties, FRAMES_IN_FLIGHT };
+     *
+     * // Before: device.updateDescriptorSets({ descriptorSet.getWriteOne<0>({ buffer, 0, size }) }, {});
+     * descriptorBuffer.update(frameIndex, { Layout::getWriteOne<0>({ buffer, 0, size }) });
+     * @endcode
+     *
+     * @tparam Layout Descriptor set layout type.
+     * @note Device must be created with <tt>VK_EXT_descriptor_buffer</tt> and <tt>bufferDeviceAddress</tt> feature, and
+     * the VMA allocator must be created with <tt>vma::AllocatorCreateFlagBits::eBufferDeviceAddress</tt>.
+     */
+    export template <details::derived_from_value_specialization_of<DescriptorSetLayout> Layout>
+    class DescriptorBuffer : public DescriptorBufferBase {
+    public:
+        /**
+         * @brief Buffer usage flags required for storing descriptors of \p Layout.
+         */
+        static constexpr VULKAN_HPP_NAMESPACE::BufferUsageFlags requiredUsage = [] {
+            VULKAN_HPP_NAMESPACE::BufferUsageFlags result = VULKAN_HPP_NAMESPACE::BufferUsageFlagBits::eShaderDeviceAddress;
+            for (VULKAN_HPP_NAMESPACE::DescriptorType type : Layout::bindingTypes) {
+                if (type == VULKAN_HPP_NAMESPACE::DescriptorType::eSampler || type == VULKAN_HPP_NAMESPACE::DescriptorType::eCombinedImageSampler) {
+                    result |= VULKAN_HPP_NAMESPACE::BufferUsageFlagBits::eSamplerDescriptorBufferEXT;
+                }
+                if (type != VULKAN_HPP_NAMESPACE::DescriptorType::eSampler) {
+                    result |= VULKAN_HPP_NAMESPACE::BufferUsageFlagBits::eResourceDescriptorBufferEXT;
+                }
+            }
+            return result;
+        }();
+
+        /**
+         * @brief Create a descriptor buffer for \p setCount descriptor sets of \p layout.
+         * @param device Vulkan device.
+         * @param allocator VMA allocator.
+         * @param layout Descriptor set layout, created with <tt>vk::DescriptorSetLayoutCreateFlagBits::eDescriptorBufferEXT</tt>.
+         * @param properties Descriptor buffer properties of the physical device.
+         * @param setCount Number of descriptor sets.
+         */
+        DescriptorBuffer(
+            const VULKAN_HPP_NAMESPACE::VULKAN_HPP_RAII_NAMESPACE::Device &device [[clang::lifetimebound]],
+            VMA_HPP_NAMESPACE::Allocator allocator,
+            const Layout &layout,
+            const VULKAN_HPP_NAMESPACE::PhysicalDeviceDescriptorBufferPropertiesEXT &properties,
+            std::uint32_t setCount = 1
+        ) : DescriptorBufferBase { device, allocator, layout, Layout::bindingCount, properties, setCount, requiredUsage } { }
+
+        /**
+         * @brief Typed version of <tt>update</tt>, same as <tt>DescriptorSet<Layout>::getWrite<Binding></tt>.
+         * @tparam Binding Binding index to write.
+         * @param setIndex Index of the descriptor set in this buffer.
+         * @param descriptorInfos Descriptor infos to write.
+         */
+        template <std::uint32_t Binding>
+        void write(
+            std::uint32_t setIndex,
+            const VULKAN_HPP_NAMESPACE::ArrayProxyNoTemporaries<const WriteDescriptorInfo_t<get<Binding>(Layout::bindingTypes)>> &descriptorInfos
+        ) {
+            update(setIndex, Layout::template getWrite<Binding>(descriptorInfos));
+        }
+    };
+}
+
+// --------------------
+// Implementations.
+// --------------------
+
+[[nodiscard]] constexpr VULKAN_HPP_NAMESPACE::DeviceSize alignDescriptorBufferOffset(VULKAN_HPP_NAMESPACE::DeviceSize offset, VULKAN_HPP_NAMESPACE::DeviceSize alignment) noexcept {
+    return (offset + alignment - 1) / alignment * alignment;
+}
+
+vku::DescriptorBufferBase::DescriptorBufferBase(
+    const VULKAN_HPP_NAMESPACE::VULKAN_HPP_RAII_NAMESPACE::Device &device,
+    VMA_HPP_NAMESPACE::Allocator allocator,
+    const VULKAN_HPP_NAMESPACE::VULKAN_HPP_RAII_NAMESPACE::DescriptorSetLayout &layout,
+    std::uint32_t bindingCount,
+    const VULKAN_HPP_NAMESPACE::PhysicalDeviceDescriptorBufferPropertiesEXT &properties,
+    std::uint32_t setCount,
+    VULKAN_HPP_NAMESPACE::BufferUsageFlags usage
+) : MappedBuffer { allocator, VULKAN_HPP_NAMESPACE::BufferCreateInfo {
+        {},
+        setCount * alignDescriptorBufferOffset(layout.getSizeEXT(), properties.descriptorBufferOffsetAlignment),
+        usage,
+    } },
+    setCount { setCount },
+    setStride { alignDescriptorBufferOffset(layout.getSizeEXT(), properties.descriptorBufferOffsetAlignment) },
+    device { device },
+    properties { properties },
+    usage { usage },
+    deviceAddress { device.getBufferAddress({ buffer }) } {
+    this->properties.pNext = nullptr;
+
+    bindingOffsets.reserve(bindingCount);
+    for (std::uint32_t binding = 0; binding < bindingCount; ++binding) {
+        bindingOffsets.push_back(layout.getBindingOffsetEXT(binding));
+    }
+}
+
+void vku::DescriptorBufferBase::update(
+    std::uint32_t setIndex,
+    VULKAN_HPP_NAMESPACE::ArrayProxy<const VULKAN_HPP_NAMESPACE::WriteDescriptorSet> writes
+) {
+    assert(setIndex < setCount && "Descriptor set index out of range");
+
+    for (const VULKAN_HPP_NAMESPACE::WriteDescriptorSet &write : writes) {
+        const std::size_t descriptorSize = getDescriptorSize(write.descriptorType);
+        std::byte *const pBinding = static_cast<std::byte*>(data) + getOffset(setIndex) + bindingOffsets[write.dstBinding];
+
+        for (std::uint32_t i = 0; i < write.descriptorCount; ++i) {
+            VULKAN_HPP_NAMESPACE::DescriptorGetInfoEXT getInfo { write.descriptorType };
+            VULKAN_HPP_NAMESPACE::DescriptorAddressInfoEXT addressInfo;
+            switch (write.descriptorType) {
+                case VULKAN_HPP_NAMESPACE::DescriptorType::eSampler:
+                    getInfo.data.pSampler = &write.pImageInfo[i].sampler;
+                    break;
+                case VULKAN_HPP_NAMESPACE::DescriptorType::eCombinedImageSampler:
+                    getInfo.data.pCombinedImageSampler = &write.pImageInfo[i];
+                    break;
+                case VULKAN_HPP_NAMESPACE::DescriptorType::eSampledImage:
+                    getInfo.data.pSampledImage = &write.pImageInfo[i];
+                    break;
+                case VULKAN_HPP_NAMESPACE::DescriptorType::eStorageImage:
+                    getInfo.data.pStorageImage = &write.pImageInfo[i];
+                    break;
+                case VULKAN_HPP_NAMESPACE::DescriptorType::eInputAttachment:
+                    getInfo.data.pInputAttachmentImage = &write.pImageInfo[i];
+                    break;
+                case VULKAN_HPP_NAMESPACE::DescriptorType::eUniformBuffer:
+                case VULKAN_HPP_NAMESPACE::DescriptorType::eStorageBuffer: {
+                    const VULKAN_HPP_NAMESPACE::DescriptorBufferInfo &bufferInfo = write.pBufferInfo[i];
+                    assert(bufferInfo.range != VULKAN_HPP_NAMESPACE::WholeSize && "Buffer descriptor range must be explicitly specified");
+                    addressInfo.address = device.get().getBufferAddress({ bufferInfo.buffer }) + bufferInfo.offset;
+                    addressInfo.range = bufferInfo.range;
+                    if (write.descriptorType == VULKAN_HPP_NAMESPACE::DescriptorType::eUniformBuffer) {
+                        getInfo.data.pUniformBuffer = &addressInfo;
+                    }
+                    else {
+                        getInfo.data.pStorageBuffer = &addressInfo;
+                    }
+                    break;
+                }
+                default:
+                    throw std::runtime_error { "Unsupported descriptor type for descriptor buffer" };
+            }
+
+            device.get().getDescriptorEXT(getInfo, descriptorSize, pBinding + (write.dstArrayElement + i) * descriptorSize);
+        }
+    }
+}
+
+void vku::DescriptorBufferBase::bindSet(
+    VULKAN_HPP_NAMESPACE::CommandBuffer commandBuffer,
+    VULKAN_HPP_NAMESPACE::PipelineBindPoint pipelineBindPoint,
+    VULKAN_HPP_NAMESPACE::PipelineLayout pipelineLayout,
+    std::uint32_t set,
+    std::uint32_t bufferIndex,
+    std::uint32_t setIndex
+) const {
+    commandBuffer.setDescriptorBufferOffsetsEXT(pipelineBindPoint, pipelineLayout, set, bufferIndex, getOffset(setIndex), *device.get().getDispatcher());
+}
+
+auto vku::DescriptorBufferBase::getDescriptorSize(
+    VULKAN_HPP_NAMESPACE::DescriptorType type
+) const noexcept -> std::size_t {
+    switch (type) {
+        case VULKAN_HPP_NAMESPACE::DescriptorType::eSampler:
+            return properties.samplerDescriptorSize;
+        case VULKAN_HPP_NAMESPACE::DescriptorType::eCombinedImageSampler:
+            return properties.combinedImageSamplerDescriptorSize;
+        case VULKAN_HPP_NAMESPACE::DescriptorType::eSampledImage:
+            return properties.sampledImageDescriptorSize;
+        case VULKAN_HPP_NAMESPACE::DescriptorType::eStorageImage:
+            return properties.storageImageDescriptorSize;
+        case VULKAN_HPP_NAMESPACE::DescriptorType::eInputAttachment:
+            return properties.inputAttachmentDescriptorSize;
+        case VULKAN_HPP_NAMESPACE::DescriptorType::eUniformBuffer:
+            return properties.uniformBufferDescriptorSize;
+        case VULKAN_HPP_NAMESPACE::DescriptorType::eStorageBuffer:
+            return properties.storageBufferDescriptorSize;
+        default:
+            return 0;
+    }
+}
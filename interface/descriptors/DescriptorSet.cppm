@@ -9,6 +9,7 @@ export module vku:descriptors.DescriptorSet;
 
 import std;
 export import :descriptors.DescriptorSetLayout;
+export import :descriptors.DescriptorUpdateTemplate;
 import :details.concepts;
 import :utils;
 
@@ -55,6 +56,30 @@ namespace vku {
             return getWrite<Binding>(descriptorInfo);
         }
 
+        /**
+         * @brief Update the descriptor set with a single <tt>vkUpdateDescriptorSetWithTemplate</tt> call.
+         *
+         * @code{.cpp}
+         * struct Layout : vku::DescriptorSetLayout<vk::DescriptorType::eStorageBuffer, vk::DescriptorType::eStorageImage> { ... } layout;
+         * const vku::DescriptorUpdateTemplate updateTemplate { device, layout };
+         *
+         * descriptorSet.update(*device, updateTemplate, {
+         *     vk::DescriptorBufferInfo { buffer, 0, vk::WholeSize },
+         *     vk::DescriptorImageInfo { {}, imageView, vk::ImageLayout::eGeneral },
+         * });
+         * @endcode
+         * @param device Vulkan device.
+         * @param updateTemplate Descriptor update template created from the layout of this descriptor set.
+         * @param data Descriptor infos for each binding.
+         */
+        void update(
+            VULKAN_HPP_NAMESPACE::Device device,
+            const DescriptorUpdateTemplate<Layout> &updateTemplate,
+            const DescriptorUpdateData_t<Layout> &data
+        ) const noexcept {
+            device.updateDescriptorSetWithTemplate(*this, *updateTemplate, &data);
+        }
+
         template <details::derived_from_value_specialization_of<DescriptorSetLayout>... Layouts>
         friend auto allocateDescriptorSets(VULKAN_HPP_NAMESPACE::Device, VULKAN_HPP_NAMESPACE::DescriptorPool, const std::tuple<Layouts...> &layouts) -> std::tuple<DescriptorSet<std::remove_cvref_t<Layouts>>...>;
     };
@@ -64,6 +64,7 @@ namespace vku {
             std::uint32_t descriptorCount;
             VULKAN_HPP_NAMESPACE::ShaderStageFlags stageFlags;
             const VULKAN_HPP_NAMESPACE::Sampler *pImmutableSamplers;
+            VULKAN_HPP_NAMESPACE::DescriptorBindingFlags flags = {};
         };
 
         /**
@@ -89,7 +90,17 @@ namespace vku {
         DescriptorSetLayout(
             const VULKAN_HPP_NAMESPACE::VULKAN_HPP_RAII_NAMESPACE::Device &device [[clang::lifetimebound]],
             const VULKAN_HPP_NAMESPACE::DescriptorSetLayoutCreateInfo &createInfo
-        ) : VULKAN_HPP_NAMESPACE::VULKAN_HPP_RAII_NAMESPACE::DescriptorSetLayout { device, createInfo } {
+        ) : DescriptorSetLayout { VULKAN_HPP_NAMESPACE::VULKAN_HPP_RAII_NAMESPACE::DescriptorSetLayout { device, createInfo }, createInfo } { }
+
+        /**
+         * @brief Take the ownership of the RAII descriptor set layout \p layout, which was created with \p createInfo.
+         * @param layout RAII descriptor set layout.
+         * @param createInfo Descriptor set layout create info used for \p layout creation. Its bindings must match the template parameter count and types.
+         */
+        DescriptorSetLayout(
+            VULKAN_HPP_NAMESPACE::VULKAN_HPP_RAII_NAMESPACE::DescriptorSetLayout &&layout,
+            const VULKAN_HPP_NAMESPACE::DescriptorSetLayoutCreateInfo &createInfo
+        ) : VULKAN_HPP_NAMESPACE::VULKAN_HPP_RAII_NAMESPACE::DescriptorSetLayout { std::move(layout) } {
             assert(createInfo.bindingCount == bindingCount && "The binding count must match the template parameter count.");
             INDEX_SEQ(Is, bindingCount, {
                 assert(((createInfo.pBindings[Is].descriptorType == BindingTypes) && ...) && "The descriptor types must match the template parameter.");
@@ -127,6 +138,38 @@ namespace vku {
             });
         }
 
+        /**
+         * @brief Create binding flags array from the binding infos, for <tt>vk::DescriptorSetLayoutBindingFlagsCreateInfo</tt>.
+         *
+         * @code{.cpp}
+         * struct BindlessLayout : vku::DescriptorSetLayout<vk::DescriptorType::eSampledImage> {
+         *     static constexpr BindingInfo<vk::DescriptorType::eSampledImage> bindingInfo {
+         *         4096, vk::ShaderStageFlagBits::eFragment, nullptr,
+         *         vk::DescriptorBindingFlagBits::eUpdateAfterBind | vk::DescriptorBindingFlagBits::ePartiallyBound,
+         *     };
+         *
+         *     explicit BindlessLayout(const vk::raii::Device &device)
+         *         : DescriptorSetLayout { device, vk::StructureChain {
+         *             vk::DescriptorSetLayoutCreateInfo {
+         *                 vk::DescriptorSetLayoutCreateFlagBits::eUpdateAfterBindPool,
+         *                 vku::unsafeProxy(getBindings(bindingInfo)),
+         *             },
+         *             vk::DescriptorSetLayoutBindingFlagsCreateInfo {
+         *                 vku::unsafeProxy(getBindingFlags(bindingInfo)),
+         *             },
+         *         }.get() } { }
+         * };
+         * @endcode
+         *
+         * @param bindingInfos Binding infos for each binding. These will be applied with index starts from zero.
+         * @return Array of vk::DescriptorBindingFlags with the specified binding infos.
+         */
+        [[nodiscard]] static constexpr std::array<VULKAN_HPP_NAMESPACE::DescriptorBindingFlags, bindingCount> getBindingFlags(
+            const BindingInfo<BindingTypes> &...bindingInfos
+        ) noexcept {
+            return { bindingInfos.flags... };
+        }
+
         /**
          * @brief PoolSizes that allocating a single descriptor set with this layout requires.
          *
@@ -182,6 +225,51 @@ namespace vku {
         ) noexcept {
             return getWrite<Binding>(descriptorInfo);
         }
+
+        /**
+         * @brief Record the descriptors of \p Bindings into \p commandBuffer with <tt>vkCmdPushDescriptorSetKHR</tt>,
+         * without any descriptor pool and descriptor set.
+         *
+         * The layout must be created with <tt>vk::DescriptorSetLayoutCreateFlagBits::ePushDescriptorKHR</tt>, and the
+         * device must be created with <tt>VK_KHR_push_descriptor</tt> extension.
+         *
+         * @code{.cpp}
+         * struct Layout : vku::DescriptorSetLayout<vk::DescriptorType::eUniformBuffer, vk::DescriptorType::eCombinedImageSampler> {
+         *     explicit Layout(const vk::raii::Device &device)
+         *         : DescriptorSetLayout { device, vk::DescriptorSetLayoutCreateInfo {
+         *             vk::DescriptorSetLayoutCreateFlagBits::ePushDescriptorKHR,
+         *             vku::unsafeProxy(getBindings({ 1, vk::ShaderStageFlagBits::eVertex }, { 1, vk::ShaderStageFlagBits::eFragment })),
+         *         } } { }
+         * };
+         *
+         * // Per-draw bindings. Descriptor info types are inferred at the compile time.
+         * Layout::cmdPushDescriptorSet<0, 1>(
+         *     device, cb, vk::PipelineBindPoint::eGraphics, *pipelineLayout, 0,
+         *     vk::DescriptorBufferInfo { uniformBuffer, drawIndex * sizeof(DrawData), sizeof(DrawData) },
+         *     vk::DescriptorImageInfo { {}, *textureView, vk::ImageLayout::eShaderReadOnlyOptimal });
+         * @endcode
+         *
+         * @tparam Bindings Binding indices to push.
+         * @param device Vulkan-Hpp RAII device whose dispatcher is used for recording <tt>vkCmdPushDescriptorSetKHR</tt>.
+         * @param commandBuffer Command buffer to record.
+         * @param pipelineBindPoint Pipeline bind point.
+         * @param pipelineLayout Pipeline layout that is compatible with this layout at \p set.
+         * @param set Set number to push.
+         * @param descriptorInfos Descriptor infos for each binding in \p Bindings.
+         */
+        template <std::uint32_t... Bindings>
+        static void cmdPushDescriptorSet(
+            const VULKAN_HPP_NAMESPACE::VULKAN_HPP_RAII_NAMESPACE::Device &device,
+            VULKAN_HPP_NAMESPACE::CommandBuffer commandBuffer,
+            VULKAN_HPP_NAMESPACE::PipelineBindPoint pipelineBindPoint,
+            VULKAN_HPP_NAMESPACE::PipelineLayout pipelineLayout,
+            std::uint32_t set,
+            VULKAN_HPP_NAMESPACE::ArrayProxy<const WriteDescriptorInfo_t<get<Bindings>(bindingTypes)>> ...descriptorInfos
+        ) {
+            commandBuffer.pushDescriptorSetKHR(pipelineBindPoint, pipelineLayout, set, std::array {
+                getWrite<Bindings>({ descriptorInfos.size(), descriptorInfos.data() })...
+            }, *device.getDispatcher());
+        }
     };
 
     /**
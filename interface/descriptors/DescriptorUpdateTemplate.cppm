@@ -0,0 +1,94 @@
+/** @file descriptors/DescriptorUpdateTemplate.cppm
+ */
+
+module;
+
+#include <vulkan/vulkan_hpp_macros.hpp>
+
+export module vku:descriptors.DescriptorUpdateTemplate;
+
+import std;
+export import vulkan_hpp;
+export import :descriptors.DescriptorSetLayout;
+import :details.concepts;
+import :utils;
+
+#define INDEX_SEQ(Is, N, ...) [&]<std::size_t ...Is>(std::index_sequence<Is...>) __VA_ARGS__ (std::make_index_sequence<N>{})
+
+template <typename Layout, typename = std::make_index_sequence<Layout::bindingCount>>
+struct DescriptorUpdateData;
+
+template <typename Layout, std::size_t... Is>
+struct DescriptorUpdateData<Layout, std::index_sequence<Is...>> {
+    using type = std::tuple<WriteDescriptorInfo_t<get<Is>(Layout::bindingTypes)>...>;
+};
+
+namespace vku {
+    /**
+     * @brief Host data type for updating a descriptor set of \p Layout with <tt>vku::DescriptorUpdateTemplate<Layout></tt>.
+     *
+     * It is a tuple of the descriptor infos, whose <tt>I</tt>-th element is a descriptor info for the <tt>I</tt>-th binding
+     * (<tt>vk::DescriptorBufferInfo</tt>, <tt>vk::DescriptorImageInfo</tt> or <tt>vk::BufferView</tt>, based on its
+     * descriptor type).
+     */
+    export template <details::derived_from_value_specialization_of<DescriptorSetLayout> Layout>
+    using DescriptorUpdateData_t = typename DescriptorUpdateData<Layout>::type;
+
+    /**
+     * @brief Owning descriptor update template generated from the binding types of \p Layout.
+     *
+     * The template updates the first descriptor of every binding from a <tt>vku::DescriptorUpdateData_t<Layout></tt>
+     * object with a single <tt>vkUpdateDescriptorSetWithTemplate</tt> call, without any <tt>vk::WriteDescriptorSet</tt>
+     * struct.
+     *
+     * @code{.cpp}
+     * struct Layout : vku::DescriptorSetLayout<vk::DescriptorType::eUniformBuffer, vk::DescriptorType::eCombinedImageSampler> { ... } layout;
+     * const vku::DescriptorUpdateTemplate updateTemplate { device, layout };
+     *
+     * descriptorSet.update(*device, updateTemplate, {
+     *     vk::DescriptorBufferInfo { buffer, 0, vk::WholeSize },
+     *     vk::DescriptorImageInfo { sampler, imageView, vk::ImageLayout::eShaderReadOnlyOptimal },
+     * });
+     * @endcode
+     *
+     * @tparam Layout Descriptor set layout type.
+     * @note For a binding with multiple descriptors, only the first descriptor is updated. Use <tt>getWrite<Binding></tt>
+     * to update the other descriptors.
+     */
+    export template <details::derived_from_value_specialization_of<DescriptorSetLayout> Layout>
+    class DescriptorUpdateTemplate : public VULKAN_HPP_NAMESPACE::VULKAN_HPP_RAII_NAMESPACE::DescriptorUpdateTemplate {
+    public:
+        using Data = DescriptorUpdateData_t<Layout>;
+
+        /**
+         * @brief Create a descriptor update template for the descriptor sets allocated with \p layout.
+         * @param device Vulkan device. Vulkan 1.1 or <tt>VK_KHR_descriptor_update_template</tt> extension is required.
+         * @param layout Descriptor set layout.
+         */
+        DescriptorUpdateTemplate(
+            const VULKAN_HPP_NAMESPACE::VULKAN_HPP_RAII_NAMESPACE::Device &device [[clang::lifetimebound]],
+            const Layout &layout
+        ) : VULKAN_HPP_NAMESPACE::VULKAN_HPP_RAII_NAMESPACE::DescriptorUpdateTemplate { device, VULKAN_HPP_NAMESPACE::DescriptorUpdateTemplateCreateInfo {
+                {},
+                unsafeProxy(getEntries()),
+                VULKAN_HPP_NAMESPACE::DescriptorUpdateTemplateType::eDescriptorSet,
+                *layout,
+            } } { }
+
+        /**
+         * @brief Get the descriptor update template entries, whose offsets are pointing the elements of <tt>Data</tt>.
+         * @return Array of <tt>vk::DescriptorUpdateTemplateEntry</tt>.
+         */
+        [[nodiscard]] static auto getEntries() noexcept -> std::array<VULKAN_HPP_NAMESPACE::DescriptorUpdateTemplateEntry, Layout::bindingCount> {
+            // std::tuple layout is implementation-defined, therefore offsets are measured from an actual object.
+            static const Data data {};
+            return INDEX_SEQ(Is, Layout::bindingCount, {
+                return std::array { VULKAN_HPP_NAMESPACE::DescriptorUpdateTemplateEntry {
+                    Is, 0, 1, get<Is>(Layout::bindingTypes),
+                    static_cast<std::size_t>(reinterpret_cast<const std::byte*>(&get<Is>(data)) - reinterpret_cast<const std::byte*>(&data)),
+                    sizeof(std::tuple_element_t<Is, Data>),
+                }... };
+            });
+        }
+    };
+}
@@ -20,6 +20,8 @@ namespace vku {
         PoolSizes() noexcept = default;
         PoolSizes(const PoolSizes&) noexcept = default;
         PoolSizes(PoolSizes&&) noexcept = default;
+        auto operator=(const PoolSizes&) noexcept -> PoolSizes& = default;
+        auto operator=(PoolSizes&&) noexcept -> PoolSizes& = default;
 
         // Addition/scalar multiplication operators.
         [[nodiscard]] auto operator+(PoolSizes rhs) const noexcept -> PoolSizes;
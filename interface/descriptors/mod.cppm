@@ -4,6 +4,10 @@
 module;
 
 export module vku:descriptors;
+export import :descriptors.BindlessDescriptorHeap;
+export import :descriptors.DescriptorAllocator;
+export import :descriptors.DescriptorBuffer;
 export import :descriptors.DescriptorSetLayout;
 export import :descriptors.DescriptorSet;
+export import :descriptors.DescriptorUpdateTemplate;
 export import :descriptors.PoolSizes;
\ No newline at end of file
@@ -0,0 +1,73 @@
+/** @file details/container/StaticVector.cppm
+ */
+
+export module vku:details.container.StaticVector;
+
+import std;
+
+#define FWD(...) static_cast<decltype(__VA_ARGS__)&&>(__VA_ARGS__)
+
+namespace details {
+    /**
+     * A contiguous container with fixed capacity \p N, whose elements are stored inline (no heap allocation).
+     *
+     * Unlike <tt>std::vector</tt>, pointers to the elements are invalidated when the container is moved, therefore it
+     * must not be moved after the pointers to its elements are handed out.
+     * @tparam T Element type. It must be default constructible, as the storage is a <tt>std::array<T, N></tt>.
+     * @tparam N Maximum number of elements.
+     */
+    export template <std::default_initializable T, std::size_t N>
+    class StaticVector {
+    public:
+        using value_type = T;
+        using size_type = std::size_t;
+        using iterator = T*;
+        using const_iterator = const T*;
+
+        constexpr StaticVector() noexcept(std::is_nothrow_default_constructible_v<T>) = default;
+
+        /**
+         * @brief Construct an element at the end.
+         * @throw std::length_error If the container is full.
+         */
+        template <typename... Args>
+        constexpr auto emplace_back(Args &&...args) -> T& {
+            if (count == N) {
+                throw std::length_error { "StaticVector capacity exceeded" };
+            }
+            return storage[count++] = T { FWD(args)... };
+        }
+
+        /**
+         * @brief Copy \p value at the end.
+         * @throw std::length_error If the container is full.
+         */
+        constexpr auto push_back(const T &value) -> T& {
+            if (count == N) {
+                throw std::length_error { "StaticVector capacity exceeded" };
+            }
+            return storage[count++] = value;
+        }
+
+        constexpr void clear() noexcept { count = 0; }
+
+        [[nodiscard]] constexpr auto size() const noexcept -> size_type { return count; }
+        [[nodiscard]] constexpr auto empty() const noexcept -> bool { return count == 0; }
+        [[nodiscard]] static constexpr auto capacity() noexcept -> size_type { return N; }
+
+        [[nodiscard]] constexpr auto data() noexcept -> T* { return storage.data(); }
+        [[nodiscard]] constexpr auto data() const noexcept -> const T* { return storage.data(); }
+
+        [[nodiscard]] constexpr auto begin() noexcept -> iterator { return storage.data(); }
+        [[nodiscard]] constexpr auto begin() const noexcept -> const_iterator { return storage.data(); }
+        [[nodiscard]] constexpr auto end() noexcept -> iterator { return storage.data() + count; }
+        [[nodiscard]] constexpr auto end() const noexcept -> const_iterator { return storage.data() + count; }
+
+        [[nodiscard]] constexpr auto operator[](size_type index) noexcept -> T& { return storage[index]; }
+        [[nodiscard]] constexpr auto operator[](size_type index) const noexcept -> const T& { return storage[index]; }
+
+    private:
+        std::array<T, N> storage{};
+        size_type count = 0;
+    };
+}
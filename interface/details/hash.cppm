@@ -0,0 +1,25 @@
+/** @file details/hash.cppm
+ */
+
+export module vku:details.hash;
+
+import std;
+
+namespace details {
+    /**
+     * @brief Combine the hash of \p value into \p seed (same as <tt>boost::hash_combine</tt>).
+     * @param seed Hash seed to be updated.
+     * @param value Value to be hashed. If it is an enum, its underlying value is hashed.
+     */
+    export template <typename T>
+    void hash_combine(std::size_t &seed, const T &value) noexcept {
+        std::size_t hash;
+        if constexpr (std::is_enum_v<T>) {
+            hash = std::hash<std::underlying_type_t<T>>{}(std::to_underlying(value));
+        }
+        else {
+            hash = std::hash<T>{}(value);
+        }
+        seed ^= hash + 0x9e3779b9 + (seed << 6) + (seed >> 2);
+    }
+}
@@ -10,4 +10,83 @@ namespace details {
     [[nodiscard]] auto to_string(std::source_location srcLoc) noexcept -> std::string {
         return std::format("{}:{}:{}", srcLoc.file_name(), srcLoc.line(), srcLoc.column());
     }
-}
\ No newline at end of file
+
+    /**
+     * @brief Null-terminated <tt>file:line:column</tt> string of a source location, formatted at compile time.
+     *
+     * Unlike <tt>to_string(std::source_location)</tt>, constructing this does not allocate: the characters are
+     * computed during the constant evaluation and stored inline. If the formatted string exceeds \p capacity, the
+     * leading part of the file path is dropped.
+     */
+    export struct SourceLocationName {
+        static constexpr std::size_t capacity = 255;
+
+        std::array<char, capacity + 1> data{};
+        std::size_t length = 0;
+
+        consteval SourceLocationName(std::source_location srcLoc) noexcept {
+            // Format ":line:column" suffix first, to know how many characters remain for the file path.
+            std::array<char, 24> suffix{};
+            std::size_t suffixLength = 0;
+            const auto appendNumber = [&](std::uint_least32_t n) {
+                std::array<char, 10> digits{};
+                std::size_t digitCount = 0;
+                do {
+                    digits[digitCount++] = static_cast<char>('0' + n % 10);
+                    n /= 10;
+                } while (n != 0);
+                while (digitCount != 0) {
+                    suffix[suffixLength++] = digits[--digitCount];
+                }
+            };
+            suffix[suffixLength++] = ':';
+            appendNumber(srcLoc.line());
+            suffix[suffixLength++] = ':';
+            appendNumber(srcLoc.column());
+
+            std::string_view fileName = srcLoc.file_name();
+            fileName.remove_prefix(fileName.size() - std::min(fileName.size(), capacity - suffixLength));
+
+            const auto it = std::ranges::copy(fileName, data.begin()).out;
+            std::ranges::copy(suffix.begin(), suffix.begin() + suffixLength, it);
+            length = fileName.size() + suffixLength;
+        }
+
+        [[nodiscard]] constexpr auto c_str() const noexcept -> const char* {
+            return data.data();
+        }
+
+        [[nodiscard]] constexpr auto view() const noexcept -> std::string_view {
+            return { data.data(), length };
+        }
+
+        /**
+         * @brief 64-bit FNV-1a hash of the string, usable as a stable numeric identifier (e.g. debug utils tag name).
+         */
+        [[nodiscard]] constexpr auto hash() const noexcept -> std::uint64_t {
+            std::uint64_t result = 0xCBF29CE484222325ULL;
+            for (char c : view()) {
+                result ^= static_cast<unsigned char>(c);
+                result *= 0x100000001B3ULL;
+            }
+            return result;
+        }
+    };
+
+    /**
+     * @brief Copy \p name into the static storage, and get its null-terminated string that is valid for the whole
+     * program. The same names share the storage, therefore the storage grows only by the number of distinct call sites.
+     *
+     * It is for the names that must outlive the call, since a <tt>SourceLocationName</tt> parameter (which must be
+     * defaulted to <tt>std::source_location::current()</tt> to get the caller's location) is destroyed after the call.
+     */
+    export
+    [[nodiscard]] auto intern(const SourceLocationName &name) -> const char* {
+        static std::mutex mutex;
+        // Node-based container, whose elements are never relocated.
+        static std::unordered_set<std::string> names;
+
+        std::scoped_lock lock { mutex };
+        return names.emplace(name.view()).first->c_str();
+    }
+}
@@ -3,6 +3,7 @@
 
 export module vku;
 export import :buffers;
+export import :caches;
 export import :constants;
 export import :debugging;
 export import :descriptors;
@@ -10,6 +11,10 @@ export import :Gpu;
 export import :commands;
 export import :images;
 export import :pipelines;
+export import :profiling;
 export import :queue;
 export import :rendering;
+export import :submission;
+export import :sync;
+export import :TransferUploader;
 export import :utils;
\ No newline at end of file
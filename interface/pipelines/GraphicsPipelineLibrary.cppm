@@ -0,0 +1,290 @@
+/** @file pipelines/GraphicsPipelineLibrary.cppm
+ */
+
+module;
+
+#include <vulkan/vulkan_hpp_macros.hpp>
+
+export module vku:pipelines.GraphicsPipelineLibrary;
+
+import std;
+export import vulkan_hpp;
+import :details.hash;
+import :pipelines.PipelineBuildQueue;
+
+#define FWD(...) static_cast<decltype(__VA_ARGS__)&&>(__VA_ARGS__)
+
+/**
+ * @brief Get <tt>vk::GraphicsPipelineCreateInfo</tt> from \p createInfo, which is either convertible to it or has
+ * <tt>get()</tt> method returning it (such as <tt>vku::RefHolder</tt> and <tt>vk::StructureChain</tt>).
+ */
+template <typename R>
+[[nodiscard]] auto getGraphicsPipelineCreateInfo(const R &createInfo) noexcept -> const VULKAN_HPP_NAMESPACE::GraphicsPipelineCreateInfo& {
+    if constexpr (std::convertible_to<const R&, const VULKAN_HPP_NAMESPACE::GraphicsPipelineCreateInfo&>) {
+        return createInfo;
+    }
+    else {
+        static_assert(requires { createInfo.get(); }, "Factory must return graphics pipeline create info, or the object that has get() method returning it.");
+        return getGraphicsPipelineCreateInfo(createInfo.get());
+    }
+}
+
+namespace vku {
+    /**
+     * @brief Cache of <tt>VK_EXT_graphics_pipeline_library</tt> parts and their linker.
+     *
+     * Each part (vertex input interface, pre-rasterization shaders, fragment shader and fragment output interface) is
+     * cached independently with a user-provided key, so that a new combination of the parts only requires the fast link
+     * instead of the whole pipeline compilation. If <tt>vku::PipelineBuildQueue</tt> is given, the link time optimized
+     * pipeline is compiled in the background and swapped in when ready.
+     *
+     * Parts must be created with <tt>vk::PipelineCreateFlagBits::eRetainLinkTimeOptimizationInfoEXT</tt> for the optimized
+     * link, which is already set in <tt>vku::getDefault{VertexInputInterface,PreRasterizationShaders,FragmentShader,FragmentOutputInterface}CreateInfo</tt>.
+     *
+     * Member functions except <tt>clear()</tt> are thread-safe.
+     *
+     * @code{.cpp}
+     * vku::GraphicsPipelineLibrary pipelineLibrary { gpu.device, &gpu.pipelineCache, &buildQueue };
+     * const vk::Pipeline fragmentShader = pipelineLibrary.getPart(
+     *     vk::GraphicsPipelineLibraryFlagBitsEXT::eFragmentShader, materialHash,
+     *     [&] {
+     *         return vku::RefHolder {
+     *             [&](const auto &stages) {
+     *                 return vk::StructureChain {
+     *                     vku::getDefaultFragmentShaderCreateInfo(stages.get(), *pipelineLayout, true),
+     *                     vk::GraphicsPipelineLibraryCreateInfoEXT { vk::GraphicsPipelineLibraryFlagBitsEXT::eFragmentShader },
+     *                     vk::PipelineRenderingCreateInfo { {}, colorFormats, depthFormat },
+     *                 };
+     *             },
+     *             vku::createPipelineStages(gpu.device, vku::Shader::fromSpirvFile(materialPath, vk::ShaderStageFlagBits::eFragment)),
+     *         };
+     *     }); // Factory is invoked only if the part with materialHash is not cached.
+     * ...
+     * vku::GraphicsPipelineLibrary::LinkedPipeline pipeline = pipelineLibrary.link(
+     *     { vertexInputInterface, preRasterizationShaders, fragmentShader, fragmentOutputInterface },
+     *     *pipelineLayout);
+     *
+     * // In each frame.
+     * cb.bindPipeline(vk::PipelineBindPoint::eGraphics, pipeline.get()); // Optimized pipeline is used when ready.
+     * @endcode
+     */
+    export class GraphicsPipelineLibrary {
+    public:
+        /**
+         * @brief Fast-linked pipeline that is replaced by the link time optimized pipeline when its background compilation
+         * is finished.
+         *
+         * The fast-linked pipeline is kept alive until this object is destroyed, as it may be still in use by the
+         * command buffers that are recorded before the swap.
+         */
+        class LinkedPipeline {
+        public:
+            LinkedPipeline(VULKAN_HPP_NAMESPACE::VULKAN_HPP_RAII_NAMESPACE::Pipeline fastLinked, std::future<VULKAN_HPP_NAMESPACE::VULKAN_HPP_RAII_NAMESPACE::Pipeline> optimizedFuture) noexcept;
+
+            /**
+             * @brief Get the pipeline handle to be bound.
+             *
+             * It checks the background compilation without blocking, and returns the optimized pipeline if it is ready,
+             * otherwise the fast-linked one. If the optimized compilation failed, the fast-linked pipeline is used
+             * permanently, and the exception is stored to <tt>getOptimizationError()</tt> instead of being thrown.
+             *
+             * @return Pipeline handle.
+             */
+            [[nodiscard]] auto get() -> VULKAN_HPP_NAMESPACE::Pipeline;
+
+            /**
+             * @brief Whether the link time optimized pipeline is swapped in.
+             */
+            [[nodiscard]] bool isOptimized() const noexcept;
+
+            /**
+             * @brief Exception thrown by the optimized compilation, or <tt>nullptr</tt> if it is not failed (or not
+             * checked by <tt>get()</tt> yet). Use <tt>std::rethrow_exception</tt> to inspect it.
+             */
+            [[nodiscard]] auto getOptimizationError() const noexcept -> std::exception_ptr;
+
+        private:
+            VULKAN_HPP_NAMESPACE::VULKAN_HPP_RAII_NAMESPACE::Pipeline fastLinked;
+            std::future<VULKAN_HPP_NAMESPACE::VULKAN_HPP_RAII_NAMESPACE::Pipeline> optimizedFuture;
+            std::optional<VULKAN_HPP_NAMESPACE::VULKAN_HPP_RAII_NAMESPACE::Pipeline> optimized;
+            std::exception_ptr optimizationError;
+        };
+
+        /**
+         * @param device Vulkan device.
+         * @param pipelineCache Pipeline cache that is used for the parts and the fast link, or <tt>nullptr</tt> if not used.
+         * @param buildQueue Build queue that compiles the link time optimized pipelines, or <tt>nullptr</tt> if only the
+         * fast link is used.
+         */
+        GraphicsPipelineLibrary(
+            const VULKAN_HPP_NAMESPACE::VULKAN_HPP_RAII_NAMESPACE::Device &device [[clang::lifetimebound]],
+            const VULKAN_HPP_NAMESPACE::VULKAN_HPP_RAII_NAMESPACE::PipelineCache *pipelineCache = nullptr,
+            PipelineBuildQueue *buildQueue = nullptr
+        );
+
+        /**
+         * @brief Get the pipeline library part with \p key, or create it if not exists.
+         * @param part Pipeline library part flag.
+         * @param key User-defined key that identifies the part state (e.g. hash of the shader and its states). Keys of
+         * the different \p part don't collide.
+         * @param createInfoFactory Function that returns the part's <tt>vk::GraphicsPipelineCreateInfo</tt> (or anything
+         * convertible to it or has <tt>get()</tt> method returning it). It is invoked only if the part is not cached.
+         * @return Pipeline library handle, which is valid until the cache is cleared or destroyed.
+         */
+        template <std::invocable F>
+        [[nodiscard]] auto getPart(VULKAN_HPP_NAMESPACE::GraphicsPipelineLibraryFlagBitsEXT part, std::uint64_t key, F &&createInfoFactory) -> VULKAN_HPP_NAMESPACE::Pipeline {
+            if (std::optional pipeline = findPart(part, key)) {
+                return *pipeline;
+            }
+            return insertPart(part, key, VULKAN_HPP_NAMESPACE::VULKAN_HPP_RAII_NAMESPACE::Pipeline { device.get(), pipelineCache, getGraphicsPipelineCreateInfo(std::invoke(FWD(createInfoFactory))) });
+        }
+
+        /**
+         * @brief Fast link the pipeline libraries, and request the link time optimized pipeline to the build queue (with
+         * <tt>vku::PipelineBuildQueue::Priority::WarmUp</tt>).
+         * @param libraries Pipeline library parts.
+         * @param layout Pipeline layout that is compatible with the layouts used in \p libraries.
+         * @return Linked pipeline.
+         * @warning Parts in \p libraries must not be destroyed (by <tt>clear()</tt>) until the optimized pipeline is
+         * compiled.
+         */
+        [[nodiscard]] auto link(std::span<const VULKAN_HPP_NAMESPACE::Pipeline> libraries, VULKAN_HPP_NAMESPACE::PipelineLayout layout) const -> LinkedPipeline;
+
+        /**
+         * @brief Destroy all cached parts.
+         */
+        void clear() noexcept;
+
+        /**
+         * @brief Number of the cached parts.
+         */
+        [[nodiscard]] auto size() const noexcept -> std::size_t;
+
+    private:
+        struct Key {
+            VULKAN_HPP_NAMESPACE::GraphicsPipelineLibraryFlagBitsEXT part;
+            std::uint64_t value;
+
+            [[nodiscard]] bool operator==(const Key&) const noexcept = default;
+        };
+
+        struct KeyHash {
+            [[nodiscard]] auto operator()(const Key &key) const noexcept -> std::size_t;
+        };
+
+        std::reference_wrapper<const VULKAN_HPP_NAMESPACE::VULKAN_HPP_RAII_NAMESPACE::Device> device;
+        const VULKAN_HPP_NAMESPACE::VULKAN_HPP_RAII_NAMESPACE::PipelineCache *pipelineCache;
+        PipelineBuildQueue *buildQueue;
+
+        mutable std::shared_mutex mutex;
+        std::unordered_map<Key, VULKAN_HPP_NAMESPACE::VULKAN_HPP_RAII_NAMESPACE::Pipeline, KeyHash> parts;
+
+        [[nodiscard]] auto findPart(VULKAN_HPP_NAMESPACE::GraphicsPipelineLibraryFlagBitsEXT part, std::uint64_t key) const -> std::optional<VULKAN_HPP_NAMESPACE::Pipeline>;
+        [[nodiscard]] auto insertPart(VULKAN_HPP_NAMESPACE::GraphicsPipelineLibraryFlagBitsEXT part, std::uint64_t key, VULKAN_HPP_NAMESPACE::VULKAN_HPP_RAII_NAMESPACE::Pipeline &&pipeline) -> VULKAN_HPP_NAMESPACE::Pipeline;
+    };
+}
+
+// --------------------
+// Implementations.
+// --------------------
+
+vku::GraphicsPipelineLibrary::LinkedPipeline::LinkedPipeline(
+    VULKAN_HPP_NAMESPACE::VULKAN_HPP_RAII_NAMESPACE::Pipeline fastLinked,
+    std::future<VULKAN_HPP_NAMESPACE::VULKAN_HPP_RAII_NAMESPACE::Pipeline> optimizedFuture
+) noexcept : fastLinked { std::move(fastLinked) },
+             optimizedFuture { std::move(optimizedFuture) } { }
+
+auto vku::GraphicsPipelineLibrary::LinkedPipeline::get() -> VULKAN_HPP_NAMESPACE::Pipeline {
+    if (optimizedFuture.valid() && optimizedFuture.wait_for(std::chrono::seconds { 0 }) == std::future_status::ready) {
+        try {
+            optimized.emplace(optimizedFuture.get());
+        }
+        catch (...) {
+            // Optimized compilation failed; keep using the fast-linked pipeline and let the user inspect the error.
+            optimizationError = std::current_exception();
+        }
+    }
+    return optimized ? **optimized : *fastLinked;
+}
+
+bool vku::GraphicsPipelineLibrary::LinkedPipeline::isOptimized() const noexcept {
+    return optimized.has_value();
+}
+
+auto vku::GraphicsPipelineLibrary::LinkedPipeline::getOptimizationError() const noexcept -> std::exception_ptr {
+    return optimizationError;
+}
+
+vku::GraphicsPipelineLibrary::GraphicsPipelineLibrary(
+    const VULKAN_HPP_NAMESPACE::VULKAN_HPP_RAII_NAMESPACE::Device &device,
+    const VULKAN_HPP_NAMESPACE::VULKAN_HPP_RAII_NAMESPACE::PipelineCache *pipelineCache,
+    PipelineBuildQueue *buildQueue
+) : device { device },
+    pipelineCache { pipelineCache },
+    buildQueue { buildQueue } { }
+
+auto vku::GraphicsPipelineLibrary::link(
+    std::span<const VULKAN_HPP_NAMESPACE::Pipeline> libraries,
+    VULKAN_HPP_NAMESPACE::PipelineLayout layout
+) const -> LinkedPipeline {
+    VULKAN_HPP_NAMESPACE::VULKAN_HPP_RAII_NAMESPACE::Pipeline fastLinked { device.get(), pipelineCache, VULKAN_HPP_NAMESPACE::StructureChain {
+        VULKAN_HPP_NAMESPACE::GraphicsPipelineCreateInfo{}.setLayout(layout),
+        VULKAN_HPP_NAMESPACE::PipelineLibraryCreateInfoKHR { libraries },
+    }.get() };
+
+    std::future<VULKAN_HPP_NAMESPACE::VULKAN_HPP_RAII_NAMESPACE::Pipeline> optimizedFuture;
+    if (buildQueue) {
+        optimizedFuture = buildQueue->enqueue(
+            [libraries = libraries | std::ranges::to<std::vector>(), layout] {
+                return VULKAN_HPP_NAMESPACE::StructureChain {
+                    VULKAN_HPP_NAMESPACE::GraphicsPipelineCreateInfo{}
+                        .setFlags(VULKAN_HPP_NAMESPACE::PipelineCreateFlagBits::eLinkTimeOptimizationEXT)
+                        .setLayout(layout),
+                    VULKAN_HPP_NAMESPACE::PipelineLibraryCreateInfoKHR { libraries },
+                };
+            },
+            PipelineBuildQueue::Priority::WarmUp);
+    }
+
+    return { std::move(fastLinked), std::move(optimizedFuture) };
+}
+
+void vku::GraphicsPipelineLibrary::clear() noexcept {
+    std::unique_lock lock { mutex };
+    parts.clear();
+}
+
+auto vku::GraphicsPipelineLibrary::size() const noexcept -> std::size_t {
+    std::shared_lock lock { mutex };
+    return parts.size();
+}
+
+auto vku::GraphicsPipelineLibrary::findPart(
+    VULKAN_HPP_NAMESPACE::GraphicsPipelineLibraryFlagBitsEXT part,
+    std::uint64_t key
+) const -> std::optional<VULKAN_HPP_NAMESPACE::Pipeline> {
+    std::shared_lock lock { mutex };
+    if (auto it = parts.find({ part, key }); it != parts.end()) {
+        return *it->second;
+    }
+    return std::nullopt;
+}
+
+auto vku::GraphicsPipelineLibrary::insertPart(
+    VULKAN_HPP_NAMESPACE::GraphicsPipelineLibraryFlagBitsEXT part,
+    std::uint64_t key,
+    VULKAN_HPP_NAMESPACE::VULKAN_HPP_RAII_NAMESPACE::Pipeline &&pipeline
+) -> VULKAN_HPP_NAMESPACE::Pipeline {
+    std::unique_lock lock { mutex };
+    // If the other thread inserted the same part in the meantime, it is used and the given pipeline is discarded.
+    return *parts.try_emplace({ part, key }, std::move(pipeline)).first->second;
+}
+
+auto vku::GraphicsPipelineLibrary::KeyHash::operator()(
+    const Key &key
+) const noexcept -> std::size_t {
+    std::size_t seed = 0;
+    details::hash_combine(seed, key.part);
+    details::hash_combine(seed, key.value);
+    return seed;
+}
@@ -0,0 +1,202 @@
+/** @file pipelines/PipelineBuildQueue.cppm
+ */
+
+module;
+
+#include <vulkan/vulkan_hpp_macros.hpp>
+
+export module vku:pipelines.PipelineBuildQueue;
+
+import std;
+export import vulkan_hpp;
+
+#define FWD(...) static_cast<decltype(__VA_ARGS__)&&>(__VA_ARGS__)
+
+namespace vku {
+    /**
+     * @brief Worker pool that compiles pipelines concurrently.
+     *
+     * Pipelines are requested with a factory function that returns the pipeline create info (either
+     * <tt>vk::GraphicsPipelineCreateInfo</tt>, <tt>vk::ComputePipelineCreateInfo</tt>, or anything that is convertible to
+     * them or has <tt>get()</tt> method returning them, such as <tt>vku::RefHolder</tt> and <tt>vk::StructureChain</tt>).
+     * The factory is invoked in the worker thread, therefore the create info and its owning storage (e.g. shader modules
+     * from <tt>vku::createPipelineStages</tt>) are alive during the compilation without any relocation.
+     *
+     * Requests of <tt>Priority::Load</tt> are always processed before the requests of <tt>Priority::WarmUp</tt>.
+     *
+     * @code{.cpp}
+     * vku::PipelineBuildQueue buildQueue { gpu.device, &gpu.pipelineCache };
+     * std::future pipeline = buildQueue.enqueue([&] {
+     *     return vk::ComputePipelineCreateInfo {
+     *         {},
+     *         vku::createPipelineStages(gpu.device, vku::Shader::fromSpirvFile("shader.comp.spv", vk::ShaderStageFlagBits::eCompute)).get()[0],
+     *         *pipelineLayout,
+     *     };
+     * }); // WRONG: shader module is destroyed when the factory returns.
+     *
+     * std::future pipeline = buildQueue.enqueue([&] {
+     *     return vku::RefHolder {
+     *         [&](const auto &stages) { return vk::ComputePipelineCreateInfo { {}, get<0>(stages.get()), *pipelineLayout }; },
+     *         vku::createPipelineStages(gpu.device, vku::Shader::fromSpirvFile("shader.comp.spv", vk::ShaderStageFlagBits::eCompute)),
+     *     };
+     * }); // OK.
+     *
+     * // Poll the result without blocking.
+     * if (pipeline.wait_for(std::chrono::seconds { 0 }) == std::future_status::ready) { ... }
+     * @endcode
+     */
+    export class PipelineBuildQueue {
+    public:
+        enum class Priority {
+            /**
+             * @brief Pipelines that are required for loading.
+             */
+            Load,
+
+            /**
+             * @brief Speculative pipeline variants that may be used later.
+             */
+            WarmUp,
+        };
+
+        /**
+         * @brief Create the worker pool.
+         * @param device Vulkan device.
+         * @param pipelineCache Pipeline cache shared by all workers, or <tt>nullptr</tt> if not used.
+         * @param threadCount Number of worker threads.
+         */
+        explicit PipelineBuildQueue(
+            const VULKAN_HPP_NAMESPACE::VULKAN_HPP_RAII_NAMESPACE::Device &device [[clang::lifetimebound]],
+            const VULKAN_HPP_NAMESPACE::VULKAN_HPP_RAII_NAMESPACE::PipelineCache *pipelineCache = nullptr,
+            std::uint32_t threadCount = std::max(std::thread::hardware_concurrency(), 1U)
+        );
+
+        PipelineBuildQueue(const PipelineBuildQueue&) = delete;
+        auto operator=(const PipelineBuildQueue&) -> PipelineBuildQueue& = delete;
+
+        /**
+         * @brief Stop the workers after finishing the currently compiling pipelines. Futures of the requests that
+         * are not started yet will have <tt>std::future_error</tt> (broken promise).
+         */
+        ~PipelineBuildQueue();
+
+        /**
+         * @brief Request the pipeline compilation.
+         * @param createInfoFactory Function that returns the pipeline create info. It is invoked in the worker thread.
+         * @param priority Request priority.
+         * @return Future of the compiled pipeline. Exception thrown by \p createInfoFactory or pipeline creation is
+         * stored in the future.
+         */
+        template <std::invocable F>
+        [[nodiscard]] auto enqueue(F &&createInfoFactory, Priority priority = Priority::Load) -> std::future<VULKAN_HPP_NAMESPACE::VULKAN_HPP_RAII_NAMESPACE::Pipeline> {
+            std::packaged_task<VULKAN_HPP_NAMESPACE::VULKAN_HPP_RAII_NAMESPACE::Pipeline()> task {
+                [this, f = FWD(createInfoFactory)]() mutable {
+                    return createPipeline(std::invoke(f));
+                },
+            };
+            std::future result = task.get_future();
+            push(std::move(task), priority);
+            return result;
+        }
+
+        /**
+         * @brief Number of the requests that are not started yet.
+         */
+        [[nodiscard]] auto getPendingCount() const -> std::size_t;
+
+    private:
+        using Task = std::packaged_task<VULKAN_HPP_NAMESPACE::VULKAN_HPP_RAII_NAMESPACE::Pipeline()>;
+
+        std::reference_wrapper<const VULKAN_HPP_NAMESPACE::VULKAN_HPP_RAII_NAMESPACE::Device> device;
+        const VULKAN_HPP_NAMESPACE::VULKAN_HPP_RAII_NAMESPACE::PipelineCache *pipelineCache;
+
+        mutable std::mutex mutex;
+        std::condition_variable_any condition;
+        std::deque<Task> loadTasks;
+        std::deque<Task> warmUpTasks;
+
+        // Must be declared at last, to make the workers joined before destroying the above members.
+        std::vector<std::jthread> workers;
+
+        void push(Task &&task, Priority priority);
+        void work(std::stop_token stopToken);
+
+        template <typename R>
+        [[nodiscard]] auto createPipeline(const R &createInfo) const -> VULKAN_HPP_NAMESPACE::VULKAN_HPP_RAII_NAMESPACE::Pipeline {
+            if constexpr (std::convertible_to<const R&, const VULKAN_HPP_NAMESPACE::GraphicsPipelineCreateInfo&>) {
+                return { device.get(), pipelineCache, static_cast<const VULKAN_HPP_NAMESPACE::GraphicsPipelineCreateInfo&>(createInfo) };
+            }
+            else if constexpr (std::convertible_to<const R&, const VULKAN_HPP_NAMESPACE::ComputePipelineCreateInfo&>) {
+                return { device.get(), pipelineCache, static_cast<const VULKAN_HPP_NAMESPACE::ComputePipelineCreateInfo&>(createInfo) };
+            }
+            else {
+                static_assert(requires { createInfo.get(); }, "Factory must return pipeline create info, or the object that has get() method returning it.");
+                return createPipeline(createInfo.get());
+            }
+        }
+    };
+}
+
+// --------------------
+// Implementations.
+// --------------------
+
+vku::PipelineBuildQueue::PipelineBuildQueue(
+    const VULKAN_HPP_NAMESPACE::VULKAN_HPP_RAII_NAMESPACE::Device &device,
+    const VULKAN_HPP_NAMESPACE::VULKAN_HPP_RAII_NAMESPACE::PipelineCache *pipelineCache,
+    std::uint32_t threadCount
+) : device { device },
+    pipelineCache { pipelineCache } {
+    workers.reserve(threadCount);
+    for (std::uint32_t i = 0; i < threadCount; ++i) {
+        workers.emplace_back([this](std::stop_token stopToken) {
+            work(stopToken);
+        });
+    }
+}
+
+vku::PipelineBuildQueue::~PipelineBuildQueue() {
+    for (std::jthread &worker : workers) {
+        worker.request_stop();
+    }
+    workers.clear();
+}
+
+auto vku::PipelineBuildQueue::getPendingCount() const -> std::size_t {
+    std::scoped_lock lock { mutex };
+    return loadTasks.size() + warmUpTasks.size();
+}
+
+void vku::PipelineBuildQueue::push(
+    Task &&task,
+    Priority priority
+) {
+    {
+        std::scoped_lock lock { mutex };
+        (priority == Priority::Load ? loadTasks : warmUpTasks).push_back(std::move(task));
+    }
+    condition.notify_one();
+}
+
+void vku::PipelineBuildQueue::work(
+    std::stop_token stopToken
+) {
+    while (true) {
+        Task task;
+        {
+            std::unique_lock lock { mutex };
+            // wait() returns true if the predicate holds even after the stop is requested, therefore the stop token must
+            // be checked separately to abandon the remaining tasks.
+            if (!condition.wait(lock, stopToken, [&] { return !loadTasks.empty() || !warmUpTasks.empty(); }) || stopToken.stop_requested()) {
+                return;
+            }
+
+            std::deque<Task> &tasks = loadTasks.empty() ? warmUpTasks : loadTasks;
+            task = std::move(tasks.front());
+            tasks.pop_front();
+        }
+
+        // Exceptions are stored in the future.
+        task();
+    }
+}
@@ -0,0 +1,164 @@
+/** @file pipelines/PipelineCache.cppm
+ */
+
+module;
+
+#include <vulkan/vulkan_hpp_macros.hpp>
+
+export module vku:pipelines.PipelineCache;
+
+import std;
+export import vulkan_hpp;
+
+namespace vku {
+    /**
+     * @brief Owning <tt>vk::PipelineCache</tt> that is persisted in a file.
+     *
+     * At construction, the cache data is loaded from the file at \p path if exists. Data whose header
+     * (<tt>vendorID</tt>, <tt>deviceID</tt> and <tt>pipelineCacheUUID</tt>) does not match the current physical device
+     * is discarded, as it is either created by the other device or the other driver version. <tt>save()</tt> writes the
+     * cache data back to the file atomically, therefore the file is never left partially written even if the process
+     * is terminated during the write.
+     *
+     * @code{.cpp}
+     * vku::PipelineCache pipelineCache { device, physicalDevice.getProperties(), "pipeline_cache.bin" };
+     * vk::raii::Pipeline pipeline { device, pipelineCache, vk::GraphicsPipelineCreateInfo { ... } };
+     * pipelineCache.save();
+     * @endcode
+     */
+    export class PipelineCache : public VULKAN_HPP_NAMESPACE::VULKAN_HPP_RAII_NAMESPACE::PipelineCache {
+    public:
+        /**
+         * @brief Path of the cache file. If empty, the cache is not persisted.
+         */
+        std::filesystem::path path;
+
+        /**
+         * @brief Create pipeline cache from the file at \p path.
+         * @param device Vulkan device.
+         * @param properties Properties of the physical device that \p device is created from.
+         * @param path Path of the cache file. If empty or file does not exist, empty pipeline cache is created.
+         */
+        PipelineCache(
+            const VULKAN_HPP_NAMESPACE::VULKAN_HPP_RAII_NAMESPACE::Device &device [[clang::lifetimebound]],
+            const VULKAN_HPP_NAMESPACE::PhysicalDeviceProperties &properties,
+            std::filesystem::path path = {}
+        );
+
+        /**
+         * @brief Write the cache data into the file at <tt>path</tt> atomically. It is no-op if <tt>path</tt> is empty.
+         *
+         * The data is written to a temporary file in the same directory, and then renamed to <tt>path</tt>.
+         *
+         * @throw std::runtime_error If failed to write the file.
+         */
+        void save() const;
+
+        /**
+         * @brief Check if the pipeline cache \p data can be used for the physical device of \p properties.
+         * @param data Pipeline cache data, which starts with <tt>VkPipelineCacheHeaderVersionOne</tt>.
+         * @param properties Physical device properties.
+         * @return <tt>true</tt> if the header of \p data matches to \p properties, <tt>false</tt> otherwise.
+         */
+        [[nodiscard]] static bool isCompatible(std::span<const std::byte> data, const VULKAN_HPP_NAMESPACE::PhysicalDeviceProperties &properties) noexcept;
+
+    private:
+        [[nodiscard]] static auto loadData(const std::filesystem::path &path, const VULKAN_HPP_NAMESPACE::PhysicalDeviceProperties &properties) -> std::vector<std::byte>;
+    };
+}
+
+// --------------------
+// Implementations.
+// --------------------
+
+vku::PipelineCache::PipelineCache(
+    const VULKAN_HPP_NAMESPACE::VULKAN_HPP_RAII_NAMESPACE::Device &device,
+    const VULKAN_HPP_NAMESPACE::PhysicalDeviceProperties &properties,
+    std::filesystem::path path
+) : VULKAN_HPP_NAMESPACE::VULKAN_HPP_RAII_NAMESPACE::PipelineCache { [&] {
+        const std::vector data = loadData(path, properties);
+        return VULKAN_HPP_NAMESPACE::VULKAN_HPP_RAII_NAMESPACE::PipelineCache {
+            device,
+            VULKAN_HPP_NAMESPACE::PipelineCacheCreateInfo { {}, data.size(), data.data() },
+        };
+    }() },
+    path { std::move(path) } { }
+
+void vku::PipelineCache::save() const {
+    if (path.empty()) {
+        return;
+    }
+
+    const std::vector data = getData();
+
+    if (path.has_parent_path()) {
+        std::filesystem::create_directories(path.parent_path());
+    }
+    std::filesystem::path tempPath = path;
+    tempPath += ".tmp";
+    {
+        std::ofstream file { tempPath, std::ios::binary | std::ios::trunc };
+        file.write(reinterpret_cast<const char*>(data.data()), data.size());
+        if (!file) {
+            throw std::runtime_error { std::format("Failed to write pipeline cache to {}", tempPath.string()) };
+        }
+    }
+    std::filesystem::rename(tempPath, path);
+}
+
+bool vku::PipelineCache::isCompatible(
+    std::span<const std::byte> data,
+    const VULKAN_HPP_NAMESPACE::PhysicalDeviceProperties &properties
+) noexcept {
+    // Layout of VkPipelineCacheHeaderVersionOne.
+    struct Header {
+        std::uint32_t headerSize;
+        VULKAN_HPP_NAMESPACE::PipelineCacheHeaderVersion headerVersion;
+        std::uint32_t vendorID;
+        std::uint32_t deviceID;
+        std::array<std::uint8_t, VULKAN_HPP_NAMESPACE::UuidSize> pipelineCacheUUID;
+    };
+    static_assert(sizeof(Header) == 32);
+
+    if (data.size() < sizeof(Header)) {
+        return false;
+    }
+
+    Header header;
+    std::memcpy(&header, data.data(), sizeof(Header));
+    return header.headerSize >= sizeof(Header)
+        && header.headerVersion == VULKAN_HPP_NAMESPACE::PipelineCacheHeaderVersion::eOne
+        && header.vendorID == properties.vendorID
+        && header.deviceID == properties.deviceID
+        && std::ranges::equal(header.pipelineCacheUUID, properties.pipelineCacheUUID);
+}
+
+auto vku::PipelineCache::loadData(
+    const std::filesystem::path &path,
+    const VULKAN_HPP_NAMESPACE::PhysicalDeviceProperties &properties
+) -> std::vector<std::byte> {
+    if (path.empty()) {
+        return {};
+    }
+
+    std::ifstream file { path, std::ios::binary | std::ios::ate };
+    if (!file) {
+        // Cache file not exists yet.
+        return {};
+    }
+
+    const std::streamoff size = file.tellg();
+    if (size <= 0) {
+        // Empty file, or the size cannot be determined (e.g. path is a directory).
+        return {};
+    }
+
+    std::vector<std::byte> data(static_cast<std::size_t>(size));
+    file.seekg(0, std::ios::beg);
+    file.read(reinterpret_cast<char*>(data.data()), data.size());
+    if (!file || !isCompatible(data, properties)) {
+        // Stale or corrupted data.
+        return {};
+    }
+    return data;
+}
@@ -4,7 +4,6 @@
 module;
 
 #include <cassert>
-#include <cerrno>
 
 #ifdef VKU_USE_SHADERC
 #include <shaderc/shaderc.hpp>
@@ -15,6 +14,7 @@ export module vku:pipelines.Shader;
 
 import std;
 export import vulkan_hpp;
+import :utils.MappedFile;
 import :utils.RefHolder;
 #ifdef VKU_USE_SHADERC
 import :details.to_string;
@@ -26,24 +26,6 @@ import :details.to_string;
 #define PATH_C_STR(...) (__VA_ARGS__).c_str()
 #endif
 
-[[nodiscard]] auto loadFileAsBinary(
-    const std::filesystem::path &path
-) -> std::vector<std::byte> {
-    std::ifstream file { path, std::ios::binary };
-    if (!file) {
-        throw std::runtime_error { std::format("Failed to open file: {} (error code={})", std::strerror(errno), errno) };
-    }
-
-    file.seekg(0, std::ios::end);
-    const auto fileSize = file.tellg();
-    file.seekg(0, std::ios::beg);
-
-    std::vector<std::byte> result(fileSize);
-    file.read(reinterpret_cast<char*>(result.data()), fileSize);
-
-    return result;
-}
-
 template <typename T, typename U>
 [[nodiscard]] constexpr auto as(std::span<U> span) noexcept -> std::span<T> {
     assert(span.size_bytes() % sizeof(T) == 0 && "Size of span must be a multiple of the size of T");
@@ -95,24 +77,28 @@ namespace vku {
 
         /**
          * @brief Create Shader from compiled SPIR-V file.
+         *
+         * The file is memory-mapped instead of being read into the heap, and the mapping is stored in the returned RefHolder.
+         *
          * @param path Path to the SPIR-V file.
          * @param stage The stage of the shader.
          * @param pSpecializationInfo The specialization info of the shader. If <tt>nullptr</tt>, no specialization is used.
          * @param entryPoint The entry point of the shader. Default is <tt>"main"</tt>.
          * @return A RefHolder of the Shader.
+         * @throw std::runtime_error If the file cannot be opened or mapped.
          * @warning If \p pSpecializationInfo passed, its lifetime must be tied to its actual usage (passed to <tt>vk::create{Graphics,Compute}Pipeline</tt>).
          */
-        [[nodiscard]] static RefHolder<Shader, std::vector<std::byte>> fromSpirvFile(
+        [[nodiscard]] static RefHolder<Shader, MappedFile> fromSpirvFile(
             const std::filesystem::path &path,
             VULKAN_HPP_NAMESPACE::ShaderStageFlagBits stage,
             const VULKAN_HPP_NAMESPACE::SpecializationInfo *pSpecializationInfo [[clang::lifetimebound]] = nullptr,
             const char *entryPoint = "main"
         ) {
             return {
-                [=](std::span<const std::byte> code) {
-                    return Shader { as<const std::uint32_t>(code), stage, pSpecializationInfo, entryPoint };
+                [=](const MappedFile &file) {
+                    return Shader { as<const std::uint32_t>(file.data()), stage, pSpecializationInfo, entryPoint };
                 },
-                loadFileAsBinary(path),
+                MappedFile { path },
             };
         }
 
@@ -131,7 +117,7 @@ namespace vku {
          * @param stage The stage of the shader. Must be a kind of either vertex, tessellation control, tessellation evaluation, geometry, fragment, or compute.
          * @param compileOptions The compile options.
          * @param pSpecializationInfo The specialization info of the shader. If <tt>nullptr</tt>, no specialization is used.
-         * @param identifier The identifier of the shader. If not specified, it will use the function caller's source location.
+         * @param identifier The identifier of the shader.
          * @return A RefHolder of the Shader.
          * @throw std::runtime_error If the compilation failed.
          * @warning If \p pSpecializationInfo passed, its lifetime must be tied to its actual usage (passed to <tt>vk::create{Graphics,Compute}Pipeline</tt>).
@@ -142,8 +128,8 @@ namespace vku {
             std::string_view glsl,
             VULKAN_HPP_NAMESPACE::ShaderStageFlagBits stage,
             const shaderc::CompileOptions &compileOptions,
-            const VULKAN_HPP_NAMESPACE::SpecializationInfo *pSpecializationInfo [[clang::lifetimebound]] = nullptr,
-            const char *identifier = details::to_string(std::source_location::current()).c_str()
+            const VULKAN_HPP_NAMESPACE::SpecializationInfo *pSpecializationInfo [[clang::lifetimebound]],
+            const char *identifier
         ) {
             const auto compilationResult = compiler.CompileGlslToSpv(glsl.data(), glsl.size(), getShaderKind(stage), identifier, "main", compileOptions);
             if (compilationResult.GetCompilationStatus() != shaderc_compilation_status_success) {
@@ -158,6 +144,31 @@ namespace vku {
             };
         }
 
+        /**
+         * @brief Create Shader from GLSL string, identified by the function caller's source location.
+         *
+         * @param compiler The shaderc compiler.
+         * @param glsl The GLSL string.
+         * @param stage The stage of the shader. Must be a kind of either vertex, tessellation control, tessellation evaluation, geometry, fragment, or compute.
+         * @param compileOptions The compile options.
+         * @param pSpecializationInfo The specialization info of the shader. If <tt>nullptr</tt>, no specialization is used.
+         * @param location Source location of the caller, which is used as the shader identifier.
+         * @return A RefHolder of the Shader.
+         * @throw std::runtime_error If the compilation failed.
+         * @note This function is available only if the macro <tt>VKU_USE_SHADERC</tt> is defined.
+         */
+        [[nodiscard]] static RefHolder<Shader, std::vector<std::uint32_t>> fromGLSLString(
+            shaderc::Compiler compiler,
+            std::string_view glsl,
+            VULKAN_HPP_NAMESPACE::ShaderStageFlagBits stage,
+            const shaderc::CompileOptions &compileOptions,
+            const VULKAN_HPP_NAMESPACE::SpecializationInfo *pSpecializationInfo [[clang::lifetimebound]] = nullptr,
+            details::SourceLocationName location = std::source_location::current()
+        ) {
+            // The identifier is only used during the compilation, therefore it doesn't have to be interned.
+            return fromGLSLString(std::move(compiler), glsl, stage, compileOptions, pSpecializationInfo, location.c_str());
+        }
+
         /**
          * @brief Create Shader from GLSL file.
          *
@@ -184,7 +195,8 @@ namespace vku {
             const shaderc::CompileOptions &compileOptions,
             const VULKAN_HPP_NAMESPACE::SpecializationInfo *pSpecializationInfo [[clang::lifetimebound]] = nullptr
         ) {
-            const std::vector glsl = loadFileAsBinary(glslPath);
+            const MappedFile file { glslPath };
+            const std::span glsl = file.data();
             const auto compilationResult = compiler.CompileGlslToSpv(reinterpret_cast<const char*>(glsl.data()), glsl.size(), getShaderKind(stage), PATH_C_STR(glslPath), "main", compileOptions);
             if (compilationResult.GetCompilationStatus() != shaderc_compilation_status_success) {
                 throw std::runtime_error { std::format("Failed to compile shader: {}", compilationResult.GetErrorMessage()) };
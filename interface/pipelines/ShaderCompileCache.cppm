@@ -0,0 +1,303 @@
+/** @file pipelines/ShaderCompileCache.cppm
+ */
+
+module;
+
+#ifdef VKU_USE_SHADERC
+#include <shaderc/shaderc.hpp>
+#endif
+#include <vulkan/vulkan_hpp_macros.hpp>
+
+export module vku:pipelines.ShaderCompileCache;
+
+import std;
+export import vulkan_hpp;
+#ifdef VKU_USE_SHADERC
+import :pipelines.Shader;
+import :utils.MappedFile;
+#endif
+
+#ifdef _MSC_VER
+#define PATH_C_STR(...) (__VA_ARGS__).string().c_str()
+#else
+#define PATH_C_STR(...) (__VA_ARGS__).c_str()
+#endif
+
+#ifdef VKU_USE_SHADERC
+/**
+ * @brief 64-bit FNV-1a hash, which is stable across the runs and platforms (unlike <tt>std::hash</tt>).
+ */
+class Fnv1aHasher {
+public:
+    void update(std::span<const std::byte> bytes) noexcept {
+        for (std::byte byte : bytes) {
+            value = (value ^ std::to_integer<std::uint64_t>(byte)) * 0x100000001b3ULL;
+        }
+    }
+
+    void update(std::string_view str) noexcept {
+        update(std::as_bytes(std::span { str }));
+        // Separator to distinguish ("ab", "c") from ("a", "bc").
+        update(std::as_bytes(std::span { "\0", 1 }));
+    }
+
+    [[nodiscard]] auto get() const noexcept -> std::uint64_t { return value; }
+
+private:
+    std::uint64_t value = 0xcbf29ce484222325ULL;
+};
+
+namespace vku {
+    /**
+     * @brief Content-addressed on-disk cache of SPIR-V codes compiled from GLSL by shaderc.
+     *
+     * The cache key is the hash of the preprocessed GLSL source (therefore the included files and macro definitions are
+     * reflected), shader stage, entry point and \p compileOptionsKey. As <tt>shaderc::CompileOptions</tt> cannot be
+     * inspected, you must pass \p compileOptionsKey that uniquely describes the options (e.g. target environment,
+     * optimization level and macro definitions) which affects the compilation result; changing the options with the same
+     * key will return stale SPIR-V.
+     *
+     * Cache files are written atomically (temporary file, then rename), therefore multiple processes can share the same
+     * cache directory.
+     *
+     * @code{.cpp}
+     * shaderc::CompileOptions compileOptions;
+     * compileOptions.SetTargetEnvironment(shaderc_target_env_vulkan, shaderc_env_version_vulkan_1_3);
+     * compileOptions.SetOptimizationLevel(shaderc_optimization_level_performance);
+     * vku::ShaderCompileCache shaderCompileCache { "shader_cache", compileOptions, "vulkan1.3;O" };
+     *
+     * const std::vector spirvs = shaderCompileCache.compileFiles({
+     *     { "shader.vert", vk::ShaderStageFlagBits::eVertex },
+     *     { "shader.frag", vk::ShaderStageFlagBits::eFragment },
+     * });
+     * vku::createPipelineStages(
+     *     gpu.device,
+     *     vku::Shader { spirvs[0], vk::ShaderStageFlagBits::eVertex },
+     *     vku::Shader { spirvs[1], vk::ShaderStageFlagBits::eFragment });
+     * @endcode
+     *
+     * @note This class is available only if the macro <tt>VKU_USE_SHADERC</tt> is defined.
+     */
+    export class ShaderCompileCache {
+    public:
+        /**
+         * @brief GLSL file compilation request of <tt>compileFiles</tt>.
+         */
+        struct FileRequest {
+            std::filesystem::path path;
+            VULKAN_HPP_NAMESPACE::ShaderStageFlagBits stage;
+            const char *entryPoint = "main";
+        };
+
+        /**
+         * @brief Path to the cache directory. It is created on the first write.
+         */
+        std::filesystem::path directory;
+
+        /**
+         * @param directory Path to the cache directory.
+         * @param compileOptions Compile options that are used for both preprocessing and compilation.
+         * @param compileOptionsKey String that uniquely describes \p compileOptions.
+         */
+        ShaderCompileCache(std::filesystem::path directory, shaderc::CompileOptions compileOptions, std::string compileOptionsKey);
+
+        /**
+         * @brief Get the SPIR-V code of GLSL string from the cache, or compile it and store into the cache if not exists.
+         * @param glsl The GLSL string.
+         * @param stage The stage of the shader.
+         * @param identifier The identifier of the shader, which is used for the diagnostics and resolving relative includes.
+         * @param entryPoint The name of the entry point function.
+         * @return SPIR-V code.
+         * @throw std::runtime_error If the preprocessing or compilation failed.
+         */
+        [[nodiscard]] auto compile(std::string_view glsl, VULKAN_HPP_NAMESPACE::ShaderStageFlagBits stage, const char *identifier = "", const char *entryPoint = "main") const -> std::vector<std::uint32_t>;
+
+        /**
+         * @brief Get the SPIR-V code of GLSL file from the cache, or compile it and store into the cache if not exists.
+         * @param path The path to the GLSL file.
+         * @param stage The stage of the shader.
+         * @param entryPoint The name of the entry point function.
+         * @return SPIR-V code.
+         * @throw std::runtime_error If the file cannot be read, or the preprocessing or compilation failed.
+         */
+        [[nodiscard]] auto compileFile(const std::filesystem::path &path, VULKAN_HPP_NAMESPACE::ShaderStageFlagBits stage, const char *entryPoint = "main") const -> std::vector<std::uint32_t>;
+
+        /**
+         * @brief Get the SPIR-V codes of multiple GLSL files, compiling the cache misses in parallel.
+         * @param requests Compilation requests.
+         * @param threadCount Number of the worker threads. <tt>0</tt> is treated as <tt>1</tt>.
+         * @return SPIR-V codes, in the same order as \p requests.
+         * @throw std::runtime_error If any of the requests failed. Other requests are finished before it is thrown.
+         * @note Compile options are shared by the worker threads, therefore its include resolver (if set) must be thread-safe.
+         */
+        [[nodiscard]] auto compileFiles(std::span<const FileRequest> requests, std::uint32_t threadCount = std::max(std::thread::hardware_concurrency(), 1U)) const -> std::vector<std::vector<std::uint32_t>>;
+
+    private:
+        shaderc::CompileOptions compileOptions;
+        std::string compileOptionsKey;
+
+        [[nodiscard]] auto compile(const shaderc::Compiler &compiler, std::string_view glsl, VULKAN_HPP_NAMESPACE::ShaderStageFlagBits stage, const char *identifier, const char *entryPoint) const -> std::vector<std::uint32_t>;
+        [[nodiscard]] auto compileFile(const shaderc::Compiler &compiler, const std::filesystem::path &path, VULKAN_HPP_NAMESPACE::ShaderStageFlagBits stage, const char *entryPoint) const -> std::vector<std::uint32_t>;
+        [[nodiscard]] auto load(const std::filesystem::path &path) const -> std::optional<std::vector<std::uint32_t>>;
+        void store(const std::filesystem::path &path, std::span<const std::uint32_t> spirv) const;
+    };
+}
+
+// --------------------
+// Implementations.
+// --------------------
+
+vku::ShaderCompileCache::ShaderCompileCache(
+    std::filesystem::path directory,
+    shaderc::CompileOptions compileOptions,
+    std::string compileOptionsKey
+) : directory { std::move(directory) },
+    compileOptions { std::move(compileOptions) },
+    compileOptionsKey { std::move(compileOptionsKey) } { }
+
+auto vku::ShaderCompileCache::compile(
+    std::string_view glsl,
+    VULKAN_HPP_NAMESPACE::ShaderStageFlagBits stage,
+    const char *identifier,
+    const char *entryPoint
+) const -> std::vector<std::uint32_t> {
+    return compile(shaderc::Compiler{}, glsl, stage, identifier, entryPoint);
+}
+
+auto vku::ShaderCompileCache::compileFile(
+    const std::filesystem::path &path,
+    VULKAN_HPP_NAMESPACE::ShaderStageFlagBits stage,
+    const char *entryPoint
+) const -> std::vector<std::uint32_t> {
+    return compileFile(shaderc::Compiler{}, path, stage, entryPoint);
+}
+
+auto vku::ShaderCompileCache::compileFiles(
+    std::span<const FileRequest> requests,
+    std::uint32_t threadCount
+) const -> std::vector<std::vector<std::uint32_t>> {
+    std::vector<std::vector<std::uint32_t>> result(requests.size());
+
+    std::atomic<std::size_t> nextIndex = 0;
+    std::mutex exceptionMutex;
+    std::exception_ptr exception;
+    {
+        std::vector<std::jthread> workers;
+        threadCount = static_cast<std::uint32_t>(std::min<std::size_t>(std::max(threadCount, 1U), requests.size()));
+        workers.reserve(threadCount);
+        for (std::uint32_t i = 0; i < threadCount; ++i) {
+            workers.emplace_back([&] {
+                // shaderc::Compiler is not shared between the threads.
+                const shaderc::Compiler compiler;
+                for (std::size_t index; (index = nextIndex.fetch_add(1, std::memory_order_relaxed)) < requests.size();) {
+                    try {
+                        result[index] = compileFile(compiler, requests[index].path, requests[index].stage, requests[index].entryPoint);
+                    }
+                    catch (...) {
+                        std::scoped_lock lock { exceptionMutex };
+                        if (!exception) {
+                            exception = std::current_exception();
+                        }
+                    }
+                }
+            });
+        }
+    } // Workers are joined here.
+
+    if (exception) {
+        std::rethrow_exception(exception);
+    }
+    return result;
+}
+
+auto vku::ShaderCompileCache::compile(
+    const shaderc::Compiler &compiler,
+    std::string_view glsl,
+    VULKAN_HPP_NAMESPACE::ShaderStageFlagBits stage,
+    const char *identifier,
+    const char *entryPoint
+) const -> std::vector<std::uint32_t> {
+    const shaderc_shader_kind shaderKind = getShaderKind(stage);
+
+    const auto preprocessResult = compiler.PreprocessGlsl(glsl.data(), glsl.size(), shaderKind, identifier, compileOptions);
+    if (preprocessResult.GetCompilationStatus() != shaderc_compilation_status_success) {
+        throw std::runtime_error { std::format("Failed to preprocess shader: {}", preprocessResult.GetErrorMessage()) };
+    }
+    const std::string_view preprocessed { preprocessResult.cbegin(), preprocessResult.cend() };
+
+    Fnv1aHasher hasher;
+    hasher.update(preprocessed);
+    hasher.update(to_string(stage));
+    hasher.update(entryPoint);
+    hasher.update(compileOptionsKey);
+    const std::filesystem::path cachePath = directory / std::format("{:016x}.spv", hasher.get());
+
+    if (std::optional cached = load(cachePath)) {
+        return *std::move(cached);
+    }
+
+    const auto compilationResult = compiler.CompileGlslToSpv(preprocessed.data(), preprocessed.size(), shaderKind, identifier, entryPoint, compileOptions);
+    if (compilationResult.GetCompilationStatus() != shaderc_compilation_status_success) {
+        throw std::runtime_error { std::format("Failed to compile shader: {}", compilationResult.GetErrorMessage()) };
+    }
+
+    std::vector spirv = compilationResult | std::ranges::to<std::vector>();
+    store(cachePath, spirv);
+    return spirv;
+}
+
+auto vku::ShaderCompileCache::compileFile(
+    const shaderc::Compiler &compiler,
+    const std::filesystem::path &path,
+    VULKAN_HPP_NAMESPACE::ShaderStageFlagBits stage,
+    const char *entryPoint
+) const -> std::vector<std::uint32_t> {
+    const MappedFile file { path };
+    const std::span glsl = file.data();
+    return compile(compiler, { reinterpret_cast<const char*>(glsl.data()), glsl.size() }, stage, PATH_C_STR(path), entryPoint);
+}
+
+auto vku::ShaderCompileCache::load(
+    const std::filesystem::path &path
+) const -> std::optional<std::vector<std::uint32_t>> {
+    std::ifstream file { path, std::ios::binary | std::ios::ate };
+    if (!file) {
+        // Cache miss.
+        return std::nullopt;
+    }
+
+    const std::streamsize size = file.tellg();
+    if (size < 4 || size % 4 != 0) {
+        // Corrupted data.
+        return std::nullopt;
+    }
+
+    std::vector<std::uint32_t> spirv(size / 4);
+    file.seekg(0, std::ios::beg);
+    file.read(reinterpret_cast<char*>(spirv.data()), size);
+    if (!file || spirv[0] != 0x07230203U /* SPIR-V magic number */) {
+        // Corrupted data.
+        return std::nullopt;
+    }
+    return spirv;
+}
+
+void vku::ShaderCompileCache::store(
+    const std::filesystem::path &path,
+    std::span<const std::uint32_t> spirv
+) const {
+    std::filesystem::create_directories(directory);
+
+    // Temporary file name must be unique among the threads and processes that are writing the same entry.
+    std::filesystem::path tempPath = path;
+    tempPath += std::format(".{:016x}.tmp", std::random_device{}() ^ std::hash<std::thread::id>{}(std::this_thread::get_id()));
+    {
+        std::ofstream file { tempPath, std::ios::binary | std::ios::trunc };
+        file.write(reinterpret_cast<const char*>(spirv.data()), spirv.size_bytes());
+        if (!file) {
+            throw std::runtime_error { std::format("Failed to write shader cache to {}", tempPath.string()) };
+        }
+    }
+    std::filesystem::rename(tempPath, path);
+}
+#endif
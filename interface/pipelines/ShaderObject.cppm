@@ -0,0 +1,189 @@
+/** @file pipelines/ShaderObject.cppm
+ */
+
+module;
+
+#include <vulkan/vulkan_hpp_macros.hpp>
+
+export module vku:pipelines.ShaderObject;
+
+import std;
+export import vulkan_hpp;
+import :pipelines.Shader;
+
+template <typename T, std::size_t>
+using type_tag_t = T;
+
+namespace vku {
+    /**
+     * @brief Linked <tt>vk::ShaderEXT</tt>s created by <tt>vku::createShaderObjects</tt>, with their stages.
+     */
+    export struct ShaderObjects {
+        std::vector<VULKAN_HPP_NAMESPACE::ShaderStageFlagBits> stages;
+        std::vector<VULKAN_HPP_NAMESPACE::VULKAN_HPP_RAII_NAMESPACE::ShaderEXT> shaders;
+
+        /**
+         * @brief Bind the shaders to their stages.
+         *
+         * Stages that are not in <tt>stages</tt> are not touched, therefore you have to bind <tt>VK_NULL_HANDLE</tt> to
+         * the other graphics stages that are enabled in the device (e.g. tessellation and geometry) before drawing.
+         *
+         * The command is dispatched through the device dispatcher of the shaders.
+         *
+         * @param commandBuffer Command buffer to record.
+         */
+        void bind(VULKAN_HPP_NAMESPACE::CommandBuffer commandBuffer) const;
+    };
+
+    /**
+     * Create linked <tt>vk::ShaderEXT</tt>s from <tt>vku::Shader</tt>s, the <tt>VK_EXT_shader_object</tt> counterpart of
+     * <tt>vku::createPipelineStages</tt>.
+     *
+     * If multiple shaders are given, they are created with <tt>vk::ShaderCreateFlagBitsEXT::eLinkStage</tt> and each
+     * shader's <tt>nextStage</tt> is set to the stage of the following shader, therefore \p shaders must be passed in the
+     * pipeline stage order (e.g. vertex, then fragment).
+     *
+     * @code{.cpp}
+     * const vku::ShaderObjects shaderObjects = vku::createShaderObjects(
+     *     device, *descriptorSetLayout, {},
+     *     vku::Shader::fromSpirvFile("triangle.vert.spv", vk::ShaderStageFlagBits::eVertex),
+     *     vku::Shader::fromSpirvFile("triangle.frag.spv", vk::ShaderStageFlagBits::eFragment));
+     *
+     * shaderObjects.bind(cb);
+     * vku::setDefaultGraphicsDynamicStates(device, cb, 1);
+     * cb.setViewportWithCount(vku::toViewport(extent, true));
+     * cb.setScissorWithCount(vk::Rect2D { { 0, 0 }, extent });
+     * cb.draw(3, 1, 0, 0);
+     * @endcode
+     *
+     * @param device Vulkan-Hpp RAII device that is used to create <tt>vk::raii::ShaderEXT</tt>s.
+     * @param setLayouts Descriptor set layouts that are used by the shaders.
+     * @param pushConstantRanges Push constant ranges that are used by the shaders.
+     * @param shaders Variadic template parameters of <tt>vku::Shader</tt>s. This can be destroyed after the function call.
+     * @return Created shader objects.
+     */
+    export template <typename... Shaders>
+    [[nodiscard]] auto createShaderObjects(
+        const VULKAN_HPP_NAMESPACE::VULKAN_HPP_RAII_NAMESPACE::Device &device,
+        VULKAN_HPP_NAMESPACE::ArrayProxy<const VULKAN_HPP_NAMESPACE::DescriptorSetLayout> setLayouts,
+        VULKAN_HPP_NAMESPACE::ArrayProxy<const VULKAN_HPP_NAMESPACE::PushConstantRange> pushConstantRanges,
+        const Shaders &...shaders
+    ) -> ShaderObjects {
+        constexpr auto impl = []<std::size_t... Is>(
+            std::index_sequence<Is...>,
+            const VULKAN_HPP_NAMESPACE::VULKAN_HPP_RAII_NAMESPACE::Device &device,
+            VULKAN_HPP_NAMESPACE::ArrayProxy<const VULKAN_HPP_NAMESPACE::DescriptorSetLayout> setLayouts,
+            VULKAN_HPP_NAMESPACE::ArrayProxy<const VULKAN_HPP_NAMESPACE::PushConstantRange> pushConstantRanges,
+            const type_tag_t<Shader, Is> &...shaders
+        ) -> ShaderObjects {
+            const std::array stages { shaders.stage... };
+            const VULKAN_HPP_NAMESPACE::ShaderCreateFlagsEXT flags
+                = sizeof...(Is) > 1 ? VULKAN_HPP_NAMESPACE::ShaderCreateFlagBitsEXT::eLinkStage : VULKAN_HPP_NAMESPACE::ShaderCreateFlagsEXT{};
+            const std::array createInfos {
+                VULKAN_HPP_NAMESPACE::ShaderCreateInfoEXT {
+                    flags,
+                    shaders.stage,
+                    Is + 1 < sizeof...(Is) ? VULKAN_HPP_NAMESPACE::ShaderStageFlags { stages[std::min(Is + 1, sizeof...(Is) - 1)] } : VULKAN_HPP_NAMESPACE::ShaderStageFlags{},
+                    VULKAN_HPP_NAMESPACE::ShaderCodeTypeEXT::eSpirv,
+                    shaders.code.size_bytes(), shaders.code.data(),
+                    shaders.entryPoint,
+                    setLayouts.size(), setLayouts.data(),
+                    pushConstantRanges.size(), pushConstantRanges.data(),
+                    shaders.pSpecializationInfo,
+                }...
+            };
+
+            return {
+                stages | std::ranges::to<std::vector>(),
+                device.createShadersEXT(createInfos),
+            };
+        };
+
+        return impl(std::make_index_sequence<sizeof...(shaders)>{}, device, setLayouts, pushConstantRanges, shaders...);
+    }
+
+    /**
+     * Set the dynamic states required for drawing with <tt>VK_EXT_shader_object</tt>, to the same values that are
+     * baked in <tt>vku::getDefaultGraphicsPipelineCreateInfo</tt>.
+     *
+     * Viewport and scissor are left to be set by <tt>setViewportWithCount</tt> and <tt>setScissorWithCount</tt>, as they
+     * are dynamic in the default graphics pipeline, too.
+     *
+     * Depth and stencil tests are disabled, same as the default graphics pipeline with depth-stencil attachment.
+     *
+     * @param device Vulkan-Hpp RAII device whose dispatcher is used for recording the extension commands.
+     * @param commandBuffer Command buffer to record.
+     * @param colorAttachmentCount Number of color attachments (default=<tt>0</tt>).
+     * @param multisample MSAA sample count (default=<tt>vk::SampleCountFlagBits::e1</tt>).
+     * @note States that depend on the optional features (e.g. <tt>logicOp</tt>, <tt>alphaToOne</tt>) or extensions
+     * (e.g. <tt>VK_EXT_conservative_rasterization</tt>) are not set, and must be set by yourself if they are enabled.
+     */
+    export void setDefaultGraphicsDynamicStates(
+        const VULKAN_HPP_NAMESPACE::VULKAN_HPP_RAII_NAMESPACE::Device &device,
+        VULKAN_HPP_NAMESPACE::CommandBuffer commandBuffer,
+        std::uint32_t colorAttachmentCount = 0,
+        VULKAN_HPP_NAMESPACE::SampleCountFlagBits multisample = VULKAN_HPP_NAMESPACE::SampleCountFlagBits::e1
+    );
+}
+
+// --------------------
+// Implementations.
+// --------------------
+
+void vku::ShaderObjects::bind(
+    VULKAN_HPP_NAMESPACE::CommandBuffer commandBuffer
+) const {
+    if (shaders.empty()) {
+        return;
+    }
+
+    const std::vector handles = shaders | std::views::transform([](const auto &shader) { return *shader; }) | std::ranges::to<std::vector>();
+    commandBuffer.bindShadersEXT(stages, handles, *shaders.front().getDispatcher());
+}
+
+void vku::setDefaultGraphicsDynamicStates(
+    const VULKAN_HPP_NAMESPACE::VULKAN_HPP_RAII_NAMESPACE::Device &device,
+    VULKAN_HPP_NAMESPACE::CommandBuffer commandBuffer,
+    std::uint32_t colorAttachmentCount,
+    VULKAN_HPP_NAMESPACE::SampleCountFlagBits multisample
+) {
+    const auto &dispatcher = *device.getDispatcher();
+
+    // Vertex input and input assembly state.
+    commandBuffer.setVertexInputEXT({}, {}, dispatcher);
+    commandBuffer.setPrimitiveTopology(VULKAN_HPP_NAMESPACE::PrimitiveTopology::eTriangleList, dispatcher);
+    commandBuffer.setPrimitiveRestartEnable(false, dispatcher);
+
+    // Rasterization state.
+    commandBuffer.setDepthClampEnableEXT(false, dispatcher);
+    commandBuffer.setRasterizerDiscardEnable(false, dispatcher);
+    commandBuffer.setPolygonModeEXT(VULKAN_HPP_NAMESPACE::PolygonMode::eFill, dispatcher);
+    commandBuffer.setCullMode(VULKAN_HPP_NAMESPACE::CullModeFlagBits::eBack, dispatcher);
+    commandBuffer.setFrontFace(VULKAN_HPP_NAMESPACE::FrontFace::eCounterClockwise, dispatcher);
+    commandBuffer.setDepthBiasEnable(false, dispatcher);
+    commandBuffer.setLineWidth(1.f, dispatcher);
+
+    // Multisample state.
+    commandBuffer.setRasterizationSamplesEXT(multisample, dispatcher);
+    // Sample mask for up to 64 samples, one 32-bit word per 32 samples.
+    constexpr std::array sampleMasks { ~VULKAN_HPP_NAMESPACE::SampleMask{}, ~VULKAN_HPP_NAMESPACE::SampleMask{} };
+    commandBuffer.setSampleMaskEXT(multisample, std::span { sampleMasks }.first((static_cast<std::uint32_t>(multisample) + 31) / 32), dispatcher);
+    commandBuffer.setAlphaToCoverageEnableEXT(false, dispatcher);
+
+    // Depth-stencil state.
+    commandBuffer.setDepthTestEnable(false, dispatcher);
+    commandBuffer.setDepthWriteEnable(false, dispatcher);
+    commandBuffer.setDepthCompareOp(VULKAN_HPP_NAMESPACE::CompareOp::eNever, dispatcher);
+    commandBuffer.setDepthBoundsTestEnable(false, dispatcher);
+    commandBuffer.setStencilTestEnable(false, dispatcher);
+
+    // Color blend state.
+    if (colorAttachmentCount > 0) {
+        const std::vector<VULKAN_HPP_NAMESPACE::Bool32> colorBlendEnables(colorAttachmentCount, false);
+        const std::vector<VULKAN_HPP_NAMESPACE::ColorComponentFlags> colorWriteMasks(
+            colorAttachmentCount,
+            VULKAN_HPP_NAMESPACE::ColorComponentFlagBits::eR | VULKAN_HPP_NAMESPACE::ColorComponentFlagBits::eG | VULKAN_HPP_NAMESPACE::ColorComponentFlagBits::eB | VULKAN_HPP_NAMESPACE::ColorComponentFlagBits::eA);
+        commandBuffer.setColorBlendEnableEXT(0, colorBlendEnables, dispatcher);
+        commandBuffer.setColorWriteMaskEXT(0, colorWriteMasks, dispatcher);
+    }
+}
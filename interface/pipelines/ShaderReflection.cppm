@@ -0,0 +1,478 @@
+/** @file pipelines/ShaderReflection.cppm
+ */
+
+module;
+
+#include <vulkan/vulkan_hpp_macros.hpp>
+
+export module vku:pipelines.ShaderReflection;
+
+import std;
+export import vulkan_hpp;
+import :caches.ObjectCache;
+import :pipelines.Shader;
+
+namespace vku {
+    /**
+     * @brief Resource interface of the shaders (descriptor set layout bindings and push constant range), obtained by the
+     * SPIR-V reflection.
+     *
+     * Signatures of the multiple shader stages can be merged into a single pipeline signature, and the pipelines that have
+     * the same signature get the same (therefore compatible) pipeline layout from <tt>vku::DeviceObjectCache</tt>, so that
+     * the bound descriptor sets are persisted across the pipeline switches.
+     *
+     * Following things cannot be derived from SPIR-V and must be patched by yourself if needed:
+     * - Dynamic uniform/storage buffers are reflected as the non-dynamic ones.
+     * - Runtime-sized descriptor arrays are reflected with <tt>descriptorCount=0</tt>.
+     * - Push constant ranges of all stages are merged into a single range that covers all of them.
+     *
+     * @code{.cpp}
+     * const vku::Shader vertexShader = ..., fragmentShader = ...;
+     * vku::ReflectedPipelineLayout layout = vku::createReflectedPipelineLayout(
+     *     objectCache, vku::reflectShaders(vertexShader, fragmentShader));
+     * // layout.pipelineLayout is shared by the other pipelines with the same signature.
+     * @endcode
+     */
+    export struct ShaderSignature {
+        /**
+         * @brief Descriptor set layout bindings, indexed by set number and sorted by binding number. Unused set numbers
+         * have empty bindings.
+         */
+        std::vector<std::vector<VULKAN_HPP_NAMESPACE::DescriptorSetLayoutBinding>> setLayoutBindings;
+
+        /**
+         * @brief Push constant range, or <tt>std::nullopt</tt> if push constant is not used.
+         */
+        std::optional<VULKAN_HPP_NAMESPACE::PushConstantRange> pushConstantRange;
+
+        /**
+         * @brief Merge \p other signature into this.
+         *
+         * Bindings at the same set and binding number are merged by OR-ing their stage flags and taking the max
+         * descriptor count.
+         *
+         * @param other Signature to be merged.
+         * @throw std::runtime_error If bindings at the same set and binding number have different descriptor types.
+         */
+        void merge(const ShaderSignature &other);
+
+        [[nodiscard]] bool operator==(const ShaderSignature&) const noexcept = default;
+    };
+
+    /**
+     * @brief Descriptor set layouts and pipeline layout that are created from <tt>vku::ShaderSignature</tt>.
+     */
+    export struct ReflectedPipelineLayout {
+        std::vector<std::shared_ptr<const VULKAN_HPP_NAMESPACE::VULKAN_HPP_RAII_NAMESPACE::DescriptorSetLayout>> setLayouts;
+        std::shared_ptr<const VULKAN_HPP_NAMESPACE::VULKAN_HPP_RAII_NAMESPACE::PipelineLayout> pipelineLayout;
+    };
+
+    /**
+     * @brief Reflect the resource interface of SPIR-V \p code.
+     * @param code SPIR-V code.
+     * @param stage Shader stage of \p code.
+     * @return Shader signature.
+     * @throw std::runtime_error If \p code is not a valid SPIR-V module.
+     */
+    export
+    [[nodiscard]] auto reflectShader(std::span<const std::uint32_t> code, VULKAN_HPP_NAMESPACE::ShaderStageFlagBits stage) -> ShaderSignature;
+
+    /**
+     * @brief Reflect the resource interfaces of <tt>vku::Shader</tt>s and merge them into a pipeline signature.
+     * @param shaders Variadic template parameters of <tt>vku::Shader</tt>s.
+     * @return Merged shader signature.
+     * @throw std::runtime_error If any shader is not a valid SPIR-V module, or the shaders have conflicting bindings.
+     */
+    export template <typename... Shaders>
+    [[nodiscard]] auto reflectShaders(const Shaders &...shaders) -> ShaderSignature {
+        ShaderSignature result;
+        ([&](const Shader &shader) {
+            result.merge(reflectShader(shader.code, shader.stage));
+        }(shaders), ...);
+        return result;
+    }
+
+    /**
+     * @brief Get the descriptor set layouts and pipeline layout of \p signature from \p objectCache.
+     * @param objectCache Device object cache.
+     * @param signature Pipeline signature.
+     * @return Descriptor set layouts (for all set numbers, including unused ones) and pipeline layout.
+     */
+    export
+    [[nodiscard]] auto createReflectedPipelineLayout(DeviceObjectCache &objectCache, const ShaderSignature &signature) -> ReflectedPipelineLayout;
+}
+
+// --------------------
+// Implementations.
+// --------------------
+
+/**
+ * @brief Minimal SPIR-V parser that only collects the information for the resource interface reflection.
+ * @see https://registry.khronos.org/SPIR-V/specs/unified1/SPIRV.html
+ */
+class SpirvReflector {
+public:
+    explicit SpirvReflector(std::span<const std::uint32_t> code) {
+        if (code.size() < 5 || code[0] != MAGIC_NUMBER) {
+            throw std::runtime_error { "Invalid SPIR-V module" };
+        }
+
+        for (std::size_t i = 5; i < code.size();) {
+            const std::uint32_t wordCount = code[i] >> 16;
+            if (wordCount == 0 || i + wordCount > code.size()) {
+                throw std::runtime_error { "Invalid SPIR-V module: malformed instruction" };
+            }
+            parseInstruction(code[i] & 0xFFFF, code.subspan(i + 1, wordCount - 1));
+            i += wordCount;
+        }
+    }
+
+    [[nodiscard]] auto getSignature(VULKAN_HPP_NAMESPACE::ShaderStageFlagBits stage) const -> ShaderSignature {
+        ShaderSignature result;
+
+        std::optional<std::pair<std::uint32_t, std::uint32_t>> pushConstantBounds;
+        for (const auto &[id, variable] : variables) {
+            if (variable.storageClass == STORAGE_CLASS_PUSH_CONSTANT) {
+                const std::pair bounds = getStructBounds(getPointeeType(variable.pointerType));
+                if (pushConstantBounds) {
+                    pushConstantBounds->first = std::min(pushConstantBounds->first, bounds.first);
+                    pushConstantBounds->second = std::max(pushConstantBounds->second, bounds.second);
+                }
+                else {
+                    pushConstantBounds = bounds;
+                }
+                continue;
+            }
+
+            if (variable.storageClass != STORAGE_CLASS_UNIFORM_CONSTANT
+                && variable.storageClass != STORAGE_CLASS_UNIFORM
+                && variable.storageClass != STORAGE_CLASS_STORAGE_BUFFER) {
+                continue;
+            }
+
+            const Decoration *decoration = findDecoration(id);
+            if (!decoration || !decoration->set || !decoration->binding) {
+                continue;
+            }
+
+            // Unwrap the descriptor array.
+            std::uint32_t typeId = getPointeeType(variable.pointerType);
+            std::uint32_t descriptorCount = 1;
+            if (const Type &type = types.at(typeId); type.opcode == OP_TYPE_ARRAY) {
+                descriptorCount = constants.at(type.operands[1]);
+                typeId = type.operands[0];
+            }
+            else if (type.opcode == OP_TYPE_RUNTIME_ARRAY) {
+                descriptorCount = 0;
+                typeId = type.operands[0];
+            }
+
+            const std::uint32_t set = *decoration->set;
+            if (set >= result.setLayoutBindings.size()) {
+                result.setLayoutBindings.resize(set + 1);
+            }
+            result.setLayoutBindings[set].push_back({
+                *decoration->binding,
+                getDescriptorType(typeId, variable.storageClass),
+                descriptorCount,
+                stage,
+            });
+        }
+
+        for (auto &bindings : result.setLayoutBindings) {
+            std::ranges::sort(bindings, {}, &VULKAN_HPP_NAMESPACE::DescriptorSetLayoutBinding::binding);
+        }
+
+        if (pushConstantBounds) {
+            result.pushConstantRange.emplace(stage, pushConstantBounds->first, pushConstantBounds->second - pushConstantBounds->first);
+        }
+
+        return result;
+    }
+
+private:
+    static constexpr std::uint32_t MAGIC_NUMBER = 0x07230203;
+
+    static constexpr std::uint32_t OP_TYPE_INT = 21;
+    static constexpr std::uint32_t OP_TYPE_FLOAT = 22;
+    static constexpr std::uint32_t OP_TYPE_VECTOR = 23;
+    static constexpr std::uint32_t OP_TYPE_MATRIX = 24;
+    static constexpr std::uint32_t OP_TYPE_IMAGE = 25;
+    static constexpr std::uint32_t OP_TYPE_SAMPLER = 26;
+    static constexpr std::uint32_t OP_TYPE_SAMPLED_IMAGE = 27;
+    static constexpr std::uint32_t OP_TYPE_ARRAY = 28;
+    static constexpr std::uint32_t OP_TYPE_RUNTIME_ARRAY = 29;
+    static constexpr std::uint32_t OP_TYPE_STRUCT = 30;
+    static constexpr std::uint32_t OP_TYPE_POINTER = 32;
+    static constexpr std::uint32_t OP_CONSTANT = 43;
+    static constexpr std::uint32_t OP_SPEC_CONSTANT = 50;
+    static constexpr std::uint32_t OP_VARIABLE = 59;
+    static constexpr std::uint32_t OP_DECORATE = 71;
+    static constexpr std::uint32_t OP_MEMBER_DECORATE = 72;
+    static constexpr std::uint32_t OP_TYPE_ACCELERATION_STRUCTURE = 5341;
+
+    static constexpr std::uint32_t DECORATION_BLOCK = 2;
+    static constexpr std::uint32_t DECORATION_BUFFER_BLOCK = 3;
+    static constexpr std::uint32_t DECORATION_ROW_MAJOR = 4;
+    static constexpr std::uint32_t DECORATION_ARRAY_STRIDE = 6;
+    static constexpr std::uint32_t DECORATION_MATRIX_STRIDE = 7;
+    static constexpr std::uint32_t DECORATION_BINDING = 33;
+    static constexpr std::uint32_t DECORATION_DESCRIPTOR_SET = 34;
+    static constexpr std::uint32_t DECORATION_OFFSET = 35;
+
+    static constexpr std::uint32_t STORAGE_CLASS_UNIFORM_CONSTANT = 0;
+    static constexpr std::uint32_t STORAGE_CLASS_UNIFORM = 2;
+    static constexpr std::uint32_t STORAGE_CLASS_PUSH_CONSTANT = 9;
+    static constexpr std::uint32_t STORAGE_CLASS_STORAGE_BUFFER = 12;
+
+    static constexpr std::uint32_t DIM_BUFFER = 5;
+    static constexpr std::uint32_t DIM_SUBPASS_DATA = 6;
+
+    struct Type {
+        std::uint32_t opcode;
+        std::vector<std::uint32_t> operands; // Operands after the result id.
+    };
+
+    struct MemberDecoration {
+        std::optional<std::uint32_t> offset;
+        std::optional<std::uint32_t> matrixStride;
+        bool rowMajor = false;
+    };
+
+    struct Decoration {
+        std::optional<std::uint32_t> set;
+        std::optional<std::uint32_t> binding;
+        std::optional<std::uint32_t> arrayStride;
+        bool block = false;
+        bool bufferBlock = false;
+        std::unordered_map<std::uint32_t, MemberDecoration> members;
+    };
+
+    struct Variable {
+        std::uint32_t pointerType;
+        std::uint32_t storageClass;
+    };
+
+    std::unordered_map<std::uint32_t, Type> types;
+    std::unordered_map<std::uint32_t, std::uint32_t> constants;
+    std::unordered_map<std::uint32_t, Decoration> decorations;
+    std::map<std::uint32_t, Variable> variables;
+
+    void parseInstruction(std::uint32_t opcode, std::span<const std::uint32_t> operands) {
+        switch (opcode) {
+            case OP_TYPE_INT: case OP_TYPE_FLOAT: case OP_TYPE_VECTOR: case OP_TYPE_MATRIX: case OP_TYPE_IMAGE:
+            case OP_TYPE_SAMPLER: case OP_TYPE_SAMPLED_IMAGE: case OP_TYPE_ARRAY: case OP_TYPE_RUNTIME_ARRAY:
+            case OP_TYPE_STRUCT: case OP_TYPE_POINTER: case OP_TYPE_ACCELERATION_STRUCTURE:
+                types.emplace(operands[0], Type { opcode, operands.subspan(1) | std::ranges::to<std::vector>() });
+                break;
+            case OP_CONSTANT: case OP_SPEC_CONSTANT:
+                // Only the lower 32-bit is used, as it is only for the array length.
+                constants.emplace(operands[1], operands[2]);
+                break;
+            case OP_VARIABLE:
+                variables.emplace(operands[1], Variable { operands[0], operands[2] });
+                break;
+            case OP_DECORATE: {
+                Decoration &decoration = decorations[operands[0]];
+                switch (operands[1]) {
+                    case DECORATION_DESCRIPTOR_SET: decoration.set = operands[2]; break;
+                    case DECORATION_BINDING: decoration.binding = operands[2]; break;
+                    case DECORATION_ARRAY_STRIDE: decoration.arrayStride = operands[2]; break;
+                    case DECORATION_BLOCK: decoration.block = true; break;
+                    case DECORATION_BUFFER_BLOCK: decoration.bufferBlock = true; break;
+                    default: break;
+                }
+                break;
+            }
+            case OP_MEMBER_DECORATE: {
+                MemberDecoration &decoration = decorations[operands[0]].members[operands[1]];
+                switch (operands[2]) {
+                    case DECORATION_OFFSET: decoration.offset = operands[3]; break;
+                    case DECORATION_MATRIX_STRIDE: decoration.matrixStride = operands[3]; break;
+                    case DECORATION_ROW_MAJOR: decoration.rowMajor = true; break;
+                    default: break;
+                }
+                break;
+            }
+            default:
+                break;
+        }
+    }
+
+    [[nodiscard]] auto findDecoration(std::uint32_t id) const noexcept -> const Decoration* {
+        const auto it = decorations.find(id);
+        return it == decorations.end() ? nullptr : &it->second;
+    }
+
+    [[nodiscard]] auto getPointeeType(std::uint32_t pointerType) const -> std::uint32_t {
+        // OpTypePointer operands: Storage Class, Type.
+        return types.at(pointerType).operands[1];
+    }
+
+    [[nodiscard]] auto getDescriptorType(std::uint32_t typeId, std::uint32_t storageClass) const -> VULKAN_HPP_NAMESPACE::DescriptorType {
+        const Type &type = types.at(typeId);
+        switch (type.opcode) {
+            case OP_TYPE_SAMPLER:
+                return VULKAN_HPP_NAMESPACE::DescriptorType::eSampler;
+            case OP_TYPE_SAMPLED_IMAGE:
+                // OpTypeSampledImage operands: Image Type.
+                if (types.at(type.operands[0]).operands[1] == DIM_BUFFER) {
+                    return VULKAN_HPP_NAMESPACE::DescriptorType::eUniformTexelBuffer;
+                }
+                return VULKAN_HPP_NAMESPACE::DescriptorType::eCombinedImageSampler;
+            case OP_TYPE_IMAGE: {
+                // OpTypeImage operands: Sampled Type, Dim, Depth, Arrayed, MS, Sampled, Image Format.
+                const std::uint32_t dim = type.operands[1], sampled = type.operands[5];
+                if (dim == DIM_SUBPASS_DATA) {
+                    return VULKAN_HPP_NAMESPACE::DescriptorType::eInputAttachment;
+                }
+                if (dim == DIM_BUFFER) {
+                    return sampled == 2 ? VULKAN_HPP_NAMESPACE::DescriptorType::eStorageTexelBuffer : VULKAN_HPP_NAMESPACE::DescriptorType::eUniformTexelBuffer;
+                }
+                return sampled == 2 ? VULKAN_HPP_NAMESPACE::DescriptorType::eStorageImage : VULKAN_HPP_NAMESPACE::DescriptorType::eSampledImage;
+            }
+            case OP_TYPE_ACCELERATION_STRUCTURE:
+                return VULKAN_HPP_NAMESPACE::DescriptorType::eAccelerationStructureKHR;
+            case OP_TYPE_STRUCT:
+                if (storageClass == STORAGE_CLASS_STORAGE_BUFFER) {
+                    return VULKAN_HPP_NAMESPACE::DescriptorType::eStorageBuffer;
+                }
+                if (const Decoration *decoration = findDecoration(typeId); decoration && decoration->bufferBlock) {
+                    // Legacy storage buffer declaration (before SPIR-V 1.3).
+                    return VULKAN_HPP_NAMESPACE::DescriptorType::eStorageBuffer;
+                }
+                return VULKAN_HPP_NAMESPACE::DescriptorType::eUniformBuffer;
+            default:
+                throw std::runtime_error { std::format("Unsupported descriptor type (opcode={})", type.opcode) };
+        }
+    }
+
+    /**
+     * @brief Get the byte range <tt>[begin, end)</tt> of the struct members.
+     */
+    [[nodiscard]] auto getStructBounds(std::uint32_t structType) const -> std::pair<std::uint32_t, std::uint32_t> {
+        const Type &type = types.at(structType);
+        const Decoration *decoration = findDecoration(structType);
+
+        std::uint32_t begin = std::numeric_limits<std::uint32_t>::max(), end = 0;
+        for (std::uint32_t i = 0; i < type.operands.size(); ++i) {
+            MemberDecoration memberDecoration{};
+            if (decoration) {
+                if (auto it = decoration->members.find(i); it != decoration->members.end()) {
+                    memberDecoration = it->second;
+                }
+            }
+
+            const std::uint32_t offset = memberDecoration.offset.value_or(0);
+            begin = std::min(begin, offset);
+            end = std::max(end, offset + getTypeSize(type.operands[i], memberDecoration));
+        }
+        return { type.operands.empty() ? 0 : begin, end };
+    }
+
+    [[nodiscard]] auto getTypeSize(std::uint32_t typeId, const MemberDecoration &memberDecoration) const -> std::uint32_t {
+        const Type &type = types.at(typeId);
+        switch (type.opcode) {
+            case OP_TYPE_INT: case OP_TYPE_FLOAT:
+                // Operands: Width, ...
+                return type.operands[0] / 8;
+            case OP_TYPE_VECTOR:
+                // Operands: Component Type, Component Count.
+                return getTypeSize(type.operands[0], {}) * type.operands[1];
+            case OP_TYPE_MATRIX: {
+                // Operands: Column Type, Column Count.
+                const std::uint32_t columnCount = type.operands[1];
+                if (!memberDecoration.matrixStride) {
+                    return getTypeSize(type.operands[0], {}) * columnCount;
+                }
+                const std::uint32_t rowCount = types.at(type.operands[0]).operands[1];
+                return *memberDecoration.matrixStride * (memberDecoration.rowMajor ? rowCount : columnCount);
+            }
+            case OP_TYPE_ARRAY: {
+                // Operands: Element Type, Length.
+                const std::uint32_t length = constants.at(type.operands[1]);
+                const Decoration *decoration = findDecoration(typeId);
+                if (decoration && decoration->arrayStride) {
+                    return *decoration->arrayStride * length;
+                }
+                return getTypeSize(type.operands[0], memberDecoration) * length;
+            }
+            case OP_TYPE_STRUCT:
+                return getStructBounds(typeId).second;
+            case OP_TYPE_POINTER:
+                // Physical storage buffer pointer.
+                return 8;
+            default:
+                // Runtime array and opaque types have no size.
+                return 0;
+        }
+    }
+};
+
+void vku::ShaderSignature::merge(
+    const ShaderSignature &other
+) {
+    if (setLayoutBindings.size() < other.setLayoutBindings.size()) {
+        setLayoutBindings.resize(other.setLayoutBindings.size());
+    }
+
+    for (auto &&[bindings, otherBindings] : std::views::zip(setLayoutBindings, other.setLayoutBindings)) {
+        for (const VULKAN_HPP_NAMESPACE::DescriptorSetLayoutBinding &otherBinding : otherBindings) {
+            const auto it = std::ranges::lower_bound(bindings, otherBinding.binding, {}, &VULKAN_HPP_NAMESPACE::DescriptorSetLayoutBinding::binding);
+            if (it == bindings.end() || it->binding != otherBinding.binding) {
+                bindings.insert(it, otherBinding);
+            }
+            else if (it->descriptorType != otherBinding.descriptorType) {
+                throw std::runtime_error { std::format(
+                    "Conflicting descriptor type at binding {}: {} and {}",
+                    otherBinding.binding, to_string(it->descriptorType), to_string(otherBinding.descriptorType)) };
+            }
+            else {
+                it->descriptorCount = std::max(it->descriptorCount, otherBinding.descriptorCount);
+                it->stageFlags |= otherBinding.stageFlags;
+            }
+        }
+    }
+
+    if (other.pushConstantRange) {
+        if (pushConstantRange) {
+            const std::uint32_t end = std::max(pushConstantRange->offset + pushConstantRange->size, other.pushConstantRange->offset + other.pushConstantRange->size);
+            pushConstantRange->stageFlags |= other.pushConstantRange->stageFlags;
+            pushConstantRange->offset = std::min(pushConstantRange->offset, other.pushConstantRange->offset);
+            pushConstantRange->size = end - pushConstantRange->offset;
+        }
+        else {
+            pushConstantRange = other.pushConstantRange;
+        }
+    }
+}
+
+auto vku::reflectShader(
+    std::span<const std::uint32_t> code,
+    VULKAN_HPP_NAMESPACE::ShaderStageFlagBits stage
+) -> ShaderSignature {
+    return SpirvReflector { code }.getSignature(stage);
+}
+
+auto vku::createReflectedPipelineLayout(
+    DeviceObjectCache &objectCache,
+    const ShaderSignature &signature
+) -> ReflectedPipelineLayout {
+    ReflectedPipelineLayout result;
+    result.setLayouts.reserve(signature.setLayoutBindings.size());
+    for (const auto &bindings : signature.setLayoutBindings) {
+        result.setLayouts.push_back(objectCache.getDescriptorSetLayout(VULKAN_HPP_NAMESPACE::DescriptorSetLayoutCreateInfo { {}, bindings }));
+    }
+
+    const std::vector setLayoutHandles
+        = result.setLayouts
+        | std::views::transform([](const auto &setLayout) { return **setLayout; })
+        | std::ranges::to<std::vector>();
+    VULKAN_HPP_NAMESPACE::PipelineLayoutCreateInfo createInfo { {}, setLayoutHandles };
+    if (signature.pushConstantRange) {
+        createInfo.setPushConstantRanges(*signature.pushConstantRange);
+    }
+    result.pipelineLayout = objectCache.getPipelineLayout(createInfo);
+
+    return result;
+}
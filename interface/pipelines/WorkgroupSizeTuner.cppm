@@ -0,0 +1,429 @@
+/** @file pipelines/WorkgroupSizeTuner.cppm
+ */
+
+module;
+
+#include <vulkan/vulkan_hpp_macros.hpp>
+
+export module vku:pipelines.WorkgroupSizeTuner;
+
+import std;
+export import vulkan_hpp;
+import :pipelines.Shader;
+
+#define FWD(...) static_cast<decltype(__VA_ARGS__)&&>(__VA_ARGS__)
+
+namespace vku {
+    /**
+     * @brief Compute shader workgroup size autotuner, using specialization constants and timestamp queries.
+     *
+     * The compute shader must declare its workgroup size by the specialization constants, with the constant IDs
+     * <tt>WorkgroupSizeTuner::constantIds</tt>:
+     * @code{.glsl}
+     * layout (local_size_x_id = 0, local_size_y_id = 1, local_size_z_id = 2) in;
+     * @endcode
+     *
+     * For each kernel key, the tuner creates the pipeline per candidate workgroup size, measures the GPU time of the
+     * representative dispatches recorded by the user, and remembers the fastest one. Results are persisted into a text
+     * file whose entries are keyed by the device's <tt>pipelineCacheUUID</tt>, so the later runs on the same device (and
+     * driver) get the result without re-tuning, while the tuning is redone on another device without discarding the
+     * results of the other devices in the same file.
+     *
+     * All member functions are thread-safe, but tuning of the same kernel from multiple threads may run redundantly.
+     *
+     * @code{.cpp}
+     * vku::WorkgroupSizeTuner tuner { gpu.device, gpu.physicalDevice, "workgroup_sizes.txt" };
+     * const vku::WorkgroupSizeTuner::WorkgroupSize workgroupSize = tuner.tune(
+     *     "blur", vku::Shader::fromSpirvFile("blur.comp.spv", vk::ShaderStageFlagBits::eCompute), *pipelineLayout,
+     *     { { 8, 8, 1 }, { 16, 16, 1 }, { 32, 8, 1 }, { 64, 1, 1 } },
+     *     gpu.queues.compute, gpu.queueFamilies.compute,
+     *     [&](vk::CommandBuffer cb, const vku::WorkgroupSizeTuner::WorkgroupSize &size) {
+     *         cb.bindDescriptorSets(vk::PipelineBindPoint::eCompute, *pipelineLayout, 0, descriptorSet, {});
+     *         cb.dispatch((width + size[0] - 1) / size[0], (height + size[1] - 1) / size[1], 1);
+     *     });
+     * const vk::raii::Pipeline pipeline = tuner.createPipeline(shader, *pipelineLayout, workgroupSize);
+     * @endcode
+     */
+    export class WorkgroupSizeTuner {
+    public:
+        using WorkgroupSize = std::array<std::uint32_t, 3>;
+
+        /**
+         * @brief Specialization constant IDs of the workgroup size (x, y, z).
+         */
+        static constexpr std::array<std::uint32_t, 3> constantIds { 0, 1, 2 };
+
+        /**
+         * @brief Path to the persisted results file. If empty, results are not persisted.
+         */
+        std::filesystem::path path;
+
+        /**
+         * @brief Create the tuner, and load the persisted results from \p path if it is tuned with the same device.
+         * @param device Vulkan device.
+         * @param physicalDevice Physical device of \p device.
+         * @param path Path to the persisted results file (default=empty, not persisted).
+         * @param pipelineCache Pipeline cache that is used for creating the candidate pipelines, or <tt>nullptr</tt> if not used.
+         */
+        WorkgroupSizeTuner(
+            const VULKAN_HPP_NAMESPACE::VULKAN_HPP_RAII_NAMESPACE::Device &device [[clang::lifetimebound]],
+            VULKAN_HPP_NAMESPACE::PhysicalDevice physicalDevice,
+            std::filesystem::path path = {},
+            const VULKAN_HPP_NAMESPACE::VULKAN_HPP_RAII_NAMESPACE::PipelineCache *pipelineCache = nullptr
+        );
+
+        /**
+         * @brief Get the tuned workgroup size of \p kernelKey.
+         * @param kernelKey Kernel identifier.
+         * @return Tuned workgroup size, or <tt>std::nullopt</tt> if the kernel is not tuned yet.
+         */
+        [[nodiscard]] auto find(std::string_view kernelKey) const -> std::optional<WorkgroupSize>;
+
+        /**
+         * @brief Get the tuned workgroup size of \p kernelKey, or tune it if not tuned yet.
+         *
+         * For each candidate, the pipeline is bound and \p dispatcher is called once for the warm-up and
+         * \p iterations times for the measurement. The tuning result is saved to <tt>path</tt> immediately.
+         *
+         * @param kernelKey Kernel identifier. It must not contain the newline characters.
+         * @param shader Compute shader. If it has <tt>pSpecializationInfo</tt>, the workgroup size constants are appended to it.
+         * @param layout Pipeline layout.
+         * @param candidates Candidate workgroup sizes. Candidates exceeding the device limits are skipped.
+         * @param queue Queue that is used for the measurement. Its family must support the timestamp queries.
+         * @param queueFamilyIndex Queue family index of \p queue.
+         * @param dispatcher Function that records the representative dispatch with the given workgroup size. Pipeline is
+         * already bound when it is called.
+         * @param iterations Number of the measured dispatches per candidate (default=<tt>8</tt>).
+         * @return Fastest workgroup size.
+         * @throw std::runtime_error If no candidate is valid, or the queue family doesn't support the timestamp queries.
+         */
+        template <std::invocable<VULKAN_HPP_NAMESPACE::CommandBuffer, const WorkgroupSize&> F>
+        auto tune(
+            std::string_view kernelKey,
+            const Shader &shader,
+            VULKAN_HPP_NAMESPACE::PipelineLayout layout,
+            VULKAN_HPP_NAMESPACE::ArrayProxy<const WorkgroupSize> candidates,
+            VULKAN_HPP_NAMESPACE::Queue queue,
+            std::uint32_t queueFamilyIndex,
+            F &&dispatcher,
+            std::uint32_t iterations = 8
+        ) -> WorkgroupSize {
+            if (std::optional result = find(kernelKey)) {
+                return *result;
+            }
+
+            return measure(kernelKey, shader, layout, candidates, queue, queueFamilyIndex, std::function<void(VULKAN_HPP_NAMESPACE::CommandBuffer, const WorkgroupSize&)> { FWD(dispatcher) }, iterations);
+        }
+
+        /**
+         * @brief Create the compute pipeline of \p shader with \p workgroupSize.
+         * @param shader Compute shader.
+         * @param layout Pipeline layout.
+         * @param workgroupSize Workgroup size.
+         * @return Compute pipeline.
+         */
+        [[nodiscard]] auto createPipeline(
+            const Shader &shader,
+            VULKAN_HPP_NAMESPACE::PipelineLayout layout,
+            const WorkgroupSize &workgroupSize
+        ) const -> VULKAN_HPP_NAMESPACE::VULKAN_HPP_RAII_NAMESPACE::Pipeline;
+
+        /**
+         * @brief Save the tuned results into <tt>path</tt>, preserving the entries of the other devices in the file. Does
+         * nothing if <tt>path</tt> is empty.
+         * @throw std::runtime_error If failed to write the file.
+         */
+        void save() const;
+
+    private:
+        std::reference_wrapper<const VULKAN_HPP_NAMESPACE::VULKAN_HPP_RAII_NAMESPACE::Device> device;
+        VULKAN_HPP_NAMESPACE::PhysicalDeviceProperties properties;
+        std::vector<VULKAN_HPP_NAMESPACE::QueueFamilyProperties> queueFamilyProperties;
+        const VULKAN_HPP_NAMESPACE::VULKAN_HPP_RAII_NAMESPACE::PipelineCache *pipelineCache;
+
+        mutable std::mutex mutex;
+        std::map<std::string, WorkgroupSize, std::less<>> results;
+
+        /**
+         * @brief Measure all candidates and store the fastest one as the result of \p kernelKey.
+         */
+        auto measure(
+            std::string_view kernelKey,
+            const Shader &shader,
+            VULKAN_HPP_NAMESPACE::PipelineLayout layout,
+            VULKAN_HPP_NAMESPACE::ArrayProxy<const WorkgroupSize> candidates,
+            VULKAN_HPP_NAMESPACE::Queue queue,
+            std::uint32_t queueFamilyIndex,
+            const std::function<void(VULKAN_HPP_NAMESPACE::CommandBuffer, const WorkgroupSize&)> &dispatcher,
+            std::uint32_t iterations
+        ) -> WorkgroupSize;
+
+        [[nodiscard]] bool isSupported(const WorkgroupSize &workgroupSize) const noexcept;
+        [[nodiscard]] auto getDeviceUuidString() const -> std::string;
+        void load();
+
+        /**
+         * @brief Parse a line of the results file.
+         * @return Tuple of device UUID string, kernel key and workgroup size, or <tt>std::nullopt</tt> if the line is malformed.
+         */
+        [[nodiscard]] static auto parseEntry(const std::string &line) -> std::optional<std::tuple<std::string, std::string, WorkgroupSize>>;
+    };
+}
+
+// --------------------
+// Implementations.
+// --------------------
+
+vku::WorkgroupSizeTuner::WorkgroupSizeTuner(
+    const VULKAN_HPP_NAMESPACE::VULKAN_HPP_RAII_NAMESPACE::Device &device,
+    VULKAN_HPP_NAMESPACE::PhysicalDevice physicalDevice,
+    std::filesystem::path path,
+    const VULKAN_HPP_NAMESPACE::VULKAN_HPP_RAII_NAMESPACE::PipelineCache *pipelineCache
+) : path { std::move(path) },
+    device { device },
+    properties { physicalDevice.getProperties() },
+    queueFamilyProperties { physicalDevice.getQueueFamilyProperties() },
+    pipelineCache { pipelineCache } {
+    load();
+}
+
+auto vku::WorkgroupSizeTuner::find(
+    std::string_view kernelKey
+) const -> std::optional<WorkgroupSize> {
+    std::scoped_lock lock { mutex };
+    if (auto it = results.find(kernelKey); it != results.end()) {
+        return it->second;
+    }
+    return std::nullopt;
+}
+
+auto vku::WorkgroupSizeTuner::createPipeline(
+    const Shader &shader,
+    VULKAN_HPP_NAMESPACE::PipelineLayout layout,
+    const WorkgroupSize &workgroupSize
+) const -> VULKAN_HPP_NAMESPACE::VULKAN_HPP_RAII_NAMESPACE::Pipeline {
+    // Append the workgroup size constants after the user's specialization constants.
+    std::vector<VULKAN_HPP_NAMESPACE::SpecializationMapEntry> mapEntries;
+    std::vector<std::byte> data;
+    if (shader.pSpecializationInfo) {
+        const std::span userMapEntries { shader.pSpecializationInfo->pMapEntries, shader.pSpecializationInfo->mapEntryCount };
+        const std::span userData { static_cast<const std::byte*>(shader.pSpecializationInfo->pData), shader.pSpecializationInfo->dataSize };
+        mapEntries.assign(userMapEntries.begin(), userMapEntries.end());
+        data.assign(userData.begin(), userData.end());
+    }
+
+    // Align the offset to 4 bytes.
+    data.resize((data.size() + 3) / 4 * 4);
+    for (std::uint32_t i = 0; i < 3; ++i) {
+        mapEntries.emplace_back(constantIds[i], static_cast<std::uint32_t>(data.size()), sizeof(std::uint32_t));
+        const std::span bytes = std::as_bytes(std::span { &workgroupSize[i], 1 });
+        data.insert(data.end(), bytes.begin(), bytes.end());
+    }
+
+    const VULKAN_HPP_NAMESPACE::SpecializationInfo specializationInfo {
+        mapEntries,
+        VULKAN_HPP_NAMESPACE::ArrayProxyNoTemporaries<const std::byte> { data },
+    };
+    const VULKAN_HPP_NAMESPACE::VULKAN_HPP_RAII_NAMESPACE::ShaderModule shaderModule {
+        device.get(),
+        VULKAN_HPP_NAMESPACE::ShaderModuleCreateInfo { {}, shader.code },
+    };
+    return { device.get(), pipelineCache, VULKAN_HPP_NAMESPACE::ComputePipelineCreateInfo {
+        {},
+        VULKAN_HPP_NAMESPACE::PipelineShaderStageCreateInfo {
+            {},
+            VULKAN_HPP_NAMESPACE::ShaderStageFlagBits::eCompute,
+            *shaderModule,
+            shader.entryPoint,
+            &specializationInfo,
+        },
+        layout,
+    } };
+}
+
+void vku::WorkgroupSizeTuner::save() const {
+    if (path.empty()) {
+        return;
+    }
+
+    // Concurrent tune() calls of the different kernels save at the same time, therefore the whole read-modify-write of
+    // the file is serialized.
+    std::scoped_lock lock { mutex };
+
+    const std::string uuid = getDeviceUuidString();
+
+    // Keep the entries of the other devices, which may be written after this tuner loaded the file.
+    std::vector<std::string> otherDeviceLines;
+    if (std::ifstream file { path }) {
+        for (std::string line; std::getline(file, line);) {
+            if (std::optional entry = parseEntry(line); entry && get<0>(*entry) != uuid) {
+                otherDeviceLines.push_back(std::move(line));
+            }
+        }
+    }
+
+    if (path.has_parent_path()) {
+        std::filesystem::create_directories(path.parent_path());
+    }
+
+    // Temporary file name must be unique among the processes that are writing the same file.
+    std::filesystem::path tempPath = path;
+    tempPath += std::format(".{:016x}.tmp", std::random_device{}() ^ std::hash<std::thread::id>{}(std::this_thread::get_id()));
+    {
+        std::ofstream file { tempPath, std::ios::trunc };
+        for (const std::string &line : otherDeviceLines) {
+            file << line << '\n';
+        }
+        for (const auto &[kernelKey, workgroupSize] : results) {
+            file << uuid << ' ' << std::quoted(kernelKey) << ' ' << workgroupSize[0] << ' ' << workgroupSize[1] << ' ' << workgroupSize[2] << '\n';
+        }
+
+        if (!file) {
+            throw std::runtime_error { std::format("Failed to write workgroup size tuning results to {}", tempPath.string()) };
+        }
+    }
+    std::filesystem::rename(tempPath, path);
+}
+
+auto vku::WorkgroupSizeTuner::measure(
+    std::string_view kernelKey,
+    const Shader &shader,
+    VULKAN_HPP_NAMESPACE::PipelineLayout layout,
+    VULKAN_HPP_NAMESPACE::ArrayProxy<const WorkgroupSize> candidates,
+    VULKAN_HPP_NAMESPACE::Queue queue,
+    std::uint32_t queueFamilyIndex,
+    const std::function<void(VULKAN_HPP_NAMESPACE::CommandBuffer, const WorkgroupSize&)> &dispatcher,
+    std::uint32_t iterations
+) -> WorkgroupSize {
+    if (queueFamilyProperties.at(queueFamilyIndex).timestampValidBits == 0) {
+        throw std::runtime_error { std::format("Queue family {} does not support the timestamp queries", queueFamilyIndex) };
+    }
+
+    const std::vector supportedCandidates
+        = candidates
+        | std::views::filter([this](const WorkgroupSize &workgroupSize) { return isSupported(workgroupSize); })
+        | std::ranges::to<std::vector>();
+    if (supportedCandidates.empty()) {
+        throw std::runtime_error { std::format("No supported workgroup size candidate for kernel {}", kernelKey) };
+    }
+
+    const std::vector pipelines
+        = supportedCandidates
+        | std::views::transform([&](const WorkgroupSize &workgroupSize) { return createPipeline(shader, layout, workgroupSize); })
+        | std::ranges::to<std::vector>();
+
+    const auto queryCount = static_cast<std::uint32_t>(2 * supportedCandidates.size());
+    const VULKAN_HPP_NAMESPACE::VULKAN_HPP_RAII_NAMESPACE::QueryPool queryPool {
+        device.get(),
+        VULKAN_HPP_NAMESPACE::QueryPoolCreateInfo { {}, VULKAN_HPP_NAMESPACE::QueryType::eTimestamp, queryCount },
+    };
+    const VULKAN_HPP_NAMESPACE::VULKAN_HPP_RAII_NAMESPACE::CommandPool commandPool {
+        device.get(),
+        VULKAN_HPP_NAMESPACE::CommandPoolCreateInfo { VULKAN_HPP_NAMESPACE::CommandPoolCreateFlagBits::eTransient, queueFamilyIndex },
+    };
+    const VULKAN_HPP_NAMESPACE::VULKAN_HPP_RAII_NAMESPACE::Fence fence { device.get(), VULKAN_HPP_NAMESPACE::FenceCreateInfo{} };
+
+    const VULKAN_HPP_NAMESPACE::CommandBuffer commandBuffer = (*device.get()).allocateCommandBuffers({ *commandPool, VULKAN_HPP_NAMESPACE::CommandBufferLevel::ePrimary, 1 })[0];
+    commandBuffer.begin({ VULKAN_HPP_NAMESPACE::CommandBufferUsageFlagBits::eOneTimeSubmit });
+    commandBuffer.resetQueryPool(*queryPool, 0, queryCount);
+
+    constexpr VULKAN_HPP_NAMESPACE::MemoryBarrier serializeBarrier {
+        VULKAN_HPP_NAMESPACE::AccessFlagBits::eShaderWrite,
+        VULKAN_HPP_NAMESPACE::AccessFlagBits::eShaderRead | VULKAN_HPP_NAMESPACE::AccessFlagBits::eShaderWrite,
+    };
+    for (const auto &[i, workgroupSize, pipeline] : std::views::zip(std::views::iota(0U), supportedCandidates, pipelines)) {
+        commandBuffer.bindPipeline(VULKAN_HPP_NAMESPACE::PipelineBindPoint::eCompute, *pipeline);
+
+        // Warm-up dispatch, which is not measured.
+        dispatcher(commandBuffer, workgroupSize);
+        commandBuffer.pipelineBarrier(
+            VULKAN_HPP_NAMESPACE::PipelineStageFlagBits::eComputeShader, VULKAN_HPP_NAMESPACE::PipelineStageFlagBits::eComputeShader,
+            {}, serializeBarrier, {}, {});
+
+        // Written after the warm-up dispatch finishes its compute stage, so that its tail is not measured. A top-of-pipe
+        // timestamp would be written as soon as the preceding commands start.
+        commandBuffer.writeTimestamp(VULKAN_HPP_NAMESPACE::PipelineStageFlagBits::eComputeShader, *queryPool, 2 * i);
+        for (std::uint32_t iteration = 0; iteration < iterations; ++iteration) {
+            dispatcher(commandBuffer, workgroupSize);
+            commandBuffer.pipelineBarrier(
+                VULKAN_HPP_NAMESPACE::PipelineStageFlagBits::eComputeShader, VULKAN_HPP_NAMESPACE::PipelineStageFlagBits::eComputeShader,
+                {}, serializeBarrier, {}, {});
+        }
+        commandBuffer.writeTimestamp(VULKAN_HPP_NAMESPACE::PipelineStageFlagBits::eBottomOfPipe, *queryPool, 2 * i + 1);
+    }
+    commandBuffer.end();
+
+    queue.submit(VULKAN_HPP_NAMESPACE::SubmitInfo { {}, {}, commandBuffer }, *fence);
+    std::ignore = device.get().waitForFences(*fence, true, ~0ULL);
+
+    const auto [result, timestamps] = queryPool.getResults<std::uint64_t>(
+        0, queryCount, queryCount * sizeof(std::uint64_t), sizeof(std::uint64_t),
+        VULKAN_HPP_NAMESPACE::QueryResultFlagBits::e64 | VULKAN_HPP_NAMESPACE::QueryResultFlagBits::eWait);
+
+    const std::size_t fastestIndex = std::ranges::min(
+        std::views::iota(std::size_t { 0 }, supportedCandidates.size()),
+        {},
+        [&](std::size_t i) { return timestamps[2 * i + 1] - timestamps[2 * i]; });
+    const WorkgroupSize fastest = supportedCandidates[fastestIndex];
+
+    {
+        std::scoped_lock lock { mutex };
+        results.insert_or_assign(std::string { kernelKey }, fastest);
+    }
+    save();
+
+    return fastest;
+}
+
+bool vku::WorkgroupSizeTuner::isSupported(
+    const WorkgroupSize &workgroupSize
+) const noexcept {
+    return std::ranges::all_of(std::views::zip(workgroupSize, properties.limits.maxComputeWorkGroupSize), [](const auto &pair) {
+            const auto [size, maxSize] = pair;
+            return size != 0 && size <= maxSize;
+        })
+        && static_cast<std::uint64_t>(workgroupSize[0]) * workgroupSize[1] * workgroupSize[2] <= properties.limits.maxComputeWorkGroupInvocations;
+}
+
+auto vku::WorkgroupSizeTuner::getDeviceUuidString() const -> std::string {
+    std::string result;
+    for (std::uint8_t byte : properties.pipelineCacheUUID) {
+        result += std::format("{:02x}", byte);
+    }
+    return result;
+}
+
+void vku::WorkgroupSizeTuner::load() {
+    if (path.empty()) {
+        return;
+    }
+
+    std::ifstream file { path };
+    if (!file) {
+        // Results file not exists yet.
+        return;
+    }
+
+    const std::string uuid = getDeviceUuidString();
+    for (std::string line; std::getline(file, line);) {
+        std::optional entry = parseEntry(line);
+        if (!entry || get<0>(*entry) != uuid) {
+            // Malformed, or tuned with the other device or driver.
+            continue;
+        }
+
+        results.insert_or_assign(std::move(get<1>(*entry)), get<2>(*entry));
+    }
+}
+
+auto vku::WorkgroupSizeTuner::parseEntry(
+    const std::string &line
+) -> std::optional<std::tuple<std::string, std::string, WorkgroupSize>> {
+    std::istringstream stream { line };
+    std::string uuid, kernelKey;
+    WorkgroupSize workgroupSize;
+    if (stream >> uuid >> std::quoted(kernelKey) >> workgroupSize[0] >> workgroupSize[1] >> workgroupSize[2]) {
+        return std::tuple { std::move(uuid), std::move(kernelKey), workgroupSize };
+    }
+    return std::nullopt;
+}
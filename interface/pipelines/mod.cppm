@@ -6,9 +6,17 @@ module;
 #include <vulkan/vulkan_hpp_macros.hpp>
 
 export module vku:pipelines;
+export import :pipelines.GraphicsPipelineLibrary;
+export import :pipelines.PipelineBuildQueue;
+export import :pipelines.PipelineCache;
 export import :pipelines.Shader;
+export import :pipelines.ShaderCompileCache;
+export import :pipelines.ShaderObject;
+export import :pipelines.ShaderReflection;
+export import :pipelines.WorkgroupSizeTuner;
 
 import std;
+import :caches.ShaderModuleCache;
 import :utils.RefHolder;
 
 template <typename T, std::size_t>
@@ -21,7 +29,7 @@ namespace vku {
      * Creating compute pipeline:
      * @code{.cpp}
      * vk::raii::PipelineLayout pipelineLayout { device, vk::PipelineLayoutCreateInfo { ... } };
-     * vk::raii::Pipeline pipeline { device, nullptr, vk::ComputePipelineCreateInfo {
+     * vk::raii::Pipeline pipeline { device, gpu.pipelineCache, vk::ComputePipelineCreateInfo {
      *     {},
      *     // vk::ComputePipelineCreateInfo accepts a single vk::PipelineShaderStageCreateInfo, therefore we call
      *     // vku::RefHolder<...>::get() to explicitly get the array, and access the first element.
@@ -34,7 +42,7 @@ namespace vku {
      *
      * Creating graphics pipeline:
      * @code{.cpp}
-     * vk::raii::Pipeline pipeline { device, nullptr, vk::GraphicsPipelineCreateInfo {
+     * vk::raii::Pipeline pipeline { device, gpu.pipelineCache, vk::GraphicsPipelineCreateInfo {
      *     {},
      *     vku::createPipelineStages(
      *         device,
@@ -87,6 +95,94 @@ namespace vku {
         return impl(std::make_index_sequence<sizeof...(shaders)>{}, device, shaders...);
     }
 
+    /**
+     * Create array of <tt>vk::PipelineShaderStageCreateInfos</tt> from <tt>vku::Shader</tt>s, with the shader modules
+     * obtained from \p shaderModuleCache.
+     *
+     * Unlike the <tt>vk::raii::Device</tt> overload, shader modules are not owned by the return value, and the module of
+     * the same SPIR-V code is created only once. It is useful when creating many pipelines that share the shaders (e.g.
+     * specialization constant permutations).
+     *
+     * @param shaderModuleCache Shader module cache that is used to get the shader modules.
+     * @param shaders Variadic template parameters of <tt>vku::Shader</tt>s. This can be destroyed after the function call.
+     * @return vku::RefHolder of <tt>std::array<vk::PipelineShaderStageCreateInfo, sizeof...(shaders)></tt>. Shader
+     * modules referenced by the create infos are valid until \p shaderModuleCache is cleared or destroyed.
+     */
+    export template <typename... Shaders>
+    [[nodiscard]] auto createPipelineStages(
+        ShaderModuleCache &shaderModuleCache,
+        const Shaders &...shaders
+    ) -> RefHolder<std::array<VULKAN_HPP_NAMESPACE::PipelineShaderStageCreateInfo, sizeof...(Shaders)>> {
+        constexpr auto impl = []<std::size_t... Is>(
+            std::index_sequence<Is...>,
+            ShaderModuleCache &shaderModuleCache,
+            const type_tag<Shader, Is> &...shaders
+        ) -> RefHolder<std::array<VULKAN_HPP_NAMESPACE::PipelineShaderStageCreateInfo, sizeof...(Shaders)>> {
+            return RefHolder<std::array<VULKAN_HPP_NAMESPACE::PipelineShaderStageCreateInfo, sizeof...(Shaders)>> {
+                [&]() {
+                    return std::array {
+                        VULKAN_HPP_NAMESPACE::PipelineShaderStageCreateInfo {
+                            {},
+                            shaders.stage,
+                            shaderModuleCache.get(shaders.code),
+                            shaders.entryPoint,
+                            shaders.pSpecializationInfo,
+                        }...
+                    };
+                },
+            };
+        };
+
+        return impl(std::make_index_sequence<sizeof...(shaders)>{}, shaderModuleCache, shaders...);
+    }
+
+    /**
+     * Create array of <tt>vk::PipelineShaderStageCreateInfos</tt> from <tt>vku::Shader</tt>s, without creating
+     * shader modules.
+     *
+     * Each stage has null <tt>module</tt> and its <tt>vk::ShaderModuleCreateInfo</tt> is chained in <tt>pNext</tt>, so the
+     * driver compiles the SPIR-V code directly at the pipeline creation. This requires
+     * <tt>VK_KHR_maintenance5</tt> (or <tt>VK_EXT_graphics_pipeline_library</tt>) to be enabled.
+     *
+     * @param shaders Variadic template parameters of <tt>vku::Shader</tt>s. Their SPIR-V codes must be alive until the
+     * pipeline creation.
+     * @return vku::RefHolder of <tt>std::array<vk::PipelineShaderStageCreateInfo, sizeof...(shaders)></tt>. Chained
+     * <tt>vk::ShaderModuleCreateInfo</tt>s are stored in the return value inline, therefore it is not movable (use it as a
+     * prvalue, or bind it to a variable by guaranteed copy elision).
+     */
+    export template <typename... Shaders>
+    [[nodiscard]] auto createInlinePipelineStages(
+        const Shaders &...shaders
+    ) -> RefHolder<std::array<VULKAN_HPP_NAMESPACE::PipelineShaderStageCreateInfo, sizeof...(Shaders)>, details::PinnedArray<VULKAN_HPP_NAMESPACE::ShaderModuleCreateInfo, sizeof...(Shaders)>> {
+        constexpr auto impl = []<std::size_t... Is>(
+            std::index_sequence<Is...>,
+            const type_tag<Shader, Is> &...shaders
+        ) -> RefHolder<std::array<VULKAN_HPP_NAMESPACE::PipelineShaderStageCreateInfo, sizeof...(Shaders)>, details::PinnedArray<VULKAN_HPP_NAMESPACE::ShaderModuleCreateInfo, sizeof...(Shaders)>> {
+            return {
+                [&](const auto &shaderModuleCreateInfos) {
+                    return std::array {
+                        VULKAN_HPP_NAMESPACE::PipelineShaderStageCreateInfo {
+                            {},
+                            shaders.stage,
+                            {},
+                            shaders.entryPoint,
+                            shaders.pSpecializationInfo,
+                            &get<Is>(shaderModuleCreateInfos),
+                        }...
+                    };
+                },
+                details::PinnedArray<VULKAN_HPP_NAMESPACE::ShaderModuleCreateInfo, sizeof...(Shaders)> {
+                    std::array { VULKAN_HPP_NAMESPACE::ShaderModuleCreateInfo { {}, shaders.code }... },
+                },
+            };
+        };
+
+        // Stages' pNext point into the stored vk::ShaderModuleCreateInfos, which must not be relocated.
+        static_assert(!std::move_constructible<RefHolder<std::array<VULKAN_HPP_NAMESPACE::PipelineShaderStageCreateInfo, sizeof...(Shaders)>, details::PinnedArray<VULKAN_HPP_NAMESPACE::ShaderModuleCreateInfo, sizeof...(Shaders)>>>);
+
+        return impl(std::make_index_sequence<sizeof...(shaders)>{}, shaders...);
+    }
+
     /**
      * A convenience function to create <tt>vk::GraphicsPipelineCreateInfo</tt> with mostly used pipeline parameters.
      *
@@ -107,7 +203,7 @@ namespace vku {
      * 4x MSAA using dynamic rendering (color format=B8G8R8A8Srgb, depth format=D32Sfloat):
      * @code{.cpp}
      * vk::raii::PipelineLayout pipelineLayout { device, vk::PipelineLayoutCreateInfo { ... } };
-     * vk::raii::Pipeline pipeline { device, nullptr, vk::StructureChain {
+     * vk::raii::Pipeline pipeline { device, gpu.pipelineCache, vk::StructureChain {
      *     getDefaultGraphicsPipelineCreateInfo(
      *         vku::createPipelineStages(
      *             device,
@@ -150,6 +246,83 @@ namespace vku {
         bool hasDepthStencilAttachment = false,
         VULKAN_HPP_NAMESPACE::SampleCountFlagBits multisample = VULKAN_HPP_NAMESPACE::SampleCountFlagBits::e1
     ) -> VULKAN_HPP_NAMESPACE::GraphicsPipelineCreateInfo;
+
+    /**
+     * Create <tt>vk::GraphicsPipelineCreateInfo</tt> of the vertex input interface part for
+     * <tt>VK_EXT_graphics_pipeline_library</tt>, with the same vertex input and input assembly state as
+     * <tt>vku::getDefaultGraphicsPipelineCreateInfo</tt>.
+     *
+     * Each part created by <tt>vku::getDefault{VertexInputInterface,PreRasterizationShaders,FragmentShader,FragmentOutputInterface}CreateInfo</tt>
+     * has <tt>vk::PipelineCreateFlagBits::eLibraryKHR | vk::PipelineCreateFlagBits::eRetainLinkTimeOptimizationInfoEXT</tt>
+     * flags, and you have to chain <tt>vk::GraphicsPipelineLibraryCreateInfoEXT</tt> with the corresponding part flag to
+     * its pNext (and <tt>vk::PipelineRenderingCreateInfo</tt> for the fragment shader/output interface part in dynamic
+     * rendering).
+     *
+     * @code{.cpp}
+     * vk::raii::Pipeline vertexInputInterface { device, gpu.pipelineCache, vk::StructureChain {
+     *     vku::getDefaultVertexInputInterfaceCreateInfo(),
+     *     vk::GraphicsPipelineLibraryCreateInfoEXT { vk::GraphicsPipelineLibraryFlagBitsEXT::eVertexInputInterface },
+     * }.get() };
+     * @endcode
+     *
+     * @return <tt>vk::GraphicsPipelineCreateInfo</tt> struct.
+     * @see vku::GraphicsPipelineLibrary for caching and linking the parts.
+     */
+    export
+    [[nodiscard]] auto getDefaultVertexInputInterfaceCreateInfo() noexcept -> VULKAN_HPP_NAMESPACE::GraphicsPipelineCreateInfo;
+
+    /**
+     * Create <tt>vk::GraphicsPipelineCreateInfo</tt> of the pre-rasterization shaders part for
+     * <tt>VK_EXT_graphics_pipeline_library</tt>, with the same viewport, rasterization and dynamic state as
+     * <tt>vku::getDefaultGraphicsPipelineCreateInfo</tt>.
+     *
+     * @param stages Pre-rasterization shader stages (vertex, tessellation, geometry, task or mesh).
+     * @param layout Pipeline layout that is used for the pipeline.
+     * @return <tt>vk::GraphicsPipelineCreateInfo</tt> struct.
+     * @see vku::getDefaultVertexInputInterfaceCreateInfo for the usage.
+     */
+    export
+    [[nodiscard]] auto getDefaultPreRasterizationShadersCreateInfo(
+        VULKAN_HPP_NAMESPACE::ArrayProxyNoTemporaries<const VULKAN_HPP_NAMESPACE::PipelineShaderStageCreateInfo> stages,
+        VULKAN_HPP_NAMESPACE::PipelineLayout layout
+    ) noexcept -> VULKAN_HPP_NAMESPACE::GraphicsPipelineCreateInfo;
+
+    /**
+     * Create <tt>vk::GraphicsPipelineCreateInfo</tt> of the fragment shader part for
+     * <tt>VK_EXT_graphics_pipeline_library</tt>, with the same multisample and depth-stencil state as
+     * <tt>vku::getDefaultGraphicsPipelineCreateInfo</tt>.
+     *
+     * @param stages Fragment shader stage.
+     * @param layout Pipeline layout that is used for the pipeline.
+     * @param hasDepthStencilAttachment Boolean value that indicates whether the pipeline has depth-stencil attachment (default=<tt>false</tt>).
+     * @param multisample MSAA sample count (default=<tt>vk::SampleCountFlagBits::e1</tt>).
+     * @return <tt>vk::GraphicsPipelineCreateInfo</tt> struct.
+     * @see vku::getDefaultVertexInputInterfaceCreateInfo for the usage.
+     */
+    export
+    [[nodiscard]] auto getDefaultFragmentShaderCreateInfo(
+        VULKAN_HPP_NAMESPACE::ArrayProxyNoTemporaries<const VULKAN_HPP_NAMESPACE::PipelineShaderStageCreateInfo> stages,
+        VULKAN_HPP_NAMESPACE::PipelineLayout layout,
+        bool hasDepthStencilAttachment = false,
+        VULKAN_HPP_NAMESPACE::SampleCountFlagBits multisample = VULKAN_HPP_NAMESPACE::SampleCountFlagBits::e1
+    ) noexcept -> VULKAN_HPP_NAMESPACE::GraphicsPipelineCreateInfo;
+
+    /**
+     * Create <tt>vk::GraphicsPipelineCreateInfo</tt> of the fragment output interface part for
+     * <tt>VK_EXT_graphics_pipeline_library</tt>, with the same multisample and color blend state as
+     * <tt>vku::getDefaultGraphicsPipelineCreateInfo</tt>.
+     *
+     * @param colorAttachmentCount Number of color attachments (default=<tt>0</tt>). This must be less than or equal to 8.
+     * @param multisample MSAA sample count (default=<tt>vk::SampleCountFlagBits::e1</tt>).
+     * @return <tt>vk::GraphicsPipelineCreateInfo</tt> struct.
+     * @throw std::runtime_error if \p colorAttachmentCount exceeds the maximum value (=8).
+     * @see vku::getDefaultVertexInputInterfaceCreateInfo for the usage.
+     */
+    export
+    [[nodiscard]] auto getDefaultFragmentOutputInterfaceCreateInfo(
+        std::uint32_t colorAttachmentCount = 0,
+        VULKAN_HPP_NAMESPACE::SampleCountFlagBits multisample = VULKAN_HPP_NAMESPACE::SampleCountFlagBits::e1
+    ) -> VULKAN_HPP_NAMESPACE::GraphicsPipelineCreateInfo;
 }
 
 // --------------------
@@ -159,13 +332,31 @@ namespace vku {
 #define INDEX_SEQ(Is, N, ...) [&]<std::size_t ...Is>(std::index_sequence<Is...>) __VA_ARGS__ (std::make_index_sequence<N>{})
 #define ARRAY_OF(N, ...) INDEX_SEQ(Is, N, { return std::array { ((void)Is, __VA_ARGS__)... }; })
 
-auto vku::getDefaultGraphicsPipelineCreateInfo(
-    VULKAN_HPP_NAMESPACE::ArrayProxyNoTemporaries<const VULKAN_HPP_NAMESPACE::PipelineShaderStageCreateInfo> stages,
-    VULKAN_HPP_NAMESPACE::PipelineLayout layout,
-    std::uint32_t colorAttachmentCount,
-    bool hasDepthStencilAttachment,
-    VULKAN_HPP_NAMESPACE::SampleCountFlagBits multisample
-) -> VULKAN_HPP_NAMESPACE::GraphicsPipelineCreateInfo {
+/**
+ * @brief Pipeline states that are shared by <tt>vku::getDefaultGraphicsPipelineCreateInfo</tt> and its graphics pipeline
+ * library counterparts. Every state is in static storage.
+ */
+struct DefaultGraphicsPipelineStates {
+    const VULKAN_HPP_NAMESPACE::PipelineVertexInputStateCreateInfo *vertexInputState;
+    const VULKAN_HPP_NAMESPACE::PipelineInputAssemblyStateCreateInfo *inputAssemblyState;
+    const VULKAN_HPP_NAMESPACE::PipelineViewportStateCreateInfo *viewportState;
+    const VULKAN_HPP_NAMESPACE::PipelineRasterizationStateCreateInfo *rasterizationState;
+    std::span<const VULKAN_HPP_NAMESPACE::PipelineMultisampleStateCreateInfo> multisampleStates;
+    const VULKAN_HPP_NAMESPACE::PipelineDepthStencilStateCreateInfo *depthStencilState;
+    std::span<const VULKAN_HPP_NAMESPACE::PipelineColorBlendStateCreateInfo> colorBlendStates;
+    const VULKAN_HPP_NAMESPACE::PipelineDynamicStateCreateInfo *dynamicState;
+
+    [[nodiscard]] auto getMultisampleState(VULKAN_HPP_NAMESPACE::SampleCountFlagBits multisample) const noexcept -> const VULKAN_HPP_NAMESPACE::PipelineMultisampleStateCreateInfo*;
+    [[nodiscard]] auto getColorBlendState(std::uint32_t colorAttachmentCount) const -> const VULKAN_HPP_NAMESPACE::PipelineColorBlendStateCreateInfo*;
+};
+
+/**
+ * @brief Flags of the pipeline library parts. Link time optimization info is retained to make the optimized link possible.
+ */
+constexpr VULKAN_HPP_NAMESPACE::PipelineCreateFlags pipelineLibraryFlags
+    = VULKAN_HPP_NAMESPACE::PipelineCreateFlagBits::eLibraryKHR | VULKAN_HPP_NAMESPACE::PipelineCreateFlagBits::eRetainLinkTimeOptimizationInfoEXT;
+
+auto getDefaultGraphicsPipelineStates() noexcept -> const DefaultGraphicsPipelineStates& {
     static constexpr VULKAN_HPP_NAMESPACE::PipelineVertexInputStateCreateInfo vertexInputState{};
 
     static constexpr VULKAN_HPP_NAMESPACE::PipelineInputAssemblyStateCreateInfo inputAssemblyState {
@@ -201,9 +392,6 @@ auto vku::getDefaultGraphicsPipelineCreateInfo(
     static constexpr VULKAN_HPP_NAMESPACE::PipelineDepthStencilStateCreateInfo depthStencilState{};
 
     constexpr std::uint32_t MAX_COLOR_ATTACHMENT_COUNT = 8;
-    if (colorAttachmentCount > MAX_COLOR_ATTACHMENT_COUNT) {
-        throw std::runtime_error { "Color attachment count exceeds maximum" };
-    }
     static constexpr std::array colorBlendAttachments
         = ARRAY_OF(MAX_COLOR_ATTACHMENT_COUNT + 1, VULKAN_HPP_NAMESPACE::PipelineColorBlendAttachmentState {
             {},
@@ -231,18 +419,102 @@ auto vku::getDefaultGraphicsPipelineCreateInfo(
         dynamicStates.size(), dynamicStates.data(),
     };
 
-    return {
-        {},
-        stages,
+    static constexpr DefaultGraphicsPipelineStates result {
         &vertexInputState,
         &inputAssemblyState,
-        {},
         &viewportState,
         &rasterizationState,
-        &multisampleStates[std::countr_zero(static_cast<std::underlying_type_t<VULKAN_HPP_NAMESPACE::SampleCountFlagBits>>(multisample))],
-        hasDepthStencilAttachment ? &depthStencilState : nullptr,
-        &colorBlendStates[colorAttachmentCount],
+        multisampleStates,
+        &depthStencilState,
+        colorBlendStates,
         &dynamicState,
+    };
+    return result;
+}
+
+auto DefaultGraphicsPipelineStates::getMultisampleState(
+    VULKAN_HPP_NAMESPACE::SampleCountFlagBits multisample
+) const noexcept -> const VULKAN_HPP_NAMESPACE::PipelineMultisampleStateCreateInfo* {
+    return &multisampleStates[std::countr_zero(static_cast<std::underlying_type_t<VULKAN_HPP_NAMESPACE::SampleCountFlagBits>>(multisample))];
+}
+
+auto DefaultGraphicsPipelineStates::getColorBlendState(
+    std::uint32_t colorAttachmentCount
+) const -> const VULKAN_HPP_NAMESPACE::PipelineColorBlendStateCreateInfo* {
+    if (colorAttachmentCount >= colorBlendStates.size()) {
+        throw std::runtime_error { "Color attachment count exceeds maximum" };
+    }
+    return &colorBlendStates[colorAttachmentCount];
+}
+
+auto vku::getDefaultGraphicsPipelineCreateInfo(
+    VULKAN_HPP_NAMESPACE::ArrayProxyNoTemporaries<const VULKAN_HPP_NAMESPACE::PipelineShaderStageCreateInfo> stages,
+    VULKAN_HPP_NAMESPACE::PipelineLayout layout,
+    std::uint32_t colorAttachmentCount,
+    bool hasDepthStencilAttachment,
+    VULKAN_HPP_NAMESPACE::SampleCountFlagBits multisample
+) -> VULKAN_HPP_NAMESPACE::GraphicsPipelineCreateInfo {
+    const DefaultGraphicsPipelineStates &states = getDefaultGraphicsPipelineStates();
+    return {
+        {},
+        stages,
+        states.vertexInputState,
+        states.inputAssemblyState,
+        {},
+        states.viewportState,
+        states.rasterizationState,
+        states.getMultisampleState(multisample),
+        hasDepthStencilAttachment ? states.depthStencilState : nullptr,
+        states.getColorBlendState(colorAttachmentCount),
+        states.dynamicState,
         layout,
     };
+}
+
+auto vku::getDefaultVertexInputInterfaceCreateInfo() noexcept -> VULKAN_HPP_NAMESPACE::GraphicsPipelineCreateInfo {
+    const DefaultGraphicsPipelineStates &states = getDefaultGraphicsPipelineStates();
+    return VULKAN_HPP_NAMESPACE::GraphicsPipelineCreateInfo{}
+        .setFlags(pipelineLibraryFlags)
+        .setPVertexInputState(states.vertexInputState)
+        .setPInputAssemblyState(states.inputAssemblyState);
+}
+
+auto vku::getDefaultPreRasterizationShadersCreateInfo(
+    VULKAN_HPP_NAMESPACE::ArrayProxyNoTemporaries<const VULKAN_HPP_NAMESPACE::PipelineShaderStageCreateInfo> stages,
+    VULKAN_HPP_NAMESPACE::PipelineLayout layout
+) noexcept -> VULKAN_HPP_NAMESPACE::GraphicsPipelineCreateInfo {
+    const DefaultGraphicsPipelineStates &states = getDefaultGraphicsPipelineStates();
+    return VULKAN_HPP_NAMESPACE::GraphicsPipelineCreateInfo{}
+        .setFlags(pipelineLibraryFlags)
+        .setStages(stages)
+        .setPViewportState(states.viewportState)
+        .setPRasterizationState(states.rasterizationState)
+        .setPDynamicState(states.dynamicState)
+        .setLayout(layout);
+}
+
+auto vku::getDefaultFragmentShaderCreateInfo(
+    VULKAN_HPP_NAMESPACE::ArrayProxyNoTemporaries<const VULKAN_HPP_NAMESPACE::PipelineShaderStageCreateInfo> stages,
+    VULKAN_HPP_NAMESPACE::PipelineLayout layout,
+    bool hasDepthStencilAttachment,
+    VULKAN_HPP_NAMESPACE::SampleCountFlagBits multisample
+) noexcept -> VULKAN_HPP_NAMESPACE::GraphicsPipelineCreateInfo {
+    const DefaultGraphicsPipelineStates &states = getDefaultGraphicsPipelineStates();
+    return VULKAN_HPP_NAMESPACE::GraphicsPipelineCreateInfo{}
+        .setFlags(pipelineLibraryFlags)
+        .setStages(stages)
+        .setPMultisampleState(states.getMultisampleState(multisample))
+        .setPDepthStencilState(hasDepthStencilAttachment ? states.depthStencilState : nullptr)
+        .setLayout(layout);
+}
+
+auto vku::getDefaultFragmentOutputInterfaceCreateInfo(
+    std::uint32_t colorAttachmentCount,
+    VULKAN_HPP_NAMESPACE::SampleCountFlagBits multisample
+) -> VULKAN_HPP_NAMESPACE::GraphicsPipelineCreateInfo {
+    const DefaultGraphicsPipelineStates &states = getDefaultGraphicsPipelineStates();
+    return VULKAN_HPP_NAMESPACE::GraphicsPipelineCreateInfo{}
+        .setFlags(pipelineLibraryFlags)
+        .setPMultisampleState(states.getMultisampleState(multisample))
+        .setPColorBlendState(states.getColorBlendState(colorAttachmentCount));
 }
\ No newline at end of file
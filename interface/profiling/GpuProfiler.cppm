@@ -0,0 +1,414 @@
+/** @file profiling/GpuProfiler.cppm
+ */
+
+module;
+
+#include <vulkan/vulkan_hpp_macros.hpp>
+
+export module vku:profiling.GpuProfiler;
+
+import std;
+export import vulkan_hpp;
+
+#define FWD(...) static_cast<decltype(__VA_ARGS__)&&>(__VA_ARGS__)
+
+namespace vku {
+    /**
+     * @brief GPU timestamp profiler that exports the CPU recording and GPU execution spans as Chrome trace.
+     *
+     * Each frame in flight has its own timestamp query pool. <tt>beginFrame</tt> must be called with the frame's first
+     * command buffer after waiting the frame's fence: it reads the results of the previous use of the frame's query pool
+     * without waiting (the submission is already completed), converts them into the trace events and records the query
+     * pool reset.
+     *
+     * GPU timestamps are converted into <tt>std::chrono::steady_clock</tt> time by <tt>VK_KHR_calibrated_timestamps</tt>
+     * if enabled. Otherwise, the offset is estimated from the fact that the GPU execution of a region starts after its
+     * recording ends.
+     *
+     * @code{.cpp}
+     * vku::GpuProfiler profiler { gpu.device, *gpu.physicalDevice, FRAMES_IN_FLIGHT };
+     *
+     * // Every frame, after waiting the frame's fence.
+     * profiler.beginFrame(frameIndex, commandBuffer);
+     * {
+     *     const vku::GpuProfiler::Scope scope = profiler.scope(commandBuffer, "Shadow pass", "graphics");
+     *     ... // Record commands.
+     * }
+     *
+     * // Wrap the ExecutionInfo's command recorder.
+     * vku::ExecutionInfo { profiler.wrap("Upload", "transfer", [&](vk::CommandBuffer cb) { ... }), *transferCommandPool, gpu.queues.transfer };
+     *
+     * // At exit.
+     * std::ofstream file { "trace.json" };
+     * profiler.writeChromeTrace(file);
+     * @endcode
+     *
+     * @note Member functions are thread-safe, but a frame must not be begun while its command buffers are recorded.
+     */
+    export class GpuProfiler {
+    public:
+        /**
+         * @brief RAII region that writes the begin timestamp at construction and the end timestamp at destruction.
+         */
+        class Scope {
+        public:
+            Scope(const Scope&) = delete;
+            auto operator=(const Scope&) -> Scope& = delete;
+            ~Scope();
+
+        private:
+            friend class GpuProfiler;
+
+            GpuProfiler *profiler;
+            VULKAN_HPP_NAMESPACE::CommandBuffer commandBuffer;
+            std::uint32_t frameIndex;
+
+            /**
+             * @brief Index of the region in the frame, or <tt>std::nullopt</tt> if the queries are exhausted.
+             */
+            std::optional<std::size_t> regionIndex;
+
+            Scope(GpuProfiler &profiler, VULKAN_HPP_NAMESPACE::CommandBuffer commandBuffer, std::uint32_t frameIndex, std::optional<std::size_t> regionIndex) noexcept;
+        };
+
+        /**
+         * @brief Create the per-frame query pools.
+         * @param device Vulkan device.
+         * @param physicalDevice Physical device of \p device, for the timestamp period.
+         * @param frameCount Number of the frames in flight.
+         * @param maxRegionsPerFrame Maximum number of the regions in a frame. Regions beyond it are not measured.
+         * @param calibratedTimestamps Whether <tt>VK_KHR_calibrated_timestamps</tt> is enabled in \p device. If
+         * \p physicalDevice does not report the time domains that are required for the conversion (device and, except
+         * Windows, <tt>CLOCK_MONOTONIC</tt>), the offset is estimated as if it is <tt>false</tt>.
+         */
+        GpuProfiler(
+            const VULKAN_HPP_NAMESPACE::VULKAN_HPP_RAII_NAMESPACE::Device &device [[clang::lifetimebound]],
+            VULKAN_HPP_NAMESPACE::PhysicalDevice physicalDevice,
+            std::uint32_t frameCount,
+            std::uint32_t maxRegionsPerFrame = 256,
+            bool calibratedTimestamps = false
+        );
+
+        /**
+         * @brief Collect the results of the previous use of the frame, and record the query pool reset.
+         * @param frameIndex Frame index. Its previous submission must be completed.
+         * @param commandBuffer Command buffer that is submitted before any other command buffers of the frame.
+         */
+        void beginFrame(std::uint32_t frameIndex, VULKAN_HPP_NAMESPACE::CommandBuffer commandBuffer);
+
+        /**
+         * @brief Start the labeled region, which ends when the returned Scope is destroyed.
+         * @param commandBuffer Command buffer to write the timestamps. It must be submitted in the current frame.
+         * @param name Region name.
+         * @param track Track name that the GPU span is shown in, usually the queue name.
+         * @return Scope of the region.
+         */
+        [[nodiscard]] auto scope(VULKAN_HPP_NAMESPACE::CommandBuffer commandBuffer, std::string name, std::string_view track) -> Scope;
+
+        /**
+         * @brief Wrap \p recorder to be measured as a region, e.g. for <tt>vku::ExecutionInfo::commandRecorder</tt>.
+         * @param name Region name.
+         * @param track Track name that the GPU span is shown in, usually the queue name.
+         * @param recorder Function that accepts <tt>vk::CommandBuffer</tt> and records commands.
+         * @return Wrapped command recorder.
+         */
+        template <std::invocable<VULKAN_HPP_NAMESPACE::CommandBuffer> F>
+        [[nodiscard]] auto wrap(std::string name, std::string track, F &&recorder) {
+            return [this, name = std::move(name), track = std::move(track), recorder = FWD(recorder)](VULKAN_HPP_NAMESPACE::CommandBuffer commandBuffer) mutable {
+                const Scope scope = this->scope(commandBuffer, name, track);
+                std::invoke(recorder, commandBuffer);
+            };
+        }
+
+        /**
+         * @brief Write the collected spans as Chrome trace event format JSON, which can be opened in
+         * <tt>chrome://tracing</tt> or Perfetto.
+         * @param os Output stream.
+         */
+        void writeChromeTrace(std::ostream &os) const;
+
+        /**
+         * @brief Discard the collected spans.
+         */
+        void clearTrace();
+
+    private:
+        struct Region {
+            std::string name;
+            std::uint32_t gpuTrackIndex;
+            std::uint32_t cpuThreadIndex;
+            std::uint32_t beginQuery;
+            std::int64_t cpuBeginNs;
+            std::int64_t cpuEndNs;
+        };
+
+        struct Frame {
+            VULKAN_HPP_NAMESPACE::VULKAN_HPP_RAII_NAMESPACE::QueryPool queryPool;
+            std::uint32_t usedQueryCount = 0;
+            std::vector<Region> regions;
+        };
+
+        struct TraceEvent {
+            std::string name;
+            bool gpu;
+            std::uint32_t trackIndex;
+            std::int64_t beginNs;
+            std::int64_t endNs;
+        };
+
+        std::reference_wrapper<const VULKAN_HPP_NAMESPACE::VULKAN_HPP_RAII_NAMESPACE::Device> device;
+        double timestampPeriod;
+        std::uint32_t maxQueriesPerFrame;
+        bool calibratedTimestamps;
+        std::int64_t epochNs;
+
+        mutable std::mutex mutex;
+        std::vector<Frame> frames;
+        std::uint32_t currentFrameIndex = 0;
+
+        /**
+         * @brief Offset that converts the GPU timestamp (in nanoseconds) to steady clock time, or
+         * <tt>std::nullopt</tt> if not determined yet.
+         */
+        std::optional<std::int64_t> gpuToCpuOffsetNs;
+
+        std::vector<std::string> gpuTracks;
+        std::unordered_map<std::thread::id, std::uint32_t> cpuThreadIndices;
+        std::vector<TraceEvent> events;
+
+        [[nodiscard]] static auto now() noexcept -> std::int64_t;
+
+        /**
+         * @brief Whether \p physicalDevice can calibrate its timestamps with the time domains used by <tt>calibrate()</tt>.
+         */
+        [[nodiscard]] static auto isCalibrationSupported(VULKAN_HPP_NAMESPACE::PhysicalDevice physicalDevice) -> bool;
+
+        /**
+         * @note \p mutex must be locked.
+         */
+        void calibrate();
+
+        /**
+         * @note \p mutex must be locked.
+         */
+        void resolve(Frame &frame);
+
+        void endScope(std::uint32_t frameIndex, VULKAN_HPP_NAMESPACE::CommandBuffer commandBuffer, std::size_t regionIndex);
+    };
+}
+
+// --------------------
+// Implementations.
+// --------------------
+
+vku::GpuProfiler::Scope::Scope(
+    GpuProfiler &profiler,
+    VULKAN_HPP_NAMESPACE::CommandBuffer commandBuffer,
+    std::uint32_t frameIndex,
+    std::optional<std::size_t> regionIndex
+) noexcept : profiler { &profiler },
+             commandBuffer { commandBuffer },
+             frameIndex { frameIndex },
+             regionIndex { regionIndex } { }
+
+vku::GpuProfiler::Scope::~Scope() {
+    if (regionIndex) {
+        profiler->endScope(frameIndex, commandBuffer, *regionIndex);
+    }
+}
+
+vku::GpuProfiler::GpuProfiler(
+    const VULKAN_HPP_NAMESPACE::VULKAN_HPP_RAII_NAMESPACE::Device &device,
+    VULKAN_HPP_NAMESPACE::PhysicalDevice physicalDevice,
+    std::uint32_t frameCount,
+    std::uint32_t maxRegionsPerFrame,
+    bool calibratedTimestamps
+) : device { device },
+    timestampPeriod { physicalDevice.getProperties().limits.timestampPeriod },
+    maxQueriesPerFrame { 2 * maxRegionsPerFrame },
+    calibratedTimestamps { calibratedTimestamps && isCalibrationSupported(physicalDevice) },
+    epochNs { now() } {
+    frames.reserve(frameCount);
+    for (std::uint32_t i = 0; i < frameCount; ++i) {
+        frames.emplace_back(VULKAN_HPP_NAMESPACE::VULKAN_HPP_RAII_NAMESPACE::QueryPool { device, VULKAN_HPP_NAMESPACE::QueryPoolCreateInfo {
+            {},
+            VULKAN_HPP_NAMESPACE::QueryType::eTimestamp,
+            maxQueriesPerFrame,
+        } });
+
+        // Newly created queries are in undefined state, therefore they must be reset before the first use.
+        frames.back().usedQueryCount = maxQueriesPerFrame;
+    }
+}
+
+void vku::GpuProfiler::beginFrame(
+    std::uint32_t frameIndex,
+    VULKAN_HPP_NAMESPACE::CommandBuffer commandBuffer
+) {
+    std::scoped_lock lock { mutex };
+    Frame &frame = frames[frameIndex];
+    resolve(frame);
+
+    commandBuffer.resetQueryPool(*frame.queryPool, 0, frame.usedQueryCount);
+    frame.usedQueryCount = 0;
+    frame.regions.clear();
+    currentFrameIndex = frameIndex;
+
+    if (calibratedTimestamps) {
+        calibrate();
+    }
+}
+
+auto vku::GpuProfiler::scope(
+    VULKAN_HPP_NAMESPACE::CommandBuffer commandBuffer,
+    std::string name,
+    std::string_view track
+) -> Scope {
+    std::scoped_lock lock { mutex };
+    Frame &frame = frames[currentFrameIndex];
+    if (frame.usedQueryCount + 2 > maxQueriesPerFrame) {
+        return { *this, commandBuffer, currentFrameIndex, std::nullopt };
+    }
+
+    auto trackIt = std::ranges::find(gpuTracks, track);
+    if (trackIt == gpuTracks.end()) {
+        trackIt = gpuTracks.emplace(gpuTracks.end(), track);
+    }
+    const auto [threadIt, _] = cpuThreadIndices.try_emplace(std::this_thread::get_id(), static_cast<std::uint32_t>(cpuThreadIndices.size()));
+
+    const std::uint32_t beginQuery = frame.usedQueryCount;
+    frame.usedQueryCount += 2;
+    frame.regions.push_back({
+        .name = std::move(name),
+        .gpuTrackIndex = static_cast<std::uint32_t>(trackIt - gpuTracks.begin()),
+        .cpuThreadIndex = threadIt->second,
+        .beginQuery = beginQuery,
+        .cpuBeginNs = now(),
+    });
+    commandBuffer.writeTimestamp(VULKAN_HPP_NAMESPACE::PipelineStageFlagBits::eTopOfPipe, *frame.queryPool, beginQuery);
+    return { *this, commandBuffer, currentFrameIndex, frame.regions.size() - 1 };
+}
+
+void vku::GpuProfiler::writeChromeTrace(
+    std::ostream &os
+) const {
+    constexpr auto escape = [](std::string_view str) {
+        std::string result;
+        result.reserve(str.size());
+        for (char c : str) {
+            if (c == '"' || c == '\\') {
+                result += '\\';
+            }
+            result += c;
+        }
+        return result;
+    };
+
+    std::scoped_lock lock { mutex };
+
+    // CPU spans are in the process 1 with the thread per recording thread, GPU spans are in the process 2 with the
+    // thread per track.
+    os << R"({"displayTimeUnit":"ns","traceEvents":[)" "\n";
+    os << R"({"name":"process_name","ph":"M","pid":1,"args":{"name":"CPU"}},)" "\n";
+    os << R"({"name":"process_name","ph":"M","pid":2,"args":{"name":"GPU"}})";
+    for (std::uint32_t i = 0; const std::string &track : gpuTracks) {
+        os << std::format(",\n{{\"name\":\"thread_name\",\"ph\":\"M\",\"pid\":2,\"tid\":{},\"args\":{{\"name\":\"{}\"}}}}", i++, escape(track));
+    }
+    for (const TraceEvent &event : events) {
+        os << std::format(
+            ",\n{{\"name\":\"{}\",\"cat\":\"{}\",\"ph\":\"X\",\"pid\":{},\"tid\":{},\"ts\":{:.3f},\"dur\":{:.3f}}}",
+            escape(event.name), event.gpu ? "gpu" : "cpu", event.gpu ? 2 : 1, event.trackIndex,
+            (event.beginNs - epochNs) / 1e3, (event.endNs - event.beginNs) / 1e3);
+    }
+    os << "\n]}\n";
+}
+
+void vku::GpuProfiler::clearTrace() {
+    std::scoped_lock lock { mutex };
+    events.clear();
+}
+
+auto vku::GpuProfiler::now() noexcept -> std::int64_t {
+    return std::chrono::duration_cast<std::chrono::nanoseconds>(std::chrono::steady_clock::now().time_since_epoch()).count();
+}
+
+auto vku::GpuProfiler::isCalibrationSupported(
+    VULKAN_HPP_NAMESPACE::PhysicalDevice physicalDevice
+) -> bool {
+    const std::vector timeDomains = physicalDevice.getCalibrateableTimeDomainsKHR();
+    return std::ranges::contains(timeDomains, VULKAN_HPP_NAMESPACE::TimeDomainKHR::eDevice)
+#ifndef _WIN32
+        && std::ranges::contains(timeDomains, VULKAN_HPP_NAMESPACE::TimeDomainKHR::eClockMonotonic)
+#endif
+        ;
+}
+
+void vku::GpuProfiler::calibrate() {
+#ifdef _WIN32
+    // steady_clock is based on QueryPerformanceCounter, but its frequency is not exposed. Use the midpoint of the host
+    // time around the query instead.
+    const std::int64_t beforeNs = now();
+    const auto [timestamps, maxDeviation] = device.get().getCalibratedTimestampsKHR(VULKAN_HPP_NAMESPACE::CalibratedTimestampInfoKHR { VULKAN_HPP_NAMESPACE::TimeDomainKHR::eDevice });
+    const std::int64_t hostNs = std::midpoint(beforeNs, now());
+#else
+    // steady_clock is CLOCK_MONOTONIC in both libstdc++ and libc++.
+    const auto [timestamps, maxDeviation] = device.get().getCalibratedTimestampsKHR({
+        VULKAN_HPP_NAMESPACE::CalibratedTimestampInfoKHR { VULKAN_HPP_NAMESPACE::TimeDomainKHR::eDevice },
+        VULKAN_HPP_NAMESPACE::CalibratedTimestampInfoKHR { VULKAN_HPP_NAMESPACE::TimeDomainKHR::eClockMonotonic },
+    });
+    const std::int64_t hostNs = static_cast<std::int64_t>(timestamps[1]);
+#endif
+    gpuToCpuOffsetNs = hostNs - static_cast<std::int64_t>(static_cast<double>(timestamps[0]) * timestampPeriod);
+}
+
+void vku::GpuProfiler::resolve(
+    Frame &frame
+) {
+    if (frame.regions.empty()) {
+        return;
+    }
+
+    // The frame's submission is completed, therefore no wait is required. If the results are not available anyway
+    // (e.g. the frame was not submitted), discard them rather than stalling.
+    const auto [result, timestamps] = frame.queryPool.getResults<std::uint64_t>(
+        0, frame.usedQueryCount, frame.usedQueryCount * sizeof(std::uint64_t), sizeof(std::uint64_t),
+        VULKAN_HPP_NAMESPACE::QueryResultFlagBits::e64);
+    if (result != VULKAN_HPP_NAMESPACE::Result::eSuccess) {
+        return;
+    }
+
+    const auto toNs = [&](std::uint64_t timestamp) {
+        return static_cast<std::int64_t>(static_cast<double>(timestamp) * timestampPeriod);
+    };
+
+    if (!gpuToCpuOffsetNs) {
+        // Without the calibration, the GPU execution of every region starts after its recording ends, therefore the
+        // offset is at least (cpuEnd - gpuBegin). The tightest bound is used.
+        std::int64_t offset = std::numeric_limits<std::int64_t>::min();
+        for (const Region &region : frame.regions) {
+            offset = std::max(offset, region.cpuEndNs - toNs(timestamps[region.beginQuery]));
+        }
+        gpuToCpuOffsetNs = offset;
+    }
+
+    for (const Region &region : frame.regions) {
+        events.push_back({ region.name, false, region.cpuThreadIndex, region.cpuBeginNs, region.cpuEndNs });
+        events.push_back({
+            region.name, true, region.gpuTrackIndex,
+            toNs(timestamps[region.beginQuery]) + *gpuToCpuOffsetNs,
+            toNs(timestamps[region.beginQuery + 1]) + *gpuToCpuOffsetNs,
+        });
+    }
+}
+
+void vku::GpuProfiler::endScope(
+    std::uint32_t frameIndex,
+    VULKAN_HPP_NAMESPACE::CommandBuffer commandBuffer,
+    std::size_t regionIndex
+) {
+    std::scoped_lock lock { mutex };
+    Frame &frame = frames[frameIndex];
+    Region &region = frame.regions[regionIndex];
+    commandBuffer.writeTimestamp(VULKAN_HPP_NAMESPACE::PipelineStageFlagBits::eBottomOfPipe, *frame.queryPool, region.beginQuery + 1);
+    region.cpuEndNs = now();
+}
@@ -0,0 +1,498 @@
+/** @file profiling/PipelineCounters.cppm
+ */
+
+module;
+
+#include <vulkan/vulkan_hpp_macros.hpp>
+
+export module vku:profiling.PipelineCounters;
+
+import std;
+export import vulkan_hpp;
+
+namespace vku {
+    /**
+     * @brief Fixed-length window of the most recent samples with their statistics.
+     */
+    export class RollingHistogram {
+    public:
+        struct Summary {
+            std::uint64_t min;
+            std::uint64_t max;
+            double mean;
+            std::uint64_t p50;
+            std::uint64_t p95;
+        };
+
+        /**
+         * @param capacity Number of the most recent samples to be kept.
+         * @throw std::invalid_argument If \p capacity is 0.
+         */
+        explicit RollingHistogram(std::size_t capacity);
+
+        void push(std::uint64_t value);
+
+        [[nodiscard]] auto size() const noexcept -> std::size_t;
+
+        /**
+         * @brief Statistics of the samples in the window, or <tt>std::nullopt</tt> if empty.
+         */
+        [[nodiscard]] auto getSummary() const -> std::optional<Summary>;
+
+        /**
+         * @brief Sample counts of the power-of-two buckets: bucket 0 is for the value 0, and bucket <tt>i</tt> (> 0) is
+         * for the values in [2^(i-1), 2^i).
+         */
+        [[nodiscard]] auto getBucketCounts() const -> std::array<std::uint32_t, 65>;
+
+    private:
+        std::vector<std::uint64_t> samples;
+        std::size_t capacity;
+        std::size_t nextIndex = 0;
+    };
+
+    /**
+     * @brief Pipeline statistics and occlusion counters of the labeled scopes, aggregated per frame into the rolling
+     * histograms.
+     *
+     * Each frame in flight has its own pipeline statistics and occlusion query pools, following the same frame protocol
+     * as <tt>vku::GpuProfiler</tt>: <tt>beginFrame</tt> must be called with the frame's first command buffer after
+     * waiting the frame's fence. Counters of the same label in a frame are summed.
+     *
+     * The device must enable <tt>pipelineStatisticsQuery</tt> feature, and <tt>occlusionQueryPrecise</tt> for the
+     * precise occlusion. The ratio of <tt>Counter::FragmentShaderInvocations</tt> to <tt>Counter::SamplesPassed</tt>
+     * estimates the overdraw of a pass.
+     *
+     * Graphics pipeline statistics can only be queried on the graphics queues. For the command buffers of a
+     * compute-only queue, create a separate instance with <tt>computePipelineStatistics</tt> and use the scopes without
+     * occlusion.
+     *
+     * @code{.cpp}
+     * vku::PipelineCounters counters { gpu.device, FRAMES_IN_FLIGHT, 64, 120, true };
+     *
+     * counters.beginFrame(frameIndex, commandBuffer);
+     * commandBuffer.beginRenderingKHR(...);
+     * {
+     *     const vku::PipelineCounters::Scope scope = counters.scope(commandBuffer, "Opaque");
+     *     ... // Record draw commands.
+     * }
+     * commandBuffer.endRenderingKHR();
+     *
+     * if (auto summary = counters.getSummary("Opaque", vku::PipelineCounters::Counter::FragmentShaderInvocations)) {
+     *     std::println("Opaque FS invocations (p95): {}", summary->p95);
+     * }
+     * @endcode
+     *
+     * @note Scope must be ended in the same subpass (or rendering) where it is started, and scopes must not be nested.
+     * @note Member functions are thread-safe, but a frame must not be begun while its command buffers are recorded.
+     */
+    export class PipelineCounters {
+    public:
+        enum class Counter : std::uint8_t {
+            VertexShaderInvocations,
+            ClippingInvocations,
+            ClippingPrimitives,
+            FragmentShaderInvocations,
+            ComputeShaderInvocations,
+            SamplesPassed,
+        };
+
+        static constexpr std::size_t counterCount = 6;
+
+        /**
+         * @brief Pipeline statistics that are queried by default, which requires the graphics queue. Their results are
+         * written in the bit order, which matches <tt>Counter</tt> enumerators.
+         */
+        static constexpr VULKAN_HPP_NAMESPACE::QueryPipelineStatisticFlags graphicsPipelineStatistics
+            = VULKAN_HPP_NAMESPACE::QueryPipelineStatisticFlagBits::eVertexShaderInvocations
+            | VULKAN_HPP_NAMESPACE::QueryPipelineStatisticFlagBits::eClippingInvocations
+            | VULKAN_HPP_NAMESPACE::QueryPipelineStatisticFlagBits::eClippingPrimitives
+            | VULKAN_HPP_NAMESPACE::QueryPipelineStatisticFlagBits::eFragmentShaderInvocations
+            | VULKAN_HPP_NAMESPACE::QueryPipelineStatisticFlagBits::eComputeShaderInvocations;
+
+        /**
+         * @brief Pipeline statistics that can be queried on the compute-only queues.
+         */
+        static constexpr VULKAN_HPP_NAMESPACE::QueryPipelineStatisticFlags computePipelineStatistics
+            = VULKAN_HPP_NAMESPACE::QueryPipelineStatisticFlagBits::eComputeShaderInvocations;
+
+        /**
+         * @brief RAII scope that begins the queries at construction and ends them at destruction.
+         */
+        class Scope {
+        public:
+            Scope(const Scope&) = delete;
+            auto operator=(const Scope&) -> Scope& = delete;
+            ~Scope();
+
+        private:
+            friend class PipelineCounters;
+
+            PipelineCounters *counters;
+            VULKAN_HPP_NAMESPACE::CommandBuffer commandBuffer;
+            std::uint32_t frameIndex;
+
+            /**
+             * @brief Index of the scope in the frame, or <tt>std::nullopt</tt> if the queries are exhausted.
+             */
+            std::optional<std::size_t> scopeIndex;
+
+            Scope(PipelineCounters &counters, VULKAN_HPP_NAMESPACE::CommandBuffer commandBuffer, std::uint32_t frameIndex, std::optional<std::size_t> scopeIndex) noexcept;
+        };
+
+        /**
+         * @brief Create the per-frame query pools.
+         * @param device Vulkan device.
+         * @param frameCount Number of the frames in flight.
+         * @param maxScopesPerFrame Maximum number of the scopes in a frame. Scopes beyond it are not measured.
+         * @param historyLength Number of the frames that histograms keep.
+         * @param preciseOcclusion Whether to count the exact number of samples passed, instead of zero or non-zero.
+         * @param pipelineStatistics Pipeline statistics to be queried. Must be a non-empty subset of
+         * <tt>graphicsPipelineStatistics</tt>, and <tt>computePipelineStatistics</tt> for the compute-only queues.
+         * Counters that are not queried have no result.
+         * @throw std::invalid_argument If \p pipelineStatistics is empty or has an unsupported statistic, or
+         * \p historyLength is 0.
+         */
+        PipelineCounters(
+            const VULKAN_HPP_NAMESPACE::VULKAN_HPP_RAII_NAMESPACE::Device &device [[clang::lifetimebound]],
+            std::uint32_t frameCount,
+            std::uint32_t maxScopesPerFrame = 64,
+            std::size_t historyLength = 120,
+            bool preciseOcclusion = false,
+            VULKAN_HPP_NAMESPACE::QueryPipelineStatisticFlags pipelineStatistics = graphicsPipelineStatistics
+        );
+
+        /**
+         * @brief Aggregate the results of the previous use of the frame, and record the query pool resets.
+         * @param frameIndex Frame index. Its previous submission must be completed.
+         * @param commandBuffer Command buffer that is submitted before any other command buffers of the frame. It must
+         * not be inside a render pass.
+         */
+        void beginFrame(std::uint32_t frameIndex, VULKAN_HPP_NAMESPACE::CommandBuffer commandBuffer);
+
+        /**
+         * @brief Start the labeled scope, which ends when the returned Scope is destroyed.
+         * @param commandBuffer Command buffer to record the queries. It must be submitted in the current frame.
+         * @param name Scope label.
+         * @param occlusion Whether to count the samples passed. Must be <tt>false</tt> for the compute works, and on
+         * the compute-only queues.
+         * @return Scope.
+         */
+        [[nodiscard]] auto scope(VULKAN_HPP_NAMESPACE::CommandBuffer commandBuffer, std::string name, bool occlusion = true) -> Scope;
+
+        /**
+         * @brief Labels that have the collected counters.
+         */
+        [[nodiscard]] auto getLabels() const -> std::vector<std::string>;
+
+        /**
+         * @brief Statistics of the per-frame values of the \p counter of the scopes labeled \p name.
+         * @return Summary, or <tt>std::nullopt</tt> if no result is collected.
+         */
+        [[nodiscard]] auto getSummary(std::string_view name, Counter counter) const -> std::optional<RollingHistogram::Summary>;
+
+        /**
+         * @brief Copy of the histogram of the \p counter of the scopes labeled \p name.
+         * @return Histogram, or <tt>std::nullopt</tt> if no result is collected.
+         */
+        [[nodiscard]] auto getHistogram(std::string_view name, Counter counter) const -> std::optional<RollingHistogram>;
+
+    private:
+        struct ScopeInfo {
+            std::string name;
+            std::optional<std::uint32_t> occlusionQuery;
+        };
+
+        struct Frame {
+            VULKAN_HPP_NAMESPACE::VULKAN_HPP_RAII_NAMESPACE::QueryPool pipelineStatisticsQueryPool;
+            VULKAN_HPP_NAMESPACE::VULKAN_HPP_RAII_NAMESPACE::QueryPool occlusionQueryPool;
+            std::uint32_t usedPipelineStatisticsQueryCount = 0;
+            std::uint32_t usedOcclusionQueryCount = 0;
+            std::vector<ScopeInfo> scopes;
+        };
+
+        std::uint32_t maxScopesPerFrame;
+        std::size_t historyLength;
+        bool preciseOcclusion;
+        VULKAN_HPP_NAMESPACE::QueryPipelineStatisticFlags pipelineStatistics;
+
+        mutable std::mutex mutex;
+        std::vector<Frame> frames;
+        std::uint32_t currentFrameIndex = 0;
+        std::map<std::string, std::array<RollingHistogram, counterCount>, std::less<>> histograms;
+
+        /**
+         * @note \p mutex must be locked.
+         */
+        void resolve(Frame &frame);
+
+        void endScope(std::uint32_t frameIndex, VULKAN_HPP_NAMESPACE::CommandBuffer commandBuffer, std::size_t scopeIndex);
+    };
+}
+
+// --------------------
+// Implementations.
+// --------------------
+
+vku::RollingHistogram::RollingHistogram(
+    std::size_t capacity
+) : capacity { capacity } {
+    if (capacity == 0) {
+        throw std::invalid_argument { "Histogram capacity must be positive." };
+    }
+    samples.reserve(capacity);
+}
+
+void vku::RollingHistogram::push(
+    std::uint64_t value
+) {
+    if (samples.size() < capacity) {
+        samples.push_back(value);
+    }
+    else {
+        samples[nextIndex] = value;
+    }
+    nextIndex = (nextIndex + 1) % capacity;
+}
+
+auto vku::RollingHistogram::size() const noexcept -> std::size_t {
+    return samples.size();
+}
+
+auto vku::RollingHistogram::getSummary() const -> std::optional<Summary> {
+    if (samples.empty()) {
+        return std::nullopt;
+    }
+
+    std::vector sortedSamples = samples;
+    std::ranges::sort(sortedSamples);
+    const auto percentile = [&](double p) {
+        // Nearest-rank on [0, size - 1]; clamped in case of the floating point rounding.
+        return sortedSamples[std::min(static_cast<std::size_t>(p * (sortedSamples.size() - 1)), sortedSamples.size() - 1)];
+    };
+    return Summary {
+        .min = sortedSamples.front(),
+        .max = sortedSamples.back(),
+        .mean = static_cast<double>(std::ranges::fold_left(sortedSamples, std::uint64_t { 0 }, std::plus{})) / sortedSamples.size(),
+        .p50 = percentile(0.5),
+        .p95 = percentile(0.95),
+    };
+}
+
+auto vku::RollingHistogram::getBucketCounts() const -> std::array<std::uint32_t, 65> {
+    std::array<std::uint32_t, 65> result{};
+    for (std::uint64_t sample : samples) {
+        ++result[std::bit_width(sample)];
+    }
+    return result;
+}
+
+vku::PipelineCounters::Scope::Scope(
+    PipelineCounters &counters,
+    VULKAN_HPP_NAMESPACE::CommandBuffer commandBuffer,
+    std::uint32_t frameIndex,
+    std::optional<std::size_t> scopeIndex
+) noexcept : counters { &counters },
+             commandBuffer { commandBuffer },
+             frameIndex { frameIndex },
+             scopeIndex { scopeIndex } { }
+
+vku::PipelineCounters::Scope::~Scope() {
+    if (scopeIndex) {
+        counters->endScope(frameIndex, commandBuffer, *scopeIndex);
+    }
+}
+
+vku::PipelineCounters::PipelineCounters(
+    const VULKAN_HPP_NAMESPACE::VULKAN_HPP_RAII_NAMESPACE::Device &device,
+    std::uint32_t frameCount,
+    std::uint32_t maxScopesPerFrame,
+    std::size_t historyLength,
+    bool preciseOcclusion,
+    VULKAN_HPP_NAMESPACE::QueryPipelineStatisticFlags pipelineStatistics
+) : maxScopesPerFrame { maxScopesPerFrame },
+    historyLength { historyLength },
+    preciseOcclusion { preciseOcclusion },
+    pipelineStatistics { pipelineStatistics } {
+    if (!pipelineStatistics || (pipelineStatistics & ~graphicsPipelineStatistics)) {
+        throw std::invalid_argument { "Pipeline statistics must be a non-empty subset of graphicsPipelineStatistics." };
+    }
+    if (historyLength == 0) {
+        throw std::invalid_argument { "History length must be positive." };
+    }
+
+    frames.reserve(frameCount);
+    for (std::uint32_t i = 0; i < frameCount; ++i) {
+        frames.emplace_back(
+            VULKAN_HPP_NAMESPACE::VULKAN_HPP_RAII_NAMESPACE::QueryPool { device, VULKAN_HPP_NAMESPACE::QueryPoolCreateInfo {
+                {},
+                VULKAN_HPP_NAMESPACE::QueryType::ePipelineStatistics,
+                maxScopesPerFrame,
+                pipelineStatistics,
+            } },
+            VULKAN_HPP_NAMESPACE::VULKAN_HPP_RAII_NAMESPACE::QueryPool { device, VULKAN_HPP_NAMESPACE::QueryPoolCreateInfo {
+                {},
+                VULKAN_HPP_NAMESPACE::QueryType::eOcclusion,
+                maxScopesPerFrame,
+            } },
+            // Newly created queries are in undefined state, therefore they must be reset before the first use.
+            maxScopesPerFrame, maxScopesPerFrame);
+    }
+}
+
+void vku::PipelineCounters::beginFrame(
+    std::uint32_t frameIndex,
+    VULKAN_HPP_NAMESPACE::CommandBuffer commandBuffer
+) {
+    std::scoped_lock lock { mutex };
+    Frame &frame = frames[frameIndex];
+    resolve(frame);
+
+    if (frame.usedPipelineStatisticsQueryCount != 0) {
+        commandBuffer.resetQueryPool(*frame.pipelineStatisticsQueryPool, 0, frame.usedPipelineStatisticsQueryCount);
+    }
+    if (frame.usedOcclusionQueryCount != 0) {
+        commandBuffer.resetQueryPool(*frame.occlusionQueryPool, 0, frame.usedOcclusionQueryCount);
+    }
+    frame.usedPipelineStatisticsQueryCount = 0;
+    frame.usedOcclusionQueryCount = 0;
+    frame.scopes.clear();
+    currentFrameIndex = frameIndex;
+}
+
+auto vku::PipelineCounters::scope(
+    VULKAN_HPP_NAMESPACE::CommandBuffer commandBuffer,
+    std::string name,
+    bool occlusion
+) -> Scope {
+    std::scoped_lock lock { mutex };
+    Frame &frame = frames[currentFrameIndex];
+    if (frame.usedPipelineStatisticsQueryCount == maxScopesPerFrame) {
+        return { *this, commandBuffer, currentFrameIndex, std::nullopt };
+    }
+
+    ScopeInfo &scopeInfo = frame.scopes.emplace_back(std::move(name));
+    commandBuffer.beginQuery(*frame.pipelineStatisticsQueryPool, frame.usedPipelineStatisticsQueryCount++, {});
+    if (occlusion) {
+        scopeInfo.occlusionQuery.emplace(frame.usedOcclusionQueryCount++);
+        commandBuffer.beginQuery(
+            *frame.occlusionQueryPool, *scopeInfo.occlusionQuery,
+            preciseOcclusion ? VULKAN_HPP_NAMESPACE::QueryControlFlagBits::ePrecise : VULKAN_HPP_NAMESPACE::QueryControlFlags{});
+    }
+    return { *this, commandBuffer, currentFrameIndex, frame.scopes.size() - 1 };
+}
+
+auto vku::PipelineCounters::getLabels() const -> std::vector<std::string> {
+    std::scoped_lock lock { mutex };
+    return histograms | std::views::keys | std::ranges::to<std::vector>();
+}
+
+auto vku::PipelineCounters::getSummary(
+    std::string_view name,
+    Counter counter
+) const -> std::optional<RollingHistogram::Summary> {
+    std::scoped_lock lock { mutex };
+    const auto it = histograms.find(name);
+    if (it == histograms.end()) {
+        return std::nullopt;
+    }
+    return it->second[std::to_underlying(counter)].getSummary();
+}
+
+auto vku::PipelineCounters::getHistogram(
+    std::string_view name,
+    Counter counter
+) const -> std::optional<RollingHistogram> {
+    std::scoped_lock lock { mutex };
+    const auto it = histograms.find(name);
+    if (it == histograms.end()) {
+        return std::nullopt;
+    }
+    return it->second[std::to_underlying(counter)];
+}
+
+void vku::PipelineCounters::resolve(
+    Frame &frame
+) {
+    if (frame.scopes.empty()) {
+        return;
+    }
+
+    // The frame's submission is completed, therefore no wait is required. If the results are not available anyway
+    // (e.g. the frame was not submitted), discard them rather than stalling.
+    const std::size_t pipelineStatisticCount = std::popcount(static_cast<VULKAN_HPP_NAMESPACE::QueryPipelineStatisticFlags::MaskType>(pipelineStatistics));
+    const auto [pipelineStatisticsResult, statistics] = frame.pipelineStatisticsQueryPool.getResults<std::uint64_t>(
+        0, frame.usedPipelineStatisticsQueryCount,
+        frame.usedPipelineStatisticsQueryCount * pipelineStatisticCount * sizeof(std::uint64_t),
+        pipelineStatisticCount * sizeof(std::uint64_t),
+        VULKAN_HPP_NAMESPACE::QueryResultFlagBits::e64);
+    if (pipelineStatisticsResult != VULKAN_HPP_NAMESPACE::Result::eSuccess) {
+        return;
+    }
+
+    std::vector<std::uint64_t> occlusions;
+    if (frame.usedOcclusionQueryCount != 0) {
+        VULKAN_HPP_NAMESPACE::Result occlusionResult;
+        std::tie(occlusionResult, occlusions) = frame.occlusionQueryPool.getResults<std::uint64_t>(
+            0, frame.usedOcclusionQueryCount,
+            frame.usedOcclusionQueryCount * sizeof(std::uint64_t), sizeof(std::uint64_t),
+            VULKAN_HPP_NAMESPACE::QueryResultFlagBits::e64);
+        if (occlusionResult != VULKAN_HPP_NAMESPACE::Result::eSuccess) {
+            return;
+        }
+    }
+
+    // Bit of each pipeline statistic counter, in the Counter order.
+    constexpr std::array counterStatistics {
+        VULKAN_HPP_NAMESPACE::QueryPipelineStatisticFlagBits::eVertexShaderInvocations,
+        VULKAN_HPP_NAMESPACE::QueryPipelineStatisticFlagBits::eClippingInvocations,
+        VULKAN_HPP_NAMESPACE::QueryPipelineStatisticFlagBits::eClippingPrimitives,
+        VULKAN_HPP_NAMESPACE::QueryPipelineStatisticFlagBits::eFragmentShaderInvocations,
+        VULKAN_HPP_NAMESPACE::QueryPipelineStatisticFlagBits::eComputeShaderInvocations,
+    };
+
+    // Sum the counters of the same label. Results of a query are packed in the bit order of the queried statistics.
+    std::map<std::string_view, std::array<std::uint64_t, counterCount>> frameCounters;
+    for (std::size_t i = 0; const ScopeInfo &scopeInfo : frame.scopes) {
+        std::array<std::uint64_t, counterCount> &values = frameCounters[scopeInfo.name];
+        for (std::size_t j = 0, k = 0; j < counterStatistics.size(); ++j) {
+            if (pipelineStatistics & counterStatistics[j]) {
+                values[j] += statistics[i * pipelineStatisticCount + k++];
+            }
+        }
+        if (scopeInfo.occlusionQuery) {
+            values[std::to_underlying(Counter::SamplesPassed)] += occlusions[*scopeInfo.occlusionQuery];
+        }
+        ++i;
+    }
+
+    for (const auto &[name, values] : frameCounters) {
+        auto it = histograms.find(name);
+        if (it == histograms.end()) {
+            it = histograms.emplace(std::string { name }, [&]<std::size_t... Is>(std::index_sequence<Is...>) {
+                return std::array { (static_cast<void>(Is), RollingHistogram { historyLength })... };
+            }(std::make_index_sequence<counterCount>{})).first;
+        }
+        for (std::size_t i = 0; i < counterCount; ++i) {
+            // Counters that are not queried are left empty, so that their summaries are std::nullopt.
+            if (i < counterStatistics.size() && !(pipelineStatistics & counterStatistics[i])) {
+                continue;
+            }
+            it->second[i].push(values[i]);
+        }
+    }
+}
+
+void vku::PipelineCounters::endScope(
+    std::uint32_t frameIndex,
+    VULKAN_HPP_NAMESPACE::CommandBuffer commandBuffer,
+    std::size_t scopeIndex
+) {
+    std::scoped_lock lock { mutex };
+    Frame &frame = frames[frameIndex];
+    const ScopeInfo &scopeInfo = frame.scopes[scopeIndex];
+    if (scopeInfo.occlusionQuery) {
+        commandBuffer.endQuery(*frame.occlusionQueryPool, *scopeInfo.occlusionQuery);
+    }
+    commandBuffer.endQuery(*frame.pipelineStatisticsQueryPool, static_cast<std::uint32_t>(scopeIndex));
+}
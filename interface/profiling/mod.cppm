@@ -0,0 +1,6 @@
+/** @file profiling/mod.cppm
+ */
+
+export module vku:profiling;
+export import :profiling.GpuProfiler;
+export import :profiling.PipelineCounters;
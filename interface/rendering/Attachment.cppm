@@ -8,15 +8,16 @@ module;
 export module vku:rendering.Attachment;
 
 import std;
+export import :caches.ImageViewCache;
 export import :images.Image;
 
 namespace vku {
     export struct Attachment {
         Image image;
-        VULKAN_HPP_NAMESPACE::VULKAN_HPP_RAII_NAMESPACE::ImageView view;
+        SharedImageView view;
     };
 
     export struct SwapchainAttachment {
-        std::vector<VULKAN_HPP_NAMESPACE::VULKAN_HPP_RAII_NAMESPACE::ImageView> views;
+        std::vector<SharedImageView> views;
     };
 }
\ No newline at end of file
@@ -26,12 +26,23 @@ export namespace vku {
             VULKAN_HPP_NAMESPACE::AttachmentLoadOp loadOp;
             VULKAN_HPP_NAMESPACE::AttachmentStoreOp storeOp;
             VULKAN_HPP_NAMESPACE::ClearColorValue clearValue;
+
+            /**
+             * @brief Layout of the attachment during rendering. Use <tt>vk::ImageLayout::eRenderingLocalReadKHR</tt> to
+             * read the attachment as an input attachment in the same rendering scope (<tt>VK_KHR_dynamic_rendering_local_read</tt>).
+             */
+            VULKAN_HPP_NAMESPACE::ImageLayout layout = VULKAN_HPP_NAMESPACE::ImageLayout::eColorAttachmentOptimal;
         };
 
         struct DepthStencilAttachmentInfo {
             VULKAN_HPP_NAMESPACE::AttachmentLoadOp loadOp;
             VULKAN_HPP_NAMESPACE::AttachmentStoreOp storeOp;
             VULKAN_HPP_NAMESPACE::ClearDepthStencilValue clearValue;
+
+            /**
+             * @brief Layout of the attachment during rendering. See <tt>ColorAttachmentInfo::layout</tt>.
+             */
+            VULKAN_HPP_NAMESPACE::ImageLayout layout = VULKAN_HPP_NAMESPACE::ImageLayout::eDepthStencilAttachmentOptimal;
         };
 
         std::vector<std::variant<Attachment, SwapchainAttachment>> colorAttachments;
@@ -41,7 +52,7 @@ export namespace vku {
         AttachmentGroup(const AttachmentGroup&) = delete;
         AttachmentGroup(AttachmentGroup&&) noexcept = default;
         auto operator=(const AttachmentGroup&) -> AttachmentGroup& = delete;
-        auto operator=(AttachmentGroup&&) noexcept -> AttachmentGroup& = default;
+        auto operator=(AttachmentGroup &&src) noexcept -> AttachmentGroup&;
         ~AttachmentGroup() override = default;
 
         auto addColorAttachment(
@@ -112,23 +123,49 @@ export namespace vku {
 
         [[nodiscard]] auto getRenderingInfo(
             VULKAN_HPP_NAMESPACE::ArrayProxy<const ColorAttachmentInfo> colorAttachmentInfos
-        ) const -> RefHolder<VULKAN_HPP_NAMESPACE::RenderingInfo, std::vector<VULKAN_HPP_NAMESPACE::RenderingAttachmentInfo>>;
+        ) const -> RefHolder<VULKAN_HPP_NAMESPACE::RenderingInfo, RenderingAttachmentInfos>;
 
         [[nodiscard]] auto getRenderingInfo(
             VULKAN_HPP_NAMESPACE::ArrayProxy<const ColorAttachmentInfo> colorAttachmentInfos,
             std::uint32_t swapchainImageIndex
-        ) const -> RefHolder<VULKAN_HPP_NAMESPACE::RenderingInfo, std::vector<VULKAN_HPP_NAMESPACE::RenderingAttachmentInfo>>;
+        ) const -> RefHolder<VULKAN_HPP_NAMESPACE::RenderingInfo, RenderingAttachmentInfos>;
 
         [[nodiscard]] auto getRenderingInfo(
             VULKAN_HPP_NAMESPACE::ArrayProxy<const ColorAttachmentInfo> colorAttachmentInfos,
             const DepthStencilAttachmentInfo &depthStencilAttachmentInfo
-        ) const -> RefHolder<VULKAN_HPP_NAMESPACE::RenderingInfo, std::vector<VULKAN_HPP_NAMESPACE::RenderingAttachmentInfo>>;
+        ) const -> RefHolder<VULKAN_HPP_NAMESPACE::RenderingInfo, RenderingAttachmentInfos>;
 
         [[nodiscard]] auto getRenderingInfo(
             VULKAN_HPP_NAMESPACE::ArrayProxy<const ColorAttachmentInfo> colorAttachmentInfos,
             const DepthStencilAttachmentInfo &depthStencilAttachmentInfo,
             std::uint32_t swapchainImageIndex
-        ) const -> RefHolder<VULKAN_HPP_NAMESPACE::RenderingInfo, std::vector<VULKAN_HPP_NAMESPACE::RenderingAttachmentInfo>>;
+        ) const -> RefHolder<VULKAN_HPP_NAMESPACE::RenderingInfo, RenderingAttachmentInfos>;
+
+        /**
+         * @brief Precompute the rendering infos for every swapchain image (or a single one if there is no swapchain
+         * attachment), which can be retrieved by <tt>getCachedRenderingInfo(swapchainImageIndex)</tt> without building
+         * them in every frame.
+         * @param colorAttachmentInfos Color attachment infos, same as <tt>getRenderingInfo</tt>.
+         * @note The cache must be updated after the attachments are changed.
+         */
+        void updateRenderingInfoCache(
+            VULKAN_HPP_NAMESPACE::ArrayProxy<const ColorAttachmentInfo> colorAttachmentInfos
+        );
+
+        /**
+         * @copydoc updateRenderingInfoCache(VULKAN_HPP_NAMESPACE::ArrayProxy<const ColorAttachmentInfo>)
+         * @param depthStencilAttachmentInfo Depth-stencil attachment info, same as <tt>getRenderingInfo</tt>.
+         */
+        void updateRenderingInfoCache(
+            VULKAN_HPP_NAMESPACE::ArrayProxy<const ColorAttachmentInfo> colorAttachmentInfos,
+            const DepthStencilAttachmentInfo &depthStencilAttachmentInfo
+        );
+
+    private:
+        /**
+         * @brief Number of swapchain images of the swapchain attachment, or <tt>0</tt> if there is no swapchain attachment.
+         */
+        [[nodiscard]] auto getSwapchainImageCount() const noexcept -> std::uint32_t;
     };
 }
 
@@ -140,6 +177,21 @@ vku::AttachmentGroup::AttachmentGroup(
     const VULKAN_HPP_NAMESPACE::Extent2D &extent
 ) : AttachmentGroupBase { extent } { }
 
+auto vku::AttachmentGroup::operator=(
+    AttachmentGroup &&src
+) noexcept -> AttachmentGroup& {
+    if (this != &src) {
+        // Views must be destroyed before the base class destroys the stored images.
+        colorAttachments.clear();
+        depthStencilAttachment.reset();
+
+        AttachmentGroupBase::operator=(std::move(src));
+        colorAttachments = std::move(src.colorAttachments);
+        depthStencilAttachment = std::move(src.depthStencilAttachment);
+    }
+    return *this;
+}
+
 auto vku::AttachmentGroup::addColorAttachment(
     const VULKAN_HPP_NAMESPACE::VULKAN_HPP_RAII_NAMESPACE::Device &device,
     const Image &image,
@@ -160,10 +212,14 @@ auto vku::AttachmentGroup::addColorAttachment(
     const Image &image,
     const VULKAN_HPP_NAMESPACE::ImageViewCreateInfo &viewCreateInfo
 ) -> const Attachment & {
+    if (colorAttachments.size() == maxColorAttachmentCount) {
+        throw std::runtime_error { "Color attachment count exceeds maximum" };
+    }
+
     return *get_if<Attachment>(&colorAttachments.emplace_back(
         std::in_place_type<Attachment>,
         image,
-        VULKAN_HPP_NAMESPACE::VULKAN_HPP_RAII_NAMESPACE::ImageView { device, viewCreateInfo }));
+        createImageView(device, viewCreateInfo)));
 }
 
 auto vku::AttachmentGroup::addSwapchainAttachment(
@@ -171,17 +227,21 @@ auto vku::AttachmentGroup::addSwapchainAttachment(
     std::span<const VULKAN_HPP_NAMESPACE::Image> swapchainImages,
     VULKAN_HPP_NAMESPACE::Format viewFormat
 ) -> const SwapchainAttachment& {
-    std::vector<VULKAN_HPP_NAMESPACE::VULKAN_HPP_RAII_NAMESPACE::ImageView> views;
+    if (colorAttachments.size() == maxColorAttachmentCount) {
+        throw std::runtime_error { "Color attachment count exceeds maximum" };
+    }
+
+    std::vector<SharedImageView> views;
     views.reserve(swapchainImages.size());
     for (VULKAN_HPP_NAMESPACE::Image swapchainImage : swapchainImages) {
-        views.emplace_back(device, VULKAN_HPP_NAMESPACE::ImageViewCreateInfo {
+        views.push_back(createImageView(device, VULKAN_HPP_NAMESPACE::ImageViewCreateInfo {
             {},
             swapchainImage,
             VULKAN_HPP_NAMESPACE::ImageViewType::e2D,
             viewFormat,
             {},
             { VULKAN_HPP_NAMESPACE::ImageAspectFlagBits::eColor, 0, 1, 0, 1 },
-        });
+        }));
     }
 
     return *get_if<SwapchainAttachment>(&colorAttachments.emplace_back(
@@ -227,7 +287,7 @@ auto vku::AttachmentGroup::setDepthStencilAttachment(
     const Image &image,
     const VULKAN_HPP_NAMESPACE::ImageViewCreateInfo &viewCreateInfo
 ) -> const Attachment & {
-    return depthStencilAttachment.emplace(image, VULKAN_HPP_NAMESPACE::VULKAN_HPP_RAII_NAMESPACE::ImageView { device, viewCreateInfo });
+    return depthStencilAttachment.emplace(image, createImageView(device, viewCreateInfo));
 }
 
 auto vku::AttachmentGroup::createDepthStencilImage(
@@ -246,17 +306,16 @@ auto vku::AttachmentGroup::createDepthStencilImage(
 
 auto vku::AttachmentGroup::getRenderingInfo(
     VULKAN_HPP_NAMESPACE::ArrayProxy<const ColorAttachmentInfo> colorAttachmentInfos
-) const -> RefHolder<VULKAN_HPP_NAMESPACE::RenderingInfo, std::vector<VULKAN_HPP_NAMESPACE::RenderingAttachmentInfo>> {
+) const -> RefHolder<VULKAN_HPP_NAMESPACE::RenderingInfo, RenderingAttachmentInfos> {
     assert(colorAttachments.size() == colorAttachmentInfos.size() && "Color attachment info count mismatch");
     assert(!depthStencilAttachment.has_value() && "Depth-stencil attachment info mismatch");
 
-    std::vector<VULKAN_HPP_NAMESPACE::RenderingAttachmentInfo> renderingAttachmentInfos;
-    renderingAttachmentInfos.reserve(colorAttachmentInfos.size());
+    RenderingAttachmentInfos renderingAttachmentInfos;
     for (const auto &[attachment, info] : std::views::zip(colorAttachments, colorAttachmentInfos)) {
         auto *const pAttachment = get_if<Attachment>(&attachment);
         assert(pAttachment && "A SwapchainAttachment is in the attachment group.");
         renderingAttachmentInfos.push_back({
-            *pAttachment->view, VULKAN_HPP_NAMESPACE::ImageLayout::eColorAttachmentOptimal,
+            *pAttachment->view, info.layout,
             {}, {}, {},
             info.loadOp, info.storeOp, info.clearValue,
         });
@@ -279,12 +338,11 @@ auto vku::AttachmentGroup::getRenderingInfo(
 auto vku::AttachmentGroup::getRenderingInfo(
     VULKAN_HPP_NAMESPACE::ArrayProxy<const ColorAttachmentInfo> colorAttachmentInfos,
     std::uint32_t swapchainImageIndex
-) const -> RefHolder<VULKAN_HPP_NAMESPACE::RenderingInfo, std::vector<VULKAN_HPP_NAMESPACE::RenderingAttachmentInfo>> {
+) const -> RefHolder<VULKAN_HPP_NAMESPACE::RenderingInfo, RenderingAttachmentInfos> {
     assert(colorAttachments.size() == colorAttachmentInfos.size() && "Color attachment info count mismatch");
     assert(!depthStencilAttachment.has_value() && "Depth-stencil attachment info mismatch");
 
-    std::vector<VULKAN_HPP_NAMESPACE::RenderingAttachmentInfo> renderingAttachmentInfos;
-    renderingAttachmentInfos.reserve(colorAttachmentInfos.size());
+    RenderingAttachmentInfos renderingAttachmentInfos;
 
     // SwapchainAttachment can only appear once in the attachment group. Therefore, if a SwapchainAttachment already
     // push_backed into renderingAttachmentInfos, explicit std::visit call for the rest variants is not necessary.
@@ -309,7 +367,7 @@ auto vku::AttachmentGroup::getRenderingInfo(
         }();
 
         renderingAttachmentInfos.push_back({
-            imageView, VULKAN_HPP_NAMESPACE::ImageLayout::eColorAttachmentOptimal,
+            imageView, info.layout,
             {}, {}, {},
             info.loadOp, info.storeOp, info.clearValue,
         });
@@ -333,23 +391,22 @@ auto vku::AttachmentGroup::getRenderingInfo(
 auto vku::AttachmentGroup::getRenderingInfo(
     VULKAN_HPP_NAMESPACE::ArrayProxy<const ColorAttachmentInfo> colorAttachmentInfos,
     const DepthStencilAttachmentInfo &depthStencilAttachmentInfo
-) const -> RefHolder<VULKAN_HPP_NAMESPACE::RenderingInfo, std::vector<VULKAN_HPP_NAMESPACE::RenderingAttachmentInfo>> {
+) const -> RefHolder<VULKAN_HPP_NAMESPACE::RenderingInfo, RenderingAttachmentInfos> {
     assert(colorAttachments.size() == colorAttachmentInfos.size() && "Color attachment info count mismatch");
     assert(depthStencilAttachment.has_value() && "Depth-stencil attachment info mismatch");
 
-    std::vector<VULKAN_HPP_NAMESPACE::RenderingAttachmentInfo> renderingAttachmentInfos;
-    renderingAttachmentInfos.reserve(colorAttachmentInfos.size() + 1);
+    RenderingAttachmentInfos renderingAttachmentInfos;
     for (const auto &[attachment, info] : std::views::zip(colorAttachments, colorAttachmentInfos)) {
         auto *const pAttachment = get_if<Attachment>(&attachment);
         assert(pAttachment && "A SwapchainAttachment is in the attachment group.");
         renderingAttachmentInfos.push_back({
-            *pAttachment->view, VULKAN_HPP_NAMESPACE::ImageLayout::eColorAttachmentOptimal,
+            *pAttachment->view, info.layout,
             {}, {}, {},
             info.loadOp, info.storeOp, info.clearValue,
         });
     }
     renderingAttachmentInfos.push_back({
-        *depthStencilAttachment->view, VULKAN_HPP_NAMESPACE::ImageLayout::eDepthStencilAttachmentOptimal,
+        *depthStencilAttachment->view, depthStencilAttachmentInfo.layout,
         {}, {}, {},
         depthStencilAttachmentInfo.loadOp, depthStencilAttachmentInfo.storeOp, depthStencilAttachmentInfo.clearValue,
     });
@@ -373,12 +430,11 @@ auto vku::AttachmentGroup::getRenderingInfo(
     VULKAN_HPP_NAMESPACE::ArrayProxy<const ColorAttachmentInfo> colorAttachmentInfos,
     const DepthStencilAttachmentInfo &depthStencilAttachmentInfo,
     std::uint32_t swapchainImageIndex
-) const -> RefHolder<VULKAN_HPP_NAMESPACE::RenderingInfo, std::vector<VULKAN_HPP_NAMESPACE::RenderingAttachmentInfo>> {
+) const -> RefHolder<VULKAN_HPP_NAMESPACE::RenderingInfo, RenderingAttachmentInfos> {
     assert(colorAttachments.size() == colorAttachmentInfos.size() && "Color attachment info count mismatch");
     assert(depthStencilAttachment.has_value() && "Depth-stencil attachment info mismatch");
 
-    std::vector<VULKAN_HPP_NAMESPACE::RenderingAttachmentInfo> renderingAttachmentInfos;
-    renderingAttachmentInfos.reserve(colorAttachmentInfos.size() + 1);
+    RenderingAttachmentInfos renderingAttachmentInfos;
 
     // SwapchainAttachment can only appear once in the attachment group. Therefore, if a SwapchainAttachment already
     // push_backed into renderingAttachmentInfos, explicit std::visit call for the rest variants is not necessary.
@@ -403,14 +459,14 @@ auto vku::AttachmentGroup::getRenderingInfo(
         }();
 
         renderingAttachmentInfos.push_back({
-            imageView, VULKAN_HPP_NAMESPACE::ImageLayout::eColorAttachmentOptimal,
+            imageView, info.layout,
             {}, {}, {},
             info.loadOp, info.storeOp, info.clearValue,
         });
     }
     assert(swapchainAttachmentPushed && "swapchainImageIndex set but there is no swapchain attachment in the attachment group.");
     renderingAttachmentInfos.push_back({
-        *depthStencilAttachment->view, VULKAN_HPP_NAMESPACE::ImageLayout::eDepthStencilAttachmentOptimal,
+        *depthStencilAttachment->view, depthStencilAttachmentInfo.layout,
         {}, {}, {},
         depthStencilAttachmentInfo.loadOp, depthStencilAttachmentInfo.storeOp, depthStencilAttachmentInfo.clearValue,
     });
@@ -428,4 +484,44 @@ auto vku::AttachmentGroup::getRenderingInfo(
         },
         std::move(renderingAttachmentInfos),
     };
+}
+
+auto vku::AttachmentGroup::getSwapchainImageCount() const noexcept -> std::uint32_t {
+    for (const auto &attachment : colorAttachments) {
+        if (auto *const pSwapchainAttachment = get_if<SwapchainAttachment>(&attachment)) {
+            return static_cast<std::uint32_t>(pSwapchainAttachment->views.size());
+        }
+    }
+    return 0;
+}
+
+void vku::AttachmentGroup::updateRenderingInfoCache(
+    VULKAN_HPP_NAMESPACE::ArrayProxy<const ColorAttachmentInfo> colorAttachmentInfos
+) {
+    if (const std::uint32_t swapchainImageCount = getSwapchainImageCount(); swapchainImageCount != 0) {
+        setRenderingInfoCache(swapchainImageCount, [&](std::uint32_t swapchainImageIndex) {
+            return getRenderingInfo(colorAttachmentInfos, swapchainImageIndex);
+        });
+    }
+    else {
+        setRenderingInfoCache(1, [&](std::uint32_t) {
+            return getRenderingInfo(colorAttachmentInfos);
+        });
+    }
+}
+
+void vku::AttachmentGroup::updateRenderingInfoCache(
+    VULKAN_HPP_NAMESPACE::ArrayProxy<const ColorAttachmentInfo> colorAttachmentInfos,
+    const DepthStencilAttachmentInfo &depthStencilAttachmentInfo
+) {
+    if (const std::uint32_t swapchainImageCount = getSwapchainImageCount(); swapchainImageCount != 0) {
+        setRenderingInfoCache(swapchainImageCount, [&](std::uint32_t swapchainImageIndex) {
+            return getRenderingInfo(colorAttachmentInfos, depthStencilAttachmentInfo, swapchainImageIndex);
+        });
+    }
+    else {
+        setRenderingInfoCache(1, [&](std::uint32_t) {
+            return getRenderingInfo(colorAttachmentInfos, depthStencilAttachmentInfo);
+        });
+    }
 }
\ No newline at end of file
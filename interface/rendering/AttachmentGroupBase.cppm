@@ -3,11 +3,15 @@
 
 module;
 
+#include <cassert>
+
 #include <vulkan/vulkan_hpp_macros.hpp>
 
 export module vku:rendering.AttachmentGroupBase;
 
 import std;
+export import :caches.ImageViewCache;
+import :details.container.StaticVector;
 export import :images.AllocatedImage;
 export import :utils;
 
@@ -21,23 +25,74 @@ export import :utils;
 namespace vku {
     export class AttachmentGroupBase {
     public:
+        /**
+         * @brief Maximum number of color attachments in an attachment group.
+         *
+         * It bounds the inline storage of the rendering attachment infos, so that building <tt>vk::RenderingInfo</tt>
+         * does not allocate. Most desktop and mobile devices report <tt>maxColorAttachments</tt> of 8. Adding more color
+         * attachments than this throws <tt>std::runtime_error</tt>.
+         */
+        static constexpr std::size_t maxColorAttachmentCount = 8;
+
+        /**
+         * @brief Inline storage of the rendering attachment infos: color attachments followed by the optional
+         * depth-stencil attachment.
+         */
+        using RenderingAttachmentInfos = details::StaticVector<VULKAN_HPP_NAMESPACE::RenderingAttachmentInfo, maxColorAttachmentCount + 1>;
+
         VULKAN_HPP_NAMESPACE::Extent2D extent;
 
+        /**
+         * @brief Image view cache used for the attachment views, or <tt>nullptr</tt> if views are created for every call.
+         *
+         * If set, adding an attachment whose view create info is same as the previously added one reuses the view instead
+         * of creating a new one. It is useful when the attachment group is rebuilt frequently (e.g. on window resize).
+         *
+         * The images whose views are obtained from the cache are evicted from it when the attachment group is destroyed
+         * (or move-assigned), therefore destroying the attachment images (including the ones stored by
+         * <tt>storeImage</tt>) and the swapchain together with the group is safe.
+         * @note The cache must outlive the attachment group.
+         */
+        ImageViewCache *imageViewCache = nullptr;
+
         explicit AttachmentGroupBase(
             const VULKAN_HPP_NAMESPACE::Extent2D &extent
         );
 
         AttachmentGroupBase(const AttachmentGroupBase&) = delete;
-        AttachmentGroupBase(AttachmentGroupBase&&) noexcept = default;
+        AttachmentGroupBase(AttachmentGroupBase &&src) noexcept;
         auto operator=(const AttachmentGroupBase&) -> AttachmentGroupBase& = delete;
-        auto operator=(AttachmentGroupBase&&) noexcept -> AttachmentGroupBase& = default;
-        virtual ~AttachmentGroupBase() = default;
+        auto operator=(AttachmentGroupBase &&src) noexcept -> AttachmentGroupBase&;
+        virtual ~AttachmentGroupBase();
 
         [[nodiscard]] auto storeImage(AllocatedImage &&image) -> const AllocatedImage&;
 
+        /**
+         * @brief Get the rendering info precomputed by <tt>updateRenderingInfoCache</tt> of the derived class.
+         * @param swapchainImageIndex Swapchain image index, or <tt>0</tt> if there is no swapchain attachment in the group.
+         * @return Const reference of the cached rendering info, valid until the cache is updated or the group is destroyed.
+         */
+        [[nodiscard]] auto getCachedRenderingInfo(std::uint32_t swapchainImageIndex = 0) const noexcept -> const VULKAN_HPP_NAMESPACE::RenderingInfo&;
+
     protected:
+        struct CachedRenderingInfo {
+            RenderingAttachmentInfos attachmentInfos;
+            VULKAN_HPP_NAMESPACE::RenderingInfo renderingInfo;
+        };
+
         std::forward_list<AllocatedImage> storedImage;
 
+        /**
+         * @brief Per swapchain image rendering infos. Elements are heap allocated, so they are stable when the group is
+         * moved.
+         */
+        std::vector<std::unique_ptr<CachedRenderingInfo>> renderingInfoCache;
+
+        /**
+         * @brief Images whose views are obtained from <tt>imageViewCache</tt>, evicted on destruction.
+         */
+        std::vector<VULKAN_HPP_NAMESPACE::Image> cachedViewImages;
+
         [[nodiscard]] auto createAttachmentImage(
             VMA_HPP_NAMESPACE::Allocator allocator,
             VULKAN_HPP_NAMESPACE::Format format,
@@ -45,6 +100,64 @@ namespace vku {
             VULKAN_HPP_NAMESPACE::ImageUsageFlags usage,
             const VMA_HPP_NAMESPACE::AllocationCreateInfo &allocationCreateInfo
         ) const -> AllocatedImage;
+
+        /**
+         * @brief Create the image view with \p createInfo, or get it from <tt>imageViewCache</tt> if set.
+         */
+        [[nodiscard]] auto createImageView(
+            const VULKAN_HPP_NAMESPACE::VULKAN_HPP_RAII_NAMESPACE::Device &device,
+            const VULKAN_HPP_NAMESPACE::ImageViewCreateInfo &createInfo
+        ) -> SharedImageView;
+
+        /**
+         * @brief Evict the views of <tt>cachedViewImages</tt> from <tt>imageViewCache</tt>.
+         * @note As it is called from the destructor and the move assignment, an exception from the eviction (which is only
+         * thrown when the cache's mutex cannot be locked) is swallowed, and the views of that image remain in the cache
+         * until it is cleared.
+         */
+        void evictCachedViews() noexcept;
+
+        /**
+         * @brief Replace the rendering info cache with \p count rendering infos, where <tt>i</tt>-th one is copied from
+         * <tt>getRenderingInfo(i)</tt>.
+         * @param count Number of cached rendering infos.
+         * @param getRenderingInfo Invocable that takes an index and returns <tt>vku::RefHolder</tt> of
+         * <tt>vk::RenderingInfo</tt> whose attachments are in the same layout as <tt>RenderingAttachmentInfos</tt>.
+         * @throw std::runtime_error If a rendering info has more than <tt>maxColorAttachmentCount</tt> color attachments, or
+         * its stencil attachment is not same as the depth attachment. The previous cache is kept in this case.
+         */
+        void setRenderingInfoCache(std::uint32_t count, std::invocable<std::uint32_t> auto &&getRenderingInfo) {
+            std::vector<std::unique_ptr<CachedRenderingInfo>> newCache;
+            newCache.reserve(count);
+            for (std::uint32_t i = 0; i < count; ++i) {
+                const auto holder = getRenderingInfo(i);
+                const VULKAN_HPP_NAMESPACE::RenderingInfo &renderingInfo = holder.get();
+                if (renderingInfo.colorAttachmentCount > maxColorAttachmentCount) {
+                    throw std::runtime_error { "Color attachment count exceeds maximum" };
+                }
+                if (renderingInfo.pStencilAttachment && renderingInfo.pStencilAttachment != renderingInfo.pDepthAttachment) {
+                    throw std::runtime_error { "Separate stencil attachment is not supported" };
+                }
+
+                auto &cached = *newCache.emplace_back(std::make_unique<CachedRenderingInfo>());
+                for (const VULKAN_HPP_NAMESPACE::RenderingAttachmentInfo &attachmentInfo : std::span { renderingInfo.pColorAttachments, renderingInfo.colorAttachmentCount }) {
+                    cached.attachmentInfos.push_back(attachmentInfo);
+                }
+                if (renderingInfo.pDepthAttachment) {
+                    cached.attachmentInfos.push_back(*renderingInfo.pDepthAttachment);
+                }
+
+                cached.renderingInfo = renderingInfo;
+                cached.renderingInfo.pColorAttachments = cached.attachmentInfos.data();
+                if (renderingInfo.pDepthAttachment) {
+                    cached.renderingInfo.pDepthAttachment = &cached.attachmentInfos[renderingInfo.colorAttachmentCount];
+                }
+                if (renderingInfo.pStencilAttachment) {
+                    cached.renderingInfo.pStencilAttachment = cached.renderingInfo.pDepthAttachment;
+                }
+            }
+            renderingInfoCache = std::move(newCache);
+        }
     };
 }
 
@@ -56,12 +169,45 @@ vku::AttachmentGroupBase::AttachmentGroupBase(
     const VULKAN_HPP_NAMESPACE::Extent2D &extent
 ) : extent { extent } { }
 
+vku::AttachmentGroupBase::AttachmentGroupBase(
+    AttachmentGroupBase &&src
+) noexcept : extent { src.extent },
+             imageViewCache { src.imageViewCache },
+             storedImage { std::move(src.storedImage) },
+             renderingInfoCache { std::move(src.renderingInfoCache) },
+             cachedViewImages { std::exchange(src.cachedViewImages, {}) } { }
+
+auto vku::AttachmentGroupBase::operator=(
+    AttachmentGroupBase &&src
+) noexcept -> AttachmentGroupBase& {
+    if (this != &src) {
+        evictCachedViews();
+        extent = src.extent;
+        imageViewCache = src.imageViewCache;
+        storedImage = std::move(src.storedImage);
+        renderingInfoCache = std::move(src.renderingInfoCache);
+        cachedViewImages = std::exchange(src.cachedViewImages, {});
+    }
+    return *this;
+}
+
+vku::AttachmentGroupBase::~AttachmentGroupBase() {
+    evictCachedViews();
+}
+
 auto vku::AttachmentGroupBase::storeImage(
     AllocatedImage &&image
 ) -> const AllocatedImage& {
     return storedImage.emplace_front(std::move(image));
 }
 
+auto vku::AttachmentGroupBase::getCachedRenderingInfo(
+    std::uint32_t swapchainImageIndex
+) const noexcept -> const VULKAN_HPP_NAMESPACE::RenderingInfo& {
+    assert(swapchainImageIndex < renderingInfoCache.size() && "Rendering info cache is not updated, or swapchain image index is out of range.");
+    return renderingInfoCache[swapchainImageIndex]->renderingInfo;
+}
+
 auto vku::AttachmentGroupBase::createAttachmentImage(
     VMA_HPP_NAMESPACE::Allocator allocator,
     VULKAN_HPP_NAMESPACE::Format format,
@@ -79,4 +225,33 @@ auto vku::AttachmentGroupBase::createAttachmentImage(
         VULKAN_HPP_NAMESPACE::ImageTiling::eOptimal,
         usage,
     }, allocationCreateInfo };
-}
\ No newline at end of file
+}
+
+auto vku::AttachmentGroupBase::createImageView(
+    const VULKAN_HPP_NAMESPACE::VULKAN_HPP_RAII_NAMESPACE::Device &device,
+    const VULKAN_HPP_NAMESPACE::ImageViewCreateInfo &createInfo
+) -> SharedImageView {
+    if (imageViewCache) {
+        if (!std::ranges::contains(cachedViewImages, createInfo.image)) {
+            cachedViewImages.push_back(createInfo.image);
+        }
+        return imageViewCache->get(createInfo);
+    }
+    return { VULKAN_HPP_NAMESPACE::VULKAN_HPP_RAII_NAMESPACE::ImageView { device, createInfo } };
+}
+
+void vku::AttachmentGroupBase::evictCachedViews() noexcept {
+    // The derived class' attachments (which share the views) are already released at here, therefore evicting the
+    // views from the cache destroys them before the images are destroyed.
+    if (imageViewCache) {
+        for (VULKAN_HPP_NAMESPACE::Image image : cachedViewImages) {
+            try {
+                imageViewCache->evict(image);
+            }
+            catch (...) {
+                // The views remain in the cache. See the note of the declaration.
+            }
+        }
+    }
+    cachedViewImages.clear();
+}
@@ -0,0 +1,158 @@
+/** @file rendering/LocalRead.cppm
+ */
+
+module;
+
+#include <cassert>
+
+#include <vulkan/vulkan_hpp_macros.hpp>
+
+export module vku:rendering.LocalRead;
+
+import std;
+export import vulkan_hpp;
+import :details.container.StaticVector;
+import :rendering.AttachmentGroupBase;
+
+namespace vku {
+    /**
+     * @brief Color attachment location and input attachment index remapping of a dynamic rendering scope, for
+     * <tt>VK_KHR_dynamic_rendering_local_read</tt>.
+     *
+     * The same remapping must be chained into the <tt>vk::GraphicsPipelineCreateInfo</tt> of the pipelines used inside
+     * the rendering scope (<tt>getLocationInfo()</tt> and <tt>getInputAttachmentIndexInfo()</tt>), and be recorded into
+     * the command buffer by <tt>record</tt> if it differs from the identity mapping.
+     *
+     * @code{.cpp}
+     * // G-buffer (attachment 0, 1) is written in the first subpass and read as input attachment 0, 1 in the second one.
+     * const vku::RenderingLocalReadInfo lightingLocalReadInfo {
+     *     std::array { vk::AttachmentUnused, vk::AttachmentUnused, 0U }, // Only the color attachment 2 is written by the lighting pass.
+     *     std::array { 0U, 1U, vk::AttachmentUnused },
+     * };
+     *
+     * cb.beginRenderingKHR(attachmentGroup.getRenderingInfo(...)); // Attachments in vk::ImageLayout::eRenderingLocalReadKHR.
+     * // Draw G-buffer...
+     * vku::recordLocalReadBarrier(cb);
+     * lightingLocalReadInfo.record(device, cb);
+     * // Draw lighting with subpassLoad()...
+     * cb.endRenderingKHR();
+     * @endcode
+     */
+    export class RenderingLocalReadInfo {
+    public:
+        /**
+         * @param colorAttachmentLocations <tt>colorAttachmentLocations[i]</tt> is the fragment shader output location of
+         * the <tt>i</tt>-th color attachment, or <tt>vk::AttachmentUnused</tt> if it is not written.
+         * @param colorAttachmentInputIndices <tt>colorAttachmentInputIndices[i]</tt> is the
+         * <tt>input_attachment_index</tt> of the <tt>i</tt>-th color attachment, or <tt>vk::AttachmentUnused</tt> if it
+         * is not read. Must have the same size as \p colorAttachmentLocations.
+         * @param depthInputAttachmentIndex <tt>input_attachment_index</tt> of the depth attachment, or
+         * <tt>std::nullopt</tt> if it is read by an input attachment without <tt>input_attachment_index</tt>.
+         * @param stencilInputAttachmentIndex Same as \p depthInputAttachmentIndex, for the stencil attachment.
+         * @throw std::runtime_error If the color attachment count exceeds <tt>AttachmentGroupBase::maxColorAttachmentCount</tt>.
+         */
+        RenderingLocalReadInfo(
+            std::span<const std::uint32_t> colorAttachmentLocations,
+            std::span<const std::uint32_t> colorAttachmentInputIndices,
+            std::optional<std::uint32_t> depthInputAttachmentIndex = std::nullopt,
+            std::optional<std::uint32_t> stencilInputAttachmentIndex = std::nullopt
+        );
+
+        /**
+         * @brief Get the location remapping. The returned struct refers to this object.
+         */
+        [[nodiscard]] auto getLocationInfo() const noexcept -> VULKAN_HPP_NAMESPACE::RenderingAttachmentLocationInfoKHR;
+
+        /**
+         * @brief Get the input attachment index remapping. The returned struct refers to this object.
+         */
+        [[nodiscard]] auto getInputAttachmentIndexInfo() const noexcept -> VULKAN_HPP_NAMESPACE::RenderingInputAttachmentIndexInfoKHR;
+
+        /**
+         * @brief Record <tt>vkCmdSetRenderingAttachmentLocationsKHR</tt> and
+         * <tt>vkCmdSetRenderingInputAttachmentIndicesKHR</tt> into \p commandBuffer.
+         * @param device Vulkan-Hpp RAII device whose dispatcher is used for recording the commands.
+         * @param commandBuffer Command buffer that is recording a dynamic rendering scope.
+         */
+        void record(
+            const VULKAN_HPP_NAMESPACE::VULKAN_HPP_RAII_NAMESPACE::Device &device,
+            VULKAN_HPP_NAMESPACE::CommandBuffer commandBuffer
+        ) const;
+
+    private:
+        details::StaticVector<std::uint32_t, AttachmentGroupBase::maxColorAttachmentCount> colorAttachmentLocations;
+        details::StaticVector<std::uint32_t, AttachmentGroupBase::maxColorAttachmentCount> colorAttachmentInputIndices;
+        std::optional<std::uint32_t> depthInputAttachmentIndex;
+        std::optional<std::uint32_t> stencilInputAttachmentIndex;
+    };
+
+    /**
+     * @brief Record a by-region memory barrier that makes the color and depth-stencil attachment writes visible to the
+     * input attachment reads of the following draws, inside the same dynamic rendering scope.
+     *
+     * The attachments must be in <tt>vk::ImageLayout::eRenderingLocalReadKHR</tt> (or <tt>eGeneral</tt>).
+     * @param commandBuffer Command buffer that is recording a dynamic rendering scope.
+     */
+    export void recordLocalReadBarrier(VULKAN_HPP_NAMESPACE::CommandBuffer commandBuffer);
+}
+
+// --------------------
+// Implementations.
+// --------------------
+
+vku::RenderingLocalReadInfo::RenderingLocalReadInfo(
+    std::span<const std::uint32_t> colorAttachmentLocations,
+    std::span<const std::uint32_t> colorAttachmentInputIndices,
+    std::optional<std::uint32_t> depthInputAttachmentIndex,
+    std::optional<std::uint32_t> stencilInputAttachmentIndex
+) : depthInputAttachmentIndex { depthInputAttachmentIndex },
+    stencilInputAttachmentIndex { stencilInputAttachmentIndex } {
+    assert(colorAttachmentLocations.size() == colorAttachmentInputIndices.size() && "Color attachment count mismatch");
+    if (colorAttachmentLocations.size() > AttachmentGroupBase::maxColorAttachmentCount) {
+        throw std::runtime_error { "Color attachment count exceeds maximum" };
+    }
+
+    for (std::uint32_t location : colorAttachmentLocations) {
+        this->colorAttachmentLocations.push_back(location);
+    }
+    for (std::uint32_t inputIndex : colorAttachmentInputIndices) {
+        this->colorAttachmentInputIndices.push_back(inputIndex);
+    }
+}
+
+auto vku::RenderingLocalReadInfo::getLocationInfo() const noexcept -> VULKAN_HPP_NAMESPACE::RenderingAttachmentLocationInfoKHR {
+    return {
+        static_cast<std::uint32_t>(colorAttachmentLocations.size()),
+        colorAttachmentLocations.data(),
+    };
+}
+
+auto vku::RenderingLocalReadInfo::getInputAttachmentIndexInfo() const noexcept -> VULKAN_HPP_NAMESPACE::RenderingInputAttachmentIndexInfoKHR {
+    return {
+        static_cast<std::uint32_t>(colorAttachmentInputIndices.size()),
+        colorAttachmentInputIndices.data(),
+        depthInputAttachmentIndex ? &*depthInputAttachmentIndex : nullptr,
+        stencilInputAttachmentIndex ? &*stencilInputAttachmentIndex : nullptr,
+    };
+}
+
+void vku::RenderingLocalReadInfo::record(
+    const VULKAN_HPP_NAMESPACE::VULKAN_HPP_RAII_NAMESPACE::Device &device,
+    VULKAN_HPP_NAMESPACE::CommandBuffer commandBuffer
+) const {
+    commandBuffer.setRenderingAttachmentLocationsKHR(getLocationInfo(), *device.getDispatcher());
+    commandBuffer.setRenderingInputAttachmentIndicesKHR(getInputAttachmentIndexInfo(), *device.getDispatcher());
+}
+
+void vku::recordLocalReadBarrier(
+    VULKAN_HPP_NAMESPACE::CommandBuffer commandBuffer
+) {
+    // Within a dynamic rendering scope, only by-region memory barriers between framebuffer-space stages are allowed.
+    const VULKAN_HPP_NAMESPACE::MemoryBarrier2 barrier {
+        VULKAN_HPP_NAMESPACE::PipelineStageFlagBits2::eColorAttachmentOutput | VULKAN_HPP_NAMESPACE::PipelineStageFlagBits2::eEarlyFragmentTests | VULKAN_HPP_NAMESPACE::PipelineStageFlagBits2::eLateFragmentTests,
+        VULKAN_HPP_NAMESPACE::AccessFlagBits2::eColorAttachmentWrite | VULKAN_HPP_NAMESPACE::AccessFlagBits2::eDepthStencilAttachmentWrite,
+        VULKAN_HPP_NAMESPACE::PipelineStageFlagBits2::eFragmentShader,
+        VULKAN_HPP_NAMESPACE::AccessFlagBits2::eInputAttachmentRead,
+    };
+    commandBuffer.pipelineBarrier2({ VULKAN_HPP_NAMESPACE::DependencyFlagBits::eByRegion, barrier });
+}
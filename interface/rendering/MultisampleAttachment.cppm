@@ -8,19 +8,20 @@ module;
 export module vku:rendering.MultisampleAttachment;
 
 import std;
+export import :caches.ImageViewCache;
 export import :images.Image;
 
 namespace vku {
     export struct MultisampleAttachment {
         Image multisampleImage;
-        VULKAN_HPP_NAMESPACE::VULKAN_HPP_RAII_NAMESPACE::ImageView multisampleView;
+        SharedImageView multisampleView;
         Image image;
-        VULKAN_HPP_NAMESPACE::VULKAN_HPP_RAII_NAMESPACE::ImageView view;
+        SharedImageView view;
     };
 
     export struct SwapchainMultisampleAttachment {
         Image multisampleImage;
-        VULKAN_HPP_NAMESPACE::VULKAN_HPP_RAII_NAMESPACE::ImageView multisampleView;
-        std::vector<VULKAN_HPP_NAMESPACE::VULKAN_HPP_RAII_NAMESPACE::ImageView> views;
+        SharedImageView multisampleView;
+        std::vector<SharedImageView> views;
     };
 }
\ No newline at end of file
@@ -28,12 +28,23 @@ namespace vku {
             VULKAN_HPP_NAMESPACE::AttachmentStoreOp storeOp;
             VULKAN_HPP_NAMESPACE::ClearColorValue clearValue;
             VULKAN_HPP_NAMESPACE::ResolveModeFlagBits resolveMode = VULKAN_HPP_NAMESPACE::ResolveModeFlagBits::eAverage;
+
+            /**
+             * @brief Layout of the attachment during rendering. Use <tt>vk::ImageLayout::eRenderingLocalReadKHR</tt> to
+             * read the attachment as an input attachment in the same rendering scope (<tt>VK_KHR_dynamic_rendering_local_read</tt>).
+             */
+            VULKAN_HPP_NAMESPACE::ImageLayout layout = VULKAN_HPP_NAMESPACE::ImageLayout::eColorAttachmentOptimal;
         };
 
         struct DepthStencilAttachmentInfo {
             VULKAN_HPP_NAMESPACE::AttachmentLoadOp loadOp;
             VULKAN_HPP_NAMESPACE::AttachmentStoreOp storeOp;
             VULKAN_HPP_NAMESPACE::ClearDepthStencilValue clearValue;
+
+            /**
+             * @brief Layout of the attachment during rendering. See <tt>ColorAttachmentInfo::layout</tt>.
+             */
+            VULKAN_HPP_NAMESPACE::ImageLayout layout = VULKAN_HPP_NAMESPACE::ImageLayout::eDepthStencilAttachmentOptimal;
         };
 
         VULKAN_HPP_NAMESPACE::SampleCountFlagBits sampleCount;
@@ -44,7 +55,7 @@ namespace vku {
         MultisampleAttachmentGroup(const MultisampleAttachmentGroup&) = delete;
         MultisampleAttachmentGroup(MultisampleAttachmentGroup&&) noexcept = default;
         auto operator=(const MultisampleAttachmentGroup&) -> MultisampleAttachmentGroup& = delete;
-        auto operator=(MultisampleAttachmentGroup&&) noexcept -> MultisampleAttachmentGroup& = default;
+        auto operator=(MultisampleAttachmentGroup &&src) noexcept -> MultisampleAttachmentGroup&;
         ~MultisampleAttachmentGroup() override = default;
 
         auto addColorAttachment(
@@ -132,23 +143,49 @@ namespace vku {
 
         [[nodiscard]] auto getRenderingInfo(
             VULKAN_HPP_NAMESPACE::ArrayProxy<const ColorAttachmentInfo> colorAttachmentInfos
-        ) const -> RefHolder<VULKAN_HPP_NAMESPACE::RenderingInfo, std::vector<VULKAN_HPP_NAMESPACE::RenderingAttachmentInfo>>;
+        ) const -> RefHolder<VULKAN_HPP_NAMESPACE::RenderingInfo, RenderingAttachmentInfos>;
 
         [[nodiscard]] auto getRenderingInfo(
             VULKAN_HPP_NAMESPACE::ArrayProxy<const ColorAttachmentInfo> colorAttachmentInfos,
             std::uint32_t swapchainImageIndex
-        ) const -> RefHolder<VULKAN_HPP_NAMESPACE::RenderingInfo, std::vector<VULKAN_HPP_NAMESPACE::RenderingAttachmentInfo>>;
+        ) const -> RefHolder<VULKAN_HPP_NAMESPACE::RenderingInfo, RenderingAttachmentInfos>;
 
         [[nodiscard]] auto getRenderingInfo(
             VULKAN_HPP_NAMESPACE::ArrayProxy<const ColorAttachmentInfo> colorAttachmentInfos,
             const DepthStencilAttachmentInfo &depthStencilAttachmentInfo
-        ) const -> RefHolder<VULKAN_HPP_NAMESPACE::RenderingInfo, std::vector<VULKAN_HPP_NAMESPACE::RenderingAttachmentInfo>>;
+        ) const -> RefHolder<VULKAN_HPP_NAMESPACE::RenderingInfo, RenderingAttachmentInfos>;
 
         [[nodiscard]] auto getRenderingInfo(
             VULKAN_HPP_NAMESPACE::ArrayProxy<const ColorAttachmentInfo> colorAttachmentInfos,
             const DepthStencilAttachmentInfo &depthStencilAttachmentInfo,
             std::uint32_t swapchainImageIndex
-        ) const -> RefHolder<VULKAN_HPP_NAMESPACE::RenderingInfo, std::vector<VULKAN_HPP_NAMESPACE::RenderingAttachmentInfo>>;
+        ) const -> RefHolder<VULKAN_HPP_NAMESPACE::RenderingInfo, RenderingAttachmentInfos>;
+
+        /**
+         * @brief Precompute the rendering infos for every swapchain image (or a single one if there is no swapchain
+         * attachment), which can be retrieved by <tt>getCachedRenderingInfo(swapchainImageIndex)</tt> without building
+         * them in every frame.
+         * @param colorAttachmentInfos Color attachment infos, same as <tt>getRenderingInfo</tt>.
+         * @note The cache must be updated after the attachments are changed.
+         */
+        void updateRenderingInfoCache(
+            VULKAN_HPP_NAMESPACE::ArrayProxy<const ColorAttachmentInfo> colorAttachmentInfos
+        );
+
+        /**
+         * @copydoc updateRenderingInfoCache(VULKAN_HPP_NAMESPACE::ArrayProxy<const ColorAttachmentInfo>)
+         * @param depthStencilAttachmentInfo Depth-stencil attachment info, same as <tt>getRenderingInfo</tt>.
+         */
+        void updateRenderingInfoCache(
+            VULKAN_HPP_NAMESPACE::ArrayProxy<const ColorAttachmentInfo> colorAttachmentInfos,
+            const DepthStencilAttachmentInfo &depthStencilAttachmentInfo
+        );
+
+    private:
+        /**
+         * @brief Number of swapchain images of the swapchain attachment, or <tt>0</tt> if there is no swapchain attachment.
+         */
+        [[nodiscard]] auto getSwapchainImageCount() const noexcept -> std::uint32_t;
     };
 }
 
@@ -162,6 +199,22 @@ vku::MultisampleAttachmentGroup::MultisampleAttachmentGroup(
 ) : AttachmentGroupBase { extent },
     sampleCount { sampleCount } { }
 
+auto vku::MultisampleAttachmentGroup::operator=(
+    MultisampleAttachmentGroup &&src
+) noexcept -> MultisampleAttachmentGroup& {
+    if (this != &src) {
+        // Views must be destroyed before the base class destroys the stored images.
+        colorAttachments.clear();
+        depthStencilAttachment.reset();
+
+        AttachmentGroupBase::operator=(std::move(src));
+    sampleCount = src.sampleCount;
+        colorAttachments = std::move(src.colorAttachments);
+        depthStencilAttachment = std::move(src.depthStencilAttachment);
+    }
+    return *this;
+}
+
 auto vku::MultisampleAttachmentGroup::addColorAttachment(
     const VULKAN_HPP_NAMESPACE::VULKAN_HPP_RAII_NAMESPACE::Device &device,
     const Image &multisampleImage,
@@ -197,12 +250,16 @@ auto vku::MultisampleAttachmentGroup::addColorAttachment(
     const VULKAN_HPP_NAMESPACE::ImageViewCreateInfo &multisampleViewCreateInfo,
     const VULKAN_HPP_NAMESPACE::ImageViewCreateInfo &viewCreateInfo
 ) -> const MultisampleAttachment & {
+    if (colorAttachments.size() == maxColorAttachmentCount) {
+        throw std::runtime_error { "Color attachment count exceeds maximum" };
+    }
+
     return *get_if<MultisampleAttachment>(&colorAttachments.emplace_back(
         std::in_place_type<MultisampleAttachment>,
         multisampleImage,
-        VULKAN_HPP_NAMESPACE::VULKAN_HPP_RAII_NAMESPACE::ImageView { device, multisampleViewCreateInfo },
+        createImageView(device, multisampleViewCreateInfo),
         image,
-        VULKAN_HPP_NAMESPACE::VULKAN_HPP_RAII_NAMESPACE::ImageView { device, viewCreateInfo }));
+        createImageView(device, viewCreateInfo)));
 }
 
 auto vku::MultisampleAttachmentGroup::addSwapchainAttachment(
@@ -231,23 +288,27 @@ auto vku::MultisampleAttachmentGroup::addSwapchainAttachment(
     std::span<const VULKAN_HPP_NAMESPACE::Image> swapchainImages,
     const VULKAN_HPP_NAMESPACE::ImageViewCreateInfo &multisampleViewCreateInfo
 ) -> const SwapchainMultisampleAttachment& {
-    std::vector<VULKAN_HPP_NAMESPACE::VULKAN_HPP_RAII_NAMESPACE::ImageView> resolveViews;
+    if (colorAttachments.size() == maxColorAttachmentCount) {
+        throw std::runtime_error { "Color attachment count exceeds maximum" };
+    }
+
+    std::vector<SharedImageView> resolveViews;
     resolveViews.reserve(swapchainImages.size());
     for (VULKAN_HPP_NAMESPACE::Image swapchainImage : swapchainImages) {
-        resolveViews.emplace_back(device, VULKAN_HPP_NAMESPACE::ImageViewCreateInfo {
+        resolveViews.push_back(createImageView(device, VULKAN_HPP_NAMESPACE::ImageViewCreateInfo {
             {},
             swapchainImage,
             VULKAN_HPP_NAMESPACE::ImageViewType::e2D,
             multisampleViewCreateInfo.format,
             {},
             { VULKAN_HPP_NAMESPACE::ImageAspectFlagBits::eColor, 0, 1, 0, 1 },
-        });
+        }));
     }
 
     return *get_if<SwapchainMultisampleAttachment>(&colorAttachments.emplace_back(
         std::in_place_type<SwapchainMultisampleAttachment>,
         multisampleImage,
-        VULKAN_HPP_NAMESPACE::VULKAN_HPP_RAII_NAMESPACE::ImageView { device, multisampleViewCreateInfo },
+        createImageView(device, multisampleViewCreateInfo),
         std::move(resolveViews)));
 }
 
@@ -274,7 +335,7 @@ auto vku::MultisampleAttachmentGroup::setDepthStencilAttachment(
     const Image &multisampleImage,
     const VULKAN_HPP_NAMESPACE::ImageViewCreateInfo &multisampleViewCreateInfo
 ) -> const Attachment & {
-    return depthStencilAttachment.emplace(multisampleImage, VULKAN_HPP_NAMESPACE::VULKAN_HPP_RAII_NAMESPACE::ImageView { device, multisampleViewCreateInfo });
+    return depthStencilAttachment.emplace(multisampleImage, createImageView(device, multisampleViewCreateInfo));
 }
 
 auto vku::MultisampleAttachmentGroup::createColorImage(
@@ -311,17 +372,16 @@ auto vku::MultisampleAttachmentGroup::createDepthStencilImage(
 
 auto vku::MultisampleAttachmentGroup::getRenderingInfo(
     VULKAN_HPP_NAMESPACE::ArrayProxy<const ColorAttachmentInfo> colorAttachmentInfos
-) const -> RefHolder<VULKAN_HPP_NAMESPACE::RenderingInfo, std::vector<VULKAN_HPP_NAMESPACE::RenderingAttachmentInfo>> {
+) const -> RefHolder<VULKAN_HPP_NAMESPACE::RenderingInfo, RenderingAttachmentInfos> {
     assert(colorAttachments.size() == colorAttachmentInfos.size() && "Color attachment info count mismatch");
     assert(!depthStencilAttachment.has_value() && "Depth-stencil attachment info mismatch");
 
-    std::vector<VULKAN_HPP_NAMESPACE::RenderingAttachmentInfo> renderingAttachmentInfos;
-    renderingAttachmentInfos.reserve(colorAttachmentInfos.size());
+    RenderingAttachmentInfos renderingAttachmentInfos;
     for (const auto &[attachment, info] : std::views::zip(colorAttachments, colorAttachmentInfos)) {
         auto *const pMultisampleAttachment = get_if<MultisampleAttachment>(&attachment);
         assert(pMultisampleAttachment && "More than one SwapchainMultisampleAttachment in the attachment group.");
         renderingAttachmentInfos.push_back({
-            *pMultisampleAttachment->multisampleView, VULKAN_HPP_NAMESPACE::ImageLayout::eColorAttachmentOptimal,
+            *pMultisampleAttachment->multisampleView, info.layout,
             info.resolveMode, *pMultisampleAttachment->view, VULKAN_HPP_NAMESPACE::ImageLayout::eColorAttachmentOptimal,
             info.loadOp, info.storeOp, info.clearValue,
         });
@@ -344,12 +404,11 @@ auto vku::MultisampleAttachmentGroup::getRenderingInfo(
 auto vku::MultisampleAttachmentGroup::getRenderingInfo(
     VULKAN_HPP_NAMESPACE::ArrayProxy<const ColorAttachmentInfo> colorAttachmentInfos,
     std::uint32_t swapchainImageIndex
-) const -> RefHolder<VULKAN_HPP_NAMESPACE::RenderingInfo, std::vector<VULKAN_HPP_NAMESPACE::RenderingAttachmentInfo>> {
+) const -> RefHolder<VULKAN_HPP_NAMESPACE::RenderingInfo, RenderingAttachmentInfos> {
     assert(colorAttachments.size() == colorAttachmentInfos.size() && "Color attachment info count mismatch");
     assert(!depthStencilAttachment.has_value() && "Depth-stencil attachment info mismatch");
 
-    std::vector<VULKAN_HPP_NAMESPACE::RenderingAttachmentInfo> renderingAttachmentInfos;
-    renderingAttachmentInfos.reserve(colorAttachmentInfos.size());
+    RenderingAttachmentInfos renderingAttachmentInfos;
 
     // SwapchainMultisampleAttachment can only appear once in the attachment group. Therefore, if a SwapchainMultisampleAttachment
     // already push_backed into renderingAttachmentInfos, explicit std::visit call for the rest variants is not necessary.
@@ -373,7 +432,7 @@ auto vku::MultisampleAttachmentGroup::getRenderingInfo(
             }, attachment);
         }();
         renderingAttachmentInfos.push_back({
-            view, VULKAN_HPP_NAMESPACE::ImageLayout::eColorAttachmentOptimal,
+            view, info.layout,
             info.resolveMode, resolveView, VULKAN_HPP_NAMESPACE::ImageLayout::eColorAttachmentOptimal,
             info.loadOp, info.storeOp, info.clearValue,
         });
@@ -397,23 +456,22 @@ auto vku::MultisampleAttachmentGroup::getRenderingInfo(
 auto vku::MultisampleAttachmentGroup::getRenderingInfo(
     VULKAN_HPP_NAMESPACE::ArrayProxy<const ColorAttachmentInfo> colorAttachmentInfos,
     const DepthStencilAttachmentInfo &depthStencilAttachmentInfo
-) const -> RefHolder<VULKAN_HPP_NAMESPACE::RenderingInfo, std::vector<VULKAN_HPP_NAMESPACE::RenderingAttachmentInfo>> {
+) const -> RefHolder<VULKAN_HPP_NAMESPACE::RenderingInfo, RenderingAttachmentInfos> {
     assert(colorAttachments.size() == colorAttachmentInfos.size() && "Color attachment info count mismatch");
     assert(depthStencilAttachment.has_value() && "Depth-stencil attachment info mismatch");
 
-    std::vector<VULKAN_HPP_NAMESPACE::RenderingAttachmentInfo> renderingAttachmentInfos;
-    renderingAttachmentInfos.reserve(colorAttachmentInfos.size() + 1);
+    RenderingAttachmentInfos renderingAttachmentInfos;
     for (const auto &[attachment, info] : std::views::zip(colorAttachments, colorAttachmentInfos)) {
         auto *const pMultisampleAttachment = get_if<MultisampleAttachment>(&attachment);
         assert(pMultisampleAttachment && "More than one SwapchainMultisampleAttachment in the attachment group.");
         renderingAttachmentInfos.push_back({
-            *pMultisampleAttachment->multisampleView, VULKAN_HPP_NAMESPACE::ImageLayout::eColorAttachmentOptimal,
+            *pMultisampleAttachment->multisampleView, info.layout,
             info.resolveMode, *pMultisampleAttachment->view, VULKAN_HPP_NAMESPACE::ImageLayout::eColorAttachmentOptimal,
             info.loadOp, info.storeOp, info.clearValue,
         });
     }
     renderingAttachmentInfos.push_back({
-        *depthStencilAttachment->view, VULKAN_HPP_NAMESPACE::ImageLayout::eDepthStencilAttachmentOptimal,
+        *depthStencilAttachment->view, depthStencilAttachmentInfo.layout,
         {}, {}, {},
         depthStencilAttachmentInfo.loadOp, depthStencilAttachmentInfo.storeOp, depthStencilAttachmentInfo.clearValue,
     });
@@ -437,12 +495,11 @@ auto vku::MultisampleAttachmentGroup::getRenderingInfo(
     VULKAN_HPP_NAMESPACE::ArrayProxy<const ColorAttachmentInfo> colorAttachmentInfos,
     const DepthStencilAttachmentInfo &depthStencilAttachmentInfo,
     std::uint32_t swapchainImageIndex
-) const -> RefHolder<VULKAN_HPP_NAMESPACE::RenderingInfo, std::vector<VULKAN_HPP_NAMESPACE::RenderingAttachmentInfo>> {
+) const -> RefHolder<VULKAN_HPP_NAMESPACE::RenderingInfo, RenderingAttachmentInfos> {
     assert(colorAttachments.size() == colorAttachmentInfos.size() && "Color attachment info count mismatch");
     assert(depthStencilAttachment.has_value() && "Depth-stencil attachment info mismatch");
 
-    std::vector<VULKAN_HPP_NAMESPACE::RenderingAttachmentInfo> renderingAttachmentInfos;
-    renderingAttachmentInfos.reserve(colorAttachmentInfos.size() + 1);
+    RenderingAttachmentInfos renderingAttachmentInfos;
 
     // SwapchainMultisampleAttachment can only appear once in the attachment group. Therefore, if a SwapchainMultisampleAttachment
     // already push_backed into renderingAttachmentInfos, explicit std::visit call for the rest variants is not necessary.
@@ -466,13 +523,13 @@ auto vku::MultisampleAttachmentGroup::getRenderingInfo(
             }, attachment);
         }();
         renderingAttachmentInfos.push_back({
-            view, VULKAN_HPP_NAMESPACE::ImageLayout::eColorAttachmentOptimal,
+            view, info.layout,
             info.resolveMode, resolveView, VULKAN_HPP_NAMESPACE::ImageLayout::eColorAttachmentOptimal,
             info.loadOp, info.storeOp, info.clearValue,
         });
     }
     renderingAttachmentInfos.push_back({
-        *depthStencilAttachment->view, VULKAN_HPP_NAMESPACE::ImageLayout::eDepthStencilAttachmentOptimal,
+        *depthStencilAttachment->view, depthStencilAttachmentInfo.layout,
         {}, {}, {},
         depthStencilAttachmentInfo.loadOp, depthStencilAttachmentInfo.storeOp, depthStencilAttachmentInfo.clearValue,
     });
@@ -491,4 +548,44 @@ auto vku::MultisampleAttachmentGroup::getRenderingInfo(
         },
         std::move(renderingAttachmentInfos),
     };
+}
+
+auto vku::MultisampleAttachmentGroup::getSwapchainImageCount() const noexcept -> std::uint32_t {
+    for (const auto &attachment : colorAttachments) {
+        if (auto *const pSwapchainAttachment = get_if<SwapchainMultisampleAttachment>(&attachment)) {
+            return static_cast<std::uint32_t>(pSwapchainAttachment->views.size());
+        }
+    }
+    return 0;
+}
+
+void vku::MultisampleAttachmentGroup::updateRenderingInfoCache(
+    VULKAN_HPP_NAMESPACE::ArrayProxy<const ColorAttachmentInfo> colorAttachmentInfos
+) {
+    if (const std::uint32_t swapchainImageCount = getSwapchainImageCount(); swapchainImageCount != 0) {
+        setRenderingInfoCache(swapchainImageCount, [&](std::uint32_t swapchainImageIndex) {
+            return getRenderingInfo(colorAttachmentInfos, swapchainImageIndex);
+        });
+    }
+    else {
+        setRenderingInfoCache(1, [&](std::uint32_t) {
+            return getRenderingInfo(colorAttachmentInfos);
+        });
+    }
+}
+
+void vku::MultisampleAttachmentGroup::updateRenderingInfoCache(
+    VULKAN_HPP_NAMESPACE::ArrayProxy<const ColorAttachmentInfo> colorAttachmentInfos,
+    const DepthStencilAttachmentInfo &depthStencilAttachmentInfo
+) {
+    if (const std::uint32_t swapchainImageCount = getSwapchainImageCount(); swapchainImageCount != 0) {
+        setRenderingInfoCache(swapchainImageCount, [&](std::uint32_t swapchainImageIndex) {
+            return getRenderingInfo(colorAttachmentInfos, depthStencilAttachmentInfo, swapchainImageIndex);
+        });
+    }
+    else {
+        setRenderingInfoCache(1, [&](std::uint32_t) {
+            return getRenderingInfo(colorAttachmentInfos, depthStencilAttachmentInfo);
+        });
+    }
 }
\ No newline at end of file
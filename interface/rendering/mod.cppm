@@ -6,4 +6,5 @@ export module vku:rendering;
 export import :rendering.Attachment;
 export import :rendering.MultisampleAttachment;
 export import :rendering.AttachmentGroup;
-export import :rendering.MultisampleAttachmentGroup;
\ No newline at end of file
+export import :rendering.MultisampleAttachmentGroup;
+export import :rendering.LocalRead;
\ No newline at end of file
@@ -0,0 +1,331 @@
+/** @file submission.cppm
+ */
+
+module;
+
+#include <vulkan/vulkan_hpp_macros.hpp>
+
+export module vku:submission;
+
+import std;
+export import vulkan_hpp;
+import :utils;
+
+#define FWD(...) static_cast<decltype(__VA_ARGS__)&&>(__VA_ARGS__)
+
+namespace vku {
+    /**
+     * @brief Get the queue create infos that request every queue of each queue family in \p queueFamilyIndices.
+     *
+     * Use it in the <tt>Queues::getCreateInfos</tt> of <tt>vku::Gpu</tt> to make the multiple queues of a family be
+     * available for <tt>vku::SubmissionService</tt>.
+     *
+     * @param physicalDevice Physical device to query the queue family properties.
+     * @param queueFamilyIndices Queue family indices. Duplicated indices are allowed.
+     * @return RefHolder of queue create infos, one per unique queue family index, with queue count of
+     * <tt>vk::QueueFamilyProperties::queueCount</tt> and priority 1.0.
+     */
+    export
+    [[nodiscard]] auto getAllQueueCreateInfos(
+        VULKAN_HPP_NAMESPACE::PhysicalDevice physicalDevice,
+        std::span<const std::uint32_t> queueFamilyIndices
+    ) -> RefHolder<std::vector<VULKAN_HPP_NAMESPACE::DeviceQueueCreateInfo>, std::vector<float>>;
+
+    /**
+     * @brief Thread-safe queue submission over the multiple queues of a queue family.
+     *
+     * Submissions are distributed across the queues in round-robin manner, and each queue is guarded by its own mutex,
+     * therefore the threads that submit simultaneously are not serialized unless the queues are exhausted.
+     *
+     * Alternatively, <tt>enqueue</tt> pushes a submission to a lock-free multi-producer single-consumer queue, which
+     * is drained by a dedicated thread. It batches the pending submissions into a single <tt>vkQueueSubmit2</tt> call
+     * (split at the submission that has a fence), which reduces the driver overhead when many threads submit small
+     * amount of works. The submission thread always submits to the first queue, therefore the enqueued submissions
+     * keep their enqueued order in the queue submission order.
+     *
+     * @code{.cpp}
+     * vku::SubmissionService submissionService { *gpu.device, gpu.queueFamilies.compute, computeQueueCount };
+     *
+     * // Submit from any thread.
+     * submissionService.submit(vk::SubmitInfo2 { {}, {}, vku::unsafeProxy(vk::CommandBufferSubmitInfo { commandBuffer }) }, fence);
+     *
+     * // Or let the submission thread batch it.
+     * std::future submitted = submissionService.enqueue({ .commandBufferInfos = { vk::CommandBufferSubmitInfo { commandBuffer } } });
+     * @endcode
+     */
+    export class SubmissionService {
+    public:
+        /**
+         * @brief Submission that owns its semaphore and command buffer infos, used for the deferred submission.
+         */
+        struct Submission {
+            std::vector<VULKAN_HPP_NAMESPACE::SemaphoreSubmitInfo> waitSemaphoreInfos;
+            std::vector<VULKAN_HPP_NAMESPACE::CommandBufferSubmitInfo> commandBufferInfos;
+            std::vector<VULKAN_HPP_NAMESPACE::SemaphoreSubmitInfo> signalSemaphoreInfos;
+
+            /**
+             * @brief Fence to be signaled when this and all the previously enqueued submissions are completed, as they
+             * are submitted to the same queue.
+             */
+            VULKAN_HPP_NAMESPACE::Fence fence;
+        };
+
+        /**
+         * @brief Retrieve the queues and start the submission thread.
+         * @param device Vulkan device. The queues must be created with it (e.g. by <tt>getAllQueueCreateInfos</tt>).
+         * @param queueFamilyIndex Queue family index.
+         * @param queueCount Number of queues to be used, from index 0.
+         */
+        SubmissionService(
+            VULKAN_HPP_NAMESPACE::Device device,
+            std::uint32_t queueFamilyIndex,
+            std::uint32_t queueCount
+        );
+
+        SubmissionService(const SubmissionService&) = delete;
+        auto operator=(const SubmissionService&) -> SubmissionService& = delete;
+
+        /**
+         * @brief Submit the pending submissions and stop the submission thread.
+         */
+        ~SubmissionService();
+
+        /**
+         * @brief Queue family index of the queues.
+         */
+        [[nodiscard]] auto getQueueFamilyIndex() const noexcept -> std::uint32_t;
+
+        /**
+         * @brief Submit to one of the queues immediately. It is not ordered with the enqueued submissions.
+         * @param submitInfos Submit infos.
+         * @param fence Fence to be signaled when the submission is completed.
+         * @throw vk::SystemError If submission failed.
+         */
+        void submit(
+            VULKAN_HPP_NAMESPACE::ArrayProxy<const VULKAN_HPP_NAMESPACE::SubmitInfo2> submitInfos,
+            VULKAN_HPP_NAMESPACE::Fence fence = {}
+        );
+
+        /**
+         * @brief Invoke \p f with one of the queues while it is exclusively locked, e.g. for presentation or sparse
+         * binding.
+         * @param f Function that accepts <tt>vk::Queue</tt>.
+         * @return The result of \p f.
+         */
+        template <std::invocable<VULKAN_HPP_NAMESPACE::Queue> F>
+        auto withQueue(F &&f) -> std::invoke_result_t<F, VULKAN_HPP_NAMESPACE::Queue> {
+            auto [queue, lock] = acquireQueue();
+            return std::invoke(FWD(f), queue);
+        }
+
+        /**
+         * @brief Push the submission to be submitted by the submission thread.
+         * @param submission Submission.
+         * @return Future that is ready when the submission is passed to the queue. Submission error is stored in it.
+         */
+        [[nodiscard]] auto enqueue(Submission submission) -> std::future<void>;
+
+    private:
+        struct Node {
+            Submission submission;
+            std::promise<void> promise;
+            Node *next = nullptr;
+
+            /**
+             * @brief Sentinel that makes the submission thread exit.
+             */
+            bool stop = false;
+        };
+
+        std::uint32_t queueFamilyIndex;
+        std::vector<VULKAN_HPP_NAMESPACE::Queue> queues;
+        std::vector<std::mutex> queueMutexes;
+        std::atomic<std::size_t> nextQueueIndex = 0;
+
+        /**
+         * @brief Top of the intrusive Treiber stack. The submission thread takes the whole stack at once and reverses
+         * it to restore the submission order.
+         */
+        std::atomic<Node*> head = nullptr;
+
+        // Must be declared at last, to make the thread joined before destroying the above members.
+        std::jthread submissionThread;
+
+        [[nodiscard]] auto acquireQueue() -> std::pair<VULKAN_HPP_NAMESPACE::Queue, std::unique_lock<std::mutex>>;
+        void push(Node *node) noexcept;
+        void submitBatch(std::span<const std::unique_ptr<Node>> nodes, VULKAN_HPP_NAMESPACE::Fence fence);
+        void work();
+    };
+}
+
+// --------------------
+// Implementations.
+// --------------------
+
+auto vku::getAllQueueCreateInfos(
+    VULKAN_HPP_NAMESPACE::PhysicalDevice physicalDevice,
+    std::span<const std::uint32_t> queueFamilyIndices
+) -> RefHolder<std::vector<VULKAN_HPP_NAMESPACE::DeviceQueueCreateInfo>, std::vector<float>> {
+    const std::vector queueFamilyProperties = physicalDevice.getQueueFamilyProperties();
+
+    std::vector uniqueQueueFamilyIndices = queueFamilyIndices | std::ranges::to<std::vector>();
+    std::ranges::sort(uniqueQueueFamilyIndices);
+    const auto [first, last] = std::ranges::unique(uniqueQueueFamilyIndices);
+    uniqueQueueFamilyIndices.erase(first, last);
+
+    std::uint32_t maxQueueCount = 0;
+    for (std::uint32_t queueFamilyIndex : uniqueQueueFamilyIndices) {
+        maxQueueCount = std::max(maxQueueCount, queueFamilyProperties[queueFamilyIndex].queueCount);
+    }
+
+    return RefHolder {
+        [&](const std::vector<float> &queuePriorities) {
+            return uniqueQueueFamilyIndices
+                | std::views::transform([&](std::uint32_t queueFamilyIndex) {
+                    return VULKAN_HPP_NAMESPACE::DeviceQueueCreateInfo {
+                        {},
+                        queueFamilyIndex,
+                        queueFamilyProperties[queueFamilyIndex].queueCount,
+                        queuePriorities.data(),
+                    };
+                })
+                | std::ranges::to<std::vector>();
+        },
+        std::vector<float>(maxQueueCount, 1.f),
+    };
+}
+
+vku::SubmissionService::SubmissionService(
+    VULKAN_HPP_NAMESPACE::Device device,
+    std::uint32_t queueFamilyIndex,
+    std::uint32_t queueCount
+) : queueFamilyIndex { queueFamilyIndex },
+    queues { [&] {
+        // Checked before starting the submission thread, which will not exit without the stop sentinel.
+        if (queueCount == 0) {
+            throw std::invalid_argument { "Queue count must be positive." };
+        }
+
+        return std::views::iota(0U, queueCount)
+            | std::views::transform([&](std::uint32_t queueIndex) { return device.getQueue(queueFamilyIndex, queueIndex); })
+            | std::ranges::to<std::vector>();
+    }() },
+    queueMutexes(queueCount),
+    submissionThread { [this] { work(); } } { }
+
+vku::SubmissionService::~SubmissionService() {
+    push(new Node { .stop = true });
+    submissionThread.join();
+}
+
+auto vku::SubmissionService::getQueueFamilyIndex() const noexcept -> std::uint32_t {
+    return queueFamilyIndex;
+}
+
+void vku::SubmissionService::submit(
+    VULKAN_HPP_NAMESPACE::ArrayProxy<const VULKAN_HPP_NAMESPACE::SubmitInfo2> submitInfos,
+    VULKAN_HPP_NAMESPACE::Fence fence
+) {
+    auto [queue, lock] = acquireQueue();
+    queue.submit2(submitInfos, fence);
+}
+
+auto vku::SubmissionService::enqueue(
+    Submission submission
+) -> std::future<void> {
+    auto node = std::make_unique<Node>(std::move(submission));
+    std::future result = node->promise.get_future();
+    push(node.release());
+    return result;
+}
+
+auto vku::SubmissionService::acquireQueue() -> std::pair<VULKAN_HPP_NAMESPACE::Queue, std::unique_lock<std::mutex>> {
+    // Prefer the queue that is not being used by the other threads, starting from the round-robin index.
+    const std::size_t startIndex = nextQueueIndex.fetch_add(1, std::memory_order_relaxed) % queues.size();
+    for (std::size_t i = 0; i < queues.size(); ++i) {
+        const std::size_t queueIndex = (startIndex + i) % queues.size();
+        if (std::unique_lock lock { queueMutexes[queueIndex], std::try_to_lock }) {
+            return { queues[queueIndex], std::move(lock) };
+        }
+    }
+
+    // Every queue is busy.
+    return { queues[startIndex], std::unique_lock { queueMutexes[startIndex] } };
+}
+
+void vku::SubmissionService::push(
+    Node *node
+) noexcept {
+    node->next = head.load(std::memory_order_relaxed);
+    while (!head.compare_exchange_weak(node->next, node, std::memory_order_release, std::memory_order_relaxed));
+    head.notify_one();
+}
+
+void vku::SubmissionService::submitBatch(
+    std::span<const std::unique_ptr<Node>> nodes,
+    VULKAN_HPP_NAMESPACE::Fence fence
+) {
+    if (nodes.empty()) {
+        return;
+    }
+
+    const std::vector submitInfos
+        = nodes
+        | std::views::transform([](const std::unique_ptr<Node> &node) {
+            return VULKAN_HPP_NAMESPACE::SubmitInfo2 {
+                {},
+                node->submission.waitSemaphoreInfos,
+                node->submission.commandBufferInfos,
+                node->submission.signalSemaphoreInfos,
+            };
+        })
+        | std::ranges::to<std::vector>();
+
+    try {
+        // Enqueued submissions are always submitted to the first queue, to keep their order.
+        std::scoped_lock lock { queueMutexes[0] };
+        queues[0].submit2(submitInfos, fence);
+        for (const std::unique_ptr<Node> &node : nodes) {
+            node->promise.set_value();
+        }
+    }
+    catch (...) {
+        for (const std::unique_ptr<Node> &node : nodes) {
+            node->promise.set_exception(std::current_exception());
+        }
+    }
+}
+
+void vku::SubmissionService::work() {
+    std::vector<std::unique_ptr<Node>> nodes;
+    while (true) {
+        head.wait(nullptr, std::memory_order_acquire);
+
+        // Take the whole stack, and restore the submission order.
+        for (Node *node = head.exchange(nullptr, std::memory_order_acquire); node; node = node->next) {
+            nodes.emplace_back(node);
+        }
+        std::ranges::reverse(nodes);
+
+        bool stop = false;
+        std::size_t batchBegin = 0;
+        for (std::size_t i = 0; i < nodes.size(); ++i) {
+            if (nodes[i]->stop) {
+                submitBatch(std::span { nodes }.subspan(batchBegin, i - batchBegin), {});
+                batchBegin = i + 1;
+                stop = true;
+            }
+            else if (VULKAN_HPP_NAMESPACE::Fence fence = nodes[i]->submission.fence) {
+                // A submission call can signal only a single fence, therefore the batch is split here.
+                submitBatch(std::span { nodes }.subspan(batchBegin, i + 1 - batchBegin), fence);
+                batchBegin = i + 1;
+            }
+        }
+        submitBatch(std::span { nodes }.subspan(batchBegin), {});
+        nodes.clear();
+
+        if (stop) {
+            return;
+        }
+    }
+}
@@ -0,0 +1,268 @@
+/** @file sync/BarrierBatch.cppm
+ */
+
+module;
+
+#include <vulkan/vulkan_hpp_macros.hpp>
+
+export module vku:sync.BarrierBatch;
+
+import std;
+export import vulkan_hpp;
+export import :sync.ResourceState;
+
+namespace vku {
+    /**
+     * @brief Accumulates the minimal set of pipeline barriers for the tracked resources, and records them at once.
+     *
+     * Each <tt>transition</tt> call compares the requested state with the tracked state, and
+     * - skips the subresources that don't need any synchronization (same layout and either not accessed yet, or the
+     *   last write is already visible to the requested read),
+     * - merges adjacent subresources that share the same previous state into a single barrier (first along the array
+     *   layers, then along the mip levels).
+     *
+     * All accumulated barriers are emitted by a single <tt>vkCmdPipelineBarrier2</tt> call in <tt>record</tt>.
+     *
+     * @code{.cpp}
+     * vku::ImageState imageState { image };
+     * vku::BufferState bufferState { buffer };
+     *
+     * vku::BarrierBatch barriers;
+     * barriers.transition(imageState, vk::ImageLayout::eTransferDstOptimal, vk::PipelineStageFlagBits2::eCopy, vk::AccessFlagBits2::eTransferWrite);
+     * barriers.transition(bufferState, vk::PipelineStageFlagBits2::eCopy, vk::AccessFlagBits2::eTransferRead);
+     * barriers.record(cb); // Single vkCmdPipelineBarrier2 call.
+     * cb.copyBufferToImage(...);
+     * @endcode
+     *
+     * @note Requires <tt>synchronization2</tt> feature (or Vulkan 1.3).
+     * @warning A batch must not contain the dependent transitions of the same subresource (e.g. transitioning an image
+     * to A and then to B), since barriers in a single command are not ordered. Call <tt>record</tt> between them.
+     */
+    export class BarrierBatch {
+    public:
+        /**
+         * @brief Transition \p subresourceRange of the tracked image into \p newLayout, which will be accessed by \p dstStageMask and \p dstAccessMask.
+         * @param imageState Tracked image state. Its state is updated to the requested one.
+         * @param subresourceRange Subresource range to transition. <tt>vk::RemainingMipLevels</tt> and <tt>vk::RemainingArrayLayers</tt> are allowed.
+         * @param newLayout New image layout.
+         * @param dstStageMask Pipeline stages that will access the subresources.
+         * @param dstAccessMask Access types that will be performed to the subresources.
+         */
+        void transition(
+            ImageState &imageState,
+            const VULKAN_HPP_NAMESPACE::ImageSubresourceRange &subresourceRange,
+            VULKAN_HPP_NAMESPACE::ImageLayout newLayout,
+            VULKAN_HPP_NAMESPACE::PipelineStageFlags2 dstStageMask,
+            VULKAN_HPP_NAMESPACE::AccessFlags2 dstAccessMask
+        );
+
+        /**
+         * @brief Transition the whole subresources of the tracked image, whose aspect flags are inferred from the image format.
+         * @copydetails transition(ImageState&, const vk::ImageSubresourceRange&, vk::ImageLayout, vk::PipelineStageFlags2, vk::AccessFlags2)
+         */
+        void transition(
+            ImageState &imageState,
+            VULKAN_HPP_NAMESPACE::ImageLayout newLayout,
+            VULKAN_HPP_NAMESPACE::PipelineStageFlags2 dstStageMask,
+            VULKAN_HPP_NAMESPACE::AccessFlags2 dstAccessMask
+        );
+
+        /**
+         * @brief Make the tracked buffer to be accessed by \p dstStageMask and \p dstAccessMask.
+         * @param bufferState Tracked buffer state. Its state is updated to the requested one.
+         * @param dstStageMask Pipeline stages that will access the buffer.
+         * @param dstAccessMask Access types that will be performed to the buffer.
+         */
+        void transition(
+            BufferState &bufferState,
+            VULKAN_HPP_NAMESPACE::PipelineStageFlags2 dstStageMask,
+            VULKAN_HPP_NAMESPACE::AccessFlags2 dstAccessMask
+        );
+
+        /**
+         * @brief Record all accumulated barriers into \p commandBuffer by a single <tt>vkCmdPipelineBarrier2</tt> call, and clear the batch.
+         *
+         * Nothing is recorded if the batch is empty.
+         *
+         * @param commandBuffer Command buffer to record the barriers.
+         * @param dependencyFlags Dependency flags (default=none).
+         */
+        void record(VULKAN_HPP_NAMESPACE::CommandBuffer commandBuffer, VULKAN_HPP_NAMESPACE::DependencyFlags dependencyFlags = {});
+
+        /**
+         * @brief Check whether there is no accumulated barrier.
+         */
+        [[nodiscard]] bool empty() const noexcept {
+            return imageMemoryBarriers.empty() && bufferMemoryBarriers.empty();
+        }
+
+        [[nodiscard]] std::span<const VULKAN_HPP_NAMESPACE::ImageMemoryBarrier2> getImageMemoryBarriers() const noexcept {
+            return imageMemoryBarriers;
+        }
+
+        [[nodiscard]] std::span<const VULKAN_HPP_NAMESPACE::BufferMemoryBarrier2> getBufferMemoryBarriers() const noexcept {
+            return bufferMemoryBarriers;
+        }
+
+    private:
+        std::vector<VULKAN_HPP_NAMESPACE::ImageMemoryBarrier2> imageMemoryBarriers;
+        std::vector<VULKAN_HPP_NAMESPACE::BufferMemoryBarrier2> bufferMemoryBarriers;
+    };
+}
+
+// --------------------
+// Implementations.
+// --------------------
+
+namespace details {
+    /**
+     * @brief Update \p state for the access of \p dstStageMask and \p dstAccessMask, and get the source scope of the
+     * barrier that is required before the access.
+     *
+     * - A read only waits for the last write, and only if the write is not visible to the read yet.
+     * - A write (or layout transition) waits for the last write and all the reads since then.
+     * - Nothing is required if the resource was not accessed yet and its layout is not changed.
+     *
+     * @return Pair of source stage and access mask, or <tt>std::nullopt</tt> if no barrier is required.
+     */
+    [[nodiscard]] auto accessResource(
+        vku::AccessState &state,
+        VULKAN_HPP_NAMESPACE::PipelineStageFlags2 dstStageMask,
+        VULKAN_HPP_NAMESPACE::AccessFlags2 dstAccessMask,
+        bool layoutChanged
+    ) noexcept -> std::optional<std::pair<VULKAN_HPP_NAMESPACE::PipelineStageFlags2, VULKAN_HPP_NAMESPACE::AccessFlags2>> {
+        std::optional<std::pair<VULKAN_HPP_NAMESPACE::PipelineStageFlags2, VULKAN_HPP_NAMESPACE::AccessFlags2>> srcScope;
+        if (!layoutChanged && !vku::hasWriteAccess(dstAccessMask)) {
+            const bool visible = (dstStageMask & state.visibleStageMask) == dstStageMask
+                && (dstAccessMask & state.visibleAccessMask) == dstAccessMask;
+            if (state.writeStageMask && !visible) {
+                srcScope.emplace(state.writeStageMask, state.writeAccessMask);
+            }
+            state.visibleStageMask |= dstStageMask;
+            state.visibleAccessMask |= dstAccessMask;
+            return srcScope;
+        }
+
+        if (layoutChanged || state.writeStageMask || state.visibleStageMask) {
+            srcScope.emplace(state.writeStageMask | state.visibleStageMask, state.writeAccessMask);
+        }
+
+        if (vku::hasWriteAccess(dstAccessMask)) {
+            state = { dstStageMask, dstAccessMask };
+        }
+        else {
+            // Layout transition to a read-only access: the transition happens before dstStageMask, therefore the later
+            // accesses have to chain through it. The previous write remains to be made visible to them.
+            state = { state.writeStageMask | dstStageMask, state.writeAccessMask, dstStageMask, dstAccessMask };
+        }
+        return srcScope;
+    }
+}
+
+void vku::BarrierBatch::transition(
+    ImageState &imageState,
+    const VULKAN_HPP_NAMESPACE::ImageSubresourceRange &subresourceRange,
+    VULKAN_HPP_NAMESPACE::ImageLayout newLayout,
+    VULKAN_HPP_NAMESPACE::PipelineStageFlags2 dstStageMask,
+    VULKAN_HPP_NAMESPACE::AccessFlags2 dstAccessMask
+) {
+    const Image &image = imageState.image;
+    const std::uint32_t levelCount = subresourceRange.levelCount == VULKAN_HPP_NAMESPACE::RemainingMipLevels
+        ? image.mipLevels - subresourceRange.baseMipLevel : subresourceRange.levelCount;
+    const std::uint32_t layerCount = subresourceRange.layerCount == VULKAN_HPP_NAMESPACE::RemainingArrayLayers
+        ? image.arrayLayers - subresourceRange.baseArrayLayer : subresourceRange.layerCount;
+
+    // Consecutive array layers of a mip level that require the barrier with the same previous state.
+    struct LayerRun {
+        std::uint32_t baseArrayLayer;
+        std::uint32_t layerCount;
+        SubresourceState previousState;
+        VULKAN_HPP_NAMESPACE::PipelineStageFlags2 srcStageMask;
+        VULKAN_HPP_NAMESPACE::AccessFlags2 srcAccessMask;
+
+        [[nodiscard]] bool operator==(const LayerRun&) const noexcept = default;
+    };
+
+    std::vector<LayerRun> previousRuns, runs;
+    // Index of the first barrier in imageMemoryBarriers that is pushed for the previous mip level.
+    std::size_t previousRunsBarrierIndex = 0;
+    for (std::uint32_t level = subresourceRange.baseMipLevel; level < subresourceRange.baseMipLevel + levelCount; ++level) {
+        runs.clear();
+        for (std::uint32_t layer = subresourceRange.baseArrayLayer; layer < subresourceRange.baseArrayLayer + layerCount; ++layer) {
+            SubresourceState &state = imageState.getState(level, layer);
+            const SubresourceState previousState = state;
+            const auto srcScope = details::accessResource(state, dstStageMask, dstAccessMask, state.layout != newLayout);
+            state.layout = newLayout;
+            if (!srcScope) {
+                continue;
+            }
+
+            // Same previous state always results in the same source scope, therefore comparing it is enough.
+            if (!runs.empty() && runs.back().previousState == previousState
+                && runs.back().baseArrayLayer + runs.back().layerCount == layer) {
+                ++runs.back().layerCount;
+            }
+            else {
+                runs.emplace_back(layer, 1U, previousState, srcScope->first, srcScope->second);
+            }
+        }
+
+        if (!runs.empty() && runs == previousRuns) {
+            // Same layer runs as the previous mip level: extend the previous mip level's barriers.
+            for (std::size_t i = previousRunsBarrierIndex; i < imageMemoryBarriers.size(); ++i) {
+                ++imageMemoryBarriers[i].subresourceRange.levelCount;
+            }
+        }
+        else {
+            previousRunsBarrierIndex = imageMemoryBarriers.size();
+            for (const LayerRun &run : runs) {
+                imageMemoryBarriers.push_back({
+                    run.srcStageMask, run.srcAccessMask,
+                    dstStageMask, dstAccessMask,
+                    run.previousState.layout, newLayout,
+                    VULKAN_HPP_NAMESPACE::QueueFamilyIgnored, VULKAN_HPP_NAMESPACE::QueueFamilyIgnored,
+                    image,
+                    { subresourceRange.aspectMask, level, 1, run.baseArrayLayer, run.layerCount },
+                });
+            }
+        }
+        std::swap(previousRuns, runs);
+    }
+}
+
+void vku::BarrierBatch::transition(
+    ImageState &imageState,
+    VULKAN_HPP_NAMESPACE::ImageLayout newLayout,
+    VULKAN_HPP_NAMESPACE::PipelineStageFlags2 dstStageMask,
+    VULKAN_HPP_NAMESPACE::AccessFlags2 dstAccessMask
+) {
+    transition(imageState, fullSubresourceRange(Image::inferAspectFlags(imageState.image.format)), newLayout, dstStageMask, dstAccessMask);
+}
+
+void vku::BarrierBatch::transition(
+    BufferState &bufferState,
+    VULKAN_HPP_NAMESPACE::PipelineStageFlags2 dstStageMask,
+    VULKAN_HPP_NAMESPACE::AccessFlags2 dstAccessMask
+) {
+    if (const auto srcScope = details::accessResource(bufferState.state, dstStageMask, dstAccessMask, false)) {
+        bufferMemoryBarriers.push_back({
+            srcScope->first, srcScope->second,
+            dstStageMask, dstAccessMask,
+            VULKAN_HPP_NAMESPACE::QueueFamilyIgnored, VULKAN_HPP_NAMESPACE::QueueFamilyIgnored,
+            bufferState.buffer, 0, VULKAN_HPP_NAMESPACE::WholeSize,
+        });
+    }
+}
+
+void vku::BarrierBatch::record(
+    VULKAN_HPP_NAMESPACE::CommandBuffer commandBuffer,
+    VULKAN_HPP_NAMESPACE::DependencyFlags dependencyFlags
+) {
+    if (empty()) {
+        return;
+    }
+
+    commandBuffer.pipelineBarrier2({ dependencyFlags, {}, bufferMemoryBarriers, imageMemoryBarriers });
+    bufferMemoryBarriers.clear();
+    imageMemoryBarriers.clear();
+}
@@ -0,0 +1,166 @@
+/** @file sync/ResourceState.cppm
+ */
+
+module;
+
+#include <cassert>
+
+#include <vulkan/vulkan_hpp_macros.hpp>
+
+export module vku:sync.ResourceState;
+
+import std;
+export import vulkan_hpp;
+export import :buffers.Buffer;
+export import :images.Image;
+
+#ifdef NDEBUG
+#define NOEXCEPT_IF_RELEASE noexcept
+#else
+#define NOEXCEPT_IF_RELEASE
+#endif
+
+namespace vku {
+    /**
+     * @brief Synchronization state of a resource: its last write, and the scopes the write is already visible to.
+     */
+    export struct AccessState {
+        /**
+         * @brief Pipeline stages of the last write (including the image layout transition), which a subsequent access
+         * has to wait for.
+         */
+        VULKAN_HPP_NAMESPACE::PipelineStageFlags2 writeStageMask = {};
+
+        /**
+         * @brief Access types of the last write, which have to be made available to a subsequent access.
+         */
+        VULKAN_HPP_NAMESPACE::AccessFlags2 writeAccessMask = {};
+
+        /**
+         * @brief Pipeline stages that the last write has been made visible to, or that read the resource since the
+         * last write. A subsequent write has to wait for them.
+         */
+        VULKAN_HPP_NAMESPACE::PipelineStageFlags2 visibleStageMask = {};
+
+        /**
+         * @brief Access types that the last write has been made visible to.
+         */
+        VULKAN_HPP_NAMESPACE::AccessFlags2 visibleAccessMask = {};
+
+        [[nodiscard]] bool operator==(const AccessState&) const noexcept = default;
+    };
+
+    /**
+     * @brief Last known layout and access of an image subresource.
+     */
+    export struct SubresourceState : AccessState {
+        VULKAN_HPP_NAMESPACE::ImageLayout layout = VULKAN_HPP_NAMESPACE::ImageLayout::eUndefined;
+
+        [[nodiscard]] bool operator==(const SubresourceState&) const noexcept = default;
+    };
+
+    /**
+     * @brief Check whether \p accessMask contains any write access.
+     *
+     * Unknown access bits (e.g. from the extensions that are not listed in here) are conservatively regarded as write.
+     *
+     * @param accessMask Access flags to check.
+     * @return <tt>true</tt> if \p accessMask contains write access, <tt>false</tt> otherwise.
+     */
+    export
+    [[nodiscard]] constexpr bool hasWriteAccess(VULKAN_HPP_NAMESPACE::AccessFlags2 accessMask) noexcept {
+        constexpr VULKAN_HPP_NAMESPACE::AccessFlags2 readAccessMask
+            = VULKAN_HPP_NAMESPACE::AccessFlagBits2::eIndirectCommandRead
+            | VULKAN_HPP_NAMESPACE::AccessFlagBits2::eIndexRead
+            | VULKAN_HPP_NAMESPACE::AccessFlagBits2::eVertexAttributeRead
+            | VULKAN_HPP_NAMESPACE::AccessFlagBits2::eUniformRead
+            | VULKAN_HPP_NAMESPACE::AccessFlagBits2::eInputAttachmentRead
+            | VULKAN_HPP_NAMESPACE::AccessFlagBits2::eShaderRead
+            | VULKAN_HPP_NAMESPACE::AccessFlagBits2::eColorAttachmentRead
+            | VULKAN_HPP_NAMESPACE::AccessFlagBits2::eDepthStencilAttachmentRead
+            | VULKAN_HPP_NAMESPACE::AccessFlagBits2::eTransferRead
+            | VULKAN_HPP_NAMESPACE::AccessFlagBits2::eHostRead
+            | VULKAN_HPP_NAMESPACE::AccessFlagBits2::eMemoryRead
+            | VULKAN_HPP_NAMESPACE::AccessFlagBits2::eShaderSampledRead
+            | VULKAN_HPP_NAMESPACE::AccessFlagBits2::eShaderStorageRead
+            | VULKAN_HPP_NAMESPACE::AccessFlagBits2::eAccelerationStructureReadKHR;
+        return static_cast<bool>(accessMask & ~readAccessMask);
+    }
+
+    /**
+     * @brief Image with per-subresource layout and access tracking.
+     *
+     * States are tracked for each (mip level, array layer) pair. Image aspects are not tracked separately, i.e. depth
+     * and stencil aspects of the same subresource are assumed to share the layout.
+     *
+     * Use <tt>vku::BarrierBatch::transition</tt> to change the state and accumulate the required barriers.
+     */
+    export class ImageState {
+    public:
+        /**
+         * @brief Tracked image.
+         */
+        Image image;
+
+        /**
+         * @brief Start tracking the \p image, whose all subresources are in \p initialLayout and not accessed yet.
+         * @param image Image to track.
+         * @param initialLayout Current layout of the image (default=<tt>vk::ImageLayout::eUndefined</tt>).
+         */
+        explicit ImageState(
+            const Image &image,
+            VULKAN_HPP_NAMESPACE::ImageLayout initialLayout = VULKAN_HPP_NAMESPACE::ImageLayout::eUndefined
+        ) : image { image },
+            subresourceStates(image.mipLevels * image.arrayLayers, SubresourceState { {}, initialLayout }) { }
+
+        /**
+         * @brief Get the state of the subresource at (\p mipLevel, \p arrayLayer).
+         * @param mipLevel Mip level. Must be less than <tt>image.mipLevels</tt>.
+         * @param arrayLayer Array layer. Must be less than <tt>image.arrayLayers</tt>.
+         * @return Reference of the subresource state.
+         */
+        [[nodiscard]] const SubresourceState& getState(std::uint32_t mipLevel, std::uint32_t arrayLayer) const NOEXCEPT_IF_RELEASE {
+            assert(mipLevel < image.mipLevels && arrayLayer < image.arrayLayers && "Out of bound subresource");
+            return subresourceStates[mipLevel * image.arrayLayers + arrayLayer];
+        }
+
+        /**
+         * @copydoc getState(std::uint32_t, std::uint32_t) const
+         */
+        [[nodiscard]] SubresourceState& getState(std::uint32_t mipLevel, std::uint32_t arrayLayer) NOEXCEPT_IF_RELEASE {
+            assert(mipLevel < image.mipLevels && arrayLayer < image.arrayLayers && "Out of bound subresource");
+            return subresourceStates[mipLevel * image.arrayLayers + arrayLayer];
+        }
+
+        /**
+         * @brief Overwrite the state of all subresources, without recording any barrier.
+         *
+         * This is useful when the image layout is changed outside the tracker, e.g. by render pass or presentation.
+         *
+         * @param state New state of all subresources.
+         */
+        void reset(const SubresourceState &state = {}) noexcept {
+            std::ranges::fill(subresourceStates, state);
+        }
+
+    private:
+        std::vector<SubresourceState> subresourceStates;
+    };
+
+    /**
+     * @brief Buffer with access tracking.
+     *
+     * Use <tt>vku::BarrierBatch::transition</tt> to change the state and accumulate the required barriers.
+     */
+    export struct BufferState {
+        /**
+         * @brief Tracked buffer.
+         */
+        Buffer buffer;
+
+        /**
+         * @brief Last access of the whole buffer.
+         */
+        AccessState state = {};
+    };
+}
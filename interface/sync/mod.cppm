@@ -0,0 +1,6 @@
+/** @file sync/mod.cppm
+ */
+
+export module vku:sync;
+export import :sync.BarrierBatch;
+export import :sync.ResourceState;
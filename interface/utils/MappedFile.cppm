@@ -0,0 +1,166 @@
+/** @file utils/MappedFile.cppm
+ */
+
+module;
+
+#include <cerrno>
+
+#ifdef _WIN32
+#ifndef NOMINMAX
+#define NOMINMAX
+#endif
+#include <windows.h>
+#else
+#include <fcntl.h>
+#include <sys/mman.h>
+#include <sys/stat.h>
+#include <unistd.h>
+#endif
+
+export module vku:utils.MappedFile;
+
+import std;
+
+namespace vku {
+    /**
+     * @brief Read-only memory mapping of a whole file.
+     *
+     * The file content is accessed through <tt>data()</tt> without copying it into the process heap. The mapped address is
+     * page aligned and not changed by moving the object, therefore the spans obtained before the move remain valid until
+     * the file is unmapped (destruction of the owning object).
+     */
+    export class MappedFile {
+    public:
+        /**
+         * @brief Map the file at \p path.
+         * @param path Path to the file.
+         * @throw std::runtime_error If the file cannot be opened or mapped.
+         */
+        explicit MappedFile(const std::filesystem::path &path);
+        MappedFile(MappedFile &&src) noexcept;
+        auto operator=(MappedFile &&src) noexcept -> MappedFile&;
+        ~MappedFile();
+
+        /**
+         * @brief Get the mapped file content.
+         * @return Span of the file content. Empty span if the file is empty.
+         */
+        [[nodiscard]] auto data() const noexcept -> std::span<const std::byte> {
+            return { static_cast<const std::byte*>(address), size };
+        }
+
+    private:
+        const void *address = nullptr;
+        std::size_t size = 0;
+
+        void unmap() noexcept;
+    };
+}
+
+// --------------------
+// Implementations.
+// --------------------
+
+vku::MappedFile::MappedFile(
+    const std::filesystem::path &path
+) {
+#ifdef _WIN32
+    const HANDLE file = CreateFileW(path.c_str(), GENERIC_READ, FILE_SHARE_READ, nullptr, OPEN_EXISTING, FILE_ATTRIBUTE_NORMAL, nullptr);
+    if (file == INVALID_HANDLE_VALUE) {
+        throw std::runtime_error { std::format("Failed to open file: {} (error code={})", path.string(), GetLastError()) };
+    }
+
+    LARGE_INTEGER fileSize;
+    if (!GetFileSizeEx(file, &fileSize)) {
+        const DWORD error = GetLastError();
+        CloseHandle(file);
+        throw std::runtime_error { std::format("Failed to get file size: {} (error code={})", path.string(), error) };
+    }
+
+    size = static_cast<std::size_t>(fileSize.QuadPart);
+    if (size != 0) {
+        const HANDLE mapping = CreateFileMappingW(file, nullptr, PAGE_READONLY, 0, 0, nullptr);
+        if (!mapping) {
+            const DWORD error = GetLastError();
+            CloseHandle(file);
+            throw std::runtime_error { std::format("Failed to map file: {} (error code={})", path.string(), error) };
+        }
+
+        address = MapViewOfFile(mapping, FILE_MAP_READ, 0, 0, 0);
+        const DWORD error = GetLastError();
+
+        // The view holds the reference of the mapping object and file.
+        CloseHandle(mapping);
+        CloseHandle(file);
+
+        if (!address) {
+            throw std::runtime_error { std::format("Failed to map file: {} (error code={})", path.string(), error) };
+        }
+    }
+    else {
+        CloseHandle(file);
+    }
+#else
+    const int fd = open(path.c_str(), O_RDONLY);
+    if (fd == -1) {
+        throw std::runtime_error { std::format("Failed to open file: {} (error code={})", std::strerror(errno), errno) };
+    }
+
+    struct stat fileStat;
+    if (fstat(fd, &fileStat) == -1) {
+        const int error = errno;
+        close(fd);
+        throw std::runtime_error { std::format("Failed to get file size: {} (error code={})", std::strerror(error), error) };
+    }
+
+    size = static_cast<std::size_t>(fileStat.st_size);
+    if (size != 0) {
+        void* const mapped = mmap(nullptr, size, PROT_READ, MAP_PRIVATE, fd, 0);
+        const int error = errno;
+
+        // The mapping holds the reference of the file.
+        close(fd);
+
+        if (mapped == MAP_FAILED) {
+            throw std::runtime_error { std::format("Failed to map file: {} (error code={})", std::strerror(error), error) };
+        }
+        address = mapped;
+    }
+    else {
+        close(fd);
+    }
+#endif
+}
+
+vku::MappedFile::MappedFile(
+    MappedFile &&src
+) noexcept
+    : address { std::exchange(src.address, nullptr) },
+      size { std::exchange(src.size, 0) } { }
+
+auto vku::MappedFile::operator=(
+    MappedFile &&src
+) noexcept -> MappedFile& {
+    if (this != &src) {
+        unmap();
+        address = std::exchange(src.address, nullptr);
+        size = std::exchange(src.size, 0);
+    }
+    return *this;
+}
+
+vku::MappedFile::~MappedFile() {
+    unmap();
+}
+
+void vku::MappedFile::unmap() noexcept {
+    if (address) {
+#ifdef _WIN32
+        UnmapViewOfFile(address);
+#else
+        munmap(const_cast<void*>(address), size);
+#endif
+        address = nullptr;
+        size = 0;
+    }
+}
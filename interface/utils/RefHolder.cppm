@@ -4,15 +4,45 @@
 export module vku:utils.RefHolder;
 
 import std;
+import :details.container.StaticVector;
 
 #define FWD(...) static_cast<decltype(__VA_ARGS__)&&>(__VA_ARGS__)
 
+namespace details {
+    /**
+     * <tt>std::array</tt> whose elements are pointed by the value of <tt>vku::RefHolder</tt>, which makes the holder
+     * non-movable.
+     */
+    template <typename T, std::size_t N>
+    struct PinnedArray : std::array<T, N> { };
+
+    /**
+     * Whether \p T stores its elements inside the object itself and they are pointed by the value, so that moving it
+     * would dangle the pointers.
+     */
+    template <typename T>
+    constexpr bool isInlineStorage = false;
+
+    template <typename T, std::size_t N>
+    constexpr bool isInlineStorage<PinnedArray<T, N>> = true;
+
+    template <typename T, std::size_t N>
+    constexpr bool isInlineStorage<StaticVector<T, N>> = true;
+}
+
 namespace vku{
     /**
      * @brief A container type that can be contextually converted to a reference of type <tt>T</tt>, which has references for instances of the types <tt>Ts...</tt>.
      *
      * This class is intended to be used in a situation for returning the value that has references to the various types, but they don't have to be emphasized (function users don't have to know about them, they only care about the value).
      *
+     * Since <tt>value</tt> refers to the stored temporaries, <tt>RefHolder</tt> is not copyable. It is movable only if
+     * none of \p Ts is <tt>details::PinnedArray</tt> or <tt>details::StaticVector</tt>, whose elements are moved to the
+     * new addresses. Heap-backed storages like <tt>std::vector</tt> and <tt>vku::MappedFile</tt> keep their elements'
+     * addresses, and <tt>std::array</tt> of handles (e.g. <tt>vk::raii::ShaderModule</tt>s) is referenced by the handle
+     * values, therefore they are safe to move. Other by-value types in \p Ts are not detected, therefore <tt>value</tt>
+     * must not point into them if the <tt>RefHolder</tt> is going to be moved. Returning it as a prvalue is always fine.
+     *
      * @tparam T A type that represents the value of <tt>RefHolder</tt>.
      * @tparam Ts Types that are used as references for the value of <tt>RefHolder</tt>.
      */
@@ -30,6 +60,11 @@ namespace vku{
         ) : temporaryValues { FWD(temporaryValues)... },
             value { std::apply(FWD(f), this->temporaryValues) } { }
 
+        RefHolder(const RefHolder&) = delete;
+        RefHolder(RefHolder&&) requires (!(details::isInlineStorage<Ts> || ...)) = default;
+        auto operator=(const RefHolder&) -> RefHolder& = delete;
+        auto operator=(RefHolder&&) -> RefHolder& = delete;
+
         /**
          * Make this struct implicitly convertible to <tt>T&</tt>.
          */
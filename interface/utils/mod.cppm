@@ -8,6 +8,7 @@ module;
 #include <vulkan/vulkan_hpp_macros.hpp>
 
 export module vku:utils;
+export import :utils.MappedFile;
 export import :utils.RefHolder;
 
 import std;
@@ -0,0 +1,233 @@
+#include <cassert>
+
+#include <vulkan/vulkan_hpp_macros.hpp>
+
+import std;
+import vku;
+
+#if VULKAN_HPP_DISPATCH_LOADER_DYNAMIC == 1
+VULKAN_HPP_DEFAULT_DISPATCH_LOADER_DYNAMIC_STORAGE
+#endif
+
+struct QueueFamilies {
+    std::uint32_t compute;
+
+    explicit QueueFamilies(vk::PhysicalDevice physicalDevice)
+        : compute { vku::getComputeQueueFamily(physicalDevice.getQueueFamilyProperties()).value() } { }
+};
+
+struct Queues {
+    vk::Queue compute;
+
+    Queues(vk::Device device, const QueueFamilies &queueFamilies)
+        : compute { device.getQueue(queueFamilies.compute, 0) } { }
+
+    [[nodiscard]] static auto getCreateInfos(vk::PhysicalDevice, const QueueFamilies &queueFamilies) noexcept -> vku::RefHolder<vk::DeviceQueueCreateInfo> {
+        return vku::RefHolder {
+            [&]() {
+                static constexpr float priority = 1.f;
+                return vk::DeviceQueueCreateInfo {
+                    {},
+                    queueFamilies.compute,
+                    vk::ArrayProxyNoTemporaries<const float>(priority),
+                };
+            },
+        };
+    }
+};
+
+struct Gpu : vku::Gpu<QueueFamilies, Queues> {
+    explicit Gpu(const vk::raii::Instance &instance [[clang::lifetimebound]])
+        : vku::Gpu<QueueFamilies, Queues> { instance, vku::Gpu<QueueFamilies, Queues>::Config {
+            .verbose = true,
+#if __APPLE__
+            .deviceExtensions = {
+                vk::KHRPortabilitySubsetExtensionName,
+            },
+#endif
+            .apiVersion = vk::makeApiVersion(0, 1, 1, 0),
+        } } { }
+};
+
+// Exposes setRenderingInfoCache to test the rendering info that AttachmentGroup never produces (with stencil attachment).
+struct TestAttachmentGroup : vku::AttachmentGroup {
+    using AttachmentGroup::AttachmentGroup;
+    using AttachmentGroupBase::setRenderingInfoCache;
+};
+
+int main() {
+#if VULKAN_HPP_DISPATCH_LOADER_DYNAMIC == 1
+    VULKAN_HPP_DEFAULT_DISPATCHER.init();
+#endif
+
+    const vk::raii::Context context;
+
+    const vk::raii::Instance instance { context, vk::InstanceCreateInfo {
+#if __APPLE__
+        vk::InstanceCreateFlagBits::eEnumeratePortabilityKHR,
+#else
+        {},
+#endif
+        vku::unsafeAddress(vk::ApplicationInfo {
+            "vku_test_attachment_group", 0,
+            {}, 0,
+            vk::makeApiVersion(0, 1, 1, 0),
+        }),
+        {},
+#if __APPLE__
+        vku::unsafeProxy({
+            vk::KHRPortabilityEnumerationExtensionName,
+        }),
+#endif
+    } };
+#if VULKAN_HPP_DISPATCH_LOADER_DYNAMIC == 1
+    VULKAN_HPP_DEFAULT_DISPATCHER.init(*instance);
+#endif
+
+    const Gpu gpu { instance };
+
+    constexpr vk::Extent2D extent { 16, 16 };
+    const auto createImage = [&](vk::Format format, vk::ImageUsageFlags usage) {
+        return vku::AllocatedImage { gpu.allocator, vk::ImageCreateInfo {
+            {},
+            vk::ImageType::e2D,
+            format,
+            vk::Extent3D { extent, 1 },
+            1, 1,
+            vk::SampleCountFlagBits::e1,
+            vk::ImageTiling::eOptimal,
+            usage,
+        } };
+    };
+
+    // Stand-ins of the swapchain images.
+    const std::array fakeSwapchainImages {
+        createImage(vk::Format::eB8G8R8A8Unorm, vk::ImageUsageFlagBits::eColorAttachment),
+        createImage(vk::Format::eB8G8R8A8Unorm, vk::ImageUsageFlagBits::eColorAttachment),
+        createImage(vk::Format::eB8G8R8A8Unorm, vk::ImageUsageFlagBits::eColorAttachment),
+    };
+    const std::array swapchainImages = { vk::Image { fakeSwapchainImages[0] }, vk::Image { fakeSwapchainImages[1] }, vk::Image { fakeSwapchainImages[2] } };
+    const vku::AllocatedImage colorImage = createImage(vk::Format::eR8G8B8A8Unorm, vk::ImageUsageFlagBits::eColorAttachment);
+    const vku::AllocatedImage depthImage = createImage(vk::Format::eD32Sfloat, vk::ImageUsageFlagBits::eDepthStencilAttachment);
+
+    const std::array colorAttachmentInfos {
+        vku::AttachmentGroup::ColorAttachmentInfo { vk::AttachmentLoadOp::eClear, vk::AttachmentStoreOp::eStore, { 0.f, 0.f, 0.f, 1.f } },
+        vku::AttachmentGroup::ColorAttachmentInfo { vk::AttachmentLoadOp::eLoad, vk::AttachmentStoreOp::eDontCare },
+    };
+    const vku::AttachmentGroup::DepthStencilAttachmentInfo depthStencilAttachmentInfo { vk::AttachmentLoadOp::eClear, vk::AttachmentStoreOp::eDontCare, { 1.f, 0 } };
+
+    // --------------------
+    // Per swapchain image cache.
+    // --------------------
+
+    TestAttachmentGroup attachmentGroup { extent };
+    attachmentGroup.addSwapchainAttachment(gpu.device, swapchainImages, vk::Format::eB8G8R8A8Unorm);
+    const vk::ImageView colorView = *attachmentGroup.addColorAttachment(gpu.device, colorImage).view;
+    const vk::ImageView depthView = *attachmentGroup.setDepthStencilAttachment(gpu.device, depthImage).view;
+    attachmentGroup.updateRenderingInfoCache(colorAttachmentInfos, depthStencilAttachmentInfo);
+
+    std::array<vk::ImageView, 3> swapchainViews;
+    std::ranges::transform(attachmentGroup.getSwapchainAttachment(0).views, swapchainViews.begin(), [](const vku::SharedImageView &view) {
+        return *view;
+    });
+
+    std::array<const vk::RenderingInfo*, 3> cachedRenderingInfos;
+    for (std::uint32_t i = 0; i < swapchainImages.size(); ++i) {
+        const vk::RenderingInfo &renderingInfo = attachmentGroup.getCachedRenderingInfo(i);
+        cachedRenderingInfos[i] = &renderingInfo;
+
+        assert(renderingInfo.renderArea.extent == extent && renderingInfo.layerCount == 1);
+        assert(renderingInfo.colorAttachmentCount == 2);
+        assert(renderingInfo.pColorAttachments[0].imageView == swapchainViews[i] && "Swapchain view must match the image index");
+        assert(renderingInfo.pColorAttachments[0].loadOp == vk::AttachmentLoadOp::eClear);
+        assert(renderingInfo.pColorAttachments[1].imageView == colorView);
+        assert(renderingInfo.pColorAttachments[1].loadOp == vk::AttachmentLoadOp::eLoad);
+
+        // Depth attachment must point into the cache's own storage, right after the color attachments.
+        assert(renderingInfo.pDepthAttachment == renderingInfo.pColorAttachments + 2);
+        assert(renderingInfo.pDepthAttachment->imageView == depthView);
+        assert(renderingInfo.pStencilAttachment == nullptr);
+
+        if (i != 0) {
+            assert(renderingInfo.pColorAttachments != cachedRenderingInfos[i - 1]->pColorAttachments);
+        }
+    }
+
+    // --------------------
+    // Stability after the group is moved.
+    // --------------------
+
+    TestAttachmentGroup movedAttachmentGroup = std::move(attachmentGroup);
+    for (std::uint32_t i = 0; i < swapchainImages.size(); ++i) {
+        const vk::RenderingInfo &renderingInfo = movedAttachmentGroup.getCachedRenderingInfo(i);
+        assert(&renderingInfo == cachedRenderingInfos[i] && "Cached rendering info must not be relocated by move");
+        assert(renderingInfo.pColorAttachments[0].imageView == swapchainViews[i]);
+        assert(renderingInfo.pDepthAttachment->imageView == depthView);
+    }
+
+    TestAttachmentGroup assignedAttachmentGroup { extent };
+    assignedAttachmentGroup = std::move(movedAttachmentGroup);
+    for (std::uint32_t i = 0; i < swapchainImages.size(); ++i) {
+        assert(&assignedAttachmentGroup.getCachedRenderingInfo(i) == cachedRenderingInfos[i]);
+    }
+
+    // --------------------
+    // Stencil attachment fix-up and validation.
+    // --------------------
+
+    // Rendering info whose depth and stencil attachments are the same one, or separate ones if separateStencil is true.
+    const auto getDepthStencilRenderingInfo = [&](bool separateStencil) {
+        vku::AttachmentGroup::RenderingAttachmentInfos attachmentInfos;
+        attachmentInfos.push_back({ colorView, vk::ImageLayout::eColorAttachmentOptimal });
+        attachmentInfos.push_back({ depthView, vk::ImageLayout::eDepthStencilAttachmentOptimal });
+        attachmentInfos.push_back({ depthView, vk::ImageLayout::eDepthStencilAttachmentOptimal });
+        return vku::RefHolder {
+            [&](const vku::AttachmentGroup::RenderingAttachmentInfos &infos) {
+                return vk::RenderingInfo {
+                    {},
+                    { {}, extent },
+                    1,
+                    0,
+                    1, infos.data(),
+                    &infos[1],
+                    &infos[separateStencil ? 2 : 1],
+                };
+            },
+            std::move(attachmentInfos),
+        };
+    };
+
+    TestAttachmentGroup stencilAttachmentGroup { extent };
+    stencilAttachmentGroup.setRenderingInfoCache(1, [&](std::uint32_t) {
+        return getDepthStencilRenderingInfo(false);
+    });
+    const vk::RenderingInfo &stencilRenderingInfo = stencilAttachmentGroup.getCachedRenderingInfo();
+    assert(stencilRenderingInfo.pDepthAttachment == stencilRenderingInfo.pColorAttachments + 1);
+    assert(stencilRenderingInfo.pStencilAttachment == stencilRenderingInfo.pDepthAttachment && "Stencil attachment must point the cached depth attachment");
+    assert(stencilRenderingInfo.pStencilAttachment->imageView == depthView);
+
+    // Separate stencil attachment is rejected, and the previous cache is kept.
+    try {
+        stencilAttachmentGroup.setRenderingInfoCache(1, [&](std::uint32_t) {
+            return getDepthStencilRenderingInfo(true);
+        });
+        assert(false && "Separate stencil attachment must throw");
+    }
+    catch (const std::runtime_error&) { }
+    assert(&stencilAttachmentGroup.getCachedRenderingInfo() == &stencilRenderingInfo);
+    assert(stencilRenderingInfo.pStencilAttachment == stencilRenderingInfo.pDepthAttachment);
+
+    // --------------------
+    // Attachment count overflow.
+    // --------------------
+
+    TestAttachmentGroup fullAttachmentGroup { extent };
+    for (std::size_t i = 0; i < vku::AttachmentGroup::maxColorAttachmentCount; ++i) {
+        std::ignore = fullAttachmentGroup.addColorAttachment(gpu.device, colorImage);
+    }
+    try {
+        std::ignore = fullAttachmentGroup.addColorAttachment(gpu.device, colorImage);
+        assert(false && "Exceeding maxColorAttachmentCount must throw");
+    }
+    catch (const std::runtime_error&) { }
+}
@@ -0,0 +1,114 @@
+#include <cassert>
+
+#include <vulkan/vulkan_hpp_macros.hpp>
+
+import std;
+import vku;
+
+#if VULKAN_HPP_DISPATCH_LOADER_DYNAMIC == 1
+VULKAN_HPP_DEFAULT_DISPATCH_LOADER_DYNAMIC_STORAGE
+#endif
+
+int main() {
+    // Barrier accumulation does not touch any Vulkan handle, therefore null handles are enough.
+    vku::ImageState imageState { vku::Image { nullptr, { 256, 256, 1 }, vk::Format::eR8G8B8A8Unorm, 9, 4 } };
+    vku::BufferState bufferState { vku::Buffer { nullptr, 1024 } };
+
+    {
+        // Transitioning the whole image from its initial state must produce a single barrier.
+        vku::BarrierBatch barriers;
+        barriers.transition(imageState, vk::ImageLayout::eTransferDstOptimal, vk::PipelineStageFlagBits2::eCopy, vk::AccessFlagBits2::eTransferWrite);
+
+        const auto imageBarriers = barriers.getImageMemoryBarriers();
+        assert(imageBarriers.size() == 1 && "Whole image transition must be merged into a single barrier");
+        assert(imageBarriers[0].oldLayout == vk::ImageLayout::eUndefined);
+        assert(imageBarriers[0].subresourceRange == vk::ImageSubresourceRange(vk::ImageAspectFlagBits::eColor, 0, 9, 0, 4));
+    }
+
+    {
+        // Transition layers [1, 3) of the mip levels [0, 4): one barrier that spans all the mip levels.
+        vku::BarrierBatch barriers;
+        barriers.transition(
+            imageState, { vk::ImageAspectFlagBits::eColor, 0, 4, 1, 2 },
+            vk::ImageLayout::eShaderReadOnlyOptimal, vk::PipelineStageFlagBits2::eFragmentShader, vk::AccessFlagBits2::eShaderSampledRead);
+
+        const auto imageBarriers = barriers.getImageMemoryBarriers();
+        assert(imageBarriers.size() == 1 && "Subresources with the same previous state must be merged");
+        assert(imageBarriers[0].oldLayout == vk::ImageLayout::eTransferDstOptimal);
+        assert(imageBarriers[0].srcAccessMask == vk::AccessFlagBits2::eTransferWrite);
+        assert(imageBarriers[0].subresourceRange == vk::ImageSubresourceRange(vk::ImageAspectFlagBits::eColor, 0, 4, 1, 2));
+    }
+
+    {
+        // The transfer write was only made visible to the fragment shader. Reading it from the compute shader still
+        // needs a barrier from the write scope (and the layout transition, which happened before the fragment shader).
+        vku::BarrierBatch barriers;
+        barriers.transition(
+            imageState, { vk::ImageAspectFlagBits::eColor, 0, 4, 1, 2 },
+            vk::ImageLayout::eShaderReadOnlyOptimal, vk::PipelineStageFlagBits2::eComputeShader, vk::AccessFlagBits2::eShaderSampledRead);
+        {
+            const auto imageBarriers = barriers.getImageMemoryBarriers();
+            assert(imageBarriers.size() == 1);
+            assert(imageBarriers[0].srcStageMask & vk::PipelineStageFlagBits2::eCopy);
+            assert(imageBarriers[0].srcAccessMask == vk::AccessFlagBits2::eTransferWrite);
+            assert(imageBarriers[0].dstStageMask == vk::PipelineStageFlagBits2::eComputeShader);
+            assert(imageBarriers[0].oldLayout == imageBarriers[0].newLayout);
+        }
+
+        // Now the write is visible to both readers, therefore reading it again does not need a barrier.
+        barriers = {};
+        barriers.transition(
+            imageState, { vk::ImageAspectFlagBits::eColor, 0, 4, 1, 2 },
+            vk::ImageLayout::eShaderReadOnlyOptimal, vk::PipelineStageFlagBits2::eComputeShader, vk::AccessFlagBits2::eShaderSampledRead);
+        assert(barriers.empty() && "Read of the already visible write must not emit a barrier");
+
+        // Whole image transition now splits by the distinct previous states: layer 0, layers [1, 3), layer 3.
+        barriers.transition(imageState, vk::ImageLayout::eTransferSrcOptimal, vk::PipelineStageFlagBits2::eCopy, vk::AccessFlagBits2::eTransferRead);
+        const auto imageBarriers = barriers.getImageMemoryBarriers();
+        // Mip levels [0, 4) have 3 runs, and mip levels [4, 9) have a single run.
+        assert(imageBarriers.size() == 4);
+        assert(imageBarriers[1].oldLayout == vk::ImageLayout::eShaderReadOnlyOptimal);
+        assert(imageBarriers[1].subresourceRange.levelCount == 4);
+        assert(imageBarriers[3].subresourceRange == vk::ImageSubresourceRange(vk::ImageAspectFlagBits::eColor, 4, 5, 0, 4));
+    }
+
+    {
+        vku::BarrierBatch barriers;
+
+        // Buffer that was never accessed does not need any barrier.
+        barriers.transition(bufferState, vk::PipelineStageFlagBits2::eCopy, vk::AccessFlagBits2::eTransferRead);
+        assert(barriers.getBufferMemoryBarriers().empty());
+
+        // Write-after-read needs an execution dependency.
+        barriers.transition(bufferState, vk::PipelineStageFlagBits2::eComputeShader, vk::AccessFlagBits2::eShaderStorageWrite);
+        const auto bufferBarriers = barriers.getBufferMemoryBarriers();
+        assert(bufferBarriers.size() == 1);
+        assert(bufferBarriers[0].srcStageMask == vk::PipelineStageFlagBits2::eCopy);
+        assert(!bufferBarriers[0].srcAccessMask && "Read access does not have to be made available");
+    }
+
+    {
+        // Transfer write -> fragment shader read -> compute shader read. Each access is recorded in its own batch.
+        vku::BufferState bufferState { vku::Buffer { nullptr, 1024 } };
+        vku::BarrierBatch barriers;
+        barriers.transition(bufferState, vk::PipelineStageFlagBits2::eCopy, vk::AccessFlagBits2::eTransferWrite);
+        assert(barriers.empty() && "Buffer that was never accessed does not need any barrier");
+
+        barriers.transition(bufferState, vk::PipelineStageFlagBits2::eFragmentShader, vk::AccessFlagBits2::eShaderStorageRead);
+        assert(barriers.getBufferMemoryBarriers().size() == 1);
+
+        barriers = {};
+        barriers.transition(bufferState, vk::PipelineStageFlagBits2::eComputeShader, vk::AccessFlagBits2::eShaderStorageRead);
+        const auto bufferBarriers = barriers.getBufferMemoryBarriers();
+        assert(bufferBarriers.size() == 1 && "Write is not visible to the compute shader yet");
+        assert(bufferBarriers[0].srcStageMask == vk::PipelineStageFlagBits2::eCopy);
+        assert(bufferBarriers[0].srcAccessMask == vk::AccessFlagBits2::eTransferWrite);
+        assert(bufferBarriers[0].dstStageMask == vk::PipelineStageFlagBits2::eComputeShader);
+
+        // Both readers have to finish before the next write.
+        barriers = {};
+        barriers.transition(bufferState, vk::PipelineStageFlagBits2::eCopy, vk::AccessFlagBits2::eTransferWrite);
+        assert(barriers.getBufferMemoryBarriers().size() == 1);
+        assert(barriers.getBufferMemoryBarriers()[0].srcStageMask == (vk::PipelineStageFlagBits2::eCopy | vk::PipelineStageFlagBits2::eFragmentShader | vk::PipelineStageFlagBits2::eComputeShader));
+    }
+}
@@ -0,0 +1,52 @@
+#include <cassert>
+
+#include <vulkan/vulkan_hpp_macros.hpp>
+
+import std;
+import vku;
+
+#if VULKAN_HPP_DISPATCH_LOADER_DYNAMIC == 1
+VULKAN_HPP_DEFAULT_DISPATCH_LOADER_DYNAMIC_STORAGE
+#endif
+
+int main() {
+    constexpr std::uint32_t capacity = 1024;
+    vku::BindlessSlotAllocator slotAllocator { capacity };
+
+    // Allocate all slots from the multiple threads. Every slot must be allocated exactly once.
+    std::vector<std::uint32_t> slots(capacity);
+    {
+        std::vector<std::jthread> threads;
+        for (std::uint32_t threadIndex = 0; threadIndex < 4; ++threadIndex) {
+            threads.emplace_back([&, threadIndex]() {
+                for (std::uint32_t i = threadIndex; i < capacity; i += 4) {
+                    slots[i] = slotAllocator.allocate();
+                }
+            });
+        }
+    }
+    std::ranges::sort(slots);
+    assert(std::ranges::equal(slots, std::views::iota(0U, capacity)) && "Slots must be unique");
+
+    // Heap is full.
+    try {
+        std::ignore = slotAllocator.allocate();
+        return 1;
+    }
+    catch (const std::runtime_error&) { }
+
+    // Retired slots must not be reused until collected.
+    slotAllocator.retire(3, 10);
+    slotAllocator.retire(5, 11);
+    assert(slotAllocator.collect(9) == 0);
+    assert(slotAllocator.collect(10) == 1);
+    assert(slotAllocator.allocate() == 3);
+    assert(slotAllocator.collect(11) == 1);
+    assert(slotAllocator.allocate() == 5);
+
+    // Free slot stack is LIFO.
+    slotAllocator.free(7);
+    slotAllocator.free(8);
+    assert(slotAllocator.allocate() == 8);
+    assert(slotAllocator.allocate() == 7);
+}
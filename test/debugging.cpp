@@ -0,0 +1,40 @@
+#include <cassert>
+
+#include <vulkan/vulkan_hpp_macros.hpp>
+
+import std;
+import vku;
+
+#if VULKAN_HPP_DISPATCH_LOADER_DYNAMIC == 1
+VULKAN_HPP_DEFAULT_DISPATCH_LOADER_DYNAMIC_STORAGE
+#endif
+
+// Both are on the same line, so that the location can be compared with the default name.
+[[nodiscard]] auto getDefaultNameInfo() -> std::pair<vk::DebugUtilsObjectNameInfoEXT, std::source_location> {
+    return { vku::getDebugUtilsObjectNameInfoEXT(vk::Buffer{}), std::source_location::current() };
+}
+
+int main() {
+    // Default name must be the caller's location, not the library's.
+    const auto [nameInfo, callerLocation] = getDefaultNameInfo();
+    assert(nameInfo.objectType == vk::ObjectType::eBuffer);
+
+    const std::string_view name = nameInfo.pObjectName;
+    assert(name.contains(std::format("debugging.cpp:{}:", callerLocation.line())));
+    assert(!name.contains("debugging.cppm"));
+
+    // Interned names must outlive the call, be shared by the same call site and be distinct among the call sites.
+    assert(getDefaultNameInfo().first.pObjectName == nameInfo.pObjectName);
+    const char *const otherName = vku::getDebugUtilsObjectNameInfoEXT(vk::Buffer{}).pObjectName;
+    assert(otherName != nameInfo.pObjectName && std::string_view { otherName } != name);
+
+    // Explicit name is used as is.
+    constexpr const char *explicitName = "Vertex buffer";
+    assert(vku::getDebugUtilsObjectNameInfoEXT(vk::Buffer{}, explicitName).pObjectName == explicitName);
+
+    // Default tag names are also distinct among the call sites.
+    constexpr std::array<std::uint32_t, 1> tagData { 0 };
+    const std::uint64_t tagName1 = vku::getDebugUtilsObjectTagInfoEXT(vk::Buffer{}, vk::ArrayProxyNoTemporaries<const std::uint32_t> { tagData }).tagName;
+    const std::uint64_t tagName2 = vku::getDebugUtilsObjectTagInfoEXT(vk::Buffer{}, vk::ArrayProxyNoTemporaries<const std::uint32_t> { tagData }).tagName;
+    assert(tagName1 != tagName2);
+}
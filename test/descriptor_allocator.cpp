@@ -0,0 +1,109 @@
+#include <cassert>
+
+#include <vulkan/vulkan_hpp_macros.hpp>
+
+import std;
+import vku;
+
+#if VULKAN_HPP_DISPATCH_LOADER_DYNAMIC == 1
+VULKAN_HPP_DEFAULT_DISPATCH_LOADER_DYNAMIC_STORAGE
+#endif
+
+struct QueueFamilies {
+    std::uint32_t compute;
+
+    explicit QueueFamilies(vk::PhysicalDevice physicalDevice)
+        : compute { vku::getComputeQueueFamily(physicalDevice.getQueueFamilyProperties()).value() } { }
+};
+
+struct Queues {
+    Queues(vk::Device, const QueueFamilies&) { }
+
+    [[nodiscard]] static auto getCreateInfos(vk::PhysicalDevice, const QueueFamilies &queueFamilies) noexcept -> vku::RefHolder<vk::DeviceQueueCreateInfo> {
+        return vku::RefHolder {
+            [&]() {
+                static constexpr float priority = 1.f;
+                return vk::DeviceQueueCreateInfo {
+                    {},
+                    queueFamilies.compute,
+                    vk::ArrayProxyNoTemporaries<const float>(priority),
+                };
+            },
+        };
+    }
+};
+
+struct Gpu : vku::Gpu<QueueFamilies, Queues> {
+    explicit Gpu(const vk::raii::Instance &instance [[clang::lifetimebound]])
+        : vku::Gpu<QueueFamilies, Queues> { instance, vku::Gpu<QueueFamilies, Queues>::Config {
+            .verbose = true,
+            .deviceExtensions = {
+                vk::KHRMaintenance1ExtensionName,
+#if __APPLE__
+                vk::KHRPortabilitySubsetExtensionName,
+#endif
+            },
+        } } { }
+};
+
+int main() {
+#if VULKAN_HPP_DISPATCH_LOADER_DYNAMIC == 1
+    VULKAN_HPP_DEFAULT_DISPATCHER.init();
+#endif
+
+    const vk::raii::Context context;
+
+    const vk::raii::Instance instance { context, vk::InstanceCreateInfo {
+#if __APPLE__
+        vk::InstanceCreateFlagBits::eEnumeratePortabilityKHR,
+#else
+        {},
+#endif
+        vku::unsafeAddress(vk::ApplicationInfo {
+            "vku_test_descriptor_allocator", 0,
+            {}, 0,
+            vk::makeApiVersion(0, 1, 0, 0),
+        }),
+        {},
+#if __APPLE__
+        vku::unsafeProxy({
+            vk::KHRGetPhysicalDeviceProperties2ExtensionName,
+            vk::KHRPortabilityEnumerationExtensionName,
+        }),
+#endif
+    } };
+#if VULKAN_HPP_DISPATCH_LOADER_DYNAMIC == 1
+    VULKAN_HPP_DEFAULT_DISPATCHER.init(*instance);
+#endif
+
+    const Gpu gpu { instance };
+
+    const vku::DescriptorSetLayout<vk::DescriptorType::eUniformBuffer, vk::DescriptorType::eCombinedImageSampler> descriptorSetLayout { gpu.device, vk::DescriptorSetLayoutCreateInfo {
+        {},
+        vku::unsafeProxy(decltype(descriptorSetLayout)::getBindings(
+            { 1, vk::ShaderStageFlagBits::eCompute },
+            { 4, vk::ShaderStageFlagBits::eCompute })),
+    } };
+
+    // Initial pool can hold only 2 descriptor sets.
+    vku::DescriptorAllocator descriptorAllocator { gpu.device, descriptorSetLayout.getPoolSize() * 2 };
+
+    // Allocating 10 descriptor sets must fall through to the new pools.
+    for (std::uint32_t i = 0; i < 10; ++i) {
+        const auto [descriptorSet] = descriptorAllocator.allocate(std::tie(descriptorSetLayout));
+        assert(descriptorSet);
+    }
+    assert(descriptorAllocator.getPoolCount() > 1 && "Pool must be grown");
+    assert(descriptorAllocator.getUsage().setCount == 10);
+    assert(descriptorAllocator.getUsage().typeCounts.at(vk::DescriptorType::eCombinedImageSampler) == 40);
+
+    // After the reset, the pool chain must be collapsed into a single pool that can hold the same amount of allocations.
+    descriptorAllocator.reset();
+    assert(descriptorAllocator.getPoolCount() == 1);
+    assert(descriptorAllocator.getUsage().setCount == 0);
+
+    for (std::uint32_t i = 0; i < 10; ++i) {
+        std::ignore = descriptorAllocator.allocate(std::tie(descriptorSetLayout));
+    }
+    assert(descriptorAllocator.getPoolCount() == 1 && "Steady-state usage must not grow the pool");
+}
@@ -0,0 +1,146 @@
+#include <cassert>
+
+#include <vulkan/vulkan_hpp_macros.hpp>
+
+import std;
+import vku;
+
+#if VULKAN_HPP_DISPATCH_LOADER_DYNAMIC == 1
+VULKAN_HPP_DEFAULT_DISPATCH_LOADER_DYNAMIC_STORAGE
+#endif
+
+struct QueueFamilies {
+    std::uint32_t compute;
+
+    explicit QueueFamilies(vk::PhysicalDevice physicalDevice)
+        : compute { vku::getComputeQueueFamily(physicalDevice.getQueueFamilyProperties()).value() } { }
+};
+
+struct Queues {
+    vk::Queue compute;
+
+    Queues(vk::Device device, const QueueFamilies &queueFamilies)
+        : compute { device.getQueue(queueFamilies.compute, 0) } { }
+
+    [[nodiscard]] static auto getCreateInfos(vk::PhysicalDevice, const QueueFamilies &queueFamilies) noexcept -> vku::RefHolder<vk::DeviceQueueCreateInfo> {
+        return vku::RefHolder {
+            [&]() {
+                static constexpr float priority = 1.f;
+                return vk::DeviceQueueCreateInfo {
+                    {},
+                    queueFamilies.compute,
+                    vk::ArrayProxyNoTemporaries<const float>(priority),
+                };
+            },
+        };
+    }
+};
+
+struct Gpu : vku::Gpu<QueueFamilies, Queues> {
+    explicit Gpu(const vk::raii::Instance &instance [[clang::lifetimebound]])
+        : vku::Gpu<QueueFamilies, Queues> { instance, vku::Gpu<QueueFamilies, Queues>::Config {
+            .verbose = true,
+            .deviceExtensions = {
+                vk::EXTDescriptorBufferExtensionName,
+                vk::KHRSynchronization2ExtensionName,
+#if __APPLE__
+                vk::KHRPortabilitySubsetExtensionName,
+#endif
+            },
+            .devicePNexts = std::tuple {
+                vk::PhysicalDeviceDescriptorBufferFeaturesEXT { true },
+                vk::PhysicalDeviceBufferDeviceAddressFeatures { true },
+                vk::PhysicalDeviceSynchronization2Features { true },
+            },
+            .allocatorCreateFlags = vma::AllocatorCreateFlagBits::eBufferDeviceAddress,
+            .apiVersion = vk::makeApiVersion(0, 1, 2, 0),
+        } } { }
+};
+
+int main() {
+#if VULKAN_HPP_DISPATCH_LOADER_DYNAMIC == 1
+    VULKAN_HPP_DEFAULT_DISPATCHER.init();
+#endif
+
+    const vk::raii::Context context;
+
+    const vk::raii::Instance instance { context, vk::InstanceCreateInfo {
+#if __APPLE__
+        vk::InstanceCreateFlagBits::eEnumeratePortabilityKHR,
+#else
+        {},
+#endif
+        vku::unsafeAddress(vk::ApplicationInfo {
+            "vku_test_descriptor_buffer", 0,
+            {}, 0,
+            vk::makeApiVersion(0, 1, 2, 0),
+        }),
+        {},
+#if __APPLE__
+        vku::unsafeProxy({
+            vk::KHRGetPhysicalDeviceProperties2ExtensionName,
+            vk::KHRPortabilityEnumerationExtensionName,
+        }),
+#endif
+    } };
+#if VULKAN_HPP_DISPATCH_LOADER_DYNAMIC == 1
+    VULKAN_HPP_DEFAULT_DISPATCHER.init(*instance);
+#endif
+
+    // VK_EXT_descriptor_buffer is optional; skip the test if no physical device supports it.
+    const bool descriptorBufferSupported = std::ranges::any_of(instance.enumeratePhysicalDevices(), [](const vk::raii::PhysicalDevice &physicalDevice) {
+        return std::ranges::any_of(physicalDevice.enumerateDeviceExtensionProperties(), [](const vk::ExtensionProperties &properties) {
+            return std::string_view { properties.extensionName } == vk::EXTDescriptorBufferExtensionName;
+        });
+    });
+    if (!descriptorBufferSupported) {
+        std::cerr << "VK_EXT_descriptor_buffer is not supported, skipping the test.\n";
+        return 0;
+    }
+
+    const Gpu gpu { instance };
+
+    const vku::DescriptorSetLayout<vk::DescriptorType::eStorageBuffer> descriptorSetLayout { gpu.device, vk::DescriptorSetLayoutCreateInfo {
+        vk::DescriptorSetLayoutCreateFlagBits::eDescriptorBufferEXT,
+        vku::unsafeProxy(decltype(descriptorSetLayout)::getBindings(
+            { 1, vk::ShaderStageFlagBits::eCompute })),
+    } };
+
+    const vk::PhysicalDeviceDescriptorBufferPropertiesEXT descriptorBufferProperties
+        = gpu.physicalDevice.getProperties2<vk::PhysicalDeviceProperties2, vk::PhysicalDeviceDescriptorBufferPropertiesEXT>()
+            .get<vk::PhysicalDeviceDescriptorBufferPropertiesEXT>();
+
+    vku::DescriptorBuffer descriptorBuffer { gpu.device, gpu.allocator, descriptorSetLayout, descriptorBufferProperties, 2 };
+    assert(descriptorBuffer.setCount == 2);
+    assert(descriptorBuffer.setStride % descriptorBufferProperties.descriptorBufferOffsetAlignment == 0);
+    assert(descriptorBuffer.getOffset(1) == descriptorBuffer.setStride);
+
+    const vku::AllocatedBuffer storageBuffer { gpu.allocator, vk::BufferCreateInfo {
+        {},
+        2 * sizeof(std::uint32_t),
+        vk::BufferUsageFlagBits::eStorageBuffer | vk::BufferUsageFlagBits::eShaderDeviceAddress,
+    } };
+    descriptorBuffer.write<0>(0, vku::unsafeProxy(vk::DescriptorBufferInfo { storageBuffer, 0, sizeof(std::uint32_t) }));
+    descriptorBuffer.write<0>(1, vku::unsafeProxy(vk::DescriptorBufferInfo { storageBuffer, sizeof(std::uint32_t), sizeof(std::uint32_t) }));
+
+    // Descriptors of the two sets point to the different ranges, therefore their bytes must differ.
+    const std::span descriptorBytes = descriptorBuffer.asRange<const std::byte>();
+    const std::size_t descriptorSize = descriptorBufferProperties.storageBufferDescriptorSize;
+    assert(!std::ranges::equal(
+        descriptorBytes.subspan(descriptorBuffer.getOffset(0), descriptorSize),
+        descriptorBytes.subspan(descriptorBuffer.getOffset(1), descriptorSize)));
+
+    const vk::raii::PipelineLayout pipelineLayout { gpu.device, vk::PipelineLayoutCreateInfo {
+        {},
+        *descriptorSetLayout,
+    } };
+
+    // Bind the both sets, each of them through the device dispatcher.
+    const vk::raii::CommandPool commandPool { gpu.device, vk::CommandPoolCreateInfo { {}, gpu.queueFamilies.compute } };
+    vku::executeSingleCommand(*gpu.device, *commandPool, gpu.queues.compute, [&](vk::CommandBuffer cb) {
+        cb.bindDescriptorBuffersEXT(descriptorBuffer.getBindingInfo(), *gpu.device.getDispatcher());
+        descriptorBuffer.bindSet(cb, vk::PipelineBindPoint::eCompute, *pipelineLayout, 0, 0, 0);
+        descriptorBuffer.bindSet(cb, vk::PipelineBindPoint::eCompute, *pipelineLayout, 0, 0, 1);
+    });
+    gpu.queues.compute.waitIdle();
+}
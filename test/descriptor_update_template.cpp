@@ -0,0 +1,208 @@
+#include <cassert>
+
+#include <vulkan/vulkan_hpp_macros.hpp>
+
+import std;
+import vku;
+
+#if VULKAN_HPP_DISPATCH_LOADER_DYNAMIC == 1
+VULKAN_HPP_DEFAULT_DISPATCH_LOADER_DYNAMIC_STORAGE
+#endif
+
+struct QueueFamilies {
+    std::uint32_t compute;
+
+    explicit QueueFamilies(vk::PhysicalDevice physicalDevice)
+        : compute { vku::getComputeQueueFamily(physicalDevice.getQueueFamilyProperties()).value() } { }
+};
+
+struct Queues {
+    vk::Queue compute;
+
+    Queues(vk::Device device, const QueueFamilies &queueFamilies)
+        : compute { device.getQueue(queueFamilies.compute, 0) } { }
+
+    [[nodiscard]] static auto getCreateInfos(vk::PhysicalDevice, const QueueFamilies &queueFamilies) noexcept -> vku::RefHolder<vk::DeviceQueueCreateInfo> {
+        return vku::RefHolder {
+            [&]() {
+                static constexpr float priority = 1.f;
+                return vk::DeviceQueueCreateInfo {
+                    {},
+                    queueFamilies.compute,
+                    vk::ArrayProxyNoTemporaries<const float>(priority),
+                };
+            },
+        };
+    }
+};
+
+struct Gpu : vku::Gpu<QueueFamilies, Queues> {
+    explicit Gpu(const vk::raii::Instance &instance [[clang::lifetimebound]])
+        : vku::Gpu<QueueFamilies, Queues> { instance, vku::Gpu<QueueFamilies, Queues>::Config {
+            .verbose = true,
+#if __APPLE__
+            .deviceExtensions = {
+                vk::KHRPortabilitySubsetExtensionName,
+            },
+#endif
+            .apiVersion = vk::makeApiVersion(0, 1, 1, 0),
+        } } { }
+};
+
+// Binding types of different descriptor info sizes (vk::BufferView, vk::DescriptorBufferInfo, vk::DescriptorImageInfo) are
+// mixed, so that any offset mismatch between the template entries and the data tuple is observable.
+using DescriptorSetLayout = vku::DescriptorSetLayout<
+    vk::DescriptorType::eUniformTexelBuffer,
+    vk::DescriptorType::eUniformBuffer,
+    vk::DescriptorType::eStorageImage,
+    vk::DescriptorType::eStorageBuffer>;
+
+int main() {
+#if VULKAN_HPP_DISPATCH_LOADER_DYNAMIC == 1
+    VULKAN_HPP_DEFAULT_DISPATCHER.init();
+#endif
+
+    const vk::raii::Context context;
+
+    const vk::raii::Instance instance { context, vk::InstanceCreateInfo {
+#if __APPLE__
+        vk::InstanceCreateFlagBits::eEnumeratePortabilityKHR,
+#else
+        {},
+#endif
+        vku::unsafeAddress(vk::ApplicationInfo {
+            "vku_test_descriptor_update_template", 0,
+            {}, 0,
+            vk::makeApiVersion(0, 1, 1, 0),
+        }),
+        {},
+#if __APPLE__
+        vku::unsafeProxy({
+            vk::KHRPortabilityEnumerationExtensionName,
+        }),
+#endif
+    } };
+#if VULKAN_HPP_DISPATCH_LOADER_DYNAMIC == 1
+    VULKAN_HPP_DEFAULT_DISPATCHER.init(*instance);
+#endif
+
+    const Gpu gpu { instance };
+
+    const DescriptorSetLayout descriptorSetLayout { gpu.device, {
+        {},
+        vku::unsafeProxy(DescriptorSetLayout::getBindings(
+            { 1, vk::ShaderStageFlagBits::eCompute },
+            { 1, vk::ShaderStageFlagBits::eCompute },
+            { 1, vk::ShaderStageFlagBits::eCompute },
+            { 1, vk::ShaderStageFlagBits::eCompute })),
+    } };
+
+    // --------------------
+    // Host side: entry offsets and strides must point the elements of the data tuple.
+    // --------------------
+
+    using UpdateTemplate = vku::DescriptorUpdateTemplate<DescriptorSetLayout>;
+    static_assert(std::same_as<UpdateTemplate::Data, std::tuple<vk::BufferView, vk::DescriptorBufferInfo, vk::DescriptorImageInfo, vk::DescriptorBufferInfo>>);
+
+    const UpdateTemplate::Data probe {};
+    const auto offsetOf = [&](const auto &element) {
+        return static_cast<std::size_t>(reinterpret_cast<const std::byte*>(&element) - reinterpret_cast<const std::byte*>(&probe));
+    };
+    const std::array entries = UpdateTemplate::getEntries();
+    assert(entries[0].offset == offsetOf(get<0>(probe)) && entries[0].stride == sizeof(vk::BufferView));
+    assert(entries[1].offset == offsetOf(get<1>(probe)) && entries[1].stride == sizeof(vk::DescriptorBufferInfo));
+    assert(entries[2].offset == offsetOf(get<2>(probe)) && entries[2].stride == sizeof(vk::DescriptorImageInfo));
+    assert(entries[3].offset == offsetOf(get<3>(probe)) && entries[3].stride == sizeof(vk::DescriptorBufferInfo));
+    for (std::uint32_t binding = 0; const vk::DescriptorUpdateTemplateEntry &entry : entries) {
+        assert(entry.dstBinding == binding && entry.dstArrayElement == 0 && entry.descriptorCount == 1);
+        assert(entry.descriptorType == DescriptorSetLayout::bindingTypes[binding]);
+        ++binding;
+    }
+
+    // --------------------
+    // Device side: descriptors updated through the template must be read by the shader.
+    // --------------------
+
+    const vku::MappedBuffer texelBuffer { gpu.allocator, std::from_range, std::array { 1U }, vk::BufferUsageFlagBits::eUniformTexelBuffer };
+    const vk::raii::BufferView texelBufferView { gpu.device, vk::BufferViewCreateInfo {
+        {},
+        texelBuffer,
+        vk::Format::eR32Uint,
+        0, vk::WholeSize,
+    } };
+    const vku::MappedBuffer uniformBuffer { gpu.allocator, std::from_range, std::array { 2U }, vk::BufferUsageFlagBits::eUniformBuffer };
+    const vku::AllocatedImage storageImage { gpu.allocator, vk::ImageCreateInfo {
+        {},
+        vk::ImageType::e2D,
+        vk::Format::eR32Uint,
+        vk::Extent3D { 1, 1, 1 },
+        1, 1,
+        vk::SampleCountFlagBits::e1,
+        vk::ImageTiling::eOptimal,
+        vk::ImageUsageFlagBits::eStorage | vk::ImageUsageFlagBits::eTransferDst,
+    } };
+    const vk::raii::ImageView storageImageView { gpu.device, storageImage.getViewCreateInfo() };
+    const vku::MappedBuffer outputBuffer {
+        gpu.allocator,
+        std::from_range, std::array { 0U, 0U, 0U },
+        vk::BufferUsageFlagBits::eStorageBuffer,
+        vku::allocation::hostRead,
+    };
+
+    const vk::raii::DescriptorPool descriptorPool { gpu.device, getPoolSizes(descriptorSetLayout).getDescriptorPoolCreateInfo() };
+    const auto [descriptorSet] = vku::allocateDescriptorSets(*gpu.device, *descriptorPool, std::tie(descriptorSetLayout));
+
+    const UpdateTemplate updateTemplate { gpu.device, descriptorSetLayout };
+    descriptorSet.update(*gpu.device, updateTemplate, {
+        *texelBufferView,
+        vk::DescriptorBufferInfo { uniformBuffer, 0, vk::WholeSize },
+        vk::DescriptorImageInfo { {}, *storageImageView, vk::ImageLayout::eGeneral },
+        vk::DescriptorBufferInfo { outputBuffer, 0, vk::WholeSize },
+    });
+
+    const vk::raii::PipelineLayout pipelineLayout { gpu.device, vk::PipelineLayoutCreateInfo {
+        {},
+        *descriptorSetLayout,
+    } };
+    const vk::raii::Pipeline pipeline { gpu.device, nullptr, vk::ComputePipelineCreateInfo {
+        {},
+        createPipelineStages(
+            gpu.device,
+            vku::Shader::fromSpirvFile(COMPILED_SHADER_DIR "/descriptor_check.comp.spv", vk::ShaderStageFlagBits::eCompute)).get()[0],
+        *pipelineLayout,
+    } };
+
+    const vk::raii::CommandPool computeCommandPool { gpu.device, vk::CommandPoolCreateInfo {
+        {},
+        gpu.queueFamilies.compute,
+    } };
+
+    vku::executeSingleCommand(*gpu.device, *computeCommandPool, gpu.queues.compute, [&](vk::CommandBuffer cb) {
+        cb.pipelineBarrier(
+            vk::PipelineStageFlagBits::eTopOfPipe, vk::PipelineStageFlagBits::eTransfer,
+            {}, {}, {},
+            vk::ImageMemoryBarrier {
+                {}, vk::AccessFlagBits::eTransferWrite,
+                {}, vk::ImageLayout::eGeneral,
+                vk::QueueFamilyIgnored, vk::QueueFamilyIgnored,
+                storageImage, vku::fullSubresourceRange(),
+            });
+        cb.clearColorImage(storageImage, vk::ImageLayout::eGeneral, vk::ClearColorValue { 3U, 0U, 0U, 0U }, vku::fullSubresourceRange());
+        cb.pipelineBarrier(
+            vk::PipelineStageFlagBits::eTransfer, vk::PipelineStageFlagBits::eComputeShader,
+            {}, {}, {},
+            vk::ImageMemoryBarrier {
+                vk::AccessFlagBits::eTransferWrite, vk::AccessFlagBits::eShaderRead,
+                vk::ImageLayout::eGeneral, vk::ImageLayout::eGeneral,
+                vk::QueueFamilyIgnored, vk::QueueFamilyIgnored,
+                storageImage, vku::fullSubresourceRange(),
+            });
+
+        cb.bindPipeline(vk::PipelineBindPoint::eCompute, *pipeline);
+        cb.bindDescriptorSets(vk::PipelineBindPoint::eCompute, *pipelineLayout, 0, descriptorSet, {});
+        cb.dispatch(1, 1, 1);
+    });
+    gpu.queues.compute.waitIdle();
+
+    assert(std::ranges::equal(outputBuffer.asRange<const std::uint32_t>(), std::array { 1U, 2U, 3U }) && "Descriptor mismatch!");
+}
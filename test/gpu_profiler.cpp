@@ -0,0 +1,196 @@
+#include <cassert>
+
+#include <vulkan/vulkan_hpp_macros.hpp>
+
+import std;
+import vku;
+
+#if VULKAN_HPP_DISPATCH_LOADER_DYNAMIC == 1
+VULKAN_HPP_DEFAULT_DISPATCH_LOADER_DYNAMIC_STORAGE
+#endif
+
+struct QueueFamilies {
+    std::uint32_t compute;
+
+    explicit QueueFamilies(vk::PhysicalDevice physicalDevice)
+        : compute { vku::getComputeQueueFamily(physicalDevice.getQueueFamilyProperties()).value() } { }
+};
+
+struct Queues {
+    vk::Queue compute;
+
+    Queues(vk::Device device, const QueueFamilies &queueFamilies)
+        : compute { device.getQueue(queueFamilies.compute, 0) } { }
+
+    [[nodiscard]] static auto getCreateInfos(vk::PhysicalDevice, const QueueFamilies &queueFamilies) noexcept -> vku::RefHolder<vk::DeviceQueueCreateInfo> {
+        return vku::RefHolder {
+            [&]() {
+                static constexpr float priority = 1.f;
+                return vk::DeviceQueueCreateInfo {
+                    {},
+                    queueFamilies.compute,
+                    vk::ArrayProxyNoTemporaries<const float>(priority),
+                };
+            },
+        };
+    }
+};
+
+struct Gpu : vku::Gpu<QueueFamilies, Queues> {
+    explicit Gpu(const vk::raii::Instance &instance [[clang::lifetimebound]])
+        : vku::Gpu<QueueFamilies, Queues> { instance, vku::Gpu<QueueFamilies, Queues>::Config {
+            .verbose = true,
+#if __APPLE__
+            .deviceExtensions = {
+                vk::KHRPortabilitySubsetExtensionName,
+            },
+#endif
+            .apiVersion = vk::makeApiVersion(0, 1, 1, 0),
+        } } { }
+};
+
+struct GpuSpan {
+    std::uint32_t trackIndex;
+    double ts;
+    double dur;
+};
+
+// Parse the complete ("X") GPU events of the region named \p name from the Chrome trace JSON.
+[[nodiscard]] auto getGpuSpans(const std::string &json, std::string_view name) -> std::vector<GpuSpan> {
+    const std::regex pattern { std::format(R"re(\{{"name":"{}","cat":"gpu","ph":"X","pid":2,"tid":(\d+),"ts":(-?[0-9.]+),"dur":(-?[0-9.]+)\}})re", name) };
+    std::vector<GpuSpan> result;
+    for (auto it = std::sregex_iterator { json.begin(), json.end(), pattern }; it != std::sregex_iterator{}; ++it) {
+        result.emplace_back(static_cast<std::uint32_t>(std::stoul((*it)[1])), std::stod((*it)[2]), std::stod((*it)[3]));
+    }
+    return result;
+}
+
+[[nodiscard]] auto countOccurrences(std::string_view str, std::string_view pattern) -> std::size_t {
+    std::size_t count = 0;
+    for (std::size_t pos = 0; (pos = str.find(pattern, pos)) != std::string_view::npos; pos += pattern.size()) {
+        ++count;
+    }
+    return count;
+}
+
+constexpr std::uint32_t frameCount = 2;
+constexpr std::uint32_t submittedFrameCount = 4;
+
+int main() {
+#if VULKAN_HPP_DISPATCH_LOADER_DYNAMIC == 1
+    VULKAN_HPP_DEFAULT_DISPATCHER.init();
+#endif
+
+    const vk::raii::Context context;
+
+    const vk::raii::Instance instance { context, vk::InstanceCreateInfo {
+#if __APPLE__
+        vk::InstanceCreateFlagBits::eEnumeratePortabilityKHR,
+#else
+        {},
+#endif
+        vku::unsafeAddress(vk::ApplicationInfo {
+            "vku_test_gpu_profiler", 0,
+            {}, 0,
+            vk::makeApiVersion(0, 1, 1, 0),
+        }),
+        {},
+#if __APPLE__
+        vku::unsafeProxy({
+            vk::KHRPortabilityEnumerationExtensionName,
+        }),
+#endif
+    } };
+#if VULKAN_HPP_DISPATCH_LOADER_DYNAMIC == 1
+    VULKAN_HPP_DEFAULT_DISPATCHER.init(*instance);
+#endif
+
+    const Gpu gpu { instance };
+    if (gpu.physicalDevice.getQueueFamilyProperties()[gpu.queueFamilies.compute].timestampValidBits == 0) {
+        std::cerr << "Compute queue family does not support timestamps, skipping the test.\n";
+        return 0;
+    }
+
+    // 2 regions per frame, therefore the third region of a frame is not measured.
+    vku::GpuProfiler profiler { gpu.device, *gpu.physicalDevice, frameCount, 2 };
+
+    const vk::raii::CommandPool computeCommandPool { gpu.device, vk::CommandPoolCreateInfo {
+        vk::CommandPoolCreateFlagBits::eTransient,
+        gpu.queueFamilies.compute,
+    } };
+
+    // --------------------
+    // Frame protocol: query pools of the frames in flight are reused after reset.
+    // --------------------
+
+    for (std::uint32_t frame = 0; frame < submittedFrameCount; ++frame) {
+        vku::executeSingleCommand(*gpu.device, *computeCommandPool, gpu.queues.compute, [&](vk::CommandBuffer cb) {
+            // Results of (frame - frameCount) are collected here.
+            profiler.beginFrame(frame % frameCount, cb);
+            {
+                const vku::GpuProfiler::Scope scope = profiler.scope(cb, "Region \"A\"", "compute");
+            }
+            profiler.wrap("B", "compute \\ async", [](vk::CommandBuffer) { })(cb);
+            {
+                const vku::GpuProfiler::Scope scope = profiler.scope(cb, "C", "compute");
+            }
+        });
+        // Equivalent to waiting the frame's fence.
+        gpu.queues.compute.waitIdle();
+    }
+
+    // Collect the results of the last frameCount frames.
+    for (std::uint32_t frame = submittedFrameCount; frame < submittedFrameCount + frameCount; ++frame) {
+        vku::executeSingleCommand(*gpu.device, *computeCommandPool, gpu.queues.compute, [&](vk::CommandBuffer cb) {
+            profiler.beginFrame(frame % frameCount, cb);
+        });
+        gpu.queues.compute.waitIdle();
+    }
+
+    // --------------------
+    // Chrome trace JSON.
+    // --------------------
+
+    std::ostringstream oss;
+    profiler.writeChromeTrace(oss);
+    const std::string json = std::move(oss).str();
+
+    assert(json.starts_with(R"({"displayTimeUnit":"ns","traceEvents":[)") && json.ends_with("\n]}\n"));
+    assert(json.contains(R"({"name":"process_name","ph":"M","pid":1,"args":{"name":"CPU"}})"));
+    assert(json.contains(R"({"name":"process_name","ph":"M","pid":2,"args":{"name":"GPU"}})"));
+
+    // Track names are escaped.
+    assert(json.contains(R"({"name":"thread_name","ph":"M","pid":2,"tid":0,"args":{"name":"compute"}})"));
+    assert(json.contains(R"({"name":"thread_name","ph":"M","pid":2,"tid":1,"args":{"name":"compute \\ async"}})"));
+
+    // Every submitted frame is resolved exactly once: a CPU and a GPU span per measured region.
+    assert(countOccurrences(json, R"("ph":"X")") == submittedFrameCount * 2 * 2);
+    assert(countOccurrences(json, R"({"name":"Region \"A\"","cat":"cpu","ph":"X","pid":1,"tid":0,)") == submittedFrameCount);
+    assert(countOccurrences(json, R"({"name":"B","cat":"cpu","ph":"X","pid":1,"tid":0,)") == submittedFrameCount);
+    assert(!json.contains(R"({"name":"C",)") && "Region beyond maxRegionsPerFrame must not be measured");
+
+    // GPU spans must be in the submission order (stale results of the previous use of the query pool would break it),
+    // and have non-negative durations.
+    const std::vector spansA = getGpuSpans(json, R"(Region \\"A\\")");
+    const std::vector spansB = getGpuSpans(json, "B");
+    assert(spansA.size() == submittedFrameCount && spansB.size() == submittedFrameCount);
+    for (std::uint32_t frame = 0; frame < submittedFrameCount; ++frame) {
+        assert(spansA[frame].trackIndex == 0 && spansB[frame].trackIndex == 1);
+        assert(spansA[frame].dur >= 0.0 && spansB[frame].dur >= 0.0);
+        assert(spansA[frame].ts <= spansB[frame].ts);
+        if (frame != 0) {
+            assert(spansA[frame - 1].ts < spansA[frame].ts && "GPU timestamps must not be reused across frames");
+        }
+    }
+
+    // --------------------
+    // clearTrace discards the spans, but keeps the tracks.
+    // --------------------
+
+    profiler.clearTrace();
+    std::ostringstream clearedOss;
+    profiler.writeChromeTrace(clearedOss);
+    const std::string clearedJson = std::move(clearedOss).str();
+    assert(countOccurrences(clearedJson, R"("ph":"X")") == 0);
+    assert(countOccurrences(clearedJson, R"("name":"thread_name")") == 2);
+}
@@ -0,0 +1,88 @@
+#include <cassert>
+
+#include <vulkan/vulkan_hpp_macros.hpp>
+
+import std;
+import vku;
+
+#if VULKAN_HPP_DISPATCH_LOADER_DYNAMIC == 1
+VULKAN_HPP_DEFAULT_DISPATCH_LOADER_DYNAMIC_STORAGE
+#endif
+
+int main() {
+    constexpr vk::PipelineCreateFlags libraryFlags
+        = vk::PipelineCreateFlagBits::eLibraryKHR | vk::PipelineCreateFlagBits::eRetainLinkTimeOptimizationInfoEXT;
+
+    // Only the create info contents are inspected, therefore no device objects are needed.
+    const std::array<vk::PipelineShaderStageCreateInfo, 2> stages {};
+    const vk::PipelineLayout layout{};
+
+    // Parts must be the split of the monolithic default create info, referencing the same states.
+    const vk::GraphicsPipelineCreateInfo monolithic = vku::getDefaultGraphicsPipelineCreateInfo(stages, layout, 3, true, vk::SampleCountFlagBits::e4);
+
+    const vk::GraphicsPipelineCreateInfo vertexInputInterface = vku::getDefaultVertexInputInterfaceCreateInfo();
+    assert(vertexInputInterface.flags == libraryFlags);
+    assert(vertexInputInterface.pVertexInputState == monolithic.pVertexInputState);
+    assert(vertexInputInterface.pInputAssemblyState == monolithic.pInputAssemblyState);
+    assert(vertexInputInterface.stageCount == 0);
+    assert(!vertexInputInterface.pRasterizationState && !vertexInputInterface.pMultisampleState && !vertexInputInterface.pColorBlendState);
+
+    const vk::GraphicsPipelineCreateInfo preRasterizationShaders = vku::getDefaultPreRasterizationShadersCreateInfo(stages, layout);
+    assert(preRasterizationShaders.flags == libraryFlags);
+    assert(preRasterizationShaders.stageCount == stages.size() && preRasterizationShaders.pStages == stages.data());
+    assert(preRasterizationShaders.pViewportState == monolithic.pViewportState);
+    assert(preRasterizationShaders.pRasterizationState == monolithic.pRasterizationState);
+    assert(preRasterizationShaders.pDynamicState == monolithic.pDynamicState);
+    assert(preRasterizationShaders.layout == layout);
+    assert(!preRasterizationShaders.pVertexInputState && !preRasterizationShaders.pMultisampleState && !preRasterizationShaders.pColorBlendState);
+
+    const vk::GraphicsPipelineCreateInfo fragmentShader = vku::getDefaultFragmentShaderCreateInfo(stages[1], layout, true, vk::SampleCountFlagBits::e4);
+    assert(fragmentShader.flags == libraryFlags);
+    assert(fragmentShader.stageCount == 1 && fragmentShader.pStages == &stages[1]);
+    assert(fragmentShader.pMultisampleState == monolithic.pMultisampleState);
+    assert(fragmentShader.pDepthStencilState == monolithic.pDepthStencilState);
+    assert(!fragmentShader.pColorBlendState && !fragmentShader.pRasterizationState);
+    assert(!vku::getDefaultFragmentShaderCreateInfo(stages[1], layout).pDepthStencilState);
+
+    const vk::GraphicsPipelineCreateInfo fragmentOutputInterface = vku::getDefaultFragmentOutputInterfaceCreateInfo(3, vk::SampleCountFlagBits::e4);
+    assert(fragmentOutputInterface.flags == libraryFlags);
+    assert(fragmentOutputInterface.pMultisampleState == monolithic.pMultisampleState);
+    assert(fragmentOutputInterface.pMultisampleState->rasterizationSamples == vk::SampleCountFlagBits::e4);
+    assert(fragmentOutputInterface.pColorBlendState == monolithic.pColorBlendState);
+    assert(fragmentOutputInterface.pColorBlendState->attachmentCount == 3);
+    assert(fragmentOutputInterface.stageCount == 0 && !fragmentOutputInterface.pDepthStencilState);
+
+    // Color attachment count exceeding the maximum (=8) is rejected.
+    try {
+        std::ignore = vku::getDefaultFragmentOutputInterfaceCreateInfo(9);
+        return 1;
+    }
+    catch (const std::runtime_error&) { }
+
+    // Failure of the optimized link must not be thrown from get(), but stored for the inspection.
+    {
+        std::promise<vk::raii::Pipeline> promise;
+        vku::GraphicsPipelineLibrary::LinkedPipeline pipeline { nullptr, promise.get_future() };
+        assert(!pipeline.getOptimizationError());
+
+        promise.set_exception(std::make_exception_ptr(std::runtime_error { "Link failure" }));
+        assert(!pipeline.get() && "Fast-linked pipeline must be used");
+        assert(!pipeline.isOptimized());
+
+        const std::exception_ptr error = pipeline.getOptimizationError();
+        assert(error);
+        try {
+            std::rethrow_exception(error);
+        }
+        catch (const std::runtime_error &e) {
+            assert(std::string_view { e.what() } == "Link failure");
+        }
+    }
+
+    // Without the build queue, the fast-linked pipeline is used without any error.
+    {
+        vku::GraphicsPipelineLibrary::LinkedPipeline pipeline { nullptr, {} };
+        assert(!pipeline.get());
+        assert(!pipeline.isOptimized() && !pipeline.getOptimizationError());
+    }
+}
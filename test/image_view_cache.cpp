@@ -0,0 +1,178 @@
+#include <cassert>
+
+#include <vulkan/vulkan_hpp_macros.hpp>
+
+import std;
+import vku;
+
+#if VULKAN_HPP_DISPATCH_LOADER_DYNAMIC == 1
+VULKAN_HPP_DEFAULT_DISPATCH_LOADER_DYNAMIC_STORAGE
+#endif
+
+struct QueueFamilies {
+    std::uint32_t compute;
+
+    explicit QueueFamilies(vk::PhysicalDevice physicalDevice)
+        : compute { vku::getComputeQueueFamily(physicalDevice.getQueueFamilyProperties()).value() } { }
+};
+
+struct Queues {
+    vk::Queue compute;
+
+    Queues(vk::Device device, const QueueFamilies &queueFamilies)
+        : compute { device.getQueue(queueFamilies.compute, 0) } { }
+
+    [[nodiscard]] static auto getCreateInfos(vk::PhysicalDevice, const QueueFamilies &queueFamilies) noexcept -> vku::RefHolder<vk::DeviceQueueCreateInfo> {
+        return vku::RefHolder {
+            [&]() {
+                static constexpr float priority = 1.f;
+                return vk::DeviceQueueCreateInfo {
+                    {},
+                    queueFamilies.compute,
+                    vk::ArrayProxyNoTemporaries<const float>(priority),
+                };
+            },
+        };
+    }
+};
+
+struct Gpu : vku::Gpu<QueueFamilies, Queues> {
+    explicit Gpu(const vk::raii::Instance &instance [[clang::lifetimebound]])
+        : vku::Gpu<QueueFamilies, Queues> { instance, vku::Gpu<QueueFamilies, Queues>::Config {
+            .verbose = true,
+#if __APPLE__
+            .deviceExtensions = {
+                vk::KHRPortabilitySubsetExtensionName,
+            },
+#endif
+            .apiVersion = vk::makeApiVersion(0, 1, 1, 0),
+        } } { }
+};
+
+int main() {
+#if VULKAN_HPP_DISPATCH_LOADER_DYNAMIC == 1
+    VULKAN_HPP_DEFAULT_DISPATCHER.init();
+#endif
+
+    const vk::raii::Context context;
+
+    const vk::raii::Instance instance { context, vk::InstanceCreateInfo {
+#if __APPLE__
+        vk::InstanceCreateFlagBits::eEnumeratePortabilityKHR,
+#else
+        {},
+#endif
+        vku::unsafeAddress(vk::ApplicationInfo {
+            "vku_test_image_view_cache", 0,
+            {}, 0,
+            vk::makeApiVersion(0, 1, 1, 0),
+        }),
+        {},
+#if __APPLE__
+        vku::unsafeProxy({
+            vk::KHRPortabilityEnumerationExtensionName,
+        }),
+#endif
+    } };
+#if VULKAN_HPP_DISPATCH_LOADER_DYNAMIC == 1
+    VULKAN_HPP_DEFAULT_DISPATCHER.init(*instance);
+#endif
+
+    const Gpu gpu { instance };
+
+    // Images must outlive the cache, which must outlive the attachment groups.
+    const auto createImage = [&] {
+        return vku::AllocatedImage { gpu.allocator, vk::ImageCreateInfo {
+            {},
+            vk::ImageType::e2D,
+            vk::Format::eR8G8B8A8Unorm,
+            vk::Extent3D { 16, 16, 1 },
+            1, 1,
+            vk::SampleCountFlagBits::e1,
+            vk::ImageTiling::eOptimal,
+            vk::ImageUsageFlagBits::eColorAttachment | vk::ImageUsageFlagBits::eSampled,
+        } };
+    };
+    const vku::AllocatedImage image1 = createImage();
+    const vku::AllocatedImage image2 = createImage();
+
+    vku::ImageViewCache imageViewCache { gpu.device };
+
+    // --------------------
+    // Deduplication by create info and pNext.
+    // --------------------
+
+    const vk::ImageViewCreateInfo createInfo {
+        {},
+        image1,
+        vk::ImageViewType::e2D,
+        image1.format,
+        {},
+        vku::fullSubresourceRange(),
+    };
+
+    const vku::SharedImageView view = imageViewCache.get(createInfo);
+    assert(imageViewCache.size() == 1);
+    assert(*imageViewCache.get(createInfo) == *view && "Same create info must return the same view");
+    assert(imageViewCache.size() == 1);
+
+    // Different format -> different view.
+    const vku::SharedImageView srgbView = imageViewCache.get(vk::ImageViewCreateInfo { createInfo }.setFormat(vk::Format::eR8G8B8A8Srgb));
+    assert(*srgbView != *view);
+    assert(imageViewCache.size() == 2);
+
+    // Recognized pNext (usage) is a part of the key.
+    const vk::ImageViewUsageCreateInfo usageCreateInfo { vk::ImageUsageFlagBits::eSampled };
+    const vku::SharedImageView sampledView = imageViewCache.get(vk::ImageViewCreateInfo { createInfo }.setPNext(&usageCreateInfo));
+    assert(*sampledView != *view && "Usage pNext must produce a distinct view");
+    assert(imageViewCache.size() == 3);
+    assert(*imageViewCache.get(vk::ImageViewCreateInfo { createInfo }.setPNext(&usageCreateInfo)) == *sampledView);
+    assert(imageViewCache.size() == 3);
+
+    // Eviction removes every view of the image, but the outstanding references remain valid.
+    assert(imageViewCache.evict(image2) == 0);
+    assert(imageViewCache.evict(image1) == 3);
+    assert(imageViewCache.size() == 0);
+    assert(view && *view);
+    assert(*imageViewCache.get(createInfo) != vk::ImageView{} && imageViewCache.size() == 1);
+    imageViewCache.clear();
+    assert(imageViewCache.size() == 0);
+
+    // --------------------
+    // Eviction on attachment group destruction.
+    // --------------------
+
+    {
+        vku::AttachmentGroup group1 { { 16, 16 } };
+        group1.imageViewCache = &imageViewCache;
+        vku::AttachmentGroup group2 { { 16, 16 } };
+        group2.imageViewCache = &imageViewCache;
+
+        const vku::Attachment &attachment1 = group1.addColorAttachment(gpu.device, image1);
+        const vku::Attachment &attachment2 = group2.addColorAttachment(gpu.device, image1);
+        assert(*attachment1.view == *attachment2.view && "Groups sharing the cache must share the view");
+        assert(imageViewCache.size() == 1);
+    }
+    assert(imageViewCache.size() == 0 && "Group destruction must evict the cached views");
+
+    // --------------------
+    // Eviction on attachment group move assignment.
+    // --------------------
+
+    {
+        vku::AttachmentGroup group1 { { 16, 16 } };
+        group1.imageViewCache = &imageViewCache;
+        group1.addColorAttachment(gpu.device, image1);
+
+        vku::AttachmentGroup group2 { { 16, 16 } };
+        group2.imageViewCache = &imageViewCache;
+        group2.addColorAttachment(gpu.device, image2);
+        assert(imageViewCache.size() == 2);
+
+        // group2's previous views (of image2) are evicted, group1's views are taken over.
+        group2 = std::move(group1);
+        assert(imageViewCache.size() == 1);
+        assert(imageViewCache.evict(image2) == 0);
+    }
+    assert(imageViewCache.size() == 0 && "Moved-to group must evict the taken over views");
+}
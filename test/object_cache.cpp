@@ -0,0 +1,141 @@
+#include <cassert>
+
+#include <vulkan/vulkan_hpp_macros.hpp>
+
+import std;
+import vku;
+
+#if VULKAN_HPP_DISPATCH_LOADER_DYNAMIC == 1
+VULKAN_HPP_DEFAULT_DISPATCH_LOADER_DYNAMIC_STORAGE
+#endif
+
+struct QueueFamilies {
+    std::uint32_t compute;
+
+    explicit QueueFamilies(vk::PhysicalDevice physicalDevice)
+        : compute { vku::getComputeQueueFamily(physicalDevice.getQueueFamilyProperties()).value() } { }
+};
+
+struct Queues {
+    Queues(vk::Device, const QueueFamilies&) { }
+
+    [[nodiscard]] static auto getCreateInfos(vk::PhysicalDevice, const QueueFamilies &queueFamilies) noexcept -> vku::RefHolder<vk::DeviceQueueCreateInfo> {
+        return vku::RefHolder {
+            [&]() {
+                static constexpr float priority = 1.f;
+                return vk::DeviceQueueCreateInfo {
+                    {},
+                    queueFamilies.compute,
+                    vk::ArrayProxyNoTemporaries<const float>(priority),
+                };
+            },
+        };
+    }
+};
+
+struct Gpu : vku::Gpu<QueueFamilies, Queues> {
+    explicit Gpu(const vk::raii::Instance &instance [[clang::lifetimebound]])
+        : vku::Gpu<QueueFamilies, Queues> { instance, vku::Gpu<QueueFamilies, Queues>::Config {
+            .verbose = true,
+#if __APPLE__
+            .deviceExtensions = {
+                vk::KHRPortabilitySubsetExtensionName,
+            },
+#endif
+        } } { }
+};
+
+using StorageBufferLayout = vku::DescriptorSetLayout<vk::DescriptorType::eStorageBuffer>;
+
+// Distinct layout type with the same bindings.
+struct MyStorageBufferLayout : StorageBufferLayout {
+    using StorageBufferLayout::StorageBufferLayout;
+};
+
+int main() {
+#if VULKAN_HPP_DISPATCH_LOADER_DYNAMIC == 1
+    VULKAN_HPP_DEFAULT_DISPATCHER.init();
+#endif
+
+    const vk::raii::Context context;
+
+    const vk::raii::Instance instance { context, vk::InstanceCreateInfo {
+#if __APPLE__
+        vk::InstanceCreateFlagBits::eEnumeratePortabilityKHR,
+#else
+        {},
+#endif
+        vku::unsafeAddress(vk::ApplicationInfo {
+            "vku_test_object_cache", 0,
+            {}, 0,
+            vk::makeApiVersion(0, 1, 0, 0),
+        }),
+        {},
+#if __APPLE__
+        vku::unsafeProxy({
+            vk::KHRGetPhysicalDeviceProperties2ExtensionName,
+            vk::KHRPortabilityEnumerationExtensionName,
+        }),
+#endif
+    } };
+#if VULKAN_HPP_DISPATCH_LOADER_DYNAMIC == 1
+    VULKAN_HPP_DEFAULT_DISPATCHER.init(*instance);
+#endif
+
+    const Gpu gpu { instance };
+    vku::DeviceObjectCache objectCache { gpu.device };
+
+    // Samplers with the same create info contents must be deduplicated.
+    const vk::SamplerCreateInfo linearSamplerCreateInfo {
+        {},
+        vk::Filter::eLinear, vk::Filter::eLinear, vk::SamplerMipmapMode::eLinear,
+        {}, {}, {},
+        {}, {}, {},
+        {}, {},
+        0.f, 1000.f,
+    };
+    const std::shared_ptr linearSampler = objectCache.getSampler(linearSamplerCreateInfo);
+    assert(objectCache.getSampler(linearSamplerCreateInfo) == linearSampler);
+    assert(objectCache.getSampler(vk::SamplerCreateInfo { linearSamplerCreateInfo }.setMagFilter(vk::Filter::eNearest)) != linearSampler);
+    assert(objectCache.size() == 2);
+
+    // Typed layouts of any type and the untyped layout with the same create info must share a single handle.
+    const vk::DescriptorSetLayoutCreateInfo layoutCreateInfo {
+        {},
+        vku::unsafeProxy(StorageBufferLayout::getBindings({ 1, vk::ShaderStageFlagBits::eCompute })),
+    };
+    std::shared_ptr untypedLayout = objectCache.getDescriptorSetLayout(layoutCreateInfo);
+    const std::shared_ptr typedLayout = objectCache.getDescriptorSetLayout<StorageBufferLayout>(layoutCreateInfo);
+    const std::shared_ptr myTypedLayout = objectCache.getDescriptorSetLayout<MyStorageBufferLayout>(layoutCreateInfo);
+    assert(objectCache.getDescriptorSetLayout(layoutCreateInfo) == untypedLayout);
+    assert(**typedLayout == **untypedLayout);
+    assert(**myTypedLayout == **untypedLayout);
+    assert(typedLayout->descriptorCounts == std::array { 1U });
+    assert(objectCache.size() == 3);
+
+    // Therefore, the pipeline layouts created from them are also deduplicated.
+    const std::shared_ptr pipelineLayout = objectCache.getPipelineLayout(vk::PipelineLayoutCreateInfo { {}, **typedLayout });
+    assert(objectCache.getPipelineLayout(vk::PipelineLayoutCreateInfo { {}, **untypedLayout }) == pipelineLayout);
+    assert(objectCache.size() == 4);
+
+    // Concurrent cache misses of the same key must be resolved into a single object.
+    const vk::SamplerCreateInfo nearestSamplerCreateInfo = vk::SamplerCreateInfo { linearSamplerCreateInfo }.setMipmapMode(vk::SamplerMipmapMode::eNearest);
+    std::vector<std::shared_ptr<const vk::raii::Sampler>> nearestSamplers(8);
+    {
+        std::vector<std::jthread> threads;
+        for (std::shared_ptr<const vk::raii::Sampler> &sampler : nearestSamplers) {
+            threads.emplace_back([&]() {
+                sampler = objectCache.getSampler(nearestSamplerCreateInfo);
+            });
+        }
+    }
+    assert(std::ranges::all_of(nearestSamplers, [&](const auto &sampler) { return sampler == nearestSamplers.front(); }));
+    assert(objectCache.size() == 5);
+
+    // Typed layouts must keep the shared handle alive after the cache is cleared.
+    objectCache.clear();
+    assert(objectCache.size() == 0);
+    untypedLayout.reset();
+    const std::shared_ptr newPipelineLayout = objectCache.getPipelineLayout(vk::PipelineLayoutCreateInfo { {}, **typedLayout });
+    assert(newPipelineLayout != pipelineLayout);
+}
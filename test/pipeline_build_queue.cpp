@@ -0,0 +1,206 @@
+#include <cassert>
+
+#include <vulkan/vulkan_hpp_macros.hpp>
+
+import std;
+import vku;
+
+#if VULKAN_HPP_DISPATCH_LOADER_DYNAMIC == 1
+VULKAN_HPP_DEFAULT_DISPATCH_LOADER_DYNAMIC_STORAGE
+#endif
+
+// OpEntryPoint GLCompute %1 "main"; OpExecutionMode %1 LocalSize 1 1 1; void main() { }
+constexpr std::array emptyComputeSpirv {
+    0x07230203U, 0x00010000U, 0U, 5U, 0U,
+    0x00020011U, 1U, // OpCapability Shader
+    0x0003000EU, 0U, 1U, // OpMemoryModel Logical GLSL450
+    0x0005000FU, 5U, 1U, 0x6E69616DU, 0U, // OpEntryPoint GLCompute %1 "main"
+    0x00060010U, 1U, 17U, 1U, 1U, 1U, // OpExecutionMode %1 LocalSize 1 1 1
+    0x00020013U, 2U, // %2 = OpTypeVoid
+    0x00030021U, 3U, 2U, // %3 = OpTypeFunction %2
+    0x00050036U, 2U, 1U, 0U, 3U, // %1 = OpFunction %2 None %3
+    0x000200F8U, 4U, // %4 = OpLabel
+    0x000100FDU, // OpReturn
+    0x00010038U, // OpFunctionEnd
+};
+
+struct QueueFamilies {
+    std::uint32_t compute;
+
+    explicit QueueFamilies(vk::PhysicalDevice physicalDevice)
+        : compute { vku::getComputeQueueFamily(physicalDevice.getQueueFamilyProperties()).value() } { }
+};
+
+struct Queues {
+    vk::Queue compute;
+
+    Queues(vk::Device device, const QueueFamilies &queueFamilies)
+        : compute { device.getQueue(queueFamilies.compute, 0) } { }
+
+    [[nodiscard]] static auto getCreateInfos(vk::PhysicalDevice, const QueueFamilies &queueFamilies) noexcept -> vku::RefHolder<vk::DeviceQueueCreateInfo> {
+        return vku::RefHolder {
+            [&]() {
+                static constexpr float priority = 1.f;
+                return vk::DeviceQueueCreateInfo {
+                    {},
+                    queueFamilies.compute,
+                    vk::ArrayProxyNoTemporaries<const float>(priority),
+                };
+            },
+        };
+    }
+};
+
+struct Gpu : vku::Gpu<QueueFamilies, Queues> {
+    explicit Gpu(const vk::raii::Instance &instance [[clang::lifetimebound]])
+        : vku::Gpu<QueueFamilies, Queues> { instance, vku::Gpu<QueueFamilies, Queues>::Config {
+            .verbose = true,
+#if __APPLE__
+            .deviceExtensions = {
+                vk::KHRPortabilitySubsetExtensionName,
+            },
+#endif
+        } } { }
+};
+
+int main() {
+#if VULKAN_HPP_DISPATCH_LOADER_DYNAMIC == 1
+    VULKAN_HPP_DEFAULT_DISPATCHER.init();
+#endif
+
+    const vk::raii::Context context;
+
+    const vk::raii::Instance instance { context, vk::InstanceCreateInfo {
+#if __APPLE__
+        vk::InstanceCreateFlagBits::eEnumeratePortabilityKHR,
+#else
+        {},
+#endif
+        vku::unsafeAddress(vk::ApplicationInfo {
+            "vku_test_pipeline_build_queue", 0,
+            {}, 0,
+            vk::makeApiVersion(0, 1, 0, 0),
+        }),
+        {},
+#if __APPLE__
+        vku::unsafeProxy({
+            vk::KHRGetPhysicalDeviceProperties2ExtensionName,
+            vk::KHRPortabilityEnumerationExtensionName,
+        }),
+#endif
+    } };
+#if VULKAN_HPP_DISPATCH_LOADER_DYNAMIC == 1
+    VULKAN_HPP_DEFAULT_DISPATCHER.init(*instance);
+#endif
+
+    const Gpu gpu { instance };
+
+    const vk::raii::PipelineLayout pipelineLayout { gpu.device, vk::PipelineLayoutCreateInfo{} };
+    const vk::raii::PipelineCache pipelineCache { gpu.device, vk::PipelineCacheCreateInfo{} };
+
+    constexpr std::size_t threadCount = 4;
+    constexpr std::size_t requestCountPerThread = 8;
+
+    std::vector<vk::raii::Pipeline> pipelines;
+    {
+        vku::PipelineBuildQueue buildQueue { gpu.device, &pipelineCache, 3 };
+
+        // Enqueue the requests of both priorities from the multiple threads at once.
+        std::vector<std::future<vk::raii::Pipeline>> futures(threadCount * requestCountPerThread);
+        {
+            std::vector<std::jthread> threads;
+            for (std::size_t threadIndex = 0; threadIndex < threadCount; ++threadIndex) {
+                threads.emplace_back([&, threadIndex]() {
+                    for (std::size_t i = 0; i < requestCountPerThread; ++i) {
+                        futures[threadIndex * requestCountPerThread + i] = buildQueue.enqueue([&] {
+                            return vku::RefHolder {
+                                [&](const auto &stages) { return vk::ComputePipelineCreateInfo { {}, get<0>(stages.get()), *pipelineLayout }; },
+                                vku::createPipelineStages(gpu.device, vku::Shader { emptyComputeSpirv, vk::ShaderStageFlagBits::eCompute }),
+                            };
+                        }, i % 2 == 0 ? vku::PipelineBuildQueue::Priority::Load : vku::PipelineBuildQueue::Priority::WarmUp);
+                    }
+                });
+            }
+        }
+
+        // Exception thrown by the factory must be stored in its future, without affecting the other requests.
+        std::future failed = buildQueue.enqueue([]() -> vk::ComputePipelineCreateInfo {
+            throw std::runtime_error { "Factory failure" };
+        });
+
+        for (std::future<vk::raii::Pipeline> &future : futures) {
+            pipelines.push_back(future.get());
+        }
+
+        try {
+            std::ignore = failed.get();
+            return 1;
+        }
+        catch (const std::runtime_error&) { }
+
+        assert(buildQueue.getPendingCount() == 0);
+    }
+
+    // Every request must produce its own valid pipeline.
+    assert(pipelines.size() == threadCount * requestCountPerThread);
+    std::vector<vk::Pipeline> handles = pipelines | std::views::transform([](const vk::raii::Pipeline &pipeline) { return *pipeline; }) | std::ranges::to<std::vector>();
+    assert(std::ranges::none_of(handles, [](vk::Pipeline handle) { return !handle; }));
+    std::ranges::sort(handles);
+    assert(std::ranges::adjacent_find(handles) == handles.end());
+
+    // Destruction must abandon the requests that are not started yet, instead of compiling all of them.
+    {
+        const auto createInfoFactory = [&] {
+            return vku::RefHolder {
+                [&](const auto &stages) { return vk::ComputePipelineCreateInfo { {}, get<0>(stages.get()), *pipelineLayout }; },
+                vku::createPipelineStages(gpu.device, vku::Shader { emptyComputeSpirv, vk::ShaderStageFlagBits::eCompute }),
+            };
+        };
+
+        std::optional<vku::PipelineBuildQueue> buildQueue { std::in_place, gpu.device, nullptr, 1 };
+
+        // Occupy the only worker until the destruction starts.
+        std::binary_semaphore started { 0 }, released { 0 };
+        std::future running = buildQueue->enqueue([&] {
+            started.release();
+            released.acquire();
+            return createInfoFactory();
+        });
+
+        std::vector<std::future<vk::raii::Pipeline>> pendings;
+        for (std::size_t i = 0; i < 4; ++i) {
+            pendings.push_back(buildQueue->enqueue(createInfoFactory, vku::PipelineBuildQueue::Priority::WarmUp));
+        }
+
+        started.acquire();
+        {
+            const std::jthread releaser { [&] {
+                std::this_thread::sleep_for(std::chrono::milliseconds { 100 });
+                released.release();
+            } };
+            buildQueue.reset();
+        }
+
+        // The running request is finished, but the pending ones are abandoned.
+        assert(*running.get());
+        for (std::future<vk::raii::Pipeline> &pending : pendings) {
+            try {
+                std::ignore = pending.get();
+                return 1;
+            }
+            catch (const std::future_error &e) {
+                assert(e.code() == std::future_errc::broken_promise);
+            }
+        }
+    }
+
+    // The pipelines must be usable.
+    const vk::raii::CommandPool commandPool { gpu.device, vk::CommandPoolCreateInfo { {}, gpu.queueFamilies.compute } };
+    vku::executeSingleCommand(*gpu.device, *commandPool, gpu.queues.compute, [&](vk::CommandBuffer cb) {
+        for (const vk::raii::Pipeline &pipeline : pipelines) {
+            cb.bindPipeline(vk::PipelineBindPoint::eCompute, *pipeline);
+            cb.dispatch(1, 1, 1);
+        }
+    });
+    gpu.queues.compute.waitIdle();
+}
@@ -0,0 +1,194 @@
+#include <cassert>
+
+#include <vulkan/vulkan_hpp_macros.hpp>
+
+import std;
+import vku;
+
+#if VULKAN_HPP_DISPATCH_LOADER_DYNAMIC == 1
+VULKAN_HPP_DEFAULT_DISPATCH_LOADER_DYNAMIC_STORAGE
+#endif
+
+// OpEntryPoint GLCompute %1 "main"; OpExecutionMode %1 LocalSize 1 1 1; void main() { }
+constexpr std::array emptyComputeSpirv {
+    0x07230203U, 0x00010000U, 0U, 5U, 0U,
+    0x00020011U, 1U, // OpCapability Shader
+    0x0003000EU, 0U, 1U, // OpMemoryModel Logical GLSL450
+    0x0005000FU, 5U, 1U, 0x6E69616DU, 0U, // OpEntryPoint GLCompute %1 "main"
+    0x00060010U, 1U, 17U, 1U, 1U, 1U, // OpExecutionMode %1 LocalSize 1 1 1
+    0x00020013U, 2U, // %2 = OpTypeVoid
+    0x00030021U, 3U, 2U, // %3 = OpTypeFunction %2
+    0x00050036U, 2U, 1U, 0U, 3U, // %1 = OpFunction %2 None %3
+    0x000200F8U, 4U, // %4 = OpLabel
+    0x000100FDU, // OpReturn
+    0x00010038U, // OpFunctionEnd
+};
+
+struct QueueFamilies {
+    std::uint32_t compute;
+
+    explicit QueueFamilies(vk::PhysicalDevice physicalDevice)
+        : QueueFamilies { physicalDevice.getQueueFamilyProperties() } { }
+
+private:
+    // Prefer the compute-only queue family, whose queues cannot query the graphics pipeline statistics.
+    explicit QueueFamilies(std::span<const vk::QueueFamilyProperties> queueFamilyProperties)
+        : compute { vku::getComputeSpecializedQueueFamily(queueFamilyProperties)
+            .or_else([&] {
+                return vku::getComputeQueueFamily(queueFamilyProperties);
+            })
+            .value() } { }
+};
+
+struct Queues {
+    vk::Queue compute;
+
+    Queues(vk::Device device, const QueueFamilies &queueFamilies)
+        : compute { device.getQueue(queueFamilies.compute, 0) } { }
+
+    [[nodiscard]] static auto getCreateInfos(vk::PhysicalDevice, const QueueFamilies &queueFamilies) noexcept -> vku::RefHolder<vk::DeviceQueueCreateInfo> {
+        return vku::RefHolder {
+            [&]() {
+                static constexpr float priority = 1.f;
+                return vk::DeviceQueueCreateInfo {
+                    {},
+                    queueFamilies.compute,
+                    vk::ArrayProxyNoTemporaries<const float>(priority),
+                };
+            },
+        };
+    }
+};
+
+struct Gpu : vku::Gpu<QueueFamilies, Queues> {
+    explicit Gpu(const vk::raii::Instance &instance [[clang::lifetimebound]])
+        : vku::Gpu<QueueFamilies, Queues> { instance, vku::Gpu<QueueFamilies, Queues>::Config {
+            .verbose = true,
+            .deviceExtensions = {
+#if __APPLE__
+                vk::KHRPortabilitySubsetExtensionName,
+#endif
+            },
+            .physicalDeviceFeatures = [] {
+                vk::PhysicalDeviceFeatures features;
+                features.pipelineStatisticsQuery = true;
+                return features;
+            }(),
+        } } { }
+};
+
+int main() {
+    {
+        // Zero capacity is rejected, instead of dividing by zero in push().
+        try {
+            std::ignore = vku::RollingHistogram { 0 };
+            return 1;
+        }
+        catch (const std::invalid_argument&) { }
+
+        // Only the most recent 4 samples (7, 8, 9, 10) are kept.
+        vku::RollingHistogram histogram { 4 };
+        assert(!histogram.getSummary());
+        for (std::uint64_t value = 1; value <= 10; ++value) {
+            histogram.push(value);
+        }
+        assert(histogram.size() == 4);
+
+        const vku::RollingHistogram::Summary summary = histogram.getSummary().value();
+        assert(summary.min == 7);
+        assert(summary.max == 10);
+        assert(summary.mean == 8.5);
+        assert(summary.p50 == 8);
+        assert(summary.p95 == 9);
+
+        const std::array bucketCounts = histogram.getBucketCounts();
+        assert(bucketCounts[3] == 1); // 7 in [4, 8)
+        assert(bucketCounts[4] == 3); // 8, 9, 10 in [8, 16)
+
+        // Percentiles of a single sample must be the sample itself.
+        vku::RollingHistogram single { 1 };
+        single.push(42);
+        assert(single.getSummary()->p50 == 42 && single.getSummary()->p95 == 42);
+    }
+
+#if VULKAN_HPP_DISPATCH_LOADER_DYNAMIC == 1
+    VULKAN_HPP_DEFAULT_DISPATCHER.init();
+#endif
+
+    const vk::raii::Context context;
+
+    const vk::raii::Instance instance { context, vk::InstanceCreateInfo {
+#if __APPLE__
+        vk::InstanceCreateFlagBits::eEnumeratePortabilityKHR,
+#else
+        {},
+#endif
+        vku::unsafeAddress(vk::ApplicationInfo {
+            "vku_test_pipeline_counters", 0,
+            {}, 0,
+            vk::makeApiVersion(0, 1, 0, 0),
+        }),
+        {},
+#if __APPLE__
+        vku::unsafeProxy({
+            vk::KHRGetPhysicalDeviceProperties2ExtensionName,
+            vk::KHRPortabilityEnumerationExtensionName,
+        }),
+#endif
+    } };
+#if VULKAN_HPP_DISPATCH_LOADER_DYNAMIC == 1
+    VULKAN_HPP_DEFAULT_DISPATCHER.init(*instance);
+#endif
+
+    // pipelineStatisticsQuery is optional; skip the rest if no physical device supports it.
+    if (std::ranges::none_of(instance.enumeratePhysicalDevices(), [](const vk::raii::PhysicalDevice &physicalDevice) {
+        return static_cast<bool>(physicalDevice.getFeatures().pipelineStatisticsQuery);
+    })) {
+        std::cerr << "pipelineStatisticsQuery is not supported, skipping the test.\n";
+        return 0;
+    }
+
+    const Gpu gpu { instance };
+
+    // Statistics outside graphicsPipelineStatistics, or no statistics at all, are rejected.
+    try {
+        std::ignore = vku::PipelineCounters { gpu.device, 1, 4, 8, false, vk::QueryPipelineStatisticFlagBits::eInputAssemblyVertices };
+        return 1;
+    }
+    catch (const std::invalid_argument&) { }
+    try {
+        std::ignore = vku::PipelineCounters { gpu.device, 1, 4, 8, false, {} };
+        return 1;
+    }
+    catch (const std::invalid_argument&) { }
+
+    const vk::raii::PipelineLayout pipelineLayout { gpu.device, vk::PipelineLayoutCreateInfo{} };
+    const vk::raii::Pipeline pipeline { gpu.device, nullptr, vk::ComputePipelineCreateInfo {
+        {},
+        vku::createPipelineStages(gpu.device, vku::Shader { emptyComputeSpirv, vk::ShaderStageFlagBits::eCompute }).get()[0],
+        *pipelineLayout,
+    } };
+
+    // Compute-only statistics can be queried on any compute queue.
+    vku::PipelineCounters counters { gpu.device, 1, 4, 8, false, vku::PipelineCounters::computePipelineStatistics };
+
+    const vk::raii::CommandPool commandPool { gpu.device, vk::CommandPoolCreateInfo { {}, gpu.queueFamilies.compute } };
+    vku::executeSingleCommand(*gpu.device, *commandPool, gpu.queues.compute, [&](vk::CommandBuffer cb) {
+        counters.beginFrame(0, cb);
+
+        const vku::PipelineCounters::Scope scope = counters.scope(cb, "Dispatch", false);
+        cb.bindPipeline(vk::PipelineBindPoint::eCompute, *pipeline);
+        cb.dispatch(4, 1, 1);
+    });
+    gpu.queues.compute.waitIdle();
+
+    // Beginning the frame again collects the results of its previous use.
+    vku::executeSingleCommand(*gpu.device, *commandPool, gpu.queues.compute, [&](vk::CommandBuffer cb) {
+        counters.beginFrame(0, cb);
+    });
+    gpu.queues.compute.waitIdle();
+
+    assert(counters.getLabels() == std::vector<std::string> { "Dispatch" });
+    assert(counters.getSummary("Dispatch", vku::PipelineCounters::Counter::ComputeShaderInvocations)->max >= 4);
+    assert(!counters.getSummary("Dispatch", vku::PipelineCounters::Counter::FragmentShaderInvocations) && "Not queried");
+}
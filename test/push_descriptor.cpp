@@ -0,0 +1,120 @@
+#include <cassert>
+
+#include <vulkan/vulkan_hpp_macros.hpp>
+
+import std;
+import vku;
+
+#if VULKAN_HPP_DISPATCH_LOADER_DYNAMIC == 1
+VULKAN_HPP_DEFAULT_DISPATCH_LOADER_DYNAMIC_STORAGE
+#endif
+
+struct QueueFamilies {
+    std::uint32_t compute;
+
+    explicit QueueFamilies(vk::PhysicalDevice physicalDevice)
+        : compute { vku::getComputeQueueFamily(physicalDevice.getQueueFamilyProperties()).value() } { }
+};
+
+struct Queues {
+    vk::Queue compute;
+
+    Queues(vk::Device device, const QueueFamilies &queueFamilies)
+        : compute { device.getQueue(queueFamilies.compute, 0) } { }
+
+    [[nodiscard]] static auto getCreateInfos(vk::PhysicalDevice, const QueueFamilies &queueFamilies) noexcept -> vku::RefHolder<vk::DeviceQueueCreateInfo> {
+        return vku::RefHolder {
+            [&]() {
+                static constexpr float priority = 1.f;
+                return vk::DeviceQueueCreateInfo {
+                    {},
+                    queueFamilies.compute,
+                    vk::ArrayProxyNoTemporaries<const float>(priority),
+                };
+            },
+        };
+    }
+};
+
+struct Gpu : vku::Gpu<QueueFamilies, Queues> {
+    explicit Gpu(const vk::raii::Instance &instance [[clang::lifetimebound]])
+        : vku::Gpu<QueueFamilies, Queues> { instance, vku::Gpu<QueueFamilies, Queues>::Config {
+            .verbose = true,
+            .deviceExtensions = {
+                vk::KHRPushDescriptorExtensionName,
+#if __APPLE__
+                vk::KHRPortabilitySubsetExtensionName,
+#endif
+            },
+        } } { }
+};
+
+int main() {
+#if VULKAN_HPP_DISPATCH_LOADER_DYNAMIC == 1
+    VULKAN_HPP_DEFAULT_DISPATCHER.init();
+#endif
+
+    const vk::raii::Context context;
+
+    const vk::raii::Instance instance { context, vk::InstanceCreateInfo {
+#if __APPLE__
+        vk::InstanceCreateFlagBits::eEnumeratePortabilityKHR,
+#else
+        {},
+#endif
+        vku::unsafeAddress(vk::ApplicationInfo {
+            "vku_test_push_descriptor", 0,
+            {}, 0,
+            vk::makeApiVersion(0, 1, 0, 0),
+        }),
+        {},
+#if __APPLE__
+        vku::unsafeProxy({
+            vk::KHRGetPhysicalDeviceProperties2ExtensionName,
+            vk::KHRPortabilityEnumerationExtensionName,
+        }),
+#endif
+    } };
+#if VULKAN_HPP_DISPATCH_LOADER_DYNAMIC == 1
+    VULKAN_HPP_DEFAULT_DISPATCHER.init(*instance);
+#endif
+
+    const Gpu gpu { instance };
+
+    using Layout = vku::DescriptorSetLayout<vk::DescriptorType::eUniformBuffer, vk::DescriptorType::eStorageBuffer>;
+    const Layout descriptorSetLayout { gpu.device, vk::DescriptorSetLayoutCreateInfo {
+        vk::DescriptorSetLayoutCreateFlagBits::ePushDescriptorKHR,
+        vku::unsafeProxy(Layout::getBindings(
+            { 1, vk::ShaderStageFlagBits::eCompute },
+            { 1, vk::ShaderStageFlagBits::eCompute })),
+    } };
+
+    const vk::raii::PipelineLayout pipelineLayout { gpu.device, vk::PipelineLayoutCreateInfo {
+        {},
+        *descriptorSetLayout,
+    } };
+
+    const vku::AllocatedBuffer uniformBuffer { gpu.allocator, vk::BufferCreateInfo {
+        {},
+        512,
+        vk::BufferUsageFlagBits::eUniformBuffer,
+    } };
+    const vku::AllocatedBuffer storageBuffer { gpu.allocator, vk::BufferCreateInfo {
+        {},
+        512,
+        vk::BufferUsageFlagBits::eStorageBuffer,
+    } };
+
+    // Push the descriptors twice with the different ranges, as a per-draw update would do. Offsets are multiples of 256,
+    // the largest allowed min{Uniform,Storage}BufferOffsetAlignment.
+    const vk::raii::CommandPool commandPool { gpu.device, vk::CommandPoolCreateInfo { {}, gpu.queueFamilies.compute } };
+    vku::executeSingleCommand(*gpu.device, *commandPool, gpu.queues.compute, [&](vk::CommandBuffer cb) {
+        for (vk::DeviceSize offset : { 0, 256 }) {
+            Layout::cmdPushDescriptorSet<0, 1>(
+                gpu.device, cb, vk::PipelineBindPoint::eCompute, *pipelineLayout, 0,
+                vk::DescriptorBufferInfo { uniformBuffer, offset, 256 },
+                vk::DescriptorBufferInfo { storageBuffer, offset, 256 });
+        }
+    });
+    gpu.queues.compute.waitIdle();
+}
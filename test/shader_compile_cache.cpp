@@ -0,0 +1,117 @@
+#include <cassert>
+
+#include <shaderc/shaderc.hpp>
+#include <vulkan/vulkan_hpp_macros.hpp>
+
+import std;
+import vku;
+
+#if VULKAN_HPP_DISPATCH_LOADER_DYNAMIC == 1
+VULKAN_HPP_DEFAULT_DISPATCH_LOADER_DYNAMIC_STORAGE
+#endif
+
+constexpr std::string_view glsl = R"glsl(
+#version 450
+layout (set = 0, binding = 0) writeonly buffer OutputBuffer { uint data; };
+void main() { data = VALUE; }
+)glsl";
+
+[[nodiscard]] auto getCompileOptions() -> shaderc::CompileOptions {
+    shaderc::CompileOptions compileOptions;
+    compileOptions.SetTargetEnvironment(shaderc_target_env_vulkan, shaderc_env_version_vulkan_1_0);
+    compileOptions.AddMacroDefinition("VALUE", "1u");
+    return compileOptions;
+}
+
+[[nodiscard]] auto getCacheFiles(const std::filesystem::path &directory) -> std::vector<std::filesystem::path> {
+    return std::filesystem::directory_iterator { directory }
+        | std::views::transform([](const std::filesystem::directory_entry &entry) { return entry.path(); })
+        | std::ranges::to<std::vector>();
+}
+
+void writeFile(const std::filesystem::path &path, std::span<const std::byte> bytes) {
+    std::ofstream file { path, std::ios::binary | std::ios::trunc };
+    file.write(reinterpret_cast<const char*>(bytes.data()), bytes.size());
+    assert(file);
+}
+
+int main() {
+    const std::filesystem::path directory = std::filesystem::temp_directory_path() / "vku_test_shader_compile_cache";
+    std::filesystem::remove_all(directory);
+
+    const vku::ShaderCompileCache shaderCompileCache { directory, getCompileOptions(), "vulkan1.0;VALUE=1" };
+
+    // --------------------
+    // Cache miss: compiled and stored.
+    // --------------------
+
+    const std::vector spirv = shaderCompileCache.compile(glsl, vk::ShaderStageFlagBits::eCompute);
+    assert(!spirv.empty() && spirv[0] == 0x07230203U);
+
+    std::vector cacheFiles = getCacheFiles(directory);
+    assert(cacheFiles.size() == 1 && cacheFiles[0].extension() == ".spv" && "Temporary file must not be left");
+    const std::filesystem::path cachePath = cacheFiles[0];
+    assert(std::filesystem::file_size(cachePath) == spirv.size() * sizeof(std::uint32_t));
+
+    // --------------------
+    // Cache hit: the stored entry is returned without compilation.
+    // --------------------
+
+    // Mark the entry by appending a word, which would never be produced by the compiler.
+    std::vector markedSpirv = spirv;
+    markedSpirv.push_back(0xDEADBEEFU);
+    writeFile(cachePath, std::as_bytes(std::span { markedSpirv }));
+    assert(shaderCompileCache.compile(glsl, vk::ShaderStageFlagBits::eCompute) == markedSpirv && "Cache hit must return the stored entry");
+
+    // --------------------
+    // Cache misses for the different key components.
+    // --------------------
+
+    // Different compile options key.
+    const vku::ShaderCompileCache otherKeyCache { directory, getCompileOptions(), "vulkan1.0;VALUE=1;other" };
+    assert(otherKeyCache.compile(glsl, vk::ShaderStageFlagBits::eCompute) == spirv);
+    assert(getCacheFiles(directory).size() == 2);
+
+    // Different macro definition (reflected by the preprocessed source).
+    shaderc::CompileOptions otherCompileOptions = getCompileOptions();
+    otherCompileOptions.AddMacroDefinition("VALUE", "2u");
+    const vku::ShaderCompileCache otherMacroCache { directory, std::move(otherCompileOptions), "vulkan1.0;VALUE=1" };
+    assert(otherMacroCache.compile(glsl, vk::ShaderStageFlagBits::eCompute) != spirv);
+    assert(getCacheFiles(directory).size() == 3);
+
+    // --------------------
+    // Corrupted entries fall back to the compilation and are overwritten.
+    // --------------------
+
+    // Size is not a multiple of 4.
+    writeFile(cachePath, std::as_bytes(std::span { spirv }).first(7));
+    assert(shaderCompileCache.compile(glsl, vk::ShaderStageFlagBits::eCompute) == spirv);
+    assert(std::filesystem::file_size(cachePath) == spirv.size() * sizeof(std::uint32_t));
+
+    // Wrong magic number.
+    std::vector badMagicSpirv = spirv;
+    badMagicSpirv[0] = 0U;
+    writeFile(cachePath, std::as_bytes(std::span { badMagicSpirv }));
+    assert(shaderCompileCache.compile(glsl, vk::ShaderStageFlagBits::eCompute) == spirv);
+
+    // Empty file.
+    writeFile(cachePath, {});
+    assert(shaderCompileCache.compile(glsl, vk::ShaderStageFlagBits::eCompute) == spirv);
+    assert(getCacheFiles(directory).size() == 3);
+
+    // --------------------
+    // compileFiles with zero thread count.
+    // --------------------
+
+    const std::filesystem::path shaderPath = directory / "shader.comp";
+    writeFile(shaderPath, std::as_bytes(std::span { glsl }));
+    const std::array requests {
+        vku::ShaderCompileCache::FileRequest { shaderPath, vk::ShaderStageFlagBits::eCompute },
+        vku::ShaderCompileCache::FileRequest { shaderPath, vk::ShaderStageFlagBits::eCompute },
+    };
+    const std::vector spirvs = shaderCompileCache.compileFiles(requests, 0);
+    assert(spirvs.size() == 2 && spirvs[0] == spirv && spirvs[1] == spirv && "Zero thread count must still compile");
+    assert(shaderCompileCache.compileFiles({}, 0).empty());
+
+    std::filesystem::remove_all(directory);
+}
@@ -0,0 +1,132 @@
+#include <cassert>
+
+#include <vulkan/vulkan_hpp_macros.hpp>
+
+import std;
+import vku;
+
+#if VULKAN_HPP_DISPATCH_LOADER_DYNAMIC == 1
+VULKAN_HPP_DEFAULT_DISPATCH_LOADER_DYNAMIC_STORAGE
+#endif
+
+// OpEntryPoint GLCompute %1 "main"; OpExecutionMode %1 LocalSize 1 1 1; void main() { }
+constexpr std::array emptyComputeSpirv {
+    0x07230203U, 0x00010000U, 0U, 5U, 0U,
+    0x00020011U, 1U, // OpCapability Shader
+    0x0003000EU, 0U, 1U, // OpMemoryModel Logical GLSL450
+    0x0005000FU, 5U, 1U, 0x6E69616DU, 0U, // OpEntryPoint GLCompute %1 "main"
+    0x00060010U, 1U, 17U, 1U, 1U, 1U, // OpExecutionMode %1 LocalSize 1 1 1
+    0x00020013U, 2U, // %2 = OpTypeVoid
+    0x00030021U, 3U, 2U, // %3 = OpTypeFunction %2
+    0x00050036U, 2U, 1U, 0U, 3U, // %1 = OpFunction %2 None %3
+    0x000200F8U, 4U, // %4 = OpLabel
+    0x000100FDU, // OpReturn
+    0x00010038U, // OpFunctionEnd
+};
+
+struct QueueFamilies {
+    std::uint32_t graphics;
+
+    explicit QueueFamilies(vk::PhysicalDevice physicalDevice)
+        : graphics { vku::getGraphicsQueueFamily(physicalDevice.getQueueFamilyProperties()).value() } { }
+};
+
+struct Queues {
+    vk::Queue graphics;
+
+    Queues(vk::Device device, const QueueFamilies &queueFamilies)
+        : graphics { device.getQueue(queueFamilies.graphics, 0) } { }
+
+    [[nodiscard]] static auto getCreateInfos(vk::PhysicalDevice, const QueueFamilies &queueFamilies) noexcept -> vku::RefHolder<vk::DeviceQueueCreateInfo> {
+        return vku::RefHolder {
+            [&]() {
+                static constexpr float priority = 1.f;
+                return vk::DeviceQueueCreateInfo {
+                    {},
+                    queueFamilies.graphics,
+                    vk::ArrayProxyNoTemporaries<const float>(priority),
+                };
+            },
+        };
+    }
+};
+
+struct Gpu : vku::Gpu<QueueFamilies, Queues> {
+    explicit Gpu(const vk::raii::Instance &instance [[clang::lifetimebound]])
+        : vku::Gpu<QueueFamilies, Queues> { instance, vku::Gpu<QueueFamilies, Queues>::Config {
+            .verbose = true,
+            .deviceExtensions = {
+                vk::EXTShaderObjectExtensionName,
+                vk::KHRDynamicRenderingExtensionName,
+#if __APPLE__
+                vk::KHRPortabilitySubsetExtensionName,
+#endif
+            },
+            .devicePNexts = std::tuple {
+                vk::PhysicalDeviceShaderObjectFeaturesEXT { true },
+                vk::PhysicalDeviceDynamicRenderingFeatures { true },
+            },
+            .apiVersion = vk::makeApiVersion(0, 1, 2, 0),
+        } } { }
+};
+
+int main() {
+#if VULKAN_HPP_DISPATCH_LOADER_DYNAMIC == 1
+    VULKAN_HPP_DEFAULT_DISPATCHER.init();
+#endif
+
+    const vk::raii::Context context;
+
+    const vk::raii::Instance instance { context, vk::InstanceCreateInfo {
+#if __APPLE__
+        vk::InstanceCreateFlagBits::eEnumeratePortabilityKHR,
+#else
+        {},
+#endif
+        vku::unsafeAddress(vk::ApplicationInfo {
+            "vku_test_shader_object", 0,
+            {}, 0,
+            vk::makeApiVersion(0, 1, 2, 0),
+        }),
+        {},
+#if __APPLE__
+        vku::unsafeProxy({
+            vk::KHRGetPhysicalDeviceProperties2ExtensionName,
+            vk::KHRPortabilityEnumerationExtensionName,
+        }),
+#endif
+    } };
+#if VULKAN_HPP_DISPATCH_LOADER_DYNAMIC == 1
+    VULKAN_HPP_DEFAULT_DISPATCHER.init(*instance);
+#endif
+
+    // VK_EXT_shader_object is optional; skip the test if no physical device supports it.
+    const bool shaderObjectSupported = std::ranges::any_of(instance.enumeratePhysicalDevices(), [](const vk::raii::PhysicalDevice &physicalDevice) {
+        return std::ranges::any_of(physicalDevice.enumerateDeviceExtensionProperties(), [](const vk::ExtensionProperties &properties) {
+            return std::string_view { properties.extensionName } == vk::EXTShaderObjectExtensionName;
+        });
+    });
+    if (!shaderObjectSupported) {
+        std::cerr << "VK_EXT_shader_object is not supported, skipping the test.\n";
+        return 0;
+    }
+
+    const Gpu gpu { instance };
+
+    const vku::ShaderObjects shaderObjects = vku::createShaderObjects(
+        gpu.device, {}, {},
+        vku::Shader { emptyComputeSpirv, vk::ShaderStageFlagBits::eCompute });
+    assert(shaderObjects.stages.size() == 1 && shaderObjects.stages[0] == vk::ShaderStageFlagBits::eCompute);
+    assert(shaderObjects.shaders.size() == 1);
+
+    // Bind the compute shader and dispatch it, then record the default graphics dynamic states. All of them are
+    // extension commands and must be dispatched through the device dispatcher.
+    const vk::raii::CommandPool commandPool { gpu.device, vk::CommandPoolCreateInfo { {}, gpu.queueFamilies.graphics } };
+    vku::executeSingleCommand(*gpu.device, *commandPool, gpu.queues.graphics, [&](vk::CommandBuffer cb) {
+        shaderObjects.bind(cb);
+        cb.dispatch(1, 1, 1);
+
+        vku::setDefaultGraphicsDynamicStates(gpu.device, cb, 2, vk::SampleCountFlagBits::e4);
+    });
+    gpu.queues.graphics.waitIdle();
+}
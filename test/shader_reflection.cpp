@@ -0,0 +1,138 @@
+#include <cassert>
+
+#include <vulkan/vulkan_hpp_macros.hpp>
+
+import std;
+import vku;
+
+#if VULKAN_HPP_DISPATCH_LOADER_DYNAMIC == 1
+VULKAN_HPP_DEFAULT_DISPATCH_LOADER_DYNAMIC_STORAGE
+#endif
+
+constexpr std::uint32_t op(std::uint32_t wordCount, std::uint32_t opcode) noexcept {
+    return (wordCount << 16) | opcode;
+}
+
+// layout (set = 0, binding = 0) uniform texture2D textures[];
+// layout (set = 0, binding = 1) buffer OutputBuffer { uint success[]; };
+// layout (push_constant) uniform PushConstant { vec4 color; int mipLevel; } pc;
+constexpr std::array computeSpirv {
+    0x07230203U, 0x00010300U, 0U, 16U, 0U,
+    op(2, 17), 1U, // OpCapability Shader
+    op(3, 14), 0U, 1U, // OpMemoryModel Logical GLSL450
+    op(4, 71), 10U, 34U, 0U, // OpDecorate %10 DescriptorSet 0
+    op(4, 71), 10U, 33U, 0U, // OpDecorate %10 Binding 0
+    op(4, 71), 11U, 34U, 0U, // OpDecorate %11 DescriptorSet 0
+    op(4, 71), 11U, 33U, 1U, // OpDecorate %11 Binding 1
+    op(4, 71), 4U, 6U, 4U, // OpDecorate %4 ArrayStride 4
+    op(3, 71), 5U, 2U, // OpDecorate %5 Block
+    op(5, 72), 5U, 0U, 35U, 0U, // OpMemberDecorate %5 0 Offset 0
+    op(3, 71), 13U, 2U, // OpDecorate %13 Block
+    op(5, 72), 13U, 0U, 35U, 0U, // OpMemberDecorate %13 0 Offset 0
+    op(5, 72), 13U, 1U, 35U, 16U, // OpMemberDecorate %13 1 Offset 16
+    op(3, 22), 1U, 32U, // %1 = OpTypeFloat 32
+    op(4, 21), 2U, 32U, 0U, // %2 = OpTypeInt 32 0
+    op(9, 25), 3U, 1U, 1U, 0U, 0U, 0U, 1U, 0U, // %3 = OpTypeImage %1 2D 0 0 0 1 Unknown
+    op(3, 29), 4U, 2U, // %4 = OpTypeRuntimeArray %2
+    op(3, 30), 5U, 4U, // %5 = OpTypeStruct %4
+    op(3, 29), 6U, 3U, // %6 = OpTypeRuntimeArray %3
+    op(4, 32), 7U, 0U, 6U, // %7 = OpTypePointer UniformConstant %6
+    op(4, 32), 8U, 12U, 5U, // %8 = OpTypePointer StorageBuffer %5
+    op(4, 23), 9U, 1U, 4U, // %9 = OpTypeVector %1 4
+    op(4, 21), 12U, 32U, 1U, // %12 = OpTypeInt 32 1
+    op(4, 30), 13U, 9U, 12U, // %13 = OpTypeStruct %9 %12
+    op(4, 32), 14U, 9U, 13U, // %14 = OpTypePointer PushConstant %13
+    op(4, 59), 7U, 10U, 0U, // %10 = OpVariable %7 UniformConstant
+    op(4, 59), 8U, 11U, 12U, // %11 = OpVariable %8 StorageBuffer
+    op(4, 59), 14U, 15U, 9U, // %15 = OpVariable %14 PushConstant
+};
+
+// layout (set = 0, binding = 1) buffer OutputBuffer { uint success[]; };
+// layout (set = 1, binding = 0) uniform Uniforms { vec4 value; } uniforms[2];
+// layout (push_constant) uniform PushConstant { layout (offset = 16) int mipLevel; } pc;
+constexpr std::array fragmentSpirv {
+    0x07230203U, 0x00010300U, 0U, 32U, 0U,
+    op(2, 17), 1U, // OpCapability Shader
+    op(3, 14), 0U, 1U, // OpMemoryModel Logical GLSL450
+    op(4, 71), 11U, 34U, 0U, // OpDecorate %11 DescriptorSet 0
+    op(4, 71), 11U, 33U, 1U, // OpDecorate %11 Binding 1
+    op(4, 71), 23U, 34U, 1U, // OpDecorate %23 DescriptorSet 1
+    op(4, 71), 23U, 33U, 0U, // OpDecorate %23 Binding 0
+    op(4, 71), 4U, 6U, 4U, // OpDecorate %4 ArrayStride 4
+    op(3, 71), 5U, 2U, // OpDecorate %5 Block
+    op(5, 72), 5U, 0U, 35U, 0U, // OpMemberDecorate %5 0 Offset 0
+    op(3, 71), 16U, 2U, // OpDecorate %16 Block
+    op(5, 72), 16U, 0U, 35U, 0U, // OpMemberDecorate %16 0 Offset 0
+    op(3, 71), 13U, 2U, // OpDecorate %13 Block
+    op(5, 72), 13U, 0U, 35U, 16U, // OpMemberDecorate %13 0 Offset 16
+    op(3, 22), 1U, 32U, // %1 = OpTypeFloat 32
+    op(4, 21), 2U, 32U, 0U, // %2 = OpTypeInt 32 0
+    op(3, 29), 4U, 2U, // %4 = OpTypeRuntimeArray %2
+    op(3, 30), 5U, 4U, // %5 = OpTypeStruct %4
+    op(4, 32), 8U, 12U, 5U, // %8 = OpTypePointer StorageBuffer %5
+    op(4, 23), 9U, 1U, 4U, // %9 = OpTypeVector %1 4
+    op(4, 21), 12U, 32U, 1U, // %12 = OpTypeInt 32 1
+    op(3, 30), 13U, 12U, // %13 = OpTypeStruct %12
+    op(4, 32), 14U, 9U, 13U, // %14 = OpTypePointer PushConstant %13
+    op(3, 30), 16U, 9U, // %16 = OpTypeStruct %9
+    op(4, 43), 2U, 20U, 2U, // %20 = OpConstant %2 2
+    op(4, 28), 21U, 16U, 20U, // %21 = OpTypeArray %16 %20
+    op(4, 32), 22U, 2U, 21U, // %22 = OpTypePointer Uniform %21
+    op(4, 59), 8U, 11U, 12U, // %11 = OpVariable %8 StorageBuffer
+    op(4, 59), 14U, 15U, 9U, // %15 = OpVariable %14 PushConstant
+    op(4, 59), 22U, 23U, 2U, // %23 = OpVariable %22 Uniform
+};
+
+int main() {
+    const vku::ShaderSignature computeSignature = vku::reflectShader(computeSpirv, vk::ShaderStageFlagBits::eCompute);
+    assert(computeSignature.setLayoutBindings.size() == 1);
+    assert((computeSignature.setLayoutBindings[0] == std::vector {
+        vk::DescriptorSetLayoutBinding { 0, vk::DescriptorType::eSampledImage, 0, vk::ShaderStageFlagBits::eCompute },
+        vk::DescriptorSetLayoutBinding { 1, vk::DescriptorType::eStorageBuffer, 1, vk::ShaderStageFlagBits::eCompute },
+    }));
+    assert((computeSignature.pushConstantRange == vk::PushConstantRange { vk::ShaderStageFlagBits::eCompute, 0, 20 }));
+
+    const vku::ShaderSignature fragmentSignature = vku::reflectShader(fragmentSpirv, vk::ShaderStageFlagBits::eFragment);
+    assert(fragmentSignature.setLayoutBindings.size() == 2);
+    assert((fragmentSignature.setLayoutBindings[1] == std::vector {
+        vk::DescriptorSetLayoutBinding { 0, vk::DescriptorType::eUniformBuffer, 2, vk::ShaderStageFlagBits::eFragment },
+    }));
+    assert((fragmentSignature.pushConstantRange == vk::PushConstantRange { vk::ShaderStageFlagBits::eFragment, 16, 4 }));
+
+    // Merge: bindings at the same slot are shared by both stages, push constant range covers both.
+    vku::ShaderSignature merged = computeSignature;
+    merged.merge(fragmentSignature);
+    assert((merged.setLayoutBindings[0] == std::vector {
+        vk::DescriptorSetLayoutBinding { 0, vk::DescriptorType::eSampledImage, 0, vk::ShaderStageFlagBits::eCompute },
+        vk::DescriptorSetLayoutBinding { 1, vk::DescriptorType::eStorageBuffer, 1, vk::ShaderStageFlagBits::eCompute | vk::ShaderStageFlagBits::eFragment },
+    }));
+    assert(merged.setLayoutBindings[1] == fragmentSignature.setLayoutBindings[1]);
+    assert((merged.pushConstantRange == vk::PushConstantRange { vk::ShaderStageFlagBits::eCompute | vk::ShaderStageFlagBits::eFragment, 0, 20 }));
+
+    // Merging is order independent.
+    vku::ShaderSignature reverseMerged = fragmentSignature;
+    reverseMerged.merge(computeSignature);
+    assert(merged == reverseMerged);
+
+    // Conflicting descriptor types must be rejected.
+    vku::ShaderSignature conflicting;
+    conflicting.setLayoutBindings.push_back({ vk::DescriptorSetLayoutBinding { 1, vk::DescriptorType::eUniformBuffer, 1, vk::ShaderStageFlagBits::eVertex } });
+    bool thrown = false;
+    try {
+        merged.merge(conflicting);
+    }
+    catch (const std::runtime_error&) {
+        thrown = true;
+    }
+    assert(thrown && "Conflicting descriptor types must throw");
+
+    // Invalid SPIR-V must be rejected.
+    thrown = false;
+    try {
+        std::ignore = vku::reflectShader(std::array { 0xDEADBEEFU, 0U, 0U, 0U, 0U }, vk::ShaderStageFlagBits::eVertex);
+    }
+    catch (const std::runtime_error&) {
+        thrown = true;
+    }
+    assert(thrown && "Invalid SPIR-V must throw");
+}
@@ -0,0 +1,161 @@
+#include <cassert>
+
+#include <vulkan/vulkan_hpp_macros.hpp>
+
+import std;
+import vku;
+
+#if VULKAN_HPP_DISPATCH_LOADER_DYNAMIC == 1
+VULKAN_HPP_DEFAULT_DISPATCH_LOADER_DYNAMIC_STORAGE
+#endif
+
+struct QueueFamilies {
+    std::uint32_t compute;
+
+    explicit QueueFamilies(vk::PhysicalDevice physicalDevice)
+        : compute { vku::getComputeQueueFamily(physicalDevice.getQueueFamilyProperties()).value() } { }
+};
+
+struct Queues {
+    Queues(vk::Device, const QueueFamilies&) { }
+
+    [[nodiscard]] static auto getCreateInfos(vk::PhysicalDevice physicalDevice, const QueueFamilies &queueFamilies) -> vku::RefHolder<std::vector<vk::DeviceQueueCreateInfo>, std::vector<float>> {
+        return vku::getAllQueueCreateInfos(physicalDevice, { &queueFamilies.compute, 1 });
+    }
+};
+
+struct Gpu : vku::Gpu<QueueFamilies, Queues> {
+    explicit Gpu(const vk::raii::Instance &instance [[clang::lifetimebound]])
+        : vku::Gpu<QueueFamilies, Queues> { instance, vku::Gpu<QueueFamilies, Queues>::Config {
+            .verbose = true,
+            .deviceExtensions = {
+#if __APPLE__
+                vk::KHRPortabilitySubsetExtensionName,
+#endif
+            },
+            .devicePNexts = std::tuple {
+                vk::PhysicalDeviceSynchronization2Features { true },
+            },
+            .apiVersion = vk::makeApiVersion(0, 1, 3, 0),
+        } } { }
+};
+
+constexpr std::uint32_t threadCount = 4;
+constexpr std::uint32_t submissionCountPerThread = 16;
+
+int main() {
+#if VULKAN_HPP_DISPATCH_LOADER_DYNAMIC == 1
+    VULKAN_HPP_DEFAULT_DISPATCHER.init();
+#endif
+
+    const vk::raii::Context context;
+
+    const vk::raii::Instance instance { context, vk::InstanceCreateInfo {
+#if __APPLE__
+        vk::InstanceCreateFlagBits::eEnumeratePortabilityKHR,
+#else
+        {},
+#endif
+        vku::unsafeAddress(vk::ApplicationInfo {
+            "vku_test_submission_service", 0,
+            {}, 0,
+            vk::makeApiVersion(0, 1, 3, 0),
+        }),
+        {},
+#if __APPLE__
+        vku::unsafeProxy({
+            vk::KHRGetPhysicalDeviceProperties2ExtensionName,
+            vk::KHRPortabilityEnumerationExtensionName,
+        }),
+#endif
+    } };
+#if VULKAN_HPP_DISPATCH_LOADER_DYNAMIC == 1
+    VULKAN_HPP_DEFAULT_DISPATCHER.init(*instance);
+#endif
+
+    const Gpu gpu { instance };
+    const std::uint32_t queueCount = gpu.physicalDevice.getQueueFamilyProperties()[gpu.queueFamilies.compute].queueCount;
+
+    // buffer[thread] is the index of the last executed submission of the thread.
+    const vku::MappedBuffer buffer { gpu.allocator, vk::BufferCreateInfo {
+        {},
+        threadCount * sizeof(std::uint32_t),
+        vk::BufferUsageFlagBits::eTransferDst,
+    } };
+
+    // Each command buffer waits for the transfer writes of the previously submitted ones, and overwrites the slot of
+    // its thread. If the enqueued order was not kept, the slots would end up with the stale indices.
+    const vk::raii::CommandPool commandPool { gpu.device, vk::CommandPoolCreateInfo { {}, gpu.queueFamilies.compute } };
+    const std::vector commandBuffers = (*gpu.device).allocateCommandBuffers(vk::CommandBufferAllocateInfo {
+        *commandPool,
+        vk::CommandBufferLevel::ePrimary,
+        threadCount * submissionCountPerThread + 1,
+    });
+    for (std::uint32_t thread = 0; thread < threadCount; ++thread) {
+        for (std::uint32_t i = 0; i < submissionCountPerThread; ++i) {
+            const vk::CommandBuffer cb = commandBuffers[thread * submissionCountPerThread + i];
+            cb.begin(vk::CommandBufferBeginInfo{});
+            cb.pipelineBarrier(
+                vk::PipelineStageFlagBits::eTransfer, vk::PipelineStageFlagBits::eTransfer,
+                {}, vk::MemoryBarrier { vk::AccessFlagBits::eTransferWrite, vk::AccessFlagBits::eTransferWrite }, {}, {});
+            cb.fillBuffer(buffer, thread * sizeof(std::uint32_t), sizeof(std::uint32_t), i);
+            cb.end();
+        }
+    }
+
+    // Make the transfer writes visible to the host.
+    const vk::CommandBuffer lastCommandBuffer = commandBuffers.back();
+    lastCommandBuffer.begin(vk::CommandBufferBeginInfo{});
+    lastCommandBuffer.pipelineBarrier(
+        vk::PipelineStageFlagBits::eTransfer, vk::PipelineStageFlagBits::eHost,
+        {}, vk::MemoryBarrier { vk::AccessFlagBits::eTransferWrite, vk::AccessFlagBits::eHostRead }, {}, {});
+    lastCommandBuffer.end();
+
+    const auto enqueueAll = [&](vku::SubmissionService &submissionService) {
+        std::vector<std::future<void>> futures(threadCount * submissionCountPerThread);
+        {
+            std::vector<std::jthread> threads;
+            for (std::uint32_t thread = 0; thread < threadCount; ++thread) {
+                threads.emplace_back([&, thread] {
+                    for (std::uint32_t i = 0; i < submissionCountPerThread; ++i) {
+                        const std::uint32_t index = thread * submissionCountPerThread + i;
+                        futures[index] = submissionService.enqueue({
+                            .commandBufferInfos = { vk::CommandBufferSubmitInfo { commandBuffers[index] } },
+                        });
+                    }
+                });
+            }
+        }
+        return futures;
+    };
+
+    std::optional<vku::SubmissionService> submissionService { std::in_place, *gpu.device, gpu.queueFamilies.compute, queueCount };
+    assert(submissionService->getQueueFamilyIndex() == gpu.queueFamilies.compute);
+
+    // Ordering: the fence of the last submission covers all the previously enqueued submissions.
+    std::vector futures = enqueueAll(*submissionService);
+    const vk::raii::Fence fence { gpu.device, vk::FenceCreateInfo{} };
+    std::future lastFuture = submissionService->enqueue({
+        .commandBufferInfos = { vk::CommandBufferSubmitInfo { lastCommandBuffer } },
+        .fence = *fence,
+    });
+    lastFuture.get();
+    for (std::future<void> &future : futures) {
+        future.get();
+    }
+    if (gpu.device.waitForFences(*fence, true, ~0ULL) != vk::Result::eSuccess) {
+        throw std::runtime_error { "Failed to wait the fence!" };
+    }
+    for (std::uint32_t thread = 0; thread < threadCount; ++thread) {
+        assert(buffer.asValue<std::uint32_t>(thread * sizeof(std::uint32_t)) == submissionCountPerThread - 1);
+    }
+
+    // Shutdown: the pending submissions must be submitted before the destructor returns.
+    futures = enqueueAll(*submissionService);
+    submissionService.reset();
+    for (std::future<void> &future : futures) {
+        assert(future.wait_for(std::chrono::seconds { 0 }) == std::future_status::ready);
+        future.get();
+    }
+    gpu.device.waitIdle();
+}
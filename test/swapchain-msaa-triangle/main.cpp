@@ -128,7 +128,7 @@ int main(){
         attachmentGroup.storeImage(attachmentGroup.createDepthStencilImage(gpu.allocator, vk::Format::eD32Sfloat)));
 
     const vk::raii::PipelineLayout pipelineLayout { gpu.device, vk::PipelineLayoutCreateInfo{} };
-    const vk::raii::Pipeline pipeline { gpu.device, nullptr, vk::StructureChain {
+    const vk::raii::Pipeline pipeline { gpu.device, gpu.pipelineCache, vk::StructureChain {
         vku::getDefaultGraphicsPipelineCreateInfo(
             createPipelineStages(
                 gpu.device,
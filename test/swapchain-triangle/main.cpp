@@ -124,7 +124,7 @@ int main(){
         vk::Format::eB8G8R8A8Srgb);
 
     const vk::raii::PipelineLayout pipelineLayout { gpu.device, vk::PipelineLayoutCreateInfo{} };
-    const vk::raii::Pipeline pipeline { gpu.device, nullptr, vk::StructureChain {
+    const vk::raii::Pipeline pipeline { gpu.device, gpu.pipelineCache, vk::StructureChain {
         vku::getDefaultGraphicsPipelineCreateInfo(
             createPipelineStages(
                 gpu.device,
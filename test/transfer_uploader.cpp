@@ -0,0 +1,243 @@
+#include <cassert>
+
+#include <vulkan/vulkan_hpp_macros.hpp>
+
+import std;
+import vku;
+
+#if VULKAN_HPP_DISPATCH_LOADER_DYNAMIC == 1
+VULKAN_HPP_DEFAULT_DISPATCH_LOADER_DYNAMIC_STORAGE
+#endif
+
+struct QueueFamilies {
+    std::uint32_t compute;
+
+    /**
+     * @brief Transfer specialized queue family if exists, otherwise same as <tt>compute</tt>.
+     */
+    std::uint32_t transfer;
+
+    explicit QueueFamilies(vk::PhysicalDevice physicalDevice)
+        : compute { vku::getComputeQueueFamily(physicalDevice.getQueueFamilyProperties()).value() }
+        , transfer { vku::getTransferSpecializedQueueFamily(physicalDevice.getQueueFamilyProperties()).value_or(compute) } { }
+
+    [[nodiscard]] auto getUniqueIndices() const -> std::vector<std::uint32_t> {
+        if (compute == transfer) {
+            return { compute };
+        }
+        return { compute, transfer };
+    }
+};
+
+struct Queues {
+    vk::Queue compute;
+    vk::Queue transfer;
+
+    Queues(vk::Device device, const QueueFamilies &queueFamilies)
+        : compute { device.getQueue(queueFamilies.compute, 0) }
+        , transfer { device.getQueue(queueFamilies.transfer, 0) } { }
+
+    [[nodiscard]] static auto getCreateInfos(vk::PhysicalDevice physicalDevice, const QueueFamilies &queueFamilies) -> vku::RefHolder<std::vector<vk::DeviceQueueCreateInfo>, std::vector<float>> {
+        return vku::getAllQueueCreateInfos(physicalDevice, queueFamilies.getUniqueIndices());
+    }
+};
+
+struct Gpu : vku::Gpu<QueueFamilies, Queues> {
+    explicit Gpu(const vk::raii::Instance &instance [[clang::lifetimebound]])
+        : vku::Gpu<QueueFamilies, Queues> { instance, vku::Gpu<QueueFamilies, Queues>::Config {
+            .verbose = true,
+            .deviceExtensions = {
+#if __APPLE__
+                vk::KHRPortabilitySubsetExtensionName,
+#endif
+            },
+            .devicePNexts = std::tuple {
+                vk::PhysicalDeviceTimelineSemaphoreFeatures { true },
+                vk::PhysicalDeviceSynchronization2Features { true },
+            },
+            .apiVersion = vk::makeApiVersion(0, 1, 3, 0),
+        } } { }
+};
+
+[[nodiscard]] auto getAllocationCount(vma::Allocator allocator) -> std::uint32_t {
+    return allocator.calculateStatistics().total.statistics.allocationCount;
+}
+
+int main() {
+#if VULKAN_HPP_DISPATCH_LOADER_DYNAMIC == 1
+    VULKAN_HPP_DEFAULT_DISPATCHER.init();
+#endif
+
+    const vk::raii::Context context;
+
+    const vk::raii::Instance instance { context, vk::InstanceCreateInfo {
+#if __APPLE__
+        vk::InstanceCreateFlagBits::eEnumeratePortabilityKHR,
+#else
+        {},
+#endif
+        vku::unsafeAddress(vk::ApplicationInfo {
+            "vku_test_transfer_uploader", 0,
+            {}, 0,
+            vk::makeApiVersion(0, 1, 3, 0),
+        }),
+        {},
+#if __APPLE__
+        vku::unsafeProxy({
+            vk::KHRGetPhysicalDeviceProperties2ExtensionName,
+            vk::KHRPortabilityEnumerationExtensionName,
+        }),
+#endif
+    } };
+#if VULKAN_HPP_DISPATCH_LOADER_DYNAMIC == 1
+    VULKAN_HPP_DEFAULT_DISPATCHER.init(*instance);
+#endif
+
+    const Gpu gpu { instance };
+
+    std::array<std::uint32_t, 64> bufferData;
+    std::ranges::iota(bufferData, 0U);
+    std::array<std::uint32_t, 16> imageData; // 4x4 R32Uint texels.
+    std::ranges::iota(imageData, 100U);
+
+    vku::TransferUploader uploader { gpu.device, gpu.allocator, gpu.queues.transfer, gpu.queueFamilies.transfer };
+
+    // --------------------
+    // collect() must retain the staging buffers until the timeline semaphore reaches the submitted value.
+    // --------------------
+
+    {
+        const vku::AllocatedBuffer dstBuffer { gpu.allocator, vk::BufferCreateInfo {
+            {},
+            sizeof(bufferData),
+            vk::BufferUsageFlagBits::eTransferDst,
+        } };
+
+        // Block the transfer queue with a batch that waits for the gate semaphore, which is signaled by the host later.
+        // The uploader's signal operation includes the queue operations earlier in submission order, therefore its
+        // semaphore value cannot be reached before the gate is opened.
+        const vk::raii::Semaphore gateSemaphore { gpu.device, vk::StructureChain {
+            vk::SemaphoreCreateInfo{},
+            vk::SemaphoreTypeCreateInfo { vk::SemaphoreType::eTimeline, 0 },
+        }.get() };
+        gpu.queues.transfer.submit2(vk::SubmitInfo2 {
+            {},
+            vku::unsafeProxy(vk::SemaphoreSubmitInfo { *gateSemaphore, 1, vk::PipelineStageFlagBits2::eAllCommands }),
+        });
+
+        const std::uint32_t baseAllocationCount = getAllocationCount(gpu.allocator);
+        const vku::TransferUploader::Upload upload1 = uploader.uploadBuffer(
+            dstBuffer, std::as_bytes(std::span { bufferData }).first(128), 0,
+            gpu.queueFamilies.transfer, vk::PipelineStageFlagBits2::eCopy, vk::AccessFlagBits2::eTransferRead);
+        const vku::TransferUploader::Upload upload2 = uploader.uploadBuffer(
+            dstBuffer, std::as_bytes(std::span { bufferData }).subspan(128), 128,
+            vk::QueueFamilyIgnored, vk::PipelineStageFlagBits2::eCopy, vk::AccessFlagBits2::eTransferRead);
+        assert(getAllocationCount(gpu.allocator) == baseAllocationCount + 2 && "Each upload must have its own staging buffer");
+
+        // No ownership transfer for the same or ignored queue family.
+        assert(!upload1.bufferAcquireBarrier && !upload1.imageAcquireBarrier);
+        assert(!upload2.bufferAcquireBarrier && !upload2.imageAcquireBarrier);
+
+        const std::uint64_t submittedValue = uploader.submit();
+        assert(upload1.timelineValue == submittedValue && upload2.timelineValue == submittedValue);
+        assert(uploader.submit() == submittedValue && "Empty submit must return the last submitted value");
+
+        // Submission is blocked by the gate: staging buffers must be retained.
+        assert(uploader.collect() < submittedValue);
+        assert(getAllocationCount(gpu.allocator) == baseAllocationCount + 2 && "Staging buffers must not be freed before completion");
+
+        gpu.device.signalSemaphore({ *gateSemaphore, 1 });
+        std::ignore = gpu.device.waitSemaphores({ {}, uploader.getTimelineSemaphore(), submittedValue }, ~0ULL);
+
+        assert(uploader.collect() >= submittedValue);
+        assert(getAllocationCount(gpu.allocator) == baseAllocationCount && "Staging buffers must be freed after completion");
+    }
+
+    // --------------------
+    // Queue family ownership release/acquire pair with the timeline wait.
+    // --------------------
+
+    if (gpu.queueFamilies.transfer == gpu.queueFamilies.compute) {
+        std::cerr << "Transfer specialized queue family is not available, skipping the ownership transfer test.\n";
+        return 0;
+    }
+
+    const vku::AllocatedBuffer dstBuffer { gpu.allocator, vk::BufferCreateInfo {
+        {},
+        sizeof(bufferData),
+        vk::BufferUsageFlagBits::eTransferDst | vk::BufferUsageFlagBits::eTransferSrc,
+    } };
+    const vku::AllocatedImage dstImage { gpu.allocator, vk::ImageCreateInfo {
+        {},
+        vk::ImageType::e2D,
+        vk::Format::eR32Uint,
+        vk::Extent3D { 4, 4, 1 },
+        1, 1,
+        vk::SampleCountFlagBits::e1,
+        vk::ImageTiling::eOptimal,
+        vk::ImageUsageFlagBits::eTransferDst | vk::ImageUsageFlagBits::eTransferSrc,
+    } };
+
+    const vku::TransferUploader::Upload bufferUpload = uploader.uploadBuffer(
+        dstBuffer, std::as_bytes(std::span { bufferData }), 0,
+        gpu.queueFamilies.compute, vk::PipelineStageFlagBits2::eCopy, vk::AccessFlagBits2::eTransferRead);
+    const vku::TransferUploader::Upload imageUpload = uploader.uploadImage(
+        dstImage, std::as_bytes(std::span { imageData }), vk::ImageLayout::eTransferSrcOptimal,
+        gpu.queueFamilies.compute, vk::PipelineStageFlagBits2::eCopy, vk::AccessFlagBits2::eTransferRead);
+    const std::uint64_t submittedValue = uploader.submit();
+    assert(bufferUpload.timelineValue == submittedValue && imageUpload.timelineValue == submittedValue);
+
+    // Acquire barriers must match the release barriers: same queue families, range and layouts.
+    assert(bufferUpload.bufferAcquireBarrier && !bufferUpload.imageAcquireBarrier);
+    const vk::BufferMemoryBarrier2 &bufferAcquireBarrier = *bufferUpload.bufferAcquireBarrier;
+    assert(bufferAcquireBarrier.srcQueueFamilyIndex == gpu.queueFamilies.transfer);
+    assert(bufferAcquireBarrier.dstQueueFamilyIndex == gpu.queueFamilies.compute);
+    assert(bufferAcquireBarrier.buffer == dstBuffer.buffer && bufferAcquireBarrier.offset == 0 && bufferAcquireBarrier.size == sizeof(bufferData));
+    assert(bufferAcquireBarrier.srcAccessMask == vk::AccessFlagBits2::eNone);
+    assert(bufferAcquireBarrier.dstStageMask == vk::PipelineStageFlagBits2::eCopy && bufferAcquireBarrier.dstAccessMask == vk::AccessFlagBits2::eTransferRead);
+
+    assert(imageUpload.imageAcquireBarrier && !imageUpload.bufferAcquireBarrier);
+    const vk::ImageMemoryBarrier2 &imageAcquireBarrier = *imageUpload.imageAcquireBarrier;
+    assert(imageAcquireBarrier.srcQueueFamilyIndex == gpu.queueFamilies.transfer);
+    assert(imageAcquireBarrier.dstQueueFamilyIndex == gpu.queueFamilies.compute);
+    assert(imageAcquireBarrier.oldLayout == vk::ImageLayout::eTransferDstOptimal && imageAcquireBarrier.newLayout == vk::ImageLayout::eTransferSrcOptimal);
+    assert(imageAcquireBarrier.image == dstImage.image);
+
+    // Acquire the resources in the compute queue after waiting the timeline value, and read them back.
+    const vku::MappedBuffer readbackBuffer { gpu.allocator, vk::BufferCreateInfo {
+        {},
+        sizeof(bufferData) + sizeof(imageData),
+        vk::BufferUsageFlagBits::eTransferDst,
+    }, vku::allocation::hostRead };
+
+    const vk::raii::CommandPool computeCommandPool { gpu.device, vk::CommandPoolCreateInfo {
+        {},
+        gpu.queueFamilies.compute,
+    } };
+    const vk::CommandBuffer commandBuffer = (*gpu.device).allocateCommandBuffers({ *computeCommandPool, vk::CommandBufferLevel::ePrimary, 1 })[0];
+    commandBuffer.begin({ vk::CommandBufferUsageFlagBits::eOneTimeSubmit });
+    commandBuffer.pipelineBarrier2({ {}, {}, bufferAcquireBarrier, imageAcquireBarrier });
+    commandBuffer.copyBuffer(dstBuffer, readbackBuffer, vk::BufferCopy { 0, 0, sizeof(bufferData) });
+    commandBuffer.copyImageToBuffer(
+        dstImage, vk::ImageLayout::eTransferSrcOptimal,
+        readbackBuffer,
+        vk::BufferImageCopy {
+            sizeof(bufferData), 0, 0,
+            { vk::ImageAspectFlagBits::eColor, 0, 0, 1 },
+            { 0, 0, 0 }, dstImage.extent,
+        });
+    commandBuffer.end();
+
+    gpu.queues.compute.submit2(vk::SubmitInfo2 {
+        {},
+        vku::unsafeProxy(vk::SemaphoreSubmitInfo { uploader.getTimelineSemaphore(), submittedValue, vk::PipelineStageFlagBits2::eCopy }),
+        vku::unsafeProxy(vk::CommandBufferSubmitInfo { commandBuffer }),
+    });
+    gpu.queues.compute.waitIdle();
+
+    const std::span readback = readbackBuffer.asRange<const std::uint32_t>();
+    assert(std::ranges::equal(readback.first(bufferData.size()), bufferData) && "Buffer upload mismatch!");
+    assert(std::ranges::equal(readback.subspan(bufferData.size()), imageData) && "Image upload mismatch!");
+
+    assert(uploader.collect() >= submittedValue);
+}
@@ -0,0 +1,160 @@
+#include <cassert>
+
+#include <vulkan/vulkan_hpp_macros.hpp>
+
+import std;
+import vku;
+
+#if VULKAN_HPP_DISPATCH_LOADER_DYNAMIC == 1
+VULKAN_HPP_DEFAULT_DISPATCH_LOADER_DYNAMIC_STORAGE
+#endif
+
+// OpEntryPoint GLCompute %1 "main"; OpExecutionMode %1 LocalSize 1 1 1; void main() { }
+constexpr std::array emptyComputeSpirv {
+    0x07230203U, 0x00010000U, 0U, 5U, 0U,
+    0x00020011U, 1U, // OpCapability Shader
+    0x0003000EU, 0U, 1U, // OpMemoryModel Logical GLSL450
+    0x0005000FU, 5U, 1U, 0x6E69616DU, 0U, // OpEntryPoint GLCompute %1 "main"
+    0x00060010U, 1U, 17U, 1U, 1U, 1U, // OpExecutionMode %1 LocalSize 1 1 1
+    0x00020013U, 2U, // %2 = OpTypeVoid
+    0x00030021U, 3U, 2U, // %3 = OpTypeFunction %2
+    0x00050036U, 2U, 1U, 0U, 3U, // %1 = OpFunction %2 None %3
+    0x000200F8U, 4U, // %4 = OpLabel
+    0x000100FDU, // OpReturn
+    0x00010038U, // OpFunctionEnd
+};
+
+struct QueueFamilies {
+    std::uint32_t compute;
+
+    explicit QueueFamilies(vk::PhysicalDevice physicalDevice)
+        : compute { vku::getComputeQueueFamily(physicalDevice.getQueueFamilyProperties()).value() } { }
+};
+
+struct Queues {
+    vk::Queue compute;
+
+    Queues(vk::Device device, const QueueFamilies &queueFamilies)
+        : compute { device.getQueue(queueFamilies.compute, 0) } { }
+
+    [[nodiscard]] static auto getCreateInfos(vk::PhysicalDevice, const QueueFamilies &queueFamilies) noexcept -> vku::RefHolder<vk::DeviceQueueCreateInfo> {
+        return vku::RefHolder {
+            [&]() {
+                static constexpr float priority = 1.f;
+                return vk::DeviceQueueCreateInfo {
+                    {},
+                    queueFamilies.compute,
+                    vk::ArrayProxyNoTemporaries<const float>(priority),
+                };
+            },
+        };
+    }
+};
+
+struct Gpu : vku::Gpu<QueueFamilies, Queues> {
+    explicit Gpu(const vk::raii::Instance &instance [[clang::lifetimebound]])
+        : vku::Gpu<QueueFamilies, Queues> { instance, vku::Gpu<QueueFamilies, Queues>::Config {
+            .verbose = true,
+#if __APPLE__
+            .deviceExtensions = {
+                vk::KHRPortabilitySubsetExtensionName,
+            },
+#endif
+        } } { }
+};
+
+int main() {
+#if VULKAN_HPP_DISPATCH_LOADER_DYNAMIC == 1
+    VULKAN_HPP_DEFAULT_DISPATCHER.init();
+#endif
+
+    const vk::raii::Context context;
+
+    const vk::raii::Instance instance { context, vk::InstanceCreateInfo {
+#if __APPLE__
+        vk::InstanceCreateFlagBits::eEnumeratePortabilityKHR,
+#else
+        {},
+#endif
+        vku::unsafeAddress(vk::ApplicationInfo {
+            "vku_test_workgroup_size_tuner", 0,
+            {}, 0,
+            vk::makeApiVersion(0, 1, 0, 0),
+        }),
+        {},
+#if __APPLE__
+        vku::unsafeProxy({
+            vk::KHRGetPhysicalDeviceProperties2ExtensionName,
+            vk::KHRPortabilityEnumerationExtensionName,
+        }),
+#endif
+    } };
+#if VULKAN_HPP_DISPATCH_LOADER_DYNAMIC == 1
+    VULKAN_HPP_DEFAULT_DISPATCHER.init(*instance);
+#endif
+
+    const Gpu gpu { instance };
+    if (gpu.physicalDevice.getQueueFamilyProperties()[gpu.queueFamilies.compute].timestampValidBits == 0) {
+        std::cerr << "Compute queue family does not support the timestamp queries.\n";
+        return 0;
+    }
+
+    const std::filesystem::path path = std::filesystem::temp_directory_path() / "vku_test_workgroup_size_tuner" / "results.txt";
+    std::filesystem::remove_all(path.parent_path());
+
+    // Entry of the other device, which must be preserved by the saves.
+    constexpr std::string_view otherDeviceEntry = R"(00000000000000000000000000000000 "blur" 1 2 3)";
+    std::filesystem::create_directories(path.parent_path());
+    std::ofstream { path } << otherDeviceEntry << '\n';
+
+    const vk::raii::PipelineLayout pipelineLayout { gpu.device, vk::PipelineLayoutCreateInfo{} };
+
+    // The shader has the fixed workgroup size, therefore the appended specialization constants are ignored by the
+    // driver. It is enough for testing the persistence.
+    const vku::Shader shader { emptyComputeSpirv, vk::ShaderStageFlagBits::eCompute };
+    constexpr std::array<vku::WorkgroupSizeTuner::WorkgroupSize, 3> candidates {
+        vku::WorkgroupSizeTuner::WorkgroupSize { 1, 1, 1 },
+        vku::WorkgroupSizeTuner::WorkgroupSize { 8, 8, 1 },
+        vku::WorkgroupSizeTuner::WorkgroupSize { 64, 1, 1 },
+    };
+
+    std::map<std::string, vku::WorkgroupSizeTuner::WorkgroupSize> tunedResults;
+    {
+        vku::WorkgroupSizeTuner tuner { gpu.device, *gpu.physicalDevice, path };
+        assert(!tuner.find("blur") && "Other device's result must not be loaded");
+
+        for (std::string_view kernelKey : { "blur", "downsample", "upsample" }) {
+            const vku::WorkgroupSizeTuner::WorkgroupSize workgroupSize = tuner.tune(
+                kernelKey, shader, *pipelineLayout, candidates,
+                gpu.queues.compute, gpu.queueFamilies.compute,
+                [](vk::CommandBuffer cb, const vku::WorkgroupSizeTuner::WorkgroupSize&) {
+                    cb.dispatch(1, 1, 1);
+                });
+            assert(std::ranges::contains(candidates, workgroupSize));
+            tunedResults.emplace(kernelKey, workgroupSize);
+        }
+
+        // Concurrent saves must not corrupt the file.
+        std::vector<std::jthread> threads;
+        for (std::size_t i = 0; i < 8; ++i) {
+            threads.emplace_back([&] { tuner.save(); });
+        }
+    }
+
+    // The results must be loaded by the new tuner of the same device.
+    const vku::WorkgroupSizeTuner tuner { gpu.device, *gpu.physicalDevice, path };
+    for (const auto &[kernelKey, workgroupSize] : tunedResults) {
+        assert(tuner.find(kernelKey) == workgroupSize);
+    }
+
+    // The other device's entry must be kept, and no temporary file must be left.
+    std::ifstream file { path };
+    bool otherDeviceEntryFound = false;
+    for (std::string line; std::getline(file, line);) {
+        otherDeviceEntryFound |= line == otherDeviceEntry;
+    }
+    assert(otherDeviceEntryFound);
+    assert(std::ranges::distance(std::filesystem::directory_iterator { path.parent_path() }) == 1);
+
+    std::filesystem::remove_all(path.parent_path());
+}